@@ -19,6 +19,7 @@
 #include "glow/Backend/CompiledFunction.h"
 #include "glow/Backends/BackendOptions.h"
 #include "glow/Base/Traits.h"
+#include "glow/IR/SchedulerOptions.h"
 #include "glow/Optimizer/GraphOptimizer/CompilationContext.h"
 #include "glow/Optimizer/GraphOptimizer/FunctionPassPipeline.h"
 #include "glow/Optimizer/IROptimizer/IRFunctionPassPipeline.h"
@@ -169,6 +170,13 @@ public:
   /// performed.
   virtual bool shouldShareBuffers() const { return true; }
 
+  /// \returns the options of the graph scheduler used to linearize Functions
+  /// before IRGen for this Backend. The scheduler command line options take
+  /// precedence when they are given.
+  virtual SchedulerOptions getSchedulerOptions() const {
+    return SchedulerOptions();
+  }
+
   /// Modify the \p optimizationOpts however desired.
   virtual std::unique_ptr<FunctionPassPipeline> getOptimizationPipeline() const;
   /// Modify the \p optimizationOpts however desired.
@@ -20,6 +20,7 @@
 #include "glow/IR/IR.h"
 
 #include <map>
+#include <unordered_map>
 
 namespace glow {
 namespace runtime {
@@ -58,6 +59,9 @@ class RuntimeBundle {
   SymbolTableTy symbolTable_;
   /// Pointer to memory containing the weights for execution.
   uint8_t *constants_{nullptr};
+  /// True if constants_ is owned by a SharedConstantStore rather than by this
+  /// bundle.
+  bool sharedConstants_{false};
   /// Amount of memory needed for weights.
   size_t constantWeightVarsMemSize_{0};
   /// Amount of memory needed for mutable vars.
@@ -78,6 +82,14 @@ public:
   uint8_t *getConstants() const { return constants_; }
   /// Set pointer to memory block of constants.
   void setConstants(uint8_t *constants) { constants_ = constants; }
+  /// Set pointer to memory block of constants owned by a SharedConstantStore.
+  /// Such a block is not freed by freeConstants().
+  void setSharedConstants(uint8_t *constants) {
+    constants_ = constants;
+    sharedConstants_ = true;
+  }
+  /// \returns true if the constants are owned by a SharedConstantStore.
+  bool hasSharedConstants() const { return sharedConstants_; }
   /// Helper function, gets offset of \p v.
   size_t getValueOffset(const Named *v) const;
   /// Helper function, gets symbol info for \p v.
@@ -147,6 +159,68 @@ public:
   RuntimeBundle(RuntimeBundle &&rhs);
   RuntimeBundle &operator=(RuntimeBundle &&rhs);
 };
+
+/// A content-addressed, reference-counted store of constant blocks owned by a
+/// device. RuntimeBundles whose constants have the same layout and contents,
+/// e.g. replicas of a partition or versions of a network sharing a large
+/// embedding table, reference a single block instead of each collecting their
+/// own. The store is not thread safe.
+class SharedConstantStore {
+  /// A constant block and the number of bundles referencing it.
+  struct Block {
+    uint8_t *constants;
+    size_t size;
+    unsigned refCount;
+  };
+
+  /// Blocks keyed by the hash of their contents.
+  std::unordered_multimap<size_t, Block> blocks_;
+
+  /// Hash of each block keyed by its address.
+  std::unordered_map<const uint8_t *, size_t> hashes_;
+
+  /// \returns the block with hash \p hash holding the constants of \p bundle
+  /// taken from \p M, or blocks_.end() if there is none.
+  std::unordered_multimap<size_t, Block>::iterator
+  find(size_t hash, const RuntimeBundle &bundle, const Module *M);
+
+public:
+  SharedConstantStore() = default;
+  SharedConstantStore(const SharedConstantStore &) = delete;
+  SharedConstantStore &operator=(const SharedConstantStore &) = delete;
+  ~SharedConstantStore();
+
+  /// \returns the hash of the layout and contents of the constants of
+  /// \p bundle taken from \p M.
+  static size_t hashConstants(const RuntimeBundle &bundle, const Module *M);
+
+  /// \returns true if the store has a block with hash \p hash holding the
+  /// constants of \p bundle taken from \p M.
+  bool contains(size_t hash, const RuntimeBundle &bundle, const Module *M);
+
+  /// Points \p bundle at a block holding its constants taken from \p M, with
+  /// hash \p hash. Reuses a matching block if there is one, otherwise collects
+  /// a new one. \returns true if an existing block was reused.
+  bool acquire(size_t hash, RuntimeBundle &bundle, const Module *M);
+
+  /// Drops the reference of \p bundle to its block, freeing the block when it
+  /// is no longer referenced. \returns the number of bytes freed.
+  size_t release(RuntimeBundle &bundle);
+
+  /// \returns true if the constants of \p bundle are owned by this store.
+  bool owns(const RuntimeBundle &bundle) const {
+    return bundle.hasSharedConstants() && hashes_.count(bundle.getConstants());
+  }
+
+  /// \returns true if the constants of \p bundle are owned by this store and
+  /// also referenced by other bundles.
+  bool isShared(const RuntimeBundle &bundle);
+
+  /// Takes the block of \p bundle out of the store so that it can be modified:
+  /// \p bundle gets its own copy if other bundles reference the block, and
+  /// otherwise takes ownership of it.
+  void detach(RuntimeBundle &bundle);
+};
 } // namespace runtime
 
 /// Generates a struct named has_\p METHOD_NAME that looks for a method called
@@ -240,5 +314,11 @@ bool requiresPadding(const Placeholder *V, const Function *F);
 /// \returns true if \p V is used in \p F; false otherwise.
 bool usedInFunction(const Placeholder *V, const Function *F);
 
+/// Copies \p rows over the rows of the tensor of type \p ty stored at \p data,
+/// starting at row \p firstRow. \returns an error if \p rows does not have the
+/// element type and row shape of \p ty, or does not fit in it.
+Error copyTensorRows(uint8_t *data, const Type &ty, dim_t firstRow,
+                     const Tensor &rows);
+
 } // end namespace glow
 #endif // GLOW_BACKENDS_BACKENDUTILS_H
@@ -59,12 +59,18 @@ protected:
   /// String for logging used memory for the device.
   const std::string usedMemoryKey_{"glow.device.used_memory.device"};
 
+  /// String for logging memory saved by sharing constants on the device.
+  const std::string sharedMemoryKey_{"glow.device.shared_memory.device"};
+
   /// Maximum available memory on the device.
   std::atomic<uint64_t> maxMemoryBytes_{0};
 
   /// Amount of memory used by all models.
   std::atomic<uint64_t> usedMemoryBytes_{0};
 
+  /// Amount of memory saved by models sharing constants already on the device.
+  std::atomic<uint64_t> sharedMemoryBytes_{0};
+
   /// Keeps the stats exporter registry object alive till destructor.
   std::shared_ptr<StatsExporterRegistry> statsExporterRegistry_;
 
@@ -77,12 +83,14 @@ protected:
     statsExporterRegistry_->setCounter(availableMemoryKey_,
                                        maxMemoryBytes_ - usedMemoryBytes_);
     statsExporterRegistry_->setCounter(usedMemoryKey_, usedMemoryBytes_);
+    statsExporterRegistry_->setCounter(sharedMemoryKey_, sharedMemoryBytes_);
   }
 
   /// Helper method to zero out memory counters, used when a device is freed.
   void zeroMemoryCounters() {
     statsExporterRegistry_->setCounter(availableMemoryKey_, 0);
     statsExporterRegistry_->setCounter(usedMemoryKey_, 0);
+    statsExporterRegistry_->setCounter(sharedMemoryKey_, 0);
   }
 
 public:
@@ -92,6 +100,8 @@ public:
                             std::to_string(config_.deviceID)),
         usedMemoryKey_("glow.device.used_memory.device" +
                        std::to_string(config_.deviceID)),
+        sharedMemoryKey_("glow.device.shared_memory.device" +
+                         std::to_string(config_.deviceID)),
         maxMemoryBytes_(config_.getDeviceMemory(2000000000)),
         statsExporterRegistry_(StatsExporterRegistry::Stats()) {}
 
@@ -170,6 +180,19 @@ public:
                       "Unsupported feature, cannot copy Placeholder."));
   };
 
+  /// Overwrites the rows of the Constant or static Placeholder \p name used by
+  /// the Function \p functionName, starting at row \p firstRow, with the rows
+  /// of \p rows, then calls \p resultCB with the result of the operation. A
+  /// run of the Function sees either none or all of the update. \p rows must
+  /// stay alive until \p resultCB is called.
+  virtual void updateConstantRows(llvm::StringRef functionName,
+                                  llvm::StringRef name, dim_t firstRow,
+                                  const Tensor &rows,
+                                  std::function<void(Error)> resultCB) {
+    resultCB(MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_ERROR,
+                      "Unsupported feature, cannot update constant rows."));
+  }
+
   /// Stops execution and shuts down the Device.
   virtual Error stop(bool block = true) { return Error::success(); };
 
@@ -79,6 +79,9 @@ protected:
   void runFunctionImpl(runtime::RunIdentifierTy id, std::string functionName,
                        std::unique_ptr<ExecutionContext> context,
                        ResultCBTy cb) override;
+  void updateConstantRowsImpl(std::string functionName, std::string name,
+                              dim_t firstRow, const Tensor &rows,
+                              std::function<void(Error)> resultCB) override;
 };
 
 DeviceManager *createInterpreterDeviceManager(const DeviceConfig &config);
@@ -67,6 +67,10 @@ public:
   /// placeholders.
   void addConstant(std::string name, Tensor *T);
 
+  /// \returns the tensor holding the constant or static placeholder \p name,
+  /// or nullptr if the function has none with that name.
+  Tensor *getConstant(llvm::StringRef name) const;
+
   /// Get reference to IR function.
   IRFunction *getIR() { return F_.get(); }
 
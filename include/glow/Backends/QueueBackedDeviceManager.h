@@ -80,6 +80,20 @@ public:
     return id;
   }
 
+  /// Overwrites rows of the Constant or static Placeholder \p name used by
+  /// \p functionName. The update runs on the device thread between runs, so
+  /// no run sees a partial update.
+  void updateConstantRows(llvm::StringRef functionName, llvm::StringRef name,
+                          dim_t firstRow, const Tensor &rows,
+                          std::function<void(Error)> resultCB) override {
+    workThread_.submit([this, functionName = functionName.str(),
+                        name = name.str(), firstRow, &rows,
+                        resultCB = std::move(resultCB)]() mutable {
+      updateConstantRowsImpl(functionName, name, firstRow, rows,
+                             std::move(resultCB));
+    });
+  }
+
   /// Stops execution and shuts down the Device.
   Error stop(bool block = true) override {
     workThread_.stop(block);
@@ -101,6 +115,15 @@ protected:
   virtual void runFunctionImpl(RunIdentifierTy, std::string,
                                std::unique_ptr<ExecutionContext>,
                                ResultCBTy) = 0;
+
+  /// Overwrite rows of a constant of a loaded Function.
+  virtual void updateConstantRowsImpl(std::string functionName,
+                                      std::string name, dim_t firstRow,
+                                      const Tensor &rows,
+                                      std::function<void(Error)> resultCB) {
+    resultCB(MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_ERROR,
+                      "Unsupported feature, cannot update constant rows."));
+  }
 };
 } // namespace runtime
 } // namespace glow
@@ -44,6 +44,37 @@ public:
   bool contains(uint64_t idx) const { return idx >= begin_ && idx < end_; }
 };
 
+/// A single request issued by a schedule: the allocation of \ref size bytes
+/// for \ref handle if \ref alloc is true, or the deallocation of the buffer
+/// associated with \ref handle otherwise.
+struct Allocation {
+  /// The client-specific object the buffer belongs to.
+  const void *handle;
+  /// Whether this is an allocation or a deallocation.
+  bool alloc;
+  /// The size of the buffer in bytes. Ignored for deallocations.
+  uint64_t size;
+
+  Allocation(const void *handle, bool alloc, uint64_t size = 0)
+      : handle(handle), alloc(alloc), size(size) {}
+};
+
+/// Heuristics used to order buffers when packing them offline with
+/// MemoryAllocator::allocateAll. Each buffer is placed at the lowest address
+/// where it does not overlap any already placed buffer with an overlapping live
+/// interval.
+enum class AllocationStrategy {
+  /// Buffers are placed in the order they become live. This is interval graph
+  /// coloring by the left-edge rule, and gives the same result as the online
+  /// first-fit allocation.
+  LiveIntervalOrder,
+  /// Largest buffers are placed first.
+  SizeFirst,
+  /// Buffers live at the point of highest memory pressure are placed first,
+  /// ordered by the total size of the buffers live along with them.
+  BreadthFirst,
+};
+
 /// Allocates segments of memory.
 /// Each allocation is associated with a user-defined handle, typically
 /// representing a client-specific object, e.g. a handle can be a `Value *` and
@@ -65,6 +96,7 @@ public:
 
   void reset() {
     maxMemoryAllocated_ = 0;
+    memoryLowerBound_ = 0;
     allocations_.clear();
     handleToAllocInfo_.clear();
     addrToHandle_.clear();
@@ -119,6 +151,25 @@ public:
   /// Frees the allocation associated with \p handle.
   void deallocate(Handle handle);
 
+  /// Packs all the buffers requested by the schedule \p allocList at once,
+  /// knowing the live interval of each of them. Every AllocationStrategy is
+  /// tried and the one giving the smallest peak is kept. Segments which are
+  /// currently allocated stay in place and are live during the whole schedule.
+  /// Buffers which are not deallocated by \p allocList are live until its end.
+  /// Afterwards getAddress() and getSize() return the placement of every
+  /// buffer, and the buffers are considered deallocated. \returns the peak
+  /// memory usage of \p allocList, or MemoryAllocator::npos if it does not
+  /// fit into the pool, in which case nothing is allocated.
+  uint64_t allocateAll(const std::vector<Allocation> &allocList);
+
+  /// \returns a lower bound of the peak memory usage which the last call to
+  /// allocateAll() could have achieved: the largest total size of the buffers
+  /// live at the same time.
+  uint64_t getMemoryLowerBound() const { return memoryLowerBound_; }
+
+  /// \returns the strategy picked by the last call to allocateAll().
+  AllocationStrategy getAllocationStrategy() const { return strategy_; }
+
   /// \returns the high water mark for the allocated memory.
   uint64_t getMaxMemoryUsage() const { return maxMemoryAllocated_; }
 
@@ -143,6 +194,10 @@ private:
   uint64_t maxMemoryAllocated_{0};
   /// The alignment boundary for each segment allocation.
   size_t alignment_;
+  /// The lower bound of the peak memory usage of the last allocateAll().
+  uint64_t memoryLowerBound_{0};
+  /// The strategy picked by the last allocateAll().
+  AllocationStrategy strategy_{AllocationStrategy::LiveIntervalOrder};
   /// Maps allocated addresses to the currently associated handles.
   std::unordered_map<uint64_t, Handle> addrToHandle_;
   /// Maps handles to the allocation information about the memory block
@@ -72,6 +72,7 @@ extern int32_t GlowNNPIModelParallelSplitAlignment;
 } // namespace onnxifi
 
 extern bool GlowEnableLoadBalancedPartitioning;
+extern std::string GlowPartitionerCostProfile;
 extern bool GlowNNPILowerAllBatchMatMul;
 extern bool GlowNNPIAcceptUnarySLS;
 extern bool GlowNNPISpecializeAllOneSLS;
@@ -315,6 +315,66 @@ public:
 class Backend;
 struct CompilationContext;
 
+/// Records which Nodes of a Function were created or modified, so that
+/// incremental optimization passes only revisit the Nodes that changed since
+/// they last ran. Every change is stamped with a monotonically increasing
+/// epoch; a Node is considered changed since epoch E if its latest stamp is
+/// greater than E.
+class NodeChangeTracker {
+  /// The latest epoch handed out.
+  uint64_t epoch_{0};
+
+  /// Map from changed Nodes to the epoch of their latest change.
+  llvm::DenseMap<const Node *, uint64_t> changedNodes_;
+
+  /// Map from consumers of the changes (e.g. optimization passes) to the epoch
+  /// up to which they have processed all changes.
+  llvm::DenseMap<unsigned, uint64_t> consumerEpochs_;
+
+public:
+  /// \returns the epoch of the latest change.
+  uint64_t getEpoch() const { return epoch_; }
+
+  /// Mark \p N as changed in a new epoch.
+  void markChanged(const Node *N) { changedNodes_[N] = ++epoch_; }
+
+  /// Stop tracking \p N, e.g. because it is being erased.
+  void forget(const Node *N) { changedNodes_.erase(N); }
+
+  /// Forget all tracked Nodes.
+  void clear() { changedNodes_.clear(); }
+
+  /// \returns the number of Nodes currently tracked as changed.
+  size_t size() const { return changedNodes_.size(); }
+
+  /// Append to \p nodes all Nodes which were changed after \p epoch. Nodes are
+  /// appended in the order in which they were changed.
+  void getChangedSince(uint64_t epoch, std::vector<Node *> &nodes) const;
+
+  /// \returns whether the consumer \p consumerID has processed changes
+  /// before, in which case \p epoch is set to the epoch up to which it did.
+  bool getConsumerEpoch(unsigned consumerID, uint64_t &epoch) const {
+    auto it = consumerEpochs_.find(consumerID);
+    if (it == consumerEpochs_.end()) {
+      return false;
+    }
+    epoch = it->second;
+    return true;
+  }
+
+  /// Record that the consumer \p consumerID processed all changes up to
+  /// \p epoch.
+  void setConsumerEpoch(unsigned consumerID, uint64_t epoch) {
+    consumerEpochs_[consumerID] = epoch;
+  }
+
+  /// Forget about the consumer \p consumerID, e.g. because it skipped some
+  /// changes and needs to start from scratch next time.
+  void resetConsumerEpoch(unsigned consumerID) {
+    consumerEpochs_.erase(consumerID);
+  }
+};
+
 /// Represents the compute graph.
 class Function final : public IRContainer {
   /// A list of nodes that the Function owns.
@@ -336,6 +396,9 @@ class Function final : public IRContainer {
   /// The state of this function.
   FunctionState state_;
 
+  /// Tracks Nodes changed in this function, if change tracking is enabled.
+  std::unique_ptr<NodeChangeTracker> changeTracker_;
+
 public:
   Function(Module *parent, llvm::StringRef Name = {})
       : IRContainer(Name), parent_(parent), state_(FunctionState::FuncCreated) {
@@ -356,6 +419,26 @@ public:
 
   std::string getFilename() { return getName().rsplit('/').second.str(); }
 
+  /// Start recording which Nodes of this function are created or modified.
+  /// This is a no-op if change tracking is already enabled.
+  void enableChangeTracking() {
+    if (!changeTracker_) {
+      changeTracker_ = glow::make_unique<NodeChangeTracker>();
+    }
+  }
+
+  /// \returns the change tracker of this function, or nullptr if change
+  /// tracking is not enabled.
+  NodeChangeTracker *getChangeTracker() { return changeTracker_.get(); }
+
+  /// Mark \p N as changed if change tracking is enabled and \p N belongs to
+  /// this function.
+  void markNodeChanged(const Node *N) {
+    if (changeTracker_ && N && N->getParent() == this) {
+      changeTracker_->markChanged(N);
+    }
+  }
+
   /// Return the log context.
   std::shared_ptr<LogContext> getLogContext() { return logCtx_; }
 
@@ -402,6 +485,7 @@ public:
                                   uniqueNodeNames_, parent_->originalNames_));
     parent_->registerNodeName(N->getName());
     nodes_.push_back(N);
+    markNodeChanged(N);
 
     // Log the node creation.
     logCtx_->logNodeCreation(*N);
@@ -417,6 +501,7 @@ public:
                                   uniqueNodeNames_, parent_->originalNames_));
     parent_->registerNodeName(N->getName());
     nodes_.push_back(N);
+    markNodeChanged(N);
   }
 
   /// Get the pseudo-random number generator used by this module.
@@ -177,6 +177,11 @@ public:
   ///       of input dims and whether the result exists.
   void setTypeUnsafe(unsigned idx, TypeRef ty);
 
+  /// Mark this node and all its users as changed in the change trackers of
+  /// their Functions, e.g. because its result type or payload changed. Users
+  /// are marked as well since what they compute depends on it.
+  void markChanged();
+
   /// Methods that forward to the result type (that must be valid):
   /// @{
   ElemKind getElementType(unsigned resNo) const;
@@ -112,12 +112,15 @@ public:
 
   /// \returns a mutable reference to the payload tensor. If the payload tensor
   /// is unowned then it will be converted to an owned copy before returning.
+  /// The users of the Constant are marked as changed, since the payload may be
+  /// modified through the reference.
   Tensor &getPayloadMutable() {
     /// Make sure the payload is owned before handing out a mutable reference.
     ensureIsOwned();
 
     assert(!payload_.isUnowned() &&
            "Can only modify Constants with owned payloads");
+    markChanged();
     return payload_;
   }
 
@@ -128,9 +131,15 @@ public:
     return getPayload().getHandle<ElemTy>();
   }
 
-  void assign(const Tensor *t) { payload_.assign(t); }
+  void assign(const Tensor *t) {
+    payload_.assign(t);
+    markChanged();
+  }
 
-  void setPayloadType(TypeRef ty) { payload_.setType(ty); }
+  void setPayloadType(TypeRef ty) {
+    payload_.setType(ty);
+    markChanged();
+  }
 
   bool isDataParallel() const { return false; }
 
@@ -21,6 +21,7 @@
 #include "glow/Base/Type.h"
 #include "glow/Graph/Graph.h"
 #include "glow/Graph/UseDef.h"
+#include "glow/IR/SchedulerOptions.h"
 
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/MapVector.h"
@@ -327,9 +328,10 @@ private:
   /// A list of unique instruction names use by the function.
   llvm::StringSet<> stringTable_;
 
-  /// Perform scheduling on the graph.
+  /// Perform scheduling on the graph using the scheduler described by \p opts.
   /// \returns computed schedule in the \p Schedule parameter.
-  void scheduleGraph(NodesPtrList &Schedule);
+  void scheduleGraph(NodesPtrList &Schedule,
+                     const SchedulerOptions &opts = SchedulerOptions());
 
 public:
   /// Add an instruction to the instr stream.
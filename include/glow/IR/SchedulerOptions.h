@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) Glow Contributors. See CONTRIBUTORS file.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef GLOW_IR_SCHEDULEROPTIONS_H
+#define GLOW_IR_SCHEDULEROPTIONS_H
+
+#include <cstddef>
+
+namespace glow {
+
+/// Specifies the kind of graph scheduling to perform.
+enum class SchedulerKind {
+  /// This is a heuristics that tries to minimize memory usage.
+  ChildMemSizeBased,
+  /// Performs a standard topological search
+  TopologicalSortBased,
+  /// Searches over topological orders with a beam search, ranking complete
+  /// schedules by their packed activation peak, with the producer-consumer
+  /// reuse distance breaking ties.
+  MemoryAware,
+};
+
+/// Options of the graph scheduler which linearizes a Function before IRGen.
+struct SchedulerOptions {
+  /// The scheduler to use.
+  SchedulerKind kind{SchedulerKind::ChildMemSizeBased};
+
+  /// Number of partial schedules kept at each step by the MemoryAware
+  /// scheduler.
+  unsigned beamWidth{4};
+
+  /// Maximum work of the MemoryAware scheduler, counted in node visits: one
+  /// per candidate step, one per node of a partial schedule copied into the
+  /// beam, and the square of the number of nodes per complete schedule packed
+  /// by MemoryAllocator::allocateAll. Once it is exhausted the search
+  /// continues greedily with a beam of one, and if packing the complete
+  /// schedules would exceed it they are compared by their live peak instead.
+  /// 0 means no limit.
+  size_t searchBudget{10000000};
+};
+
+} // namespace glow
+
+#endif // GLOW_IR_SCHEDULEROPTIONS_H
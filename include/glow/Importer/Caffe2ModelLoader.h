@@ -21,7 +21,9 @@
 #include "glow/Importer/CommonOperatorLoader.h"
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 #include "caffe2/proto/caffe2.pb.h"
 
@@ -48,13 +50,37 @@ class Caffe2ModelLoader
   /// multidirectional broadcasting.
   bool hasMultidirectionalBroadcast(const llvm::StringRef typeName) override;
 
+  /// Directory against which the external weight files named by the 'init'
+  /// net are resolved.
+  std::string externalWeightsDir_;
+
+  /// External weight files mapped into memory while the weights are loaded,
+  /// keyed by their path.
+  llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> externalWeightsFiles_;
+
   /// Load the weight tensors from the 'init' file and register them in the map
-  /// \p tensors.
+  /// \p tensors. The payloads of the given tensor fills are materialized in
+  /// parallel and released from \p net once they are loaded.
   Error loadWeightsFromNet(caffe2::NetDef &net);
 
   /// Loads an individual weight \p op.
   Error loadWeight(const caffe2::OperatorDef &op);
 
+  /// Fills \p T with the payload of the GivenTensorFill, GivenTensorIntFill or
+  /// GivenTensorInt64Fill \p op. The payload is read from \p externalData if
+  /// it is not empty, and from the values argument of \p op otherwise. This
+  /// does not touch the Module, so it can be run concurrently for different
+  /// ops.
+  Error materializeGivenTensorFill(const caffe2::OperatorDef &op,
+                                   llvm::StringRef externalData, Tensor &T);
+
+  /// \returns the raw payload of \p op if it names an external weight file
+  /// through its external_data argument, or an empty StringRef otherwise. The
+  /// payload starts at the byte offset given by the external_offset argument
+  /// and the file stays mapped until all weights are loaded.
+  Expected<llvm::StringRef>
+  getExternalWeightData(const caffe2::OperatorDef &op);
+
   /// Load the structure of the network from the 'net' file.
   Error loadNetwork(caffe2::NetDef &net);
 
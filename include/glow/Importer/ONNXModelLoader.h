@@ -23,7 +23,9 @@
 #include "onnx/onnx_pb.h"
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 #include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
@@ -42,9 +44,11 @@ class TensorProto;
 namespace glow {
 
 /// Loads tensor \p T from the input \p in. \p useGlowCustomOps changes the
-/// format for doc_string format for adding meta information.
+/// format for doc_string format for adding meta information. If \p data is
+/// not empty then it is used as the raw data of \p in instead of its raw_data
+/// field, e.g. when the data is stored in an external file.
 Error loadTensor(const ONNX_NAMESPACE::TensorProto &in, Tensor *T,
-                 bool useGlowCustomOps = false, const std::string &data = "");
+                 bool useGlowCustomOps = false, llvm::StringRef data = "");
 
 /// Parses as input file name \p fileName which is an ONNX file
 /// and \returns a parsed GraphProto.
@@ -130,6 +134,14 @@ class ONNXModelLoader
   /// A set of Functions used for ConstantFolding to be deleted after loading.
   std::unordered_set<Function *> constFoldFuns_;
 
+  /// Directory relative to which the locations of external data files of
+  /// initializers are resolved.
+  std::string externalDataDir_;
+
+  /// External data files of initializers, mapped into memory while loading
+  /// the initializers.
+  llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> externalDataFiles_;
+
   /// Load ONNX NonZero Operator.
   /// Glow's requirement for static shapes results in required Constant
   /// input. Thus, the operator will be folded in the Importer.
@@ -448,9 +460,21 @@ protected:
   static Expected<ONNX_NAMESPACE::ModelProto>
   loadProto(google::protobuf::io::ZeroCopyInputStream &iStream);
 
-  /// Load the network initializers from the GraphProto.
+  /// Load the network initializers from the GraphProto. The payloads of the
+  /// initializers are released from \p net once loaded.
   Error loadInitializers(ONNX_NAMESPACE::GraphProto &net);
 
+  /// Load the initializers of \p net, none of which is pre-existing in the
+  /// Module or the result of constant folding, decoding their payloads in
+  /// parallel.
+  Error loadInitializersInParallel(ONNX_NAMESPACE::GraphProto &net);
+
+  /// \returns the raw data of initializer \p in stored in an external file,
+  /// or an empty StringRef if \p in is not stored externally. The file is
+  /// mapped into memory until all initializers are loaded.
+  Expected<llvm::StringRef>
+  getExternalData(const ONNX_NAMESPACE::TensorProto &in);
+
   /// Given some initializer \p in, check if it has some constant folding node
   /// associated with it in \p net. If so, deserializes the Function if not
   /// already done, performs the constant folding, and \returns the Constant
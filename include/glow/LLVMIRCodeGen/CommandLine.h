@@ -67,6 +67,10 @@ extern llvm::cl::list<std::string> llvmCompilerOptions;
 /// Option to set float ABI. Used as -float-abi=<abi-type>.
 extern llvm::cl::opt<llvm::FloatABI::ABIType> floatABI;
 
+/// Option to use the fast approximations of the transcendental functions.
+/// Used as -fast-transcendentals.
+extern llvm::cl::opt<bool> llvmFastTranscendentals;
+
 /// Option to specify which bundle API to use.
 extern llvm::cl::opt<glow::BundleApiType> bundleAPI;
 
@@ -55,6 +55,8 @@ class LLVMBackendOptions {
   llvm::SmallVector<std::string, 0> targetFeatures_;
   /// Bundle API to use.
   BundleApiType bundleAPI_;
+  /// Whether to use the fast approximations of the transcendental functions.
+  bool fastTranscendentals_;
 
 public:
   LLVMBackendOptions();
@@ -98,6 +100,12 @@ public:
   BundleApiType getBundleAPI() const { return bundleAPI_; }
   /// Sets bundle API used by this backend for bundles.
   void setBundleAPI(BundleApiType api) { bundleAPI_ = api; }
+  /// \returns whether the fast approximations of the transcendental functions
+  /// are used instead of the libm based kernels.
+  bool getFastTranscendentals() const { return fastTranscendentals_; }
+  /// Sets whether the fast approximations of the transcendental functions are
+  /// used.
+  void setFastTranscendentals(bool fast) { fastTranscendentals_ = fast; }
   /// \returns relocation model used by this backend.
   llvm::Reloc::Model getRelocModel() const { return relocModel_; }
   /// Sets relocation model used by this backend.
@@ -130,11 +138,14 @@ public:
   /// \returns the LLVM target triple for the host.
   static std::string getHostTarget();
 
-  /// \returns the LLVM CPU name for the host.
-  static std::string getHostCPU();
+  /// \returns the LLVM CPU name for the host. AVX-512 CPUs are mapped to
+  /// their AVX2 counterparts unless \p withAVX512 is set.
+  static std::string getHostCPU(bool withAVX512 = false);
 
-  /// \returns the LLVM CPU feature list for the host.
-  static llvm::SmallVector<std::string, 0> getHostFeatures();
+  /// \returns the LLVM CPU feature list for the host. The AVX-512 features
+  /// are left out unless \p withAVX512 is set.
+  static llvm::SmallVector<std::string, 0>
+  getHostFeatures(bool withAVX512 = false);
 
   /// \returns LLVM backend options.
   const LLVMBackendOptions &getOptions() const { return options_; }
@@ -207,6 +218,11 @@ protected:
   /// Emit the jitmain function.
   virtual void emitJitMain(LLVMIRGen &irgen) const;
 
+  /// Compiles \p IR like compileIRWithoutConstants(), but with the LLVM
+  /// backend options \p options instead of the ones of the backend.
+  std::unique_ptr<CompiledFunction>
+  compileIRWithOptions(IRFunction *IR, const LLVMBackendOptions &options) const;
+
   /// LLVM backend options.
   LLVMBackendOptions options_;
 };
@@ -39,6 +39,14 @@ public:
   ///@}
   //
 
+  /// Execute the function with \p context, placing its activations in
+  /// \p activations rather than in a buffer allocated for this run.
+  /// \p activations must hold at least getRuntimeBundle().getActivationsSize()
+  /// bytes, aligned to TensorAlignment, and must not be used by any other run
+  /// until this one returns.
+  Error executeWithActivations(ExecutionContext *context,
+                               uint8_t *activations);
+
 protected:
   /// Load constant tensors from \p bindings into \p weightsAddress, as defined
   /// by the RuntimeBundle (pre-run).
@@ -152,6 +152,8 @@ protected:
   std::unique_ptr<llvm::IRBuilder<>> builder_;
   /// Output directory for bundles, debug info files, etc.
   llvm::StringRef outputDir_;
+  /// Whether to call the fast approximations of the transcendental functions.
+  bool fastTranscendentals_{false};
   /// Debug info emission support.
   DebugInfo dbgInfo_;
   /// Debug info builder.
@@ -377,6 +379,12 @@ public:
   void setOutputDir(llvm::StringRef outputDir) { outputDir_ = outputDir; }
   /// Get output directory for bundles, debug info files, etc.
   llvm::StringRef getOutputDir() const { return outputDir_; }
+  /// Set whether the fast approximations of the transcendental functions are
+  /// used by the generated code.
+  void setFastTranscendentals(bool fast) { fastTranscendentals_ = fast; }
+  /// \returns whether the fast approximations of the transcendental functions
+  /// are used by the generated code.
+  bool getFastTranscendentals() const { return fastTranscendentals_; }
   /// Emit the array of constant offsets as provided by the \p allocationsInfo.
   virtual llvm::Value *
   emitConstOffsetsArray(llvm::IRBuilder<> &builder,
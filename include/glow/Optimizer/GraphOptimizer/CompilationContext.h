@@ -147,6 +147,27 @@ struct OptimizationOptions {
   /// If true, perform compile-time deduplication of Constants.
   bool enableConstantDeduplication{true};
 
+  /// If true, graph optimization passes which support it only revisit the
+  /// Nodes created or modified since they last ran on a Function, instead of
+  /// sweeping over the whole Function every time.
+  bool enableIncrementalGraphOptimization{false};
+
+  /// Name of the backend used to compute constant operations at compile time.
+  /// Falls back to the Interpreter if no such backend is registered.
+  std::string constantFoldingBackendName{"Interpreter"};
+
+  /// If true, all constant operations of a Function are folded together in a
+  /// few batched evaluations instead of one evaluation per operation.
+  bool enableBatchedConstantFolding{false};
+
+  /// Number of threads used to execute batched constant folding evaluations.
+  unsigned numConstantFoldingThreads{1};
+
+  /// If true, the results of constant folding are memoized in a process-wide
+  /// cache keyed on the contents of the folded subgraphs, so that folding the
+  /// same subgraph again (e.g. when recompiling a model) is skipped.
+  bool enableConstantFoldingCache{false};
+
   /// For all Splats in the Function being optimized, if they are used by any
   /// Nodes listed in this set, then they will be materialized into Constants
   /// during Constant Folding.
@@ -294,6 +315,19 @@ struct CompilationContext {
   /// support.
   runtime::DeferredWeightLoader *deferredWeightLoader{nullptr};
 
+  /// Number of deferred weights read and converted ahead of the one being
+  /// transferred to devices. If 0 then deferred weights are loaded one at a
+  /// time.
+  unsigned deferredWeightPrefetchCount{0};
+
+  /// Maximum number of bytes of deferred weights held ahead of the one being
+  /// transferred to devices, or 0 for no limit beyond
+  /// \ref deferredWeightPrefetchCount.
+  uint64_t deferredWeightPrefetchMaxBytes{0};
+
+  /// Number of threads converting prefetched deferred weights.
+  unsigned numDeferredWeightConversionThreads{1};
+
   /// Whether to print out issues/logging during compilation. Used for example
   /// to disable printing issues encountered during ConstantFolding.
   bool verboseCompile{true};
@@ -385,6 +419,10 @@ struct CompilationContext {
             precisionConfig.originNameToTQPMap,
         "If loading unique dummy QParams, must have valid originNameToTQPMap");
 
+    RETURN_ERR_IF_NOT(optimizationOpts.numConstantFoldingThreads > 0,
+                      ErrorValue::ErrorCode::COMPILE_CONTEXT_MALFORMED,
+                      "Constant folding requires at least one thread.");
+
     return Error::success();
   }
 };
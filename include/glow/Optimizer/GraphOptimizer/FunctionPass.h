@@ -19,9 +19,12 @@
 #include "glow/PassManager/Pass.h"
 #include "glow/PassManager/PassConfig.h"
 
+#include "llvm/ADT/ArrayRef.h"
+
 namespace glow {
 
 class Function;
+class Node;
 struct CompilationContext;
 enum class FunctionPassID;
 
@@ -59,7 +62,27 @@ public:
 /// Class used for all passes over Functions. All passes over Functions should
 /// derive from this class, implementing the pass logic and additionally can add
 /// logic for running before and after the pass runs.
-using FunctionPass = Pass<Function, FunctionPassConfig>;
+class FunctionPass : public Pass<Function, FunctionPassConfig> {
+public:
+  /// Constructor.
+  FunctionPass(llvm::StringRef name) : Pass(name) {}
+
+  /// \returns whether this pass can be run incrementally via runOnNodes()
+  /// given \p cctx, i.e. whether it only needs to revisit the Nodes which were
+  /// created or modified since the last time it ran.
+  virtual bool supportsIncrementalMode(const CompilationContext &cctx) const {
+    return false;
+  }
+
+  /// Run the pass on \p F, only revisiting the Nodes in \p worklist, which
+  /// contains all Nodes of \p F changed since the last time this pass ran.
+  /// \returns whether the pass modifies \p F. By default runs the pass over
+  /// the whole Function.
+  virtual bool runOnNodes(Function *F, llvm::ArrayRef<Node *> worklist,
+                          const CompilationContext &cctx) {
+    return run(F, cctx);
+  }
+};
 
 } // namespace glow
 
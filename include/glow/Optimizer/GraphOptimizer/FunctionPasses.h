@@ -32,6 +32,21 @@ namespace glow {
       return FunctionPassID::PASS_NAME;                                        \
     }                                                                          \
   };
+#define FUN_PASS_INCREMENTAL(PASS_NAME)                                        \
+  class PASS_NAME : public FunctionPass {                                      \
+  public:                                                                      \
+    PASS_NAME() : FunctionPass(#PASS_NAME) {}                                  \
+                                                                               \
+  private:                                                                     \
+    bool run(Function *F, const CompilationContext &cctx) override;            \
+    bool supportsIncrementalMode(const CompilationContext &cctx)               \
+        const override;                                                        \
+    bool runOnNodes(Function *F, llvm::ArrayRef<Node *> worklist,              \
+                    const CompilationContext &cctx) override;                  \
+    FunctionPassID getID() const override {                                    \
+      return FunctionPassID::PASS_NAME;                                        \
+    }                                                                          \
+  };
 #include "FunctionPasses.def"
 
 /// Helper that creates and \returns a FunctionPass given a provided \p passID.
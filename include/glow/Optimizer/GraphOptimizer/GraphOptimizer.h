@@ -118,6 +118,14 @@ ConstantFoldingRecordMap constantFoldAndRecord(Function *F,
 void cleanupConstantFolding(Module &mod, const ConstantFoldingRecordMap &record,
                             PlaceholderBindings *bindings = nullptr);
 
+/// Remove all results memoized by constant folding when
+/// OptimizationOptions::enableConstantFoldingCache is set.
+void clearConstantFoldingCache();
+
+/// \returns the number of constant operations whose results are memoized by
+/// constant folding.
+size_t getConstantFoldingCacheSize();
+
 /// Execute function \p F by the \p backend using the provided \p bindings and
 /// the compilation context \p cctx. If \p enableQuantizeConstFolding then
 /// QuantizeNodes can be folded as part of a constant chain.
@@ -70,6 +70,9 @@ class Partitioner final : public PartitionerBase {
   /// The struct contain user-defined partition info.
   PartitionConfig partitionConfig_;
 
+  /// Measured node execution times used in place of the roofline estimates.
+  NodeCostProfile costProfile_;
+
   /// Get the representative function (the one with the largest input) and
   /// update the memSize.
   static Function *selectRepFunc(Module *parent, uint64_t &memSize);
@@ -83,9 +86,10 @@ class Partitioner final : public PartitionerBase {
   Error finalize(const DAGListTy &partitions, const NodeToFunctionMap &mapping);
 
   /// After getting the initial partitions, adjust the partitions to minimize
-  /// communication and computation cost.
-  void partitionsAdjust(NodeToFunctionMap &partitions,
-                        uint64_t availableMemory);
+  /// communication and computation cost. The activations of a partition are
+  /// included in its memory usage if \p sharedActivations.
+  void partitionsAdjust(NodeToFunctionMap &partitions, uint64_t availableMemory,
+                        bool sharedActivations);
 
   /// Assign nodes to partitions grouped by \p backendName and return the
   /// mapping.
@@ -151,6 +155,13 @@ public:
   /// Set contextCount_ to provided /p count.
   void setContextCount(unsigned count) { contextCount_ = count; }
 
+  /// Use the node execution times measured in \p profile in place of the
+  /// roofline estimates, falling back to the latter for nodes which are not
+  /// in \p profile. Takes precedence over the -partitioner-cost-profile file.
+  void setNodeCostProfile(NodeCostProfile profile) {
+    costProfile_ = std::move(profile);
+  }
+
   /// Based on \p partitionConfig passed into Partitioner, do user-defined
   /// partition.
   Expected<DAGListTy>
@@ -21,18 +21,22 @@
 namespace glow {
 /// By using heuristic algorithm to move nodes among \p partitions, optimize the
 /// total communication cost of running a module and keep the memory usage of
-/// each partition within \p availableMemory.
+/// each partition within \p availableMemory. The activations of a partition
+/// are included in its memory usage if \p sharedActivations.
 void optimizeCommunicationCost(NodeToFunctionMap &partitions,
                                FunctionToNodesMap &nodesSet, Module *mod,
-                               uint64_t availableMemory);
+                               uint64_t availableMemory,
+                               bool sharedActivations = false);
 
 /// Combine partitions according to the following rules: Rule 1 :if all outside
 /// uses of the nodes in partition1 is in partition2, and the sum of memory
 /// consumption of partition1 and partition2 is less than availableMemory,
-/// combine partition1 and partition2.
+/// combine partition1 and partition2. The activations of a partition are
+/// included in its memory consumption if \p sharedActivations.
 void partitionsCombine(NodeToFunctionMap &partitions,
                        FunctionToNodesMap &nodesSet, Module *mod,
-                       uint64_t availableMemory);
+                       uint64_t availableMemory,
+                       bool sharedActivations = false);
 
 /// Assign the logicalDevice ID to each partition. The partitions with the same
 /// logicalDevice ID will be assigned on the same physical devices. E.g: there
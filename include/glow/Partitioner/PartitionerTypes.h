@@ -19,6 +19,8 @@
 #include "glow/Graph/Graph.h"
 #include "glow/Runtime/RuntimeTypes.h"
 
+#include "llvm/ADT/StringMap.h"
+
 namespace glow {
 
 using namespace runtime;
@@ -41,6 +43,10 @@ struct GraphMemInfo {
   // Count of inputs to the graph, this is needed to calculate p2p resource
   // consumption.
   unsigned inputCount{0};
+  // The memory usage of the results computed and consumed inside this
+  // subgraph. It is an upper bound of the activations, as it ignores buffer
+  // reuse, and is only charged on devices with shared activations.
+  uint64_t activationMemSize{0};
 
   GraphMemInfo()
       : inMemSize(0), outMemSize(0), constMemSize(0), contextCount(1){};
@@ -54,6 +60,12 @@ struct GraphMemInfo {
     return ((inMemSize + outMemSize) * contextCount) + constMemSize;
   }
 
+  /// Get the total memory size of each partition, including its activations
+  /// if \p sharedActivations, i.e. the device keeps them in a shared arena.
+  uint64_t getTotalMemSize(bool sharedActivations) const {
+    return getTotalMemSize() + (sharedActivations ? activationMemSize : 0);
+  }
+
   bool equals(const GraphMemInfo &other) const {
     return inMemSize == other.inMemSize && outMemSize == other.outMemSize &&
            constMemSize == other.constMemSize;
@@ -67,6 +79,12 @@ inline bool operator==(const GraphMemInfo &LHS, const GraphMemInfo &RHS) {
 /// A list of <nodelist> with BFS order.
 using BFSLevel = std::vector<std::vector<Node *>>;
 
+/// Measured execution time in seconds of nodes, keyed by the name of the node
+/// before lowering. It is typically gathered from OPERATOR level TraceEvents of
+/// real runs, see getNodeCostProfile() and the -dump-node-cost-profile option
+/// of the loader tools.
+using NodeCostProfile = llvm::StringMap<float>;
+
 /// Data structure that contains the info for each type of backend used for
 /// partitioning.
 struct BackendInfo {
@@ -76,6 +94,9 @@ struct BackendInfo {
   uint64_t memSize;
   /// Maximum amount of input resources defaults to 0 if there is no limit.
   uint64_t inputCountMax{0};
+  /// Whether the devices keep one activation arena, counted once per device,
+  /// for all partitions assigned to them. See DeviceInfo::sharedActivations.
+  bool sharedActivations{false};
   /// The following peakCompute, peakDramBw, peakSramBw, peakPCIeBw are from
   /// DeviceInfo_. Available SRAM capacity in bytes.
   uint64_t sramCapacity;
@@ -87,6 +108,9 @@ struct BackendInfo {
   float peakSramBw;
   /// Peak ingress/egress PCI-E bandwidth from device in bytes/second.
   float peakPCIeBw;
+  /// Measured node execution times which take precedence over the roofline
+  /// estimates, or nullptr if there are none.
+  const NodeCostProfile *costProfile{nullptr};
   /// Backend pointer.
   Backend *backend = nullptr;
   /// The non-supported nodes kind.
@@ -16,8 +16,10 @@
 #ifndef GLOW_PARTITIONER_PARTITIONUTILS_H
 #define GLOW_PARTITIONER_PARTITIONUTILS_H
 
+#include "glow/ExecutionContext/TraceEvents.h"
 #include "glow/Graph/Graph.h"
 #include "glow/Partitioner/PartitionerTypes.h"
+#include "glow/Support/Error.h"
 #include "llvm/ADT/DenseMap.h"
 
 namespace glow {
@@ -39,9 +41,47 @@ uint64_t getOutMemPerNode(const NodesSet &nodes, const Node *node);
 /// Given a node, \returns the NodeSet of inputs of this node.
 NodesSet getInputs(const Node *node);
 
-/// Return the estimated op computation time based on \p backendInfo.
+/// Return the estimated op computation time based on \p backendInfo. The time
+/// measured in the cost profile of \p backendInfo is used when it contains
+/// \p node, otherwise it is estimated with a roofline model.
 float getNodeComputeTime(const Node *node, const BackendInfo &backendInfo);
 
+/// \returns a NodeCostProfile holding the mean duration of the OPERATOR level
+/// Complete events of \p events, keyed by node name. Backend operators are
+/// named after the lowered nodes they implement. If \p loweredMap, as filled
+/// in by lowering through CompilationContext::loweredInfoMap, is given, the
+/// time of a lowered node is charged to the nodes it was lowered from, so the
+/// profile applies to the graph the partitioner sees.
+NodeCostProfile getNodeCostProfile(const std::list<TraceEvent> &events,
+                                   const LoweredInfoMap *loweredMap = nullptr);
+
+/// Writes \p profile into \p fileName, one "<seconds> <node name>" entry per
+/// line. \returns an error if the file cannot be written.
+Error saveNodeCostProfile(const NodeCostProfile &profile,
+                          llvm::StringRef fileName);
+
+/// \returns the NodeCostProfile stored in \p fileName by
+/// saveNodeCostProfile(), or an error if it cannot be read or parsed.
+Expected<NodeCostProfile> loadNodeCostProfile(llvm::StringRef fileName);
+
+/// The computation time of a set of nodes as predicted by the roofline model
+/// and as observed in a cost profile.
+struct PartitionCostComparison {
+  /// Roofline estimate of all the nodes, in seconds.
+  float predicted{0};
+  /// Sum of the measured times of the profiled nodes, in seconds.
+  float observed{0};
+  /// Number of nodes found in the cost profile.
+  unsigned numProfiledNodes{0};
+  /// Number of nodes compared.
+  unsigned numNodes{0};
+};
+
+/// Compares the roofline estimate of the computation time of \p nodes with
+/// the time observed in the cost profile of \p backendInfo.
+PartitionCostComparison comparePartitionCost(const NodesSet &nodes,
+                                             const BackendInfo &backendInfo);
+
 /// Given a node, \returns the memory usage of its inputs (i.e. Storage input).
 uint64_t getNodeMemUsage(const Node *node);
 
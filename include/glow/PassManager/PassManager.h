@@ -22,6 +22,7 @@
 #include "llvm/Support/CommandLine.h"
 
 #include <atomic>
+#include <map>
 
 namespace glow {
 
@@ -56,12 +57,46 @@ struct PassManagerOptions {
 
   llvm::cl::opt<unsigned> stopAfterPassNumOpt;
 
+  llvm::cl::opt<bool> printPassStatsOpt;
+
   PassManagerOptions(const char *id);
   /// Helper to check if \p otherStr is in \p strList.
   static bool listContainsString(const llvm::cl::list<std::string> &strList,
                                  llvm::StringRef otherStr);
 };
 
+/// Compile-time statistics of a pass, accumulated over all of its runs.
+struct PassStatistics {
+  /// Number of times the pass was run.
+  uint64_t numRuns{0};
+  /// Number of runs which modified the IR.
+  uint64_t numChangedRuns{0};
+  /// Number of runs which only revisited the changed parts of the IR.
+  uint64_t numIncrementalRuns{0};
+  /// Number of nodes (or instructions) the pass was run over.
+  uint64_t numNodesVisited{0};
+  /// Wall-clock time spent in the pass, in microseconds. Does not include the
+  /// time of other passes run on its behalf, e.g. a DCE required before it.
+  uint64_t timeUs{0};
+
+  /// Add the statistics of \p other to these ones.
+  void merge(const PassStatistics &other);
+};
+
+/// Map from pass names to their statistics.
+using PassStatisticsMap = std::map<std::string, PassStatistics>;
+
+/// Dump \p stats as a table to \p os.
+void dumpPassStatistics(const PassStatisticsMap &stats, llvm::raw_ostream &os);
+
+/// \returns the statistics accumulated by all pass managers with the id
+/// \p passManagerID (e.g. "graph" or "ir") since the start of the process or
+/// since the last call to resetAccumulatedPassStatistics().
+PassStatisticsMap getAccumulatedPassStatistics(llvm::StringRef passManagerID);
+
+/// Clear the statistics accumulated by all pass managers.
+void resetAccumulatedPassStatistics();
+
 /// The base class for pass managers. It contains most of the logic common for
 /// all pass managers, but provides a number of hooks that can be overridden by
 /// concrete pass manager to customize the behavior.
@@ -71,6 +106,19 @@ private:
   /// The index of pass iteration
   int iterationCount_ = 0;
 
+  /// Statistics of all passes run by this pass manager.
+  PassStatisticsMap passStats_;
+
+  /// Statistics of the pass currently being run, or nullptr if none is run.
+  PassStatistics *currentPassStats_{nullptr};
+
+  /// Time spent in passes run on behalf of the pass currently being run.
+  uint64_t currentNestedTimeUs_{0};
+
+  /// Record \p stats for the pass named \p passName.
+  void recordPassStatistics(llvm::StringRef passName,
+                            const PassStatistics &stats);
+
 protected:
   /// The index of the current pass being executed in the pipeline.
   size_t passIdx_ = 0;
@@ -100,6 +148,11 @@ protected:
   virtual bool runPass(const PassConfigBase &passConfig, IRContainer *C,
                        const CompilationContext &cctx);
 
+  /// Record that the pass currently being run visits \p numNodes nodes or
+  /// instructions. \p incremental indicates that the pass only revisits the
+  /// parts of the IR changed since it last ran.
+  void recordNodeVisits(uint64_t numNodes, bool incremental = false);
+
   /// A runPass customization point for the derived classes.
   virtual bool runPassHook(const PassConfigBase &passConfig, glow::PassBase &P,
                            IRContainer *C, const CompilationContext &cctx) = 0;
@@ -122,6 +175,10 @@ protected:
   /// \p cctx. \returns whether \p C was modified.
   bool run(IRContainer *C, const CompilationContext &cctx);
 
+  /// Run all passes of the PassPipeline over \p C given \p cctx. \returns
+  /// whether \p C was modified.
+  bool runPipeline(IRContainer *C, const CompilationContext &cctx);
+
   /// \returns the size of the pass pipeline.
   virtual size_t getPipelineSize() const = 0;
 
@@ -141,6 +198,9 @@ public:
   /// Dump a textual representation of the Manager to \p os.
   void dump(llvm::raw_ostream &os = llvm::outs()) const;
 
+  /// \returns the statistics of all passes run by this pass manager.
+  const PassStatisticsMap &getPassStatistics() const { return passStats_; }
+
   /// \returns the result of verification for a provided IR container \p C.
   virtual bool verify(IRContainer &C) const = 0;
 
@@ -22,6 +22,14 @@
 #include "glow/Support/Error.h"
 #include "glow/Support/Register.h"
 #include "glow/Support/Support.h"
+#include "glow/Support/ThreadPool.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 namespace glow {
 namespace runtime {
@@ -57,6 +65,155 @@ protected:
   std::map<std::string, glow::Type> typeInfo_;
 };
 
+/// Progress and throughput counters of an AsyncDeferredWeightLoader.
+struct DeferredWeightLoaderStats {
+  /// Number of weights handed out through loadNextWeight().
+  uint64_t numWeightsLoaded{0};
+
+  /// Total size in bytes of the weights handed out through loadNextWeight().
+  uint64_t numBytesLoaded{0};
+
+  /// Seconds spent by the prefetching thread reading weights from the
+  /// underlying loader.
+  double readSeconds{0};
+
+  /// Seconds spent by the conversion threads converting weights, summed over
+  /// all threads.
+  double convertSeconds{0};
+
+  /// Seconds spent by the consumer in loadNextWeight() waiting for the next
+  /// weight to be ready.
+  double stallSeconds{0};
+
+  /// Seconds elapsed since the loader was created.
+  double elapsedSeconds{0};
+
+  /// \returns the number of bytes handed out per second so far.
+  double getThroughput() const {
+    return elapsedSeconds > 0 ? numBytesLoaded / elapsedSeconds : 0;
+  }
+};
+
+/// A deferred weight loader which prefetches weights from another, strictly
+/// sequential, loader on a background thread and converts them on a pool of
+/// worker threads, so that reading and converting the next weights overlaps
+/// with the transfer of the current one. At most \ref prefetchCount_ weights,
+/// and at most \ref maxPrefetchBytes_ bytes plus one weight if it is non-zero,
+/// are held ahead of the current weight. Weights are handed out in the order
+/// of the underlying loader. The payload of each weight is moved out of the
+/// Tensor returned by the underlying loader.
+class AsyncDeferredWeightLoader final : public DeferredWeightLoader {
+public:
+  /// Function used to convert the weight \p weight named \p name in place
+  /// before it is handed out.
+  using ConvertFn = std::function<Error(const std::string &name, Tensor &)>;
+
+  /// Creates a loader prefetching up to \p prefetchCount weights from \p
+  /// loader, and up to \p maxPrefetchBytes bytes if it is non-zero. Each
+  /// weight is converted with \p convert if it is set, using \p
+  /// numConversionThreads threads.
+  AsyncDeferredWeightLoader(DeferredWeightLoader *loader,
+                            unsigned prefetchCount,
+                            unsigned numConversionThreads = 1,
+                            ConvertFn convert = nullptr,
+                            uint64_t maxPrefetchBytes = 0);
+
+  /// Stops prefetching and waits for all in-flight work to finish.
+  ~AsyncDeferredWeightLoader() override;
+
+  /// Makes the next prefetched weight current, waiting for it if it is not
+  /// ready yet, and frees the current one. \returns any Error raised while
+  /// reading or converting it.
+  Error loadNextWeight() override;
+
+  /// Forwards \p loaderObject to the underlying loader. Must be called before
+  /// the first call to loadNextWeight().
+  Error setSrc(void *loaderObject) override;
+
+  /// Forwards \p info to the underlying loader. Must be called before the
+  /// first call to loadNextWeight().
+  void setTypeInfo(std::map<std::string, Type> info) override;
+
+  /// \returns the name of the current weight, or an empty string once all
+  /// weights have been loaded.
+  std::string getName() override;
+
+  /// \returns the Tensor of the current weight.
+  Tensor *getTensor() override;
+
+  /// \returns a snapshot of the progress and throughput counters.
+  DeferredWeightLoaderStats getStats();
+
+private:
+  /// A weight read from the underlying loader.
+  struct PrefetchedWeight {
+    std::string name;
+    Tensor tensor;
+    Error err = Error::empty();
+    bool ready{false};
+  };
+
+  /// Reads weights from \ref loader_ until all are read, an error occurs or
+  /// the loader is destroyed. Runs on \ref prefetchThread_.
+  void prefetch();
+
+  /// \returns whether the prefetching thread may read another weight.
+  /// Must be called with \ref mutex_ held.
+  bool canPrefetch() const;
+
+  /// The underlying sequential loader.
+  DeferredWeightLoader *loader_;
+
+  /// Maximum number of weights held ahead of the current one.
+  const unsigned prefetchCount_;
+
+  /// Maximum number of bytes held ahead of the current weight, or 0 for no
+  /// limit.
+  const uint64_t maxPrefetchBytes_;
+
+  /// Conversion applied to each weight before it is handed out.
+  ConvertFn convert_;
+
+  /// Weights read ahead of the current one, in loading order.
+  std::deque<std::unique_ptr<PrefetchedWeight>> prefetched_;
+
+  /// Number of bytes held in \ref prefetched_.
+  uint64_t prefetchedBytes_{0};
+
+  /// Number of conversions submitted but not finished yet.
+  unsigned numConverting_{0};
+
+  /// The weight currently handed out.
+  std::unique_ptr<PrefetchedWeight> current_;
+
+  /// Whether the prefetching thread has read all weights or failed.
+  bool prefetchDone_{false};
+
+  /// Whether the prefetching thread has been started.
+  bool started_{false};
+
+  /// Whether the loader is being destroyed.
+  bool stop_{false};
+
+  /// Progress and throughput counters.
+  DeferredWeightLoaderStats stats_;
+
+  /// Time at which the loader was created.
+  std::chrono::steady_clock::time_point startTime_;
+
+  /// Protects all of the state above shared with the worker threads.
+  std::mutex mutex_;
+
+  /// Signalled whenever a weight is read, converted or consumed.
+  std::condition_variable cv_;
+
+  /// Pool on which weights are converted.
+  ThreadPool conversionPool_;
+
+  /// Thread reading weights from \ref loader_.
+  std::thread prefetchThread_;
+};
+
 class DeferredWeightLoaderRegistry final {
 public:
   void registerLoader(DeferredWeightLoader *loader);
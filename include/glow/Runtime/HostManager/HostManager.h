@@ -24,7 +24,10 @@
 #include "glow/Runtime/RuntimeTypes.h"
 #include "glow/Runtime/StatsExporter.h"
 
+#include "llvm/ADT/StringMap.h"
+
 #include <atomic>
+#include <condition_variable>
 #include <map>
 #include <mutex>
 #include <queue>
@@ -50,12 +53,26 @@ class HostManager final {
     /// use an atomic refcount rather than just store a shared_ptr for thread
     /// safety.
     std::atomic<size_t> refcount{0};
+
+    /// Modules of the versions of this network that were replaced by
+    /// replaceNetwork(), oldest first. Callers may still bind their
+    /// Placeholders. At most HostConfig::maxPreviousNetworkVersions are kept.
+    std::vector<std::shared_ptr<Module>> previousModules;
+
+    /// Maps Placeholders of previous versions to the Placeholders with the
+    /// same names and types in module.
+    std::unordered_map<const Placeholder *, Placeholder *> placeholderRemap;
   };
   /// Container for inference requests waiting in the queue.
   struct InferRequest {
     /// Name of the network the requested run is for.
     std::string networkName;
 
+    /// The network the request was queued for. Holds a reference on it, which
+    /// is moved to the current version of the network if it is replaced
+    /// before the request is dispatched.
+    NetworkData *network;
+
     /// The execution context for the request.
     std::unique_ptr<ExecutionContext> context;
 
@@ -79,14 +96,36 @@ class HostManager final {
       }
       return priority > inferReq.priority;
     }
-    InferRequest(std::string networkName,
+    InferRequest(std::string networkName, NetworkData *network,
                  std::unique_ptr<ExecutionContext> context, ResultCBTy callback,
                  uint64_t priority, uint64_t requestID, uint64_t startTime = 0)
-        : networkName{networkName}, context{std::move(context)},
-          callback{callback}, priority{priority}, requestID{requestID},
-          startTime{startTime} {}
+        : networkName{networkName}, network{network},
+          context{std::move(context)}, callback{callback}, priority{priority},
+          requestID{requestID}, startTime{startTime} {}
   };
 
+  /// One compiled variant of a network added by addNetworkVariants().
+  struct NetworkVariant {
+    /// Name of the network holding the variant.
+    std::string name;
+
+    /// Module of the variant, which keeps its Placeholders alive.
+    std::shared_ptr<Module> module;
+
+    /// Input and output Placeholders of the variant, by name.
+    llvm::StringMap<Placeholder *> inputs;
+    llvm::StringMap<Placeholder *> outputs;
+
+    /// Number of requests routed to the variant.
+    std::atomic<uint64_t> hits{0};
+
+    /// Key of the stats counter of requests routed to the variant.
+    std::string hitsCounter;
+  };
+
+  /// Variants of a network, from the smallest to the largest.
+  using NetworkVariants = std::vector<std::unique_ptr<NetworkVariant>>;
+
   /// Count of current in-flight networks being run. Atomic to allow
   /// concurrency in runNetwork.
   std::atomic<size_t> activeRequestCount_{0};
@@ -112,12 +151,29 @@ class HostManager final {
   std::unique_ptr<TraceContext> hostTraceContext_;
 
   /// A map from a networkName to a network, which is represented by struct DAG.
-  std::unordered_map<std::string, NetworkData> networks_;
+  /// NetworkData is held by pointer so that a replaced version can outlive its
+  /// entry while its runs drain.
+  std::unordered_map<std::string, std::unique_ptr<NetworkData>> networks_;
+
+  /// Networks added by addNetworkVariants(), by name. Their variants are held
+  /// in networks_.
+  std::unordered_map<std::string, std::shared_ptr<NetworkVariants>>
+      networkVariants_;
+
+  /// Count of network versions staged by replaceNetwork(), used to give their
+  /// Functions unique names.
+  size_t stagedNetworkCount_{0};
 
   /// Mutex for networks_ since runNetwork, addNetwork, and
   /// removeNetwork can all be called concurrently, a guard is needed.
   std::shared_timed_mutex networkLock_;
 
+  /// Mutex and condition variable used by replaceNetwork() to wait for the
+  /// runs of a replaced version to drain. Signalled by releaseNetwork() when
+  /// the refcount of a network drops to zero.
+  std::mutex drainLock_;
+  std::condition_variable drainCV_;
+
   /// A map of DeviceManagers by deviceID. An ordered map is used here to allow
   /// a stable iteration order over devices.
   DeviceManagerMapTy devices_;
@@ -162,6 +218,27 @@ class HostManager final {
   /// Set of networks in the process of being added.
   std::set<std::string> processingNetworks_;
 
+  /// Drops a reference on \p network taken by a run, and wakes up a
+  /// replaceNetwork() waiting for its runs to drain if it was the last one.
+  void releaseNetwork(NetworkData *network);
+
+  /// \returns an Error if the network \p networkName exists but cannot be
+  /// removed, because it is being modified or has outstanding runs. This must
+  /// be called while holding a lock on networkLock_.
+  Error checkNetworkRemovable(llvm::StringRef networkName);
+
+  /// Frees the execution state pool of \p network and evicts its partitions
+  /// from the devices and the Provisioner. This must be called while holding
+  /// a lock on networkLock_.
+  Error evictNetworkData(NetworkData &network);
+
+  /// Runs \p context on the smallest of \p variants its inputs fit in, see
+  /// addNetworkVariants(). \p callback and \p priority are as for
+  /// runNetwork().
+  RunIdentifierTy runNetworkVariant(std::shared_ptr<NetworkVariants> variants,
+                                    std::unique_ptr<ExecutionContext> context,
+                                    ResultCBTy callback, uint64_t priority);
+
   /// Method to dispatch a new run to the executor.
   void dispatchNextRun();
 
@@ -202,11 +279,63 @@ public:
   /// optimized based on \p cctx.
   Error addNetwork(std::unique_ptr<Module> module, CompilationContext &cctx);
 
+  /// Adds a network compiled for several input shapes. Each of \p modules
+  /// holds a single Function, with the same name in all of them, which is the
+  /// name of the network. Each is a variant of the network for one bucket of
+  /// input shapes, such as a sequence length, and all variants must have
+  /// inputs and outputs with the same names, element types and ranks. The
+  /// variants are optimized based on \p cctx and added as networks of their
+  /// own. runNetwork() on the network routes each request to the smallest
+  /// variant whose inputs are at least as large, in every dimension, as the
+  /// tensors bound to them. Inputs are zero padded to the shapes of the
+  /// variant, and outputs are cropped or zero padded to the shapes of the
+  /// tensors bound to them, so callers bind tensors of the actual shapes of a
+  /// request. Tensors are bound to Placeholders of any variant, which are
+  /// matched by name. \returns an Error if any variant could not be added, in
+  /// which case none is.
+  Error addNetworkVariants(std::vector<std::unique_ptr<Module>> modules,
+                           CompilationContext &cctx);
+
+  /// \returns the number of requests routed to each variant of the network
+  /// \p networkName added by addNetworkVariants(), from the smallest variant
+  /// to the largest, or an empty vector if there is no such network.
+  std::vector<uint64_t> getNetworkVariantHits(llvm::StringRef networkName);
+
   /// Given \p networkName removes that network from the host. This also
-  /// removes the network from any backends setup to execute it.
+  /// removes the network from any backends setup to execute it. All variants
+  /// of a network added by addNetworkVariants() are removed.
   /// \returns an Error indicating success or failure of the operation.
   Error removeNetwork(llvm::StringRef networkName);
 
+  /// Replaces the network named after the only Function in \p module with the
+  /// new version in \p module, optimized based on \p cctx. The new version is
+  /// compiled and provisioned next to the current one. On devices that share
+  /// identical constant blocks, such as CPU devices, blocks that did not change
+  /// are reused rather than loaded again. Runs are then switched over
+  /// atomically: requests queued after the switch, or still queued at the
+  /// switch, run on the new version, and requests already running finish on
+  /// the old one, which is removed once they have drained. Requests whose
+  /// bindings use Placeholders of a previous version are remapped to the new
+  /// Placeholders with the same names and types, for the last
+  /// HostConfig::maxPreviousNetworkVersions versions. Both versions are
+  /// resident until the runs on the old one drain, so the devices need room
+  /// for up to twice the memory of the network, minus the shared constant
+  /// blocks. \returns an Error if the new version could not be added, in which
+  /// case the current version is left in place.
+  Error replaceNetwork(std::unique_ptr<Module> module,
+                       CompilationContext &cctx);
+
+  /// Overwrites rows of the Constant or static Placeholder \p name in the
+  /// network \p networkName with \p rows, starting at row \p firstRow, on
+  /// every device and replica the network is loaded on. \p rows must have the
+  /// element type and inner dimensions of \p name. Each device applies the
+  /// update between two runs, so a run sees either the old or the new rows and
+  /// never a mix of both. Runs on different devices may briefly disagree while
+  /// the update is in flight. \returns an Error if \p name is not found or the
+  /// update failed on any device.
+  Error updateConstantRows(llvm::StringRef networkName, llvm::StringRef name,
+                           dim_t firstRow, const Tensor &rows);
+
   /// Update the list of available devices.
   void setAvailableDevices(const std::vector<DeviceIDTy> &devices);
 
@@ -250,6 +379,21 @@ public:
   Error runNetworkBlocking(llvm::StringRef networkName,
                            PlaceholderBindings &bindings);
 
+  /// Runs the network \p networkName on a batch which is \p k times larger
+  /// than the one it was compiled for. \p bindings binds Placeholders either to
+  /// tensors of their own type, which are shared by all the micro-batches, or
+  /// to tensors whose first dimension is \p k times larger, which are split
+  /// along it into \p k micro-batches. Outputs must be split. The micro-batches
+  /// are streamed through the network with up to \p maxInFlight of them in
+  /// flight, so that the partitions of a network split across devices work on
+  /// different micro-batches at the same time, and their outputs are written
+  /// in place into the tensors of \p bindings. \p maxInFlight defaults to the
+  /// number of partitions plus one when 0. \returns an Error indicating
+  /// success or failure.
+  Error runNetworkMicroBatched(llvm::StringRef networkName,
+                               PlaceholderBindings &bindings,
+                               unsigned maxInFlight = 0);
+
   /// Initialize the HostManager with the given \p configs creating one
   /// DeviceManager for each config listed.
   Error init(std::vector<std::unique_ptr<DeviceConfig>> configs);
@@ -107,7 +107,9 @@ private:
   /// Requires a vector of DeviceID:memorySize pairs \p logicalDeviceSize, \p
   /// deviceMemoryMap a mapping from backendName to a list of device:memorySize
   /// pairs for all devices of the specified backend, and \p logicalDevices a
-  /// map of logicalIDs to all associated DAGNodes.
+  /// map of logicalIDs to all associated DAGNodes. Once a partition of a
+  /// network is placed on a device bound to a NUMA node, the remaining
+  /// partitions of that network prefer devices on the same node.
   Expected<std::map<DeviceIDTy, DeviceIDTy>> generateDeviceAssignments(
       const std::vector<std::pair<DeviceIDTy, uint64_t>> &logicalDeviceSize,
       std::map<std::string, std::vector<std::pair<DeviceIDTy, uint64_t>>>
@@ -76,6 +76,11 @@ struct DeviceInfo {
   float peakPCIeBw;
   /// Maximum amount of input resources defaults to 0 if there is no limit.
   uint64_t inputCountMax{0};
+  /// NUMA node the device is bound to, -1 if it is not bound to one.
+  int numaNode{-1};
+  /// Whether the device keeps one activation arena for all functions added to
+  /// it, sized for the largest of them and counted once in availableMemory.
+  bool sharedActivations{false};
 };
 
 /// Data structure that tracks how many outstanding work items remain for a
@@ -197,11 +202,15 @@ struct DAGNode {
     alternateFunction[device] = (currentNet + 1) % replicationCount;
     nameLock.unlock();
 
-    std::string newName = name;
-    if (currentNet) {
-      newName = name + "_replicated" + std::to_string(currentNet);
+    return getReplicaName(currentNet);
+  }
+
+  /// \returns the name the function is loaded under for replica \p replica.
+  std::string getReplicaName(unsigned replica) const {
+    if (replica) {
+      return name + "_replicated" + std::to_string(replica);
     }
-    return newName;
+    return name;
   }
 };
 
@@ -269,6 +278,9 @@ struct HostConfig {
   size_t maxQueueSize{100};
   /// Number of threads to allocate to the Executor.
   size_t executorThreads{3};
+  /// Number of versions of a network replaced by replaceNetwork() whose
+  /// Placeholders may still be bound by callers. Older versions are dropped.
+  size_t maxPreviousNetworkVersions{4};
 };
 
 /// This is struct for user defined partition.
@@ -155,6 +155,10 @@ deserializeDeviceConfigFromYaml(llvm::StringRef fileName);
 std::map<std::string, std::string>
 deserializeStrStrMapFromYaml(llvm::StringRef fileName);
 
+/// Serialize the string to string map \p map to the file \p fileName.
+void serializeStrStrMapToYaml(llvm::StringRef fileName,
+                              const std::map<std::string, std::string> &map);
+
 /// Printf-like formatting for std::string.
 const std::string strFormat(const char *format, ...)
 #ifndef _MSC_VER
@@ -18,10 +18,13 @@
 #include "glow/IR/Instrs.h"
 #include "glow/Support/Debug.h"
 
+#include "llvm/ADT/Hashing.h"
 #include "llvm/Support/CommandLine.h"
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
 #define DEBUG_TYPE "backend-utils"
 
 using namespace glow;
@@ -43,10 +46,36 @@ namespace {
 void allocateActivations(const glow::IRFunction::InstListTy &instrs,
                          MemoryAllocator &allocator,
                          glow::runtime::SymbolTableTy &symbolTable) {
+  if (reuseActivationsMemory) {
+    // Pack all activations at once, knowing their live intervals.
+    std::vector<Allocation> allocList;
+    for (const auto &I : instrs) {
+      if (auto *A = dyn_cast<AllocActivationInst>(&I)) {
+        allocList.emplace_back(A, /* alloc */ true, I.getSizeInBytes());
+      } else if (auto *D = dyn_cast<DeallocActivationInst>(&I)) {
+        allocList.emplace_back(D->getAlloc(), /* alloc */ false);
+      }
+    }
+    auto peak = allocator.allocateAll(allocList);
+    (void)peak;
+    assert(peak != MemoryAllocator::npos && "Activations do not fit!");
+  } else {
+    // allocateAll considers the buffers deallocated once they are packed, so
+    // the activations of the next Function would be packed over these ones.
+    // Keep them allocated instead, so that they are placed above.
+    for (const auto &I : instrs) {
+      if (auto *A = dyn_cast<AllocActivationInst>(&I)) {
+        auto addr = allocator.allocate(I.getSizeInBytes(), A);
+        (void)addr;
+        assert(addr != MemoryAllocator::npos && "Activations do not fit!");
+      }
+    }
+  }
+
   for (const auto &I : instrs) {
     if (auto *A = dyn_cast<AllocActivationInst>(&I)) {
       auto numBytes = I.getSizeInBytes();
-      size_t addr = allocator.allocate(numBytes, A);
+      size_t addr = allocator.getAddress(A);
       assert(!symbolTable.count(std::string(A->getName())) &&
              "Allocation already made!");
       runtime::RuntimeSymbolInfo symbol;
@@ -97,12 +126,9 @@ void allocateActivations(const glow::IRFunction::InstListTy &instrs,
     }
 
     if (auto *D = dyn_cast<DeallocActivationInst>(&I)) {
-      auto *A = D->getAlloc();
-      assert(symbolTable.count(std::string(A->getName())) &&
+      assert(symbolTable.count(std::string(D->getAlloc()->getName())) &&
              "Invalid deallocation!");
-      if (reuseActivationsMemory) {
-        allocator.deallocate(A);
-      }
+      (void)D;
       continue;
     }
   }
@@ -162,6 +188,7 @@ operator=(glow::runtime::RuntimeBundle &&rhs) {
 
   std::swap(symbolTable_, rhs.symbolTable_);
   std::swap(constants_, rhs.constants_);
+  std::swap(sharedConstants_, rhs.sharedConstants_);
   std::swap(constantWeightVarsMemSize_, rhs.constantWeightVarsMemSize_);
   std::swap(mutableWeightVarsMemSize_, rhs.mutableWeightVarsMemSize_);
   std::swap(activationsMemSize_, rhs.activationsMemSize_);
@@ -179,11 +206,174 @@ void glow::runtime::RuntimeBundle::collectConstants(const IRFunction *F) {
 void glow::runtime::RuntimeBundle::freeConstants() {
   DCHECK(isValid_);
 
-  if (constants_) {
+  if (constants_ && !sharedConstants_) {
     glow::alignedFree(constants_);
-    constants_ = nullptr;
   }
+  constants_ = nullptr;
+  sharedConstants_ = false;
 }
+
+glow::runtime::SharedConstantStore::~SharedConstantStore() {
+  for (auto &block : blocks_) {
+    glow::alignedFree(block.second.constants);
+  }
+}
+
+/// \returns the constant symbols of \p bundle that are found in \p M paired
+/// with their Constants, sorted by offset.
+static std::vector<std::pair<const glow::runtime::RuntimeSymbolInfo *,
+                             const glow::Constant *>>
+getBundleConstants(const glow::runtime::RuntimeBundle &bundle,
+                   const glow::Module *M) {
+  std::vector<std::pair<const glow::runtime::RuntimeSymbolInfo *,
+                        const glow::Constant *>>
+      constants;
+  for (const auto &symbol : bundle.getSymbolTable()) {
+    if (const auto *c = M->getConstantByName(symbol.first)) {
+      constants.emplace_back(&symbol.second, c);
+    }
+  }
+  std::sort(constants.begin(), constants.end(),
+            [](const auto &a, const auto &b) {
+              return a.first->offset < b.first->offset;
+            });
+  return constants;
+}
+
+size_t
+glow::runtime::SharedConstantStore::hashConstants(const RuntimeBundle &bundle,
+                                                  const Module *M) {
+  // Names are deliberately left out so that identical weights that were given
+  // different names, e.g. in two versions of a model, still match.
+  llvm::hash_code hash = llvm::hash_value(bundle.getConstantWeightSize());
+  for (const auto &constant : getBundleConstants(bundle, M)) {
+    const auto &payload = constant.second->getPayload();
+    hash = llvm::hash_combine(
+        hash, constant.first->offset, constant.first->size,
+        llvm::hash_value(llvm::StringRef(payload.getUnsafePtr(),
+                                         payload.getSizeInBytes())));
+  }
+  return hash;
+}
+
+std::unordered_multimap<size_t,
+                        glow::runtime::SharedConstantStore::Block>::iterator
+glow::runtime::SharedConstantStore::find(size_t hash,
+                                         const RuntimeBundle &bundle,
+                                         const Module *M) {
+  auto range = blocks_.equal_range(hash);
+  if (range.first == range.second) {
+    return blocks_.end();
+  }
+  auto constants = getBundleConstants(bundle, M);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.size != bundle.getConstantWeightSize()) {
+      continue;
+    }
+    bool matches = std::all_of(
+        constants.begin(), constants.end(), [&](const auto &constant) {
+          return !memcmp(it->second.constants + constant.first->offset,
+                         constant.second->getPayload().getUnsafePtr(),
+                         constant.first->size);
+        });
+    if (matches) {
+      return it;
+    }
+  }
+  return blocks_.end();
+}
+
+bool glow::runtime::SharedConstantStore::contains(size_t hash,
+                                                  const RuntimeBundle &bundle,
+                                                  const Module *M) {
+  return find(hash, bundle, M) != blocks_.end();
+}
+
+bool glow::runtime::SharedConstantStore::acquire(size_t hash,
+                                                 RuntimeBundle &bundle,
+                                                 const Module *M) {
+  auto it = find(hash, bundle, M);
+  if (it != blocks_.end()) {
+    it->second.refCount++;
+    bundle.setSharedConstants(it->second.constants);
+    return true;
+  }
+
+  bundle.collectConstants(M);
+  if (!bundle.getConstants()) {
+    // Nothing to share.
+    return false;
+  }
+  blocks_.emplace(hash, Block{bundle.getConstants(),
+                              bundle.getConstantWeightSize(), 1});
+  hashes_.emplace(bundle.getConstants(), hash);
+  bundle.setSharedConstants(bundle.getConstants());
+  return false;
+}
+
+bool glow::runtime::SharedConstantStore::isShared(const RuntimeBundle &bundle) {
+  if (!owns(bundle)) {
+    return false;
+  }
+  auto range = blocks_.equal_range(hashes_[bundle.getConstants()]);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.constants == bundle.getConstants()) {
+      return it->second.refCount > 1;
+    }
+  }
+  return false;
+}
+
+void glow::runtime::SharedConstantStore::detach(RuntimeBundle &bundle) {
+  if (!owns(bundle)) {
+    return;
+  }
+  auto *constants = bundle.getConstants();
+  if (isShared(bundle)) {
+    auto size = bundle.getConstantWeightSize();
+    auto *copy = (uint8_t *)alignedAlloc(size, TensorAlignment);
+    memcpy(copy, constants, size);
+    release(bundle);
+    bundle.setConstants(copy);
+    return;
+  }
+  // Only this bundle references the block; hand it over without freeing it.
+  auto hashIt = hashes_.find(constants);
+  auto range = blocks_.equal_range(hashIt->second);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.constants == constants) {
+      blocks_.erase(it);
+      break;
+    }
+  }
+  hashes_.erase(hashIt);
+  bundle.freeConstants();
+  bundle.setConstants(constants);
+}
+
+size_t glow::runtime::SharedConstantStore::release(RuntimeBundle &bundle) {
+  if (!owns(bundle)) {
+    return 0;
+  }
+  auto hashIt = hashes_.find(bundle.getConstants());
+  auto range = blocks_.equal_range(hashIt->second);
+  size_t freed = 0;
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.constants != bundle.getConstants()) {
+      continue;
+    }
+    if (--it->second.refCount == 0) {
+      freed = it->second.size;
+      glow::alignedFree(it->second.constants);
+      hashes_.erase(hashIt);
+      blocks_.erase(it);
+    }
+    break;
+  }
+  bundle.freeConstants();
+  return freed;
+}
+
 void glow::runtime::RuntimeBundle::collectConstants(const Module *M) {
   DCHECK(isValid_);
 
@@ -619,3 +809,28 @@ runtime::RuntimeBundle::create(const IRFunction &F,
                                MemoryAllocator &allocator) {
   return create(F, allocator, allocator, allocator);
 }
+
+Error glow::copyTensorRows(uint8_t *data, const Type &ty, dim_t firstRow,
+                           const Tensor &rows) {
+  auto dims = ty.dims();
+  auto rowDims = rows.dims();
+  RETURN_ERR_IF_NOT(dims.size() > 0 && rowDims.size() == dims.size() &&
+                        std::equal(dims.begin() + 1, dims.end(),
+                                   rowDims.begin() + 1),
+                    "Rows do not have the row shape of the tensor.");
+  RETURN_ERR_IF_NOT(
+      rows.getType().isEqual(Type::newShape(ty, rowDims)),
+      "Rows do not have the element type of the tensor.");
+  RETURN_ERR_IF_NOT(firstRow + rowDims[0] <= dims[0],
+                    strFormat("Rows [%lu, %lu) are out of range for a tensor "
+                              "of %lu rows.",
+                              (unsigned long)firstRow,
+                              (unsigned long)(firstRow + rowDims[0]),
+                              (unsigned long)dims[0]));
+  size_t rowSize = ty.getSizeInBytes() / dims[0];
+  RETURN_ERR_IF_NOT(rows.getSizeInBytes() == rowSize * rowDims[0],
+                    "Rows must not be padded.");
+  memcpy(data + firstRow * rowSize, rows.getUnsafePtr(),
+         rows.getSizeInBytes());
+  return Error::success();
+}
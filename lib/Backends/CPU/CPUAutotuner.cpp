@@ -0,0 +1,262 @@
+/**
+ * Copyright (c) Glow Contributors. See CONTRIBUTORS file.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CPUAutotuner.h"
+#include "CPUBackend.h"
+
+#include "glow/Backend/CompiledFunction.h"
+#include "glow/ExecutionContext/ExecutionContext.h"
+#include "glow/Graph/Graph.h"
+#include "glow/LLVMIRCodeGen/CommandLine.h"
+#include "glow/Support/Support.h"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+
+#include <chrono>
+#include <limits>
+
+using namespace glow;
+using llvm::cast;
+using llvm::dyn_cast;
+
+static llvm::cl::opt<bool> autotune(
+    "cpu-autotune",
+    llvm::cl::desc("Measure the kernel configs of ops missing from the CPU "
+                   "tuning database on this host while compiling"),
+    llvm::cl::init(false), llvm::cl::cat(getLLVMBackendCat()));
+
+static llvm::cl::opt<std::string> tuningDBFile(
+    "cpu-tuning-db",
+    llvm::cl::desc("File of kernel configs tuned for the CPU backend, which "
+                   "is read by every compile and updated by -cpu-autotune"),
+    llvm::cl::value_desc("file.yaml"), llvm::cl::init(""),
+    llvm::cl::cat(getLLVMBackendCat()));
+
+static llvm::cl::opt<unsigned> autotuneReps(
+    "cpu-autotune-reps",
+    llvm::cl::desc("Number of timed runs of each config when autotuning"),
+    llvm::cl::init(10), llvm::cl::cat(getLLVMBackendCat()));
+
+std::string CPUConvConfig::toString() const {
+  std::string gemmBlocking;
+  if (gemmMC || gemmKC || gemmNC) {
+    gemmBlocking = strFormat(":%ux%ux%u", unsigned(gemmMC), unsigned(gemmKC),
+                             unsigned(gemmNC));
+  }
+  switch (algorithm) {
+  case CPUConvAlgorithm::Direct:
+    if (!numDepthRegs) {
+      return "direct";
+    }
+    return strFormat("direct:%s:%ux%u", pixelScanFirst ? "pixels" : "filter",
+                     unsigned(numDepthRegs), unsigned(sizeGroupY));
+  case CPUConvAlgorithm::Im2Col:
+    return "im2col:" + std::to_string(tileSize) + gemmBlocking;
+  case CPUConvAlgorithm::Winograd:
+    return "winograd:" + std::to_string(tileSize) + gemmBlocking;
+  default:
+    return "auto";
+  }
+}
+
+/// Parses the "<a>x<b>[x<c>]" list of \p str into \p values. \returns false
+/// if \p str does not hold exactly as many positive numbers as \p values.
+static bool parseBlocking(llvm::StringRef str,
+                          llvm::ArrayRef<unsigned_t *> values) {
+  for (size_t i = 0; i < values.size(); i++) {
+    llvm::StringRef value;
+    std::tie(value, str) = str.split('x');
+    if (value.getAsInteger(10, *values[i]) || *values[i] == 0) {
+      return false;
+    }
+  }
+  return str.empty();
+}
+
+CPUConvConfig CPUConvConfig::fromString(llvm::StringRef str) {
+  CPUConvConfig config;
+  llvm::SmallVector<llvm::StringRef, 3> fields;
+  str.split(fields, ':');
+  llvm::StringRef name = fields[0];
+  if (name == "direct") {
+    config.algorithm = CPUConvAlgorithm::Direct;
+    if (fields.size() == 1) {
+      return config;
+    }
+    bool validScan = fields.size() == 3 &&
+                     (fields[1] == "pixels" || fields[1] == "filter");
+    if (!validScan ||
+        !parseBlocking(fields[2], {&config.numDepthRegs, &config.sizeGroupY})) {
+      return CPUConvConfig();
+    }
+    config.pixelScanFirst = fields[1] == "pixels";
+    return config;
+  }
+
+  if (name == "im2col") {
+    config.algorithm = CPUConvAlgorithm::Im2Col;
+  } else if (name == "winograd") {
+    config.algorithm = CPUConvAlgorithm::Winograd;
+  } else {
+    return CPUConvConfig();
+  }
+  if (fields.size() > 3 ||
+      (fields.size() > 1 && fields[1].getAsInteger(10, config.tileSize)) ||
+      (fields.size() == 3 &&
+       !parseBlocking(fields[2],
+                      {&config.gemmMC, &config.gemmKC, &config.gemmNC}))) {
+    return CPUConvConfig();
+  }
+  return config;
+}
+
+CPUTuningDatabase::CPUTuningDatabase(llvm::StringRef fileName) {
+  setFile(fileName);
+}
+
+CPUTuningDatabase &CPUTuningDatabase::get() {
+  static CPUTuningDatabase database(tuningDBFile);
+  return database;
+}
+
+void CPUTuningDatabase::setFile(llvm::StringRef fileName) {
+  std::lock_guard<std::mutex> g(lock_);
+  fileName_ = fileName;
+  entries_.clear();
+  if (!fileName_.empty() && llvm::sys::fs::exists(fileName_)) {
+    entries_ = deserializeStrStrMapFromYaml(fileName_);
+  }
+}
+
+CPUConvConfig CPUTuningDatabase::lookup(const std::string &key) {
+  std::lock_guard<std::mutex> g(lock_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return CPUConvConfig();
+  }
+  return CPUConvConfig::fromString(it->second);
+}
+
+void CPUTuningDatabase::insert(const std::string &key,
+                               const CPUConvConfig &config) {
+  std::lock_guard<std::mutex> g(lock_);
+  entries_[key] = config.toString();
+  if (!fileName_.empty()) {
+    serializeStrStrMapToYaml(fileName_, entries_);
+  }
+}
+
+bool glow::isCPUAutotuningEnabled() { return autotune; }
+
+std::string glow::getConvTuningKey(const ConvolutionNode *CN) {
+  auto join = [](llvm::ArrayRef<dim_t> values) {
+    std::string str;
+    for (auto v : values) {
+      str += (str.empty() ? "" : "x") + std::to_string(v);
+    }
+    return str;
+  };
+  auto inDims = CN->getInput().dims();
+  auto filterDims = CN->getFilter().dims();
+  std::vector<dim_t> kernels(CN->getKernels().begin(), CN->getKernels().end());
+  std::vector<dim_t> strides(CN->getStrides().begin(), CN->getStrides().end());
+  std::vector<dim_t> pads(CN->getPads().begin(), CN->getPads().end());
+  return strFormat("%s/conv/%s/in%s/filter%s/k%s/s%s/p%s",
+                   llvm::sys::getHostCPUName().str().c_str(),
+                   CN->getResult().getType()->getElementName().str().c_str(),
+                   join(inDims).c_str(), join(filterDims).c_str(),
+                   join(kernels).c_str(), join(strides).c_str(),
+                   join(pads).c_str());
+}
+
+/// \returns the best time in seconds of running a copy of \p CN, built for
+/// \p config with \p build, on the CPU backend.
+static Expected<double> measureConv(const ConvolutionNode *CN,
+                                    const CPUConvConfig &config,
+                                    CPUConvBuilder build) {
+  Module mod;
+  Function *F = mod.createFunction("autotune");
+
+  auto *input =
+      mod.createPlaceholder(mod.uniqueType(*CN->getInput().getType()),
+                            "input", /* isTrainable */ false);
+  auto copyOperand = [&](NodeValue operand, llvm::StringRef name) -> Storage * {
+    if (auto *C = dyn_cast<Constant>(operand)) {
+      return mod.createConstant(name, C->getPayload().clone());
+    }
+    return mod.createPlaceholder(mod.uniqueType(*operand.getType()), name,
+                                 /* isTrainable */ false);
+  };
+  Storage *filter = copyOperand(CN->getFilter(), "filter");
+  Storage *bias = copyOperand(CN->getBias(), "bias");
+
+  auto *conv = F->addNode(new ConvolutionNode(
+      CN->getName(), mod.uniqueType(*CN->getResult().getType()), input, filter,
+      bias, CN->getKernels(), CN->getStrides(), CN->getPads(), CN->getGroup(),
+      CN->getDilation(), CN->getLayout(), CN->getFusedActivation()));
+  NodeValue result = conv->getResult();
+  if (Node *N = build(conv, F, config)) {
+    result = N->getNthResult(0);
+    F->eraseNode(conv);
+  }
+  auto *save = F->createSave("save", result);
+
+  CPUBackend backend;
+  std::unique_ptr<CompiledFunction> compiled;
+  ASSIGN_VALUE_OR_RETURN_ERR(compiled, backend.compile(F, BackendOptions()));
+  compiled->getRuntimeBundle().collectConstants(&mod);
+
+  ExecutionContext context;
+  auto *bindings = context.getPlaceholderBindings();
+  for (auto *PH : mod.getPlaceholders()) {
+    auto *T = bindings->allocate(PH);
+    if (PH != save->getPlaceholder()) {
+      T->getHandle().randomize(-1.0, 1.0, mod.getPRNG());
+    }
+  }
+
+  // Warm up the caches before timing.
+  RETURN_IF_ERR(compiled->execute(&context));
+  double best = std::numeric_limits<double>::max();
+  for (unsigned i = 0; i < autotuneReps; i++) {
+    auto start = std::chrono::steady_clock::now();
+    RETURN_IF_ERR(compiled->execute(&context));
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+Expected<CPUConvConfig>
+glow::autotuneConv(const ConvolutionNode *CN,
+                   llvm::ArrayRef<CPUConvConfig> candidates,
+                   CPUConvBuilder build) {
+  DCHECK(!candidates.empty()) << "No configs to measure";
+  CPUConvConfig best = candidates[0];
+  double bestTime = std::numeric_limits<double>::max();
+  for (const auto &config : candidates) {
+    double time;
+    ASSIGN_VALUE_OR_RETURN_ERR(time, measureConv(CN, config, build));
+    VLOG(1) << "Autotuning " << CN->getName().str() << ": "
+            << config.toString() << " took " << time * 1e6 << "us";
+    if (time < bestTime) {
+      bestTime = time;
+      best = config;
+    }
+  }
+  return best;
+}
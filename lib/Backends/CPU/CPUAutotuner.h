@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) Glow Contributors. See CONTRIBUTORS file.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef GLOW_BACKENDS_CPU_CPUAUTOTUNER_H
+#define GLOW_BACKENDS_CPU_CPUAUTOTUNER_H
+
+#include "glow/Graph/Nodes.h"
+#include "glow/Support/Error.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace glow {
+
+class Function;
+
+/// Algorithms for float convolutions on the CPU.
+enum class CPUConvAlgorithm { Auto, Direct, Im2Col, Winograd };
+
+/// A convolution algorithm together with its tiling and blocking parameters.
+/// Parameters that are 0 let the algorithm pick its default.
+struct CPUConvConfig {
+  CPUConvAlgorithm algorithm{CPUConvAlgorithm::Auto};
+  /// Output pixels (im2col) or tiles (Winograd) transformed at once.
+  unsigned_t tileSize{0};
+
+  /// Blocking of the libjit GEMM used by im2col and Winograd: mc x kc blocks
+  /// of A are multiplied with kc x nc panels of B.
+  unsigned_t gemmMC{0};
+  unsigned_t gemmKC{0};
+  unsigned_t gemmNC{0};
+
+  /// Blocking of the DKKC8 direct convolution: whether each output pixel is
+  /// completed before moving to the next one rather than scanning the input
+  /// once per filter element, the number of float8 registers of output
+  /// channels, and the number of output pixels along Y computed at once. A
+  /// \ref numDepthRegs of 0 picks all three heuristically.
+  bool pixelScanFirst{false};
+  unsigned_t numDepthRegs{0};
+  unsigned_t sizeGroupY{0};
+
+  /// \returns the config as stored in the tuning database, e.g. "im2col:64",
+  /// "im2col:64:256x128x4096" or "direct:filter:2x5".
+  std::string toString() const;
+
+  /// \returns the config parsed from \p str, or an Auto config if \p str is
+  /// not a valid config.
+  static CPUConvConfig fromString(llvm::StringRef str);
+};
+
+/// Creates the node implementing the convolution \p CN in \p F with the given
+/// config. \returns nullptr if the generic convolution should be kept.
+using CPUConvBuilder = llvm::function_ref<Node *(
+    ConvolutionNode *CN, Function *F, const CPUConvConfig &config)>;
+
+/// Database of the fastest kernel configs measured on this host, keyed by op
+/// and shape. It is loaded from and saved to the file given by
+/// -cpu-tuning-db, so that later compiles reuse the measurements.
+class CPUTuningDatabase {
+  /// The tuned configs, keyed by getConvTuningKey().
+  std::map<std::string, std::string> entries_;
+  /// The file the database is persisted to; empty if it is not persisted.
+  std::string fileName_;
+  /// Serializes concurrent compilations.
+  std::mutex lock_;
+
+  explicit CPUTuningDatabase(llvm::StringRef fileName);
+
+public:
+  /// \returns the database of the process.
+  static CPUTuningDatabase &get();
+
+  /// Persists the database to \p fileName instead, replacing its entries with
+  /// the ones stored there, if any.
+  void setFile(llvm::StringRef fileName);
+
+  /// \returns the config tuned for the key \p key, or an Auto config if there
+  /// is none.
+  CPUConvConfig lookup(const std::string &key);
+
+  /// Records \p config as the fastest for \p key and persists the database.
+  void insert(const std::string &key, const CPUConvConfig &config);
+};
+
+/// \returns true if compilation should measure the configs of ops that are
+/// not in the tuning database yet.
+bool isCPUAutotuningEnabled();
+
+/// \returns the key identifying the shape of \p CN on this host in the tuning
+/// database.
+std::string getConvTuningKey(const ConvolutionNode *CN);
+
+/// Measures each of \p candidates for the convolution \p CN, building them
+/// with \p build, and \returns the fastest one. The measurements run a copy of
+/// \p CN alone, compiled for and executed on the CPU backend.
+Expected<CPUConvConfig>
+autotuneConv(const ConvolutionNode *CN,
+             llvm::ArrayRef<CPUConvConfig> candidates, CPUConvBuilder build);
+
+} // namespace glow
+
+#endif // GLOW_BACKENDS_CPU_CPUAUTOTUNER_H
@@ -21,35 +21,130 @@
 #include "glow/Backend/BackendUtils.h"
 #include "glow/Graph/Graph.h"
 #include "glow/IR/Instrs.h"
+#include "glow/LLVMIRCodeGen/CommandLine.h"
 #include "glow/LLVMIRCodeGen/LLVMIRGen.h"
 #include "glow/Support/Debug.h"
 
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Host.h"
+
+#include <glog/logging.h>
 
 using namespace glow;
 
+static llvm::cl::opt<CPULibjitISA> libjitISAOpt(
+    "cpu-libjit-isa",
+    llvm::cl::desc("Instruction set extensions of the libjit flavor linked "
+                   "into functions compiled for the CPU"),
+    llvm::cl::values(
+        clEnumValN(CPULibjitISA::Auto, "auto",
+                   "The best flavor the host supports, or generic when "
+                   "compiling for another target"),
+        clEnumValN(CPULibjitISA::Generic, "generic", "No extensions"),
+        clEnumValN(CPULibjitISA::AVX2, "avx2", "AVX2 and FMA"),
+        clEnumValN(CPULibjitISA::AVX512, "avx512",
+                   "AVX-512 F, BW, DQ and VL"),
+        clEnumValN(CPULibjitISA::AVX512VNNI, "avx512vnni",
+                   "AVX-512 with VNNI int8 dot products")),
+    llvm::cl::init(CPULibjitISA::Auto), llvm::cl::cat(getLLVMBackendCat()));
+
+static llvm::cl::opt<bool> fuseConvActivations(
+    "cpu-fuse-conv-activations",
+    llvm::cl::desc("Fuse the activation following a convolution into the "
+                   "convolution kernel"),
+    llvm::cl::init(true), llvm::cl::cat(getLLVMBackendCat()));
+
 CPUBackend::CPUBackend() {
+#ifdef GLOW_WITH_CPU_LIBJIT_ISAS
+  libjitISA_ = libjitISAOpt;
+#endif
   /// If target is not explicitly given we use the host attributes.
   auto &opts = getOptions();
   if (opts.getTarget().empty()) {
+    auto hostISA = getHostLibjitISA();
+    if (libjitISA_ == CPULibjitISA::Auto) {
+      libjitISA_ = hostISA;
+    } else if (libjitISA_ > hostISA) {
+      // The compiled functions would fault on the host, so fall back to the
+      // best flavor it can run.
+      LOG(ERROR) << "The " << getLibjitISAName(libjitISA_)
+                 << " libjit flavor is not supported by the host CPU, using "
+                 << getLibjitISAName(hostISA) << " instead.";
+      libjitISA_ = hostISA;
+    }
+    // The AVX-512 flavors need the AVX-512 features for their code to be
+    // inlined into the compiled functions.
+    bool withAVX512 = libjitISA_ == CPULibjitISA::AVX512 ||
+                      libjitISA_ == CPULibjitISA::AVX512VNNI;
     opts.setTarget(LLVMBackend::getHostTarget());
-    opts.setCPU(LLVMBackend::getHostCPU());
-    opts.setTargetFeatures(LLVMBackend::getHostFeatures());
+    opts.setCPU(LLVMBackend::getHostCPU(withAVX512));
+    opts.setTargetFeatures(LLVMBackend::getHostFeatures(withAVX512));
+  } else if (libjitISA_ == CPULibjitISA::Auto) {
+    libjitISA_ = CPULibjitISA::Generic;
+  }
+}
+
+CPULibjitISA CPUBackend::getHostLibjitISA() {
+#ifdef GLOW_WITH_CPU_LIBJIT_ISAS
+  llvm::StringMap<bool> features;
+  if (!llvm::sys::getHostCPUFeatures(features)) {
+    return CPULibjitISA::Generic;
+  }
+  auto has = [&](llvm::StringRef feature) { return features.lookup(feature); };
+  if (has("avx512f") && has("avx512bw") && has("avx512dq") &&
+      has("avx512vl")) {
+    return has("avx512vnni") ? CPULibjitISA::AVX512VNNI : CPULibjitISA::AVX512;
   }
+  if (has("avx2") && has("fma")) {
+    return CPULibjitISA::AVX2;
+  }
+#endif
+  return CPULibjitISA::Generic;
+}
+
+const char *CPUBackend::getLibjitISAName(CPULibjitISA isa) {
+  switch (isa) {
+  case CPULibjitISA::Auto:
+    return "auto";
+  case CPULibjitISA::Generic:
+    return "generic";
+  case CPULibjitISA::AVX2:
+    return "avx2";
+  case CPULibjitISA::AVX512:
+    return "avx512";
+  case CPULibjitISA::AVX512VNNI:
+    return "avx512vnni";
+  }
+  llvm_unreachable("Unknown libjit ISA");
 }
 
 /// We compile the standard library (libjit) to LLVM bitcode, and then convert
 /// that binary data to an include file using an external utility (include-bin).
 /// The resulting file is included here to compile the bitcode image into our
-/// library.
+/// library. On x86 libjit is also built for the ISA extensions of
+/// CPULibjitISA, and the flavor matching the host is picked at compile time.
 static const unsigned char libjit_bc[] = {
 #include "glow/libjit/libjit_cpu.inc"
 };
 static const size_t libjit_bc_size = sizeof(libjit_bc);
 
+#ifdef GLOW_WITH_CPU_LIBJIT_ISAS
+static const unsigned char libjit_avx2_bc[] = {
+#include "glow/libjit/libjit_cpu_avx2.inc"
+};
+static const unsigned char libjit_avx512_bc[] = {
+#include "glow/libjit/libjit_cpu_avx512.inc"
+};
+static const unsigned char libjit_avx512vnni_bc[] = {
+#include "glow/libjit/libjit_cpu_avx512vnni.inc"
+};
+#endif
+
 bool CPUBackend::isOpSupported(const NodeInfo &NI) const {
   switch (NI.getKind()) {
 
@@ -58,8 +153,28 @@ bool CPUBackend::isOpSupported(const NodeInfo &NI) const {
         {ElemKind::FloatTy, ElemKind::Int8QTy});
 
   case Kinded::Kind::CPUConvDKKC8NodeKind:
+  case Kinded::Kind::CPUConvIm2ColNodeKind:
+  case Kinded::Kind::CPUConvWinogradNodeKind:
+  case Kinded::Kind::CPUAttentionNodeKind:
     return NI.allInputsAndOutputsHaveSameElemKind({ElemKind::FloatTy});
 
+  case Kinded::Kind::CPUFullyConnectedNodeKind:
+    // A float FullyConnected may quantize its result in the epilogue.
+    if (!NI.getInTy(CPUFullyConnectedNode::InputIdx)->isQuantizedType()) {
+      return NI.allInputsAndOutputsHaveSameElemKind(
+                 {ElemKind::FloatTy}, {}, {CPUFullyConnectedNode::ResultIdx}) &&
+             (NI.getOutElemTy(CPUFullyConnectedNode::ResultIdx) ==
+                  ElemKind::FloatTy ||
+              NI.getOutElemTy(CPUFullyConnectedNode::ResultIdx) ==
+                  ElemKind::Int8QTy);
+    }
+    return NI.allInputsAndOutputsHaveSameElemKind(
+               {ElemKind::Int8QTy}, {CPUFullyConnectedNode::BiasIdx}) &&
+           (NI.getInElemTy(CPUFullyConnectedNode::BiasIdx) ==
+                ElemKind::Int8QTy ||
+            NI.getInElemTy(CPUFullyConnectedNode::BiasIdx) ==
+                ElemKind::Int32QTy);
+
   // Delegate everything else to the LLVM backend.
   default:
     return LLVMBackend::isOpSupported(NI);
@@ -73,12 +188,37 @@ bool CPUBackend::shouldLower(const Node *N) const {
   case Kinded::Kind::LeakyReluNodeKind:
   case Kinded::Kind::ConvolutionNodeKind:
   case Kinded::Kind::SparseLengthsSumNodeKind:
+  // BatchMatMul is executed as a single strided batched GEMM.
+  case Kinded::Kind::BatchMatMulNodeKind:
     return false;
+  // Float LayerNormalization and Gelu have fused row-wise and element-wise
+  // kernels.
+  case Kinded::Kind::LayerNormalizationNodeKind:
+  case Kinded::Kind::GeluNodeKind:
+    return N->getNthResult(0).getElementType() != ElemKind::FloatTy;
   default:
     return true;
   }
 }
 
+bool CPUBackend::supportsFusedActivation(Node *parent,
+                                         Node *activation) const {
+  auto *CN = llvm::dyn_cast<ConvolutionNode>(parent);
+  if (!fuseConvActivations || !CN || CN->getLayout() != NHWC) {
+    return false;
+  }
+  switch (activation->getKind()) {
+  case Kinded::Kind::ReluNodeKind:
+    return true;
+  case Kinded::Kind::SigmoidNodeKind:
+  case Kinded::Kind::TanhNodeKind:
+    // Quantized Sigmoid and Tanh are lowered to lookup tables.
+    return !CN->getResult().getType()->isQuantizedType();
+  default:
+    return false;
+  }
+}
+
 unsigned CPUBackend::numDevices() {
   return std::thread::hardware_concurrency();
 }
@@ -87,7 +227,8 @@ std::unique_ptr<CompiledFunction> CPUBackend::createCompiledFunction(
     std::unique_ptr<llvm::orc::GlowJIT> JIT,
     runtime::RuntimeBundle &&runtimeBundle) const {
   return glow::make_unique<CPUFunction>(std::move(JIT),
-                                        std::move(runtimeBundle));
+                                        std::move(runtimeBundle),
+                                        getLibjitISAName(libjitISA_));
 }
 
 std::unique_ptr<LLVMIRGen>
@@ -99,6 +240,22 @@ CPUBackend::createIRGen(const IRFunction *IR,
 }
 
 llvm::StringRef CPUBackend::getLibjitBitcode() const {
+#ifdef GLOW_WITH_CPU_LIBJIT_ISAS
+  switch (libjitISA_) {
+  case CPULibjitISA::AVX2:
+    return llvm::StringRef(reinterpret_cast<const char *>(libjit_avx2_bc),
+                           sizeof(libjit_avx2_bc));
+  case CPULibjitISA::AVX512:
+    return llvm::StringRef(reinterpret_cast<const char *>(libjit_avx512_bc),
+                           sizeof(libjit_avx512_bc));
+  case CPULibjitISA::AVX512VNNI:
+    return llvm::StringRef(
+        reinterpret_cast<const char *>(libjit_avx512vnni_bc),
+        sizeof(libjit_avx512vnni_bc));
+  default:
+    break;
+  }
+#endif
   return llvm::StringRef(reinterpret_cast<const char *>(libjit_bc),
                          libjit_bc_size);
 }
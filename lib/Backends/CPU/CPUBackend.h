@@ -29,10 +29,27 @@ namespace glow {
 
 class NodeInfo;
 
+/// Instruction set extensions the CPU libjit is built for, ordered from the
+/// fewest to the most extensions. Auto stands for the best one supported by
+/// the host.
+enum class CPULibjitISA { Auto, Generic, AVX2, AVX512, AVX512VNNI };
+
 class CPUBackend : public LLVMBackend {
+  /// The flavor of libjit linked into the compiled functions.
+  CPULibjitISA libjitISA_{CPULibjitISA::Generic};
+
 public:
   CPUBackend();
 
+  /// \returns the flavor of libjit linked into the compiled functions.
+  CPULibjitISA getLibjitISA() const { return libjitISA_; }
+
+  /// \returns the best libjit flavor that the host CPU can run.
+  static CPULibjitISA getHostLibjitISA();
+
+  /// \returns the name of the libjit flavor \p isa, e.g. "avx512vnni".
+  static const char *getLibjitISAName(CPULibjitISA isa);
+
   /// @name Backend methods.
   /// This is the implementation of the Backend interface.
   ///@{
@@ -53,6 +70,11 @@ public:
 
   bool shouldLower(const Node *N) const override;
 
+  /// \returns whether the backend supports fusing \p activation into \p
+  /// parent. NHWC convolutions apply ReLU in their epilogue; float
+  /// convolutions additionally fuse Tanh and Sigmoid.
+  bool supportsFusedActivation(Node *parent, Node *activation) const override;
+
   runtime::DeviceManager *
   createDeviceManager(const runtime::DeviceConfig &deviceConfig) override {
     return createCPUDeviceManager(deviceConfig);
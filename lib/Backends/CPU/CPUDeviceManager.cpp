@@ -17,11 +17,22 @@
 #include "CPUFunction.h"
 
 #include "glow/Flags/Flags.h"
+#include "glow/Support/Memory.h"
 
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/raw_ostream.h"
 
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace glow {
 namespace runtime {
 
@@ -40,6 +51,129 @@ DeviceManager *createCPUDeviceManager(const DeviceConfig &config) {
   return new CPUDeviceManager(config);
 }
 
+#ifdef __linux__
+/// Parses a Linux style CPU list \p list such as "0-7,16-23" into the ids of
+/// the CPUs it names. \returns an error if \p list is malformed.
+static Expected<std::vector<unsigned>> parseCPUList(llvm::StringRef list) {
+  std::vector<unsigned> cpus;
+  llvm::SmallVector<llvm::StringRef, 8> ranges;
+  list.trim().split(ranges, ',', /* MaxSplit */ -1, /* KeepEmpty */ false);
+  for (auto range : ranges) {
+    auto bounds = range.trim().split('-');
+    unsigned first, last;
+    RETURN_ERR_IF_NOT(!bounds.first.getAsInteger(10, first),
+                      "Invalid CPU list: " + list.str());
+    last = first;
+    if (!bounds.second.empty()) {
+      RETURN_ERR_IF_NOT(!bounds.second.getAsInteger(10, last) && last >= first,
+                        "Invalid CPU list: " + list.str());
+    }
+    for (unsigned cpu = first; cpu <= last; cpu++) {
+      RETURN_ERR_IF_NOT(cpu < CPU_SETSIZE, "Invalid CPU list: " + list.str());
+      cpus.push_back(cpu);
+    }
+  }
+  RETURN_ERR_IF_NOT(!cpus.empty(), "Empty CPU list.");
+  return cpus;
+}
+
+/// \returns the ids of the CPUs belonging to NUMA node \p numaNode.
+static Expected<std::vector<unsigned>> getNUMANodeCPUs(int numaNode) {
+  std::ifstream cpuList(strFormat("/sys/devices/system/node/node%d/cpulist",
+                                  numaNode));
+  std::string list;
+  RETURN_ERR_IF_NOT(cpuList && std::getline(cpuList, list),
+                    ErrorValue::ErrorCode::RUNTIME_DEVICE_NOT_FOUND,
+                    strFormat("NUMA node %d not found", numaNode));
+  return parseCPUList(list);
+}
+
+/// Pins the calling thread to \p cpus and, if \p numaNode is not negative,
+/// makes the thread prefer allocating memory on \p numaNode.
+static Error bindCurrentThread(const std::vector<unsigned> &cpus,
+                               int numaNode) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  RETURN_ERR_IF_NOT(rc == 0, strFormat("Failed to pin CPU device thread: %s",
+                                       strerror(rc)));
+  if (numaNode < 0) {
+    return Error::success();
+  }
+
+  // MPOL_PREFERRED from <numaif.h>, spelled out so we do not need libnuma.
+  constexpr int kMPolPreferred = 1;
+  constexpr unsigned kBitsPerWord = sizeof(unsigned long) * 8;
+  std::vector<unsigned long> nodeMask(numaNode / kBitsPerWord + 1, 0);
+  nodeMask[numaNode / kBitsPerWord] |= 1UL << (numaNode % kBitsPerWord);
+  long mpolErr = syscall(SYS_set_mempolicy, kMPolPreferred, nodeMask.data(),
+                         nodeMask.size() * kBitsPerWord + 1);
+  RETURN_ERR_IF_NOT(mpolErr == 0,
+                    strFormat("Failed to bind CPU device to NUMA node %d: %s",
+                              numaNode, strerror(errno)));
+  return Error::success();
+}
+#endif
+
+Error CPUDeviceManager::init() {
+  auto cpuSet = getParamByName("cpuSet");
+  auto numaNode = getParamByName("numaNode");
+  if (cpuSet.empty() && numaNode.empty()) {
+    return Error::success();
+  }
+  RETURN_ERR_IF_NOT(numaNode.empty() || numaNode_ >= 0,
+                    "Invalid numaNode: " + numaNode.str());
+#ifdef __linux__
+  std::vector<unsigned> cpus;
+  if (!cpuSet.empty()) {
+    ASSIGN_VALUE_OR_RETURN_ERR(cpus, parseCPUList(cpuSet));
+  } else {
+    ASSIGN_VALUE_OR_RETURN_ERR(cpus, getNUMANodeCPUs(numaNode_));
+  }
+
+  // Bind the device thread itself. Constants are collected, and activations
+  // and IO buffers are allocated, on this thread, so with the memory policy in
+  // place they land on the device's node.
+  Error bindErr = Error::empty();
+  workThread_
+      .submit([&]() { bindErr = bindCurrentThread(cpus, numaNode_); })
+      .wait();
+  return bindErr;
+#else
+  return MAKE_ERR("cpuSet and numaNode are only supported on Linux.");
+#endif
+}
+
+CPUDeviceManager::~CPUDeviceManager() {
+  // Stop the device thread before freeing the memory it runs on.
+  ERR_TO_VOID(stop(true));
+  alignedFree(activations_);
+  statsExporterRegistry_->incrementCounter(kDevicesUsedCPU, -1);
+  zeroMemoryCounters();
+}
+
+uint64_t CPUDeviceManager::getRequiredActivationsBytes() const {
+  uint64_t bytes = 0;
+  for (const auto &func : functions_) {
+    bytes = std::max<uint64_t>(
+        bytes, func.second->getRuntimeBundle().getActivationsSize());
+  }
+  return bytes;
+}
+
+void CPUDeviceManager::resizeActivations(uint64_t bytes) {
+  alignedFree(activations_);
+  activations_ =
+      bytes ? static_cast<uint8_t *>(alignedAlloc(bytes, TensorAlignment))
+            : nullptr;
+  usedMemoryBytes_ += bytes;
+  usedMemoryBytes_ -= activationsBytes_;
+  activationsBytes_ = bytes;
+}
+
 uint64_t CPUDeviceManager::getMaximumMemory() const { return maxMemoryBytes_; }
 
 uint64_t CPUDeviceManager::getAvailableMemory() const {
@@ -59,6 +193,8 @@ DeviceInfo CPUDeviceManager::getDeviceInfo() const {
   info.peakDramBw = 110.0 * 1024 * 1024 * 1024;
   info.peakSramBw = 1024.0 * 1024 * 1024 * 1024;
   info.peakPCIeBw = 16.0 * 1024 * 1024 * 1024;
+  info.numaNode = numaNode_;
+  info.sharedActivations = true;
   return info;
 }
 
@@ -68,6 +204,10 @@ void CPUDeviceManager::addNetworkImpl(const Module *module,
   DCHECK(readyCB != nullptr);
 
   uint64_t allFunctionsMemoryBytes{0};
+  // Activation arena size needed once this network is added.
+  uint64_t activationsBytes = activationsBytes_;
+  // Hash of the constants of each function that still has to collect them.
+  std::map<std::string, size_t> constantHashes;
 
   // First check for uniqueness of the function name.
   for (const auto &func : functions) {
@@ -93,26 +233,49 @@ void CPUDeviceManager::addNetworkImpl(const Module *module,
       return;
     }
 
-    allFunctionsMemoryBytes +=
-        func.second->getRuntimeBundle().getConstantWeightSize();
+    // Constants matching a block already on the device take no extra memory.
+    auto &bundle = func.second->getRuntimeBundle();
+    activationsBytes =
+        std::max<uint64_t>(activationsBytes, bundle.getActivationsSize());
+    if (bundle.getConstants() == nullptr) {
+      auto hash = SharedConstantStore::hashConstants(bundle, module);
+      constantHashes.emplace(func.first, hash);
+      if (constantStore_.contains(hash, bundle, module)) {
+        continue;
+      }
+    }
+    allFunctionsMemoryBytes += bundle.getConstantWeightSize();
   }
 
-  if (usedMemoryBytes_ + allFunctionsMemoryBytes > maxMemoryBytes_) {
+  // The arena is counted once, so only its growth needs room.
+  if (usedMemoryBytes_ + allFunctionsMemoryBytes + activationsBytes -
+          activationsBytes_ >
+      maxMemoryBytes_) {
     readyCB(module,
             MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_OUT_OF_DEVICE_MEMORY,
                      "Failed to add network: not enough memory"));
     return;
   }
 
-  // Add to the function name lookup map.
+  // Add to the function name lookup map. Functions in this network may also
+  // share constants with each other, so account for memory as we go.
+  allFunctionsMemoryBytes = 0;
   for (const auto &func : functions) {
-    if (func.second->getRuntimeBundle().getConstants() == nullptr) {
-      func.second->getRuntimeBundle().collectConstants(module);
+    auto &bundle = func.second->getRuntimeBundle();
+    auto hashIt = constantHashes.find(func.first);
+    if (hashIt != constantHashes.end() &&
+        constantStore_.acquire(hashIt->second, bundle, module)) {
+      sharedMemoryBytes_ += bundle.getConstantWeightSize();
+    } else {
+      allFunctionsMemoryBytes += bundle.getConstantWeightSize();
     }
     functions_.emplace(func.first, func.second);
   }
 
   usedMemoryBytes_ += allFunctionsMemoryBytes;
+  if (activationsBytes > activationsBytes_) {
+    resizeActivations(activationsBytes);
+  }
   assert(usedMemoryBytes_ <= maxMemoryBytes_);
 
   // Export change in memory usage.
@@ -128,8 +291,21 @@ void CPUDeviceManager::evictNetworkImpl(std::string functionName,
 
   auto it = functions_.find(functionName);
   if (it != functions_.end()) {
-    usedMemoryBytes_ -= it->second->getRuntimeBundle().getConstantWeightSize();
+    auto &bundle = it->second->getRuntimeBundle();
+    auto size = bundle.getConstantWeightSize();
+    if (constantStore_.owns(bundle)) {
+      // Only the last function referencing a block frees its memory.
+      auto freed = constantStore_.release(bundle);
+      usedMemoryBytes_ -= freed;
+      sharedMemoryBytes_ -= size - freed;
+    } else {
+      usedMemoryBytes_ -= size;
+    }
     functions_.erase(it);
+    auto activationsBytes = getRequiredActivationsBytes();
+    if (activationsBytes < activationsBytes_) {
+      resizeActivations(activationsBytes);
+    }
   } else {
     evictCB(functionName,
             MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_NET_NOT_FOUND,
@@ -143,6 +319,51 @@ void CPUDeviceManager::evictNetworkImpl(std::string functionName,
   evictCB(functionName, Error::success());
 }
 
+void CPUDeviceManager::updateConstantRowsImpl(
+    std::string functionName, std::string name, dim_t firstRow,
+    const Tensor &rows, std::function<void(Error)> resultCB) {
+  auto funcIt = functions_.find(functionName);
+  if (funcIt == functions_.end()) {
+    resultCB(MAKE_ERR(
+        ErrorValue::ErrorCode::RUNTIME_NET_NOT_FOUND,
+        llvm::formatv("Function {0} not found", functionName).str()));
+    return;
+  }
+  auto &bundle = funcIt->second->getRuntimeBundle();
+  const auto &symbolTable = bundle.getSymbolTable();
+  auto symbolIt = symbolTable.find(name);
+  if (symbolIt == symbolTable.end() ||
+      symbolIt->second.symbolCategory != SymbolCategory::Constant ||
+      !bundle.getConstants()) {
+    resultCB(MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_ERROR,
+                      llvm::formatv("Constant {0} not found in function {1}",
+                                    name, functionName)
+                          .str()));
+    return;
+  }
+
+  // Runs execute on this thread, so none of them sees a partial update. Other
+  // functions sharing the constant block must not see it at all, so this
+  // function gets its own copy first.
+  if (constantStore_.isShared(bundle)) {
+    auto size = bundle.getConstantWeightSize();
+    if (usedMemoryBytes_ + size > maxMemoryBytes_) {
+      resultCB(MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_OUT_OF_DEVICE_MEMORY,
+                        "Failed to update constant: not enough memory to "
+                        "unshare its constant block"));
+      return;
+    }
+    usedMemoryBytes_ += size;
+    sharedMemoryBytes_ -= size;
+    exportMemoryCounters();
+  }
+  constantStore_.detach(bundle);
+
+  const auto &info = symbolIt->second;
+  resultCB(copyTensorRows(bundle.getConstants() + info.offset, info.type,
+                          firstRow, rows));
+}
+
 void CPUDeviceManager::runFunctionImpl(
     RunIdentifierTy id, std::string function,
     std::unique_ptr<ExecutionContext> context, ResultCBTy resultCB) {
@@ -164,10 +385,10 @@ void CPUDeviceManager::runFunctionImpl(
     return;
   }
 
-  CompiledFunction *func = funcIt->second;
-
-  // Run that function.
-  auto executeErr = func->execute(context.get());
+  // Run that function in the device's activation arena. It was checked to be
+  // a CPUFunction when it was added.
+  auto *func = static_cast<CPUFunction *>(funcIt->second);
+  auto executeErr = func->executeWithActivations(context.get(), activations_);
 
   // End the TraceEvent early to avoid time in the CB.
   TRACE_EVENT_SCOPE_END_NAMED(dmRun);
@@ -16,6 +16,7 @@
 #ifndef GLOW_BACKENDS_CPU_CPUDEVICEMANAGER_H
 #define GLOW_BACKENDS_CPU_CPUDEVICEMANAGER_H
 
+#include "glow/Backend/BackendUtils.h"
 #include "glow/Backends/QueueBackedDeviceManager.h"
 #include "glow/Runtime/StatsExporter.h"
 
@@ -31,20 +32,48 @@ class CPUDeviceManager : public QueueBackedDeviceManager {
   /// Compiled function list by name.
   FunctionMapTy functions_;
 
+  /// Constant blocks shared by the functions on this device, so that functions
+  /// with identical weights hold a single copy. Only accessed on the device
+  /// thread.
+  SharedConstantStore constantStore_;
+
+  /// Activation arena shared by all functions on this device. The device runs
+  /// one function at a time, so functions, including the partitions of a
+  /// network, never need their activations at the same time; the arena is
+  /// sized for the largest of them and counted once in the device memory.
+  /// Only accessed on the device thread.
+  uint8_t *activations_{nullptr};
+
+  /// Size in bytes of activations_.
+  uint64_t activationsBytes_{0};
+
   /// String constant for logging number of in-use devices.
   static constexpr const char *kDevicesUsedCPU = "glow.devices_used.cpu";
 
+  /// NUMA node this device is bound to, taken from the "numaNode" parameter
+  /// of the DeviceConfig, or -1 if the device is not bound to a node.
+  int numaNode_{-1};
+
 public:
   explicit CPUDeviceManager(const DeviceConfig &config)
       : QueueBackedDeviceManager(config) {
+    int numaNode;
+    if (!getParamByName("numaNode").getAsInteger(10, numaNode) &&
+        numaNode >= 0) {
+      numaNode_ = numaNode;
+    }
     statsExporterRegistry_->incrementCounter(kDevicesUsedCPU);
     exportMemoryCounters();
   }
 
-  ~CPUDeviceManager() override {
-    statsExporterRegistry_->incrementCounter(kDevicesUsedCPU, -1);
-    zeroMemoryCounters();
-  }
+  ~CPUDeviceManager() override;
+
+  /// Initializes the device. If the DeviceConfig has a "cpuSet" parameter
+  /// (e.g. "0-7,16-23") the device thread is pinned to those CPUs. If it has a
+  /// "numaNode" parameter the device thread prefers allocating memory on that
+  /// node, so constants, activations and IO buffers allocated by the device
+  /// stay local; without a "cpuSet" the thread is pinned to the node's CPUs.
+  Error init() override;
 
   /// Returns the amount of memory in bytes available on the device when no
   /// models are loaded.
@@ -63,6 +92,14 @@ public:
   DeviceInfo getDeviceInfo() const override;
 
 protected:
+  /// \returns the activation arena size in bytes needed by the functions
+  /// currently on the device.
+  uint64_t getRequiredActivationsBytes() const;
+
+  /// Replaces the activation arena with one of \p bytes bytes and updates the
+  /// device memory usage accordingly.
+  void resizeActivations(uint64_t bytes);
+
   void addNetworkImpl(const Module *module, FunctionMapTy functions,
                       ReadyCBTy cb) override;
   void evictNetworkImpl(std::string functionName,
@@ -70,6 +107,9 @@ protected:
   void runFunctionImpl(runtime::RunIdentifierTy id, std::string functionName,
                        std::unique_ptr<ExecutionContext> context,
                        ResultCBTy cb) override;
+  void updateConstantRowsImpl(std::string functionName, std::string name,
+                              dim_t firstRow, const Tensor &rows,
+                              std::function<void(Error)> resultCB) override;
 };
 
 DeviceManager *createCPUDeviceManager(const DeviceConfig &config);
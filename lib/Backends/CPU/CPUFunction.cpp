@@ -22,8 +22,14 @@
 using namespace glow;
 
 CPUFunction::CPUFunction(std::unique_ptr<llvm::orc::GlowJIT> JIT,
-                         runtime::RuntimeBundle &&runtimeBundle)
-    : LLVMCompiledFunction(std::move(JIT), std::move(runtimeBundle)) {}
+                         runtime::RuntimeBundle &&runtimeBundle,
+                         llvm::StringRef libjitISA)
+    : LLVMCompiledFunction(std::move(JIT), std::move(runtimeBundle)),
+      libjitISA_(libjitISA) {}
+
+const std::string CPUFunction::toJSON() const {
+  return "{\"libjit_isa\": \"" + libjitISA_ + "\"}";
+}
 
 Error CPUFunction::execute(ExecutionContext *context) {
   return LLVMCompiledFunction::execute(context);
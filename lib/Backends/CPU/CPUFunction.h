@@ -26,9 +26,16 @@
 namespace glow {
 /// A Glow IR function compiled for the CPU using LLVM.
 class CPUFunction final : public LLVMCompiledFunction {
+  /// Name of the libjit flavor linked into the function, e.g. "avx2".
+  std::string libjitISA_;
+
 public:
   CPUFunction(std::unique_ptr<llvm::orc::GlowJIT> JIT,
-              runtime::RuntimeBundle &&runtimeBundle);
+              runtime::RuntimeBundle &&runtimeBundle,
+              llvm::StringRef libjitISA = "generic");
+
+  /// \returns the name of the libjit flavor linked into the function.
+  llvm::StringRef getLibjitISA() const { return libjitISA_; }
 
   /// \name CompiledFunction interface
   ///@{
@@ -37,6 +44,10 @@ public:
 
   /// \returns the backend used to compile this function.
   virtual std::string getCompileBackendName() const override { return "CPU"; }
+
+  /// \returns the instruction set the function was compiled for, as
+  /// {"libjit_isa": "<flavor>"}.
+  const std::string toJSON() const override;
   ///@}
   //
 };
@@ -65,17 +65,12 @@ void CPULLVMIRGen::generateLLVMIRForInstr(llvm::IRBuilder<> &builder,
     size_t inChannels = src->dims()[3];
     size_t outChannels = dest->dims()[3];
 
-    // Select a method for iterating on the image in the pixel (filter-first, or
-    // input-first). Perform convolutions with a high channel count by scanning
-    // the input image multiple times, once for each filter entry. Scan images
-    // with a low channel count by scanning the image once because the filter
-    // scan will fall in the cache.
-    bool pixelScanFirst = (inChannels < 16);
-
-    // The number of float8 registers that we use to process the depth channel.
-    unsigned numDepthRegs = (pixelScanFirst ? 8 : 2);
-    // The number of y pixels to process at once.
-    unsigned sizeGroupY = (pixelScanFirst ? 1 : 5);
+    // The scan order, the number of float8 registers that we use to process
+    // the depth channel and the number of y pixels to process at once are
+    // picked per shape when the convolution is transformed.
+    bool pixelScanFirst = CI->getPixelScanFirst();
+    unsigned numDepthRegs = CI->getNumDepthRegs();
+    unsigned sizeGroupY = CI->getSizeGroupY();
 
     // When producing output pixels process this many times of depth-strips,
     // where each chunk is float8 * numDepthRegs. This is a form of tiling. It's
@@ -100,6 +95,8 @@ void CPULLVMIRGen::generateLLVMIRForInstr(llvm::IRBuilder<> &builder,
     auto *numDepthRegsVal = emitConstI32(builder, numDepthRegs);
     auto *sizeGroupYVal = emitConstI32(builder, sizeGroupY);
     auto *depthStripsVal = emitConstI32(builder, depthStrips);
+    auto *fusedActivation =
+        emitConstI32(builder, static_cast<int32_t>(CI->getFusedActivation()));
 
     const char *kernelName = "convDKKC8";
     auto *F = getFunction(kernelName, dest->getElementType());
@@ -108,7 +105,170 @@ void CPULLVMIRGen::generateLLVMIRForInstr(llvm::IRBuilder<> &builder,
                {destPtr, srcPtr, filterPtr, biasPtr, destDims, srcDims,
                 filterDims, biasDims, kernels, strides, pads, group,
                 pixelScanFirstVal, numDepthRegsVal, sizeGroupYVal,
-                depthStripsVal});
+                depthStripsVal, fusedActivation});
+    break;
+  }
+
+  case Kinded::Kind::CPUConvIm2ColInstKind: {
+    auto *CI = cast<CPUConvIm2ColInst>(I);
+    auto *dest = CI->getDest();
+    auto *src = CI->getSrc();
+    auto *filter = CI->getFilter();
+    auto *destPtr = emitValueAddress(builder, dest);
+    auto *scratchPtr = emitValueAddress(builder, CI->getScratch());
+    auto *srcPtr = emitValueAddress(builder, src);
+    auto *filterPtr = emitValueAddress(builder, filter);
+    auto *biasPtr = emitValueAddress(builder, CI->getBias());
+
+    auto *destDims = emitValueDims(builder, dest);
+    auto *srcDims = emitValueDims(builder, src);
+    auto *filterDims = emitValueDims(builder, filter);
+
+    auto *kernels = emitConstDimTArray(builder, CI->getKernels());
+    auto *strides = emitConstDimTArray(builder, CI->getStrides());
+    auto *pads = emitConstDimTArray(builder, CI->getPads());
+    auto *tileSize = emitConstDimT(builder, CI->getTileSize());
+    auto *gemmMC = emitConstDimT(builder, CI->getGemmMC());
+    auto *gemmKC = emitConstDimT(builder, CI->getGemmKC());
+    auto *gemmNC = emitConstDimT(builder, CI->getGemmNC());
+    auto *fusedActivation =
+        emitConstI32(builder, static_cast<int32_t>(CI->getFusedActivation()));
+
+    auto *F = getFunction("cpu_conv_im2col", dest->getElementType());
+    createCall(builder, F,
+               {destPtr, scratchPtr, srcPtr, filterPtr, biasPtr, destDims,
+                srcDims, filterDims, kernels, strides, pads, tileSize, gemmMC,
+                gemmKC, gemmNC, fusedActivation});
+    break;
+  }
+
+  case Kinded::Kind::CPUConvWinogradInstKind: {
+    auto *CI = cast<CPUConvWinogradInst>(I);
+    auto *dest = CI->getDest();
+    auto *src = CI->getSrc();
+    auto *filter = CI->getFilter();
+    auto *destPtr = emitValueAddress(builder, dest);
+    auto *scratchPtr = emitValueAddress(builder, CI->getScratch());
+    auto *srcPtr = emitValueAddress(builder, src);
+    auto *filterPtr = emitValueAddress(builder, filter);
+    auto *biasPtr = emitValueAddress(builder, CI->getBias());
+
+    auto *destDims = emitValueDims(builder, dest);
+    auto *srcDims = emitValueDims(builder, src);
+    auto *filterDims = emitValueDims(builder, filter);
+
+    auto *pads = emitConstDimTArray(builder, CI->getPads());
+    auto *tileSize = emitConstDimT(builder, CI->getTileSize());
+    auto *gemmMC = emitConstDimT(builder, CI->getGemmMC());
+    auto *gemmKC = emitConstDimT(builder, CI->getGemmKC());
+    auto *gemmNC = emitConstDimT(builder, CI->getGemmNC());
+    auto *fusedActivation =
+        emitConstI32(builder, static_cast<int32_t>(CI->getFusedActivation()));
+
+    auto *F = getFunction("cpu_conv_winograd", dest->getElementType());
+    createCall(builder, F,
+               {destPtr, scratchPtr, srcPtr, filterPtr, biasPtr, destDims,
+                srcDims, filterDims, pads, tileSize, gemmMC, gemmKC, gemmNC,
+                fusedActivation});
+    break;
+  }
+
+  case Kinded::Kind::CPUFullyConnectedInstKind: {
+    auto *FCI = cast<CPUFullyConnectedInst>(I);
+    auto *dest = FCI->getDest();
+    auto *src = FCI->getSrc();
+    auto *weights = FCI->getWeights();
+    auto *destPtr = emitValueAddress(builder, dest);
+    auto *srcPtr = emitValueAddress(builder, src);
+    auto *weightsPtr = emitValueAddress(builder, weights);
+    auto *biasPtr = emitValueAddress(builder, FCI->getBias());
+
+    auto *destDims = emitValueDims(builder, dest);
+    auto *srcDims = emitValueDims(builder, src);
+    auto *weightsDims = emitValueDims(builder, weights);
+    auto *fusedActivation =
+        emitConstI32(builder, static_cast<int32_t>(FCI->getFusedActivation()));
+
+    if (src->getType()->isQuantizedType()) {
+      auto *destTy = dest->getType();
+      auto *srcTy = src->getType();
+      auto *weightsTy = weights->getType();
+      auto *biasTy = FCI->getBias()->getType();
+
+      auto *destOffset = emitConstI32(builder, destTy->getOffset());
+      auto *srcOffset = emitConstI32(builder, srcTy->getOffset());
+      auto *weightsOffset = emitConstI32(builder, weightsTy->getOffset());
+      auto *biasOffset = emitConstI32(builder, biasTy->getOffset());
+
+      // The bias is scaled to the int32 accumulators of the matmul, which are
+      // then requantized to the output once.
+      float matMulScale = srcTy->getScale() * weightsTy->getScale();
+      auto biasScaleParam = quantization::quantizeScaleOffset32To8(
+          biasTy->getScale() / matMulScale, biasTy->getOffset());
+      auto outScaleParam = quantization::quantizeScaleOffset32To8(
+          matMulScale / destTy->getScale(), 0);
+
+      auto *biasPre = emitConstI32(builder, biasScaleParam.pre);
+      auto *biasPost = emitConstI32(builder, biasScaleParam.post);
+      auto *biasScale = emitConstI32(builder, biasScaleParam.scale);
+      auto *outPre = emitConstI32(builder, outScaleParam.pre);
+      auto *outPost = emitConstI32(builder, outScaleParam.post);
+      auto *outScale = emitConstI32(builder, outScaleParam.scale);
+
+      auto *F = getFunction("matmul_fused",
+                            {dest->getElementType(), biasTy->getElementType()});
+      createCall(builder, F,
+                 {destPtr, srcPtr, weightsPtr, biasPtr, destDims, srcDims,
+                  weightsDims, destOffset, srcOffset, weightsOffset,
+                  biasOffset, biasPre, biasPost, biasScale, outPre, outPost,
+                  outScale, fusedActivation});
+      break;
+    }
+
+    // Use the default blocking of the GEMM.
+    auto *zero = emitConstDimT(builder, 0);
+    if (dest->getType()->isQuantizedType()) {
+      // The float result is computed into the scratch buffer and quantized
+      // into the destination block by block.
+      auto *scratchPtr = emitValueAddress(builder, FCI->getScratch());
+      auto *destScale = emitConstF32(builder, dest->getType()->getScale());
+      auto *destOffset = emitConstI32(builder, dest->getType()->getOffset());
+      auto *F = getFunction("matmul_fused_quantize", src->getElementType());
+      createCall(builder, F,
+                 {destPtr, scratchPtr, srcPtr, weightsPtr, biasPtr, destDims,
+                  srcDims, weightsDims, fusedActivation, zero, zero, zero,
+                  destScale, destOffset});
+      break;
+    }
+
+    auto *F = getFunction("matmul_fused", dest->getElementType());
+    createCall(builder, F,
+               {destPtr, srcPtr, weightsPtr, biasPtr, destDims, srcDims,
+                weightsDims, fusedActivation, zero, zero, zero});
+    break;
+  }
+
+  case Kinded::Kind::CPUAttentionInstKind: {
+    auto *AI = cast<CPUAttentionInst>(I);
+    auto *dest = AI->getDest();
+    auto *query = AI->getQuery();
+    auto *key = AI->getKey();
+    auto *value = AI->getValue();
+    auto *destPtr = emitValueAddress(builder, dest);
+    auto *queryPtr = emitValueAddress(builder, query);
+    auto *keyPtr = emitValueAddress(builder, key);
+    auto *valuePtr = emitValueAddress(builder, value);
+
+    auto *destDims = emitValueDims(builder, dest);
+    auto *queryDims = emitValueDims(builder, query);
+    auto *keyDims = emitValueDims(builder, key);
+    auto *valueDims = emitValueDims(builder, value);
+    auto *scale = emitConstF32(builder, AI->getScale());
+
+    auto *F = getFunction("cpu_attention", dest->getElementType());
+    createCall(builder, F,
+               {destPtr, queryPtr, keyPtr, valuePtr, destDims, queryDims,
+                keyDims, valueDims, scale});
     break;
   }
   default:
@@ -32,6 +32,57 @@ BB.newBackendSpecificInstr("CPUConvDKKC8")
     .addMember(MemberType::VectorUnsigned, "Strides")
     .addMember(MemberType::VectorUnsigned, "Pads")
     .addMember(MemberType::Unsigned, "Group")
+    .addMember(MemberType::Boolean, "PixelScanFirst")
+    .addMember(MemberType::Unsigned, "NumDepthRegs")
+    .addMember(MemberType::Unsigned, "SizeGroupY")
+    .addMember(MEMBER_TYPE_INFO(FusedActivation), "FusedActivation")
+    .autoIRGen();
+
+BB.newBackendSpecificInstr("CPUConvIm2Col")
+    .addOperand("Dest", OperandKind::Out)
+    .addOperand("Src", OperandKind::In)
+    .addOperand("Filter", OperandKind::In)
+    .addOperand("Bias", OperandKind::In)
+    .addOperand("Scratch", OperandKind::Scratch)
+    .addMember(MemberType::VectorUnsigned, "Kernels")
+    .addMember(MemberType::VectorUnsigned, "Strides")
+    .addMember(MemberType::VectorUnsigned, "Pads")
+    .addMember(MemberType::Unsigned, "TileSize")
+    .addMember(MemberType::Unsigned, "GemmMC")
+    .addMember(MemberType::Unsigned, "GemmKC")
+    .addMember(MemberType::Unsigned, "GemmNC")
+    .addMember(MEMBER_TYPE_INFO(FusedActivation), "FusedActivation")
+    .autoIRGen();
+
+BB.newBackendSpecificInstr("CPUConvWinograd")
+    .addOperand("Dest", OperandKind::Out)
+    .addOperand("Src", OperandKind::In)
+    .addOperand("Filter", OperandKind::In)
+    .addOperand("Bias", OperandKind::In)
+    .addOperand("Scratch", OperandKind::Scratch)
+    .addMember(MemberType::VectorUnsigned, "Pads")
+    .addMember(MemberType::Unsigned, "TileSize")
+    .addMember(MemberType::Unsigned, "GemmMC")
+    .addMember(MemberType::Unsigned, "GemmKC")
+    .addMember(MemberType::Unsigned, "GemmNC")
+    .addMember(MEMBER_TYPE_INFO(FusedActivation), "FusedActivation")
+    .autoIRGen();
+
+BB.newBackendSpecificInstr("CPUFullyConnected")
+    .addOperand("Dest", OperandKind::Out)
+    .addOperand("Src", OperandKind::In)
+    .addOperand("Weights", OperandKind::In)
+    .addOperand("Bias", OperandKind::In)
+    .addOperand("Scratch", OperandKind::Scratch)
+    .addMember(MEMBER_TYPE_INFO(FusedActivation), "FusedActivation")
+    .autoIRGen();
+
+BB.newBackendSpecificInstr("CPUAttention")
+    .addOperand("Dest", OperandKind::Out)
+    .addOperand("Query", OperandKind::In)
+    .addOperand("Key", OperandKind::In)
+    .addOperand("Value", OperandKind::In)
+    .addMember(MemberType::Float, "Scale")
     .autoIRGen();
 
 BB.includeBackendSpecificVerification("glow/CPUSpecificInstrsVerification.h");
@@ -33,4 +33,66 @@ void CPUConvDKKC8Inst::verify() const {
          "Invalid Element Type");
 }
 
+void CPUConvIm2ColInst::verify() const {
+  assert(getFilter()->dims()[0] ==
+             getKernels()[0] * getKernels()[1] * getSrc()->dims()[3] &&
+         "Invalid filter dimensions.");
+  assert(getFilter()->dims()[1] == getDest()->dims()[3] &&
+         "Invalid filter dimensions.");
+  assert(getDest()->getElementType() == getSrc()->getElementType() &&
+         "Invalid Element Type");
+}
+
+dim_t CPUConvIm2ColInst::getScratchSize() const {
+  // The unrolled input patches of TileSize output pixels.
+  return getTileSize() * getFilter()->dims()[0] * sizeof(float);
+}
+
+void CPUConvWinogradInst::verify() const {
+  assert(getFilter()->dims()[0] == 16 &&
+         getFilter()->dims()[1] == getSrc()->dims()[3] &&
+         getFilter()->dims()[2] == getDest()->dims()[3] &&
+         "Invalid filter dimensions.");
+  assert(getDest()->getElementType() == getSrc()->getElementType() &&
+         "Invalid Element Type");
+}
+
+dim_t CPUConvWinogradInst::getScratchSize() const {
+  // The transformed input and output of TileSize tiles.
+  dim_t channels = getFilter()->dims()[1] + getFilter()->dims()[2];
+  return 16 * getTileSize() * channels * sizeof(float);
+}
+
+void CPUFullyConnectedInst::verify() const {
+  assert(getWeights()->dims()[0] == getSrc()->dims()[1] &&
+         getWeights()->dims()[1] == getDest()->dims()[1] &&
+         "Invalid weights dimensions.");
+  assert(getWeights()->getElementType() == getSrc()->getElementType() &&
+         "Invalid Element Type");
+  assert((getSrc()->getElementType() == ElemKind::FloatTy ||
+          getDest()->getElementType() == getSrc()->getElementType()) &&
+         "Invalid Element Type");
+}
+
+dim_t CPUFullyConnectedInst::getScratchSize() const {
+  // The float result of a float FC is kept here while it is quantized.
+  if (getSrc()->getElementType() != ElemKind::FloatTy ||
+      getDest()->getElementType() == ElemKind::FloatTy) {
+    return 0;
+  }
+  return getDest()->size() * sizeof(float);
+}
+
+void CPUAttentionInst::verify() const {
+  assert(getQuery()->dims()[2] == getKey()->dims()[2] &&
+         "Query and Key must have the same depth.");
+  assert(getKey()->dims()[1] == getValue()->dims()[1] &&
+         "Key and Value must have the same length.");
+  assert(getDest()->dims()[1] == getQuery()->dims()[1] &&
+         getDest()->dims()[2] == getValue()->dims()[2] &&
+         "Invalid output dimensions.");
+  assert(getDest()->getElementType() == getQuery()->getElementType() &&
+         "Invalid Element Type");
+}
+
 #endif // GLOW_WITH_CPU
@@ -29,9 +29,78 @@ BB.newBackendSpecificNode("CPUConvDKKC8")
     .addMember(MemberType::VectorUnsigned, "Strides")
     .addMember(MemberType::VectorUnsigned, "Pads")
     .addMember(MemberType::Unsigned, "Group")
+    .addMember(MemberType::Boolean, "PixelScanFirst")
+    .addMember(MemberType::Unsigned, "NumDepthRegs")
+    .addMember(MemberType::Unsigned, "SizeGroupY")
+    .addFusedActivation()
     .addResultFromCtorArg()
     .setDocstring("This is a cpu-specific convolution implementation where the "
-                  "filter is transposed to the shape [D/8, K, K, C, 8]");
+                  "filter is transposed to the shape [D/8, K, K, C, 8]. It "
+                  "either completes each output pixel in turn or scans the "
+                  "input once per filter element (PixelScanFirst), computing "
+                  "NumDepthRegs x 8 output channels of SizeGroupY pixels at "
+                  "once");
+
+BB.newBackendSpecificNode("CPUConvIm2Col")
+    .addInput("Input")
+    .addInput("Filter")
+    .addInput("Bias")
+    .addMember(MemberType::VectorUnsigned, "Kernels")
+    .addMember(MemberType::VectorUnsigned, "Strides")
+    .addMember(MemberType::VectorUnsigned, "Pads")
+    .addMember(MemberType::Unsigned, "TileSize")
+    .addMember(MemberType::Unsigned, "GemmMC")
+    .addMember(MemberType::Unsigned, "GemmKC")
+    .addMember(MemberType::Unsigned, "GemmNC")
+    .addFusedActivation()
+    .addResultFromCtorArg()
+    .setDocstring("This is a cpu-specific convolution implementation that "
+                  "unrolls the input patches of TileSize output pixels at a "
+                  "time and multiplies them with the filter, which is "
+                  "transposed to the shape [K * K * C, D], using a GEMM "
+                  "blocked by GemmMC, GemmKC and GemmNC (0 for the default)");
+
+BB.newBackendSpecificNode("CPUConvWinograd")
+    .addInput("Input")
+    .addInput("Filter")
+    .addInput("Bias")
+    .addMember(MemberType::VectorUnsigned, "Pads")
+    .addMember(MemberType::Unsigned, "TileSize")
+    .addMember(MemberType::Unsigned, "GemmMC")
+    .addMember(MemberType::Unsigned, "GemmKC")
+    .addMember(MemberType::Unsigned, "GemmNC")
+    .addFusedActivation()
+    .addResultFromCtorArg()
+    .setDocstring("This is a cpu-specific 3x3 stride 1 convolution "
+                  "implementation using the Winograd F(2x2, 3x3) algorithm on "
+                  "TileSize output tiles at a time. The filter is transformed "
+                  "to the shape [16, C, D]. The GEMMs of the transformed "
+                  "tiles are blocked by GemmMC, GemmKC and GemmNC (0 for the "
+                  "default)");
+
+BB.newBackendSpecificNode("CPUFullyConnected")
+    .addInput("Input")
+    .addInput("Weights")
+    .addInput("Bias")
+    .addFusedActivation()
+    .addResultFromCtorArg()
+    .setDocstring("A FullyConnected whose bias and fused activation are "
+                  "applied to each block of the output right after the GEMM "
+                  "completes it, while it is in cache; CPU specific. A float "
+                  "Input may have a quantized Result, which is then quantized "
+                  "in the same epilogue. A quantized Input is requantized "
+                  "once together with the bias, and only ReLU is fused.");
+
+BB.newBackendSpecificNode("CPUAttention")
+    .addInput("Query")
+    .addInput("Key")
+    .addInput("Value")
+    .addMember(MemberType::Float, "Scale")
+    .addResultFromCtorArg()
+    .setDocstring("Fused scaled dot-product attention, computing "
+                  "softmax(Scale * Query x Key^T) x Value for Query "
+                  "[B, Sq, D], Key [B, Sk, D] and Value [B, Sk, Dv] without "
+                  "materializing the [B, Sq, Sk] scores; CPU specific.");
 
 BB.includeBackendSpecificVerification("glow/CPUSpecificNodesVerification.h");
 
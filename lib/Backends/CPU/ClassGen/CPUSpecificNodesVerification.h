@@ -30,4 +30,100 @@ bool CPUConvDKKC8Node::verify() const {
   return expectCompareTrue("Invalid output dimensions", exp, odim, this);
 }
 
+bool CPUConvIm2ColNode::verify() const {
+  ShapeNHWC idim(getInput().getType()->dims());
+  ShapeNHWC odim(getResult().getType()->dims());
+  auto outSz = calculateConvPoolOutputDims(idim.h, idim.w, getKernels(),
+                                           getStrides(), getPads());
+  ShapeNHWC exp(idim.n, outSz.first, outSz.second, getBias().dims()[0]);
+  bool isValid =
+      expectCompareTrue("Invalid output dimensions", exp, odim, this);
+  dim_t patchSize = getKernels()[0] * getKernels()[1] * idim.c;
+  isValid &= expectCompareTrue("Invalid filter dimensions", getFilter().dims(),
+                               {patchSize, odim.c}, this);
+  isValid &= checkType(getInput(), getResult().getElementType(), this);
+  isValid &= checkType(getFilter(), getResult().getElementType(), this);
+  return isValid;
+}
+
+bool CPUConvWinogradNode::verify() const {
+  ShapeNHWC idim(getInput().getType()->dims());
+  ShapeNHWC odim(getResult().getType()->dims());
+  auto outSz =
+      calculateConvPoolOutputDims(idim.h, idim.w, {3, 3}, {1, 1}, getPads());
+  ShapeNHWC exp(idim.n, outSz.first, outSz.second, getBias().dims()[0]);
+  bool isValid =
+      expectCompareTrue("Invalid output dimensions", exp, odim, this);
+  isValid &= expectCompareTrue("Invalid filter dimensions", getFilter().dims(),
+                               {16, idim.c, odim.c}, this);
+  isValid &= checkType(getInput(), getResult().getElementType(), this);
+  isValid &= checkType(getFilter(), getResult().getElementType(), this);
+  return isValid;
+}
+
+bool CPUFullyConnectedNode::verify() const {
+  auto input = getInput();
+  auto weights = getWeights();
+  auto dest = getResult();
+  bool isValid = expectCompareTrue("Input must be 2 dimensional",
+                                   input.dims().size(), size_t(2), this);
+  isValid &= expectCompareTrue("Weights must be 2 dimensional",
+                               weights.dims().size(), size_t(2), this);
+  if (!isValid) {
+    return false;
+  }
+  isValid &= expectCompareTrue("Invalid weights dimensions", weights.dims()[0],
+                               input.dims()[1], this);
+  isValid &= expectCompareTrue("Invalid output dimensions", dest.dims(),
+                               {input.dims()[0], weights.dims()[1]}, this);
+  isValid &= expectCompareTrue("Invalid bias dimensions", getBias().dims(),
+                               {weights.dims()[1]}, this);
+  isValid &= checkType(weights, input.getElementType(), this);
+  if (input.getElementType() == ElemKind::FloatTy) {
+    isValid &= checkType(getBias(), ElemKind::FloatTy, this);
+    isValid &= checkType(dest, {ElemKind::FloatTy, ElemKind::Int8QTy}, this);
+    return isValid;
+  }
+  isValid &= checkType(input, ElemKind::Int8QTy, this);
+  isValid &= checkType(dest, ElemKind::Int8QTy, this);
+  isValid &= checkType(getBias(), {ElemKind::Int8QTy, ElemKind::Int32QTy},
+                       this);
+  isValid &= expectCompareTrue(
+      "Only ReLU is fused into a quantized FullyConnected",
+      getFusedActivation() == FusedActivation::NONE ||
+          getFusedActivation() == FusedActivation::RELU,
+      true, this);
+  return isValid;
+}
+
+bool CPUAttentionNode::verify() const {
+  auto Q = getQuery();
+  auto K = getKey();
+  auto V = getValue();
+  auto dest = getResult();
+  bool isValid = expectCompareTrue("Query must be 3 dimensional",
+                                   Q.dims().size(), size_t(3), this);
+  isValid &= expectCompareTrue("Key must be 3 dimensional", K.dims().size(),
+                               size_t(3), this);
+  isValid &= expectCompareTrue("Value must be 3 dimensional", V.dims().size(),
+                               size_t(3), this);
+  if (!isValid) {
+    return false;
+  }
+  isValid &= expectCompareTrue("Query and Key must have the same batch size",
+                               Q.dims()[0], K.dims()[0], this);
+  isValid &= expectCompareTrue("Key and Value must have the same batch size",
+                               K.dims()[0], V.dims()[0], this);
+  isValid &= expectCompareTrue("Query and Key must have the same depth",
+                               Q.dims()[2], K.dims()[2], this);
+  isValid &= expectCompareTrue("Key and Value must have the same length",
+                               K.dims()[1], V.dims()[1], this);
+  isValid &= expectCompareTrue("Invalid output dimensions", dest.dims(),
+                               {Q.dims()[0], Q.dims()[1], V.dims()[2]}, this);
+  isValid &= checkType(Q, dest.getElementType(), this);
+  isValid &= checkType(K, dest.getElementType(), this);
+  isValid &= checkType(V, dest.getElementType(), this);
+  return isValid;
+}
+
 #endif // GLOW_WITH_CPU
@@ -31,6 +31,52 @@ Error ONNXModelWriter::writeCPUConvDKKC8(const CPUConvDKKC8Node *node,
   addValueAttribute(proto, "strides", node->getStrides());
   addValueAttribute(proto, "pads", node->getPads());
   addValueAttribute(proto, "group", node->getGroup());
+  addValueAttribute(proto, "pixel_scan_first", node->getPixelScanFirst());
+  addValueAttribute(proto, "num_depth_regs", node->getNumDepthRegs());
+  addValueAttribute(proto, "size_group_y", node->getSizeGroupY());
 
   return writeAllWithNode("CPUConvDKKC8", node, graph, proto);
 }
+
+Error ONNXModelWriter::writeCPUConvIm2Col(const CPUConvIm2ColNode *node,
+                                          GraphType &graph) {
+  auto *proto = graph.add_node();
+  // Add dictionary entries.
+  addValueAttribute(proto, "kernel_shape", node->getKernels());
+  addValueAttribute(proto, "strides", node->getStrides());
+  addValueAttribute(proto, "pads", node->getPads());
+  addValueAttribute(proto, "tile_size", node->getTileSize());
+  addValueAttribute(proto, "gemm_mc", node->getGemmMC());
+  addValueAttribute(proto, "gemm_kc", node->getGemmKC());
+  addValueAttribute(proto, "gemm_nc", node->getGemmNC());
+
+  return writeAllWithNode("CPUConvIm2Col", node, graph, proto);
+}
+
+Error ONNXModelWriter::writeCPUConvWinograd(const CPUConvWinogradNode *node,
+                                            GraphType &graph) {
+  auto *proto = graph.add_node();
+  // Add dictionary entries.
+  addValueAttribute(proto, "pads", node->getPads());
+  addValueAttribute(proto, "tile_size", node->getTileSize());
+  addValueAttribute(proto, "gemm_mc", node->getGemmMC());
+  addValueAttribute(proto, "gemm_kc", node->getGemmKC());
+  addValueAttribute(proto, "gemm_nc", node->getGemmNC());
+
+  return writeAllWithNode("CPUConvWinograd", node, graph, proto);
+}
+
+Error ONNXModelWriter::writeCPUFullyConnected(
+    const CPUFullyConnectedNode *node, GraphType &graph) {
+  auto *proto = graph.add_node();
+  return writeAllWithNode("CPUFullyConnected", node, graph, proto);
+}
+
+Error ONNXModelWriter::writeCPUAttention(const CPUAttentionNode *node,
+                                         GraphType &graph) {
+  auto *proto = graph.add_node();
+  // Add dictionary entries.
+  addValueAttribute(proto, "scale", node->getScale());
+
+  return writeAllWithNode("CPUAttention", node, graph, proto);
+}
@@ -14,32 +14,53 @@
  * limitations under the License.
  */
 
+#include "CPUAutotuner.h"
 #include "CPUBackend.h"
 
 #include "glow/Graph/Graph.h"
 #include "glow/Graph/Nodes.h"
+#include "glow/LLVMIRCodeGen/CommandLine.h"
 
 using namespace glow;
 using llvm::dyn_cast;
 using llvm::isa;
 
-/// Try to optimize the regular Convolution into a target-specific convolution
-/// with a different filter memory layout. This optimization adds a new kind of
-/// cpu-specific convolution that operates on filter weight data in a
-/// non-standard format. The default format is DKKC, where D is the output
-/// depth of the filter and C is the input channel, and K is the kernel size.
-/// This optimization changes the data layout to [D/8, K, K, C, 8].  We
-/// pre-swizzle the data in the weights to make the access pattern more
-/// efficient.
-static Node *optimizeCPUConv(ConvolutionNode *CN, Function *F) {
-  auto depth = CN->getFilter().dims()[0];
-  auto *M = F->getParent();
-  auto group = CN->getGroup();
+static llvm::cl::opt<CPUConvAlgorithm> convAlgorithm(
+    "cpu-conv-algorithm",
+    llvm::cl::desc("Algorithm used for float convolutions on the CPU"),
+    llvm::cl::values(
+        clEnumValN(CPUConvAlgorithm::Auto, "auto",
+                   "Pick an algorithm for each convolution"),
+        clEnumValN(CPUConvAlgorithm::Direct, "direct", "Direct loop nest"),
+        clEnumValN(CPUConvAlgorithm::Im2Col, "im2col",
+                   "Unroll the input patches and use a GEMM"),
+        clEnumValN(CPUConvAlgorithm::Winograd, "winograd",
+                   "Winograd F(2x2, 3x3) for 3x3 stride 1 convolutions")),
+    llvm::cl::init(CPUConvAlgorithm::Auto),
+    llvm::cl::cat(getLLVMBackendCat()));
+
+static llvm::cl::opt<bool> fuseAttention(
+    "cpu-fuse-attention",
+    llvm::cl::desc("Fuse scaled dot-product attention into a single "
+                   "CPUAttention node"),
+    llvm::cl::init(true), llvm::cl::cat(getLLVMBackendCat()));
 
+static llvm::cl::opt<bool> fuseFullyConnected(
+    "cpu-fuse-fc",
+    llvm::cl::desc("Fuse the bias and the following activation, rescale or "
+                   "quantization of FullyConnected layers into a "
+                   "CPUFullyConnected node"),
+    llvm::cl::init(true), llvm::cl::cat(getLLVMBackendCat()));
+
+/// \returns the filter of \p CN if it is a float convolution without dilation
+/// whose constant filter may be transformed for the DKKC8 direct convolution,
+/// or nullptr otherwise.
+static Constant *getDKKC8ConvFilter(ConvolutionNode *CN) {
   // Make sure that the depth group is divisible by 64 to perform the
   // transformation. This transformation is currently only profitable on
   // low-channel convolutions.
-  if (((depth / group) % 64) != 0) {
+  auto depth = CN->getFilter().dims()[0];
+  if (((depth / CN->getGroup()) % 64) != 0) {
     return nullptr;
   }
 
@@ -59,6 +80,26 @@ static Node *optimizeCPUConv(ConvolutionNode *CN, Function *F) {
                    [](unsigned_t i) { return i == 1; })) {
     return nullptr;
   }
+  return filter;
+}
+
+/// Try to optimize the regular Convolution into a target-specific convolution
+/// with a different filter memory layout. This optimization adds a new kind of
+/// cpu-specific convolution that operates on filter weight data in a
+/// non-standard format. The default format is DKKC, where D is the output
+/// depth of the filter and C is the input channel, and K is the kernel size.
+/// This optimization changes the data layout to [D/8, K, K, C, 8].  We
+/// pre-swizzle the data in the weights to make the access pattern more
+/// efficient. The blocking of the kernel is taken from \p config, or picked
+/// heuristically if it has none.
+static Node *optimizeCPUConv(ConvolutionNode *CN, Function *F,
+                             const CPUConvConfig &config) {
+  auto *M = F->getParent();
+  auto group = CN->getGroup();
+  Constant *filter = getDKKC8ConvFilter(CN);
+  if (!filter) {
+    return nullptr;
+  }
 
   // Create a new constant filter with the layout [D/8, K, K, C, 8];
   TypeRef filterTy = filter->getType();
@@ -80,9 +121,296 @@ static Node *optimizeCPUConv(ConvolutionNode *CN, Function *F) {
           F8H.at({c0 / 8, c1, c2, c3, c0 % 8}) = FH.at({c0, c1, c2, c3});
         }
 
+  bool pixelScanFirst = config.pixelScanFirst;
+  unsigned_t numDepthRegs = config.numDepthRegs;
+  unsigned_t sizeGroupY = config.sizeGroupY;
+  // The registers must evenly divide the output channels of a group.
+  if (!numDepthRegs || (dims[0] / group / 8) % numDepthRegs != 0) {
+    // Select a method for iterating on the image in the pixel (filter-first,
+    // or input-first). Perform convolutions with a high channel count by
+    // scanning the input image multiple times, once for each filter entry.
+    // Scan images with a low channel count by scanning the image once because
+    // the filter scan will fall in the cache.
+    pixelScanFirst = CN->getInput().dims()[3] < 16;
+    // The number of float8 registers that we use to process the depth
+    // channel, and the number of y pixels to process at once.
+    numDepthRegs = pixelScanFirst ? 8 : 2;
+    sizeGroupY = pixelScanFirst ? 1 : 5;
+  }
+
   return F->addNode(new CPUConvDKKC8Node(
       CN->getName(), CN->getResult().getType(), CN->getInput(), filter8,
-      CN->getBias(), CN->getKernels(), CN->getStrides(), CN->getPads(), group));
+      CN->getBias(), CN->getKernels(), CN->getStrides(), CN->getPads(), group,
+      pixelScanFirst, numDepthRegs, std::max<unsigned_t>(sizeGroupY, 1),
+      CN->getFusedActivation()));
+}
+
+/// \returns the filter of \p CN if it is a float NHWC convolution without
+/// groups and dilation whose constant filter may be transformed for one of the
+/// GEMM based algorithms, or nullptr otherwise.
+static Constant *getTransformableConvFilter(ConvolutionNode *CN) {
+  if (CN->getLayout() != NHWC || CN->getGroup() != 1 ||
+      CN->getResult().getElementType() != ElemKind::FloatTy ||
+      CN->getInput().getElementType() != ElemKind::FloatTy ||
+      CN->getBias().getElementType() != ElemKind::FloatTy) {
+    return nullptr;
+  }
+  if (!std::all_of(CN->getDilation().begin(), CN->getDilation().end(),
+                   [](unsigned_t i) { return i == 1; })) {
+    return nullptr;
+  }
+  Constant *filter = dyn_cast<Constant>(CN->getFilter());
+  if (!filter || filter->getNumUsers() != 1 ||
+      filter->getElementType() != ElemKind::FloatTy) {
+    return nullptr;
+  }
+  return filter;
+}
+
+/// \returns true if \p CN is a 3x3 stride 1 convolution.
+static bool isWinogradConv(ConvolutionNode *CN) {
+  return CN->getKernels()[0] == 3 && CN->getKernels()[1] == 3 &&
+         CN->getStrides()[0] == 1 && CN->getStrides()[1] == 1;
+}
+
+/// Replace the convolution \p CN with a CPUConvIm2Col node, which multiplies
+/// the unrolled input patches with the filter transposed to [K * K * C, D].
+/// The number of output pixels unrolled at once and the blocking of the GEMM
+/// are taken from \p config, where 0 picks a default.
+static Node *optimizeCPUConvIm2Col(ConvolutionNode *CN, Function *F,
+                                   const CPUConvConfig &config) {
+  Constant *filter = getTransformableConvFilter(CN);
+  if (!filter) {
+    return nullptr;
+  }
+
+  auto dims = filter->dims();
+  dim_t patchSize = dims[1] * dims[2] * dims[3];
+  auto *filterT = F->getParent()->createConstant(
+      ElemKind::FloatTy, {patchSize, dims[0]}, filter->getName());
+  auto FTH = filterT->getHandle();
+  auto FH = filter->getHandle();
+  for (dim_t d = 0; d < dims[0]; d++) {
+    for (dim_t i = 0; i < patchSize; i++) {
+      FTH.at({i, d}) = FH.raw(d * patchSize + i);
+    }
+  }
+
+  // By default keep the unrolled patches of a tile of output pixels in about
+  // 256KB.
+  auto outDims = CN->getResult().dims();
+  dim_t numPixels = outDims[0] * outDims[1] * outDims[2];
+  dim_t tileSize = config.tileSize;
+  if (!tileSize) {
+    tileSize = std::max<dim_t>(8, std::min<dim_t>(256, 65536 / patchSize));
+  }
+  tileSize = std::min(tileSize, numPixels);
+
+  return F->addNode(new CPUConvIm2ColNode(
+      CN->getName(), CN->getResult().getType(), CN->getInput(), filterT,
+      CN->getBias(), CN->getKernels(), CN->getStrides(), CN->getPads(),
+      tileSize, config.gemmMC, config.gemmKC, config.gemmNC,
+      CN->getFusedActivation()));
+}
+
+/// Replace the 3x3 stride 1 convolution \p CN with a CPUConvWinograd node.
+/// The filter is transformed to U = G g G^T for Winograd F(2x2, 3x3) here,
+/// so that only the input and output transforms are done at runtime. The
+/// number of tiles transformed at once and the blocking of the GEMMs are taken
+/// from \p config, where 0 picks a default.
+static Node *optimizeCPUConvWinograd(ConvolutionNode *CN, Function *F,
+                                     const CPUConvConfig &config) {
+  Constant *filter = getTransformableConvFilter(CN);
+  if (!filter || !isWinogradConv(CN)) {
+    return nullptr;
+  }
+
+  auto dims = filter->dims();
+  dim_t depth = dims[0];
+  dim_t channels = dims[3];
+  auto *filterU = F->getParent()->createConstant(
+      ElemKind::FloatTy, {16, channels, depth}, filter->getName());
+  auto UH = filterU->getHandle();
+  auto FH = filter->getHandle();
+  static const float G[4][3] = {
+      {1, 0, 0}, {0.5, 0.5, 0.5}, {0.5, -0.5, 0.5}, {0, 0, 1}};
+  for (dim_t d = 0; d < depth; d++) {
+    for (dim_t c = 0; c < channels; c++) {
+      // Gg = G x g, then U = Gg x G^T.
+      float Gg[4][3] = {};
+      for (dim_t i = 0; i < 4; i++) {
+        for (dim_t j = 0; j < 3; j++) {
+          for (dim_t k = 0; k < 3; k++) {
+            Gg[i][j] += G[i][k] * FH.at({d, k, j, c});
+          }
+        }
+      }
+      for (dim_t i = 0; i < 4; i++) {
+        for (dim_t j = 0; j < 4; j++) {
+          float u = 0;
+          for (dim_t k = 0; k < 3; k++) {
+            u += Gg[i][k] * G[j][k];
+          }
+          UH.at({i * 4 + j, c, d}) = u;
+        }
+      }
+    }
+  }
+
+  // By default keep the transformed input and output of a block of tiles in
+  // about 512KB.
+  auto outDims = CN->getResult().dims();
+  dim_t numTiles =
+      outDims[0] * ((outDims[1] + 1) / 2) * ((outDims[2] + 1) / 2);
+  dim_t tileSize = config.tileSize;
+  if (!tileSize) {
+    tileSize =
+        std::max<dim_t>(4, std::min<dim_t>(64, 8192 / (channels + depth)));
+  }
+  tileSize = std::min(tileSize, numTiles);
+
+  return F->addNode(new CPUConvWinogradNode(
+      CN->getName(), CN->getResult().getType(), CN->getInput(), filterU,
+      CN->getBias(), CN->getPads(), tileSize, config.gemmMC, config.gemmKC,
+      config.gemmNC, CN->getFusedActivation()));
+}
+
+/// Pick the algorithm for the convolution \p CN: Winograd for 3x3 stride 1
+/// convolutions with enough channels to amortize the transforms, the DKKC8
+/// direct convolution when the depth suits it, and im2col + GEMM otherwise.
+static CPUConvAlgorithm selectCPUConvAlgorithm(ConvolutionNode *CN) {
+  if (!getTransformableConvFilter(CN)) {
+    return CPUConvAlgorithm::Direct;
+  }
+  dim_t channels = CN->getInput().dims()[3];
+  dim_t depth = CN->getResult().dims()[3];
+  if (isWinogradConv(CN) && channels >= 16 && depth >= 16) {
+    return CPUConvAlgorithm::Winograd;
+  }
+  bool isPointwise = CN->getKernels()[0] == 1 && CN->getKernels()[1] == 1;
+  if (depth % 64 == 0 && !isPointwise) {
+    return CPUConvAlgorithm::Direct;
+  }
+  return CPUConvAlgorithm::Im2Col;
+}
+
+/// Replace the convolution \p CN with the implementation described by
+/// \p config. \returns the new node, or nullptr to keep the generic direct
+/// convolution.
+static Node *createCPUConv(ConvolutionNode *CN, Function *F,
+                           const CPUConvConfig &config) {
+  switch (config.algorithm) {
+  case CPUConvAlgorithm::Winograd:
+    return optimizeCPUConvWinograd(CN, F, config);
+  case CPUConvAlgorithm::Im2Col:
+    return optimizeCPUConvIm2Col(CN, F, config);
+  default:
+    return optimizeCPUConv(CN, F, config);
+  }
+}
+
+/// \returns the configs of the algorithms applicable to \p CN that the
+/// autotuner measures.
+static std::vector<CPUConvConfig> getCPUConvCandidates(ConvolutionNode *CN) {
+  std::vector<CPUConvConfig> candidates = {{CPUConvAlgorithm::Direct, 0}};
+  if (!getTransformableConvFilter(CN)) {
+    return candidates;
+  }
+  for (unsigned_t tileSize : {16, 64, 256}) {
+    candidates.push_back({CPUConvAlgorithm::Im2Col, tileSize});
+  }
+  if (isWinogradConv(CN)) {
+    for (unsigned_t tileSize : {8, 32, 64}) {
+      candidates.push_back({CPUConvAlgorithm::Winograd, tileSize});
+    }
+  }
+  return candidates;
+}
+
+/// \returns the variants of \p config with the blockings of its kernel that
+/// the autotuner measures for \p CN once \p config was picked, or just
+/// \p config if its kernel has no blocking to tune.
+static std::vector<CPUConvConfig>
+getCPUConvBlockingCandidates(ConvolutionNode *CN,
+                             const CPUConvConfig &config) {
+  std::vector<CPUConvConfig> candidates;
+  if (config.algorithm == CPUConvAlgorithm::Direct) {
+    if (!getDKKC8ConvFilter(CN)) {
+      return {config};
+    }
+    // Keep the accumulators of a filter-first scan within the 16 vector
+    // registers of AVX2.
+    for (unsigned_t numDepthRegs : {2, 4, 8}) {
+      CPUConvConfig candidate = config;
+      candidate.pixelScanFirst = true;
+      candidate.numDepthRegs = numDepthRegs;
+      candidate.sizeGroupY = 1;
+      candidates.push_back(candidate);
+      for (unsigned_t sizeGroupY : {1, 2, 5}) {
+        if (numDepthRegs * sizeGroupY > 16) {
+          continue;
+        }
+        candidate.pixelScanFirst = false;
+        candidate.sizeGroupY = sizeGroupY;
+        candidates.push_back(candidate);
+      }
+    }
+    return candidates;
+  }
+
+  // The GEMMs of im2col and Winograd multiply the filter with at most tileSize
+  // columns, so nc rarely matters; mc x kc blocks of the filter should fit the
+  // L2 cache.
+  for (unsigned_t mc : {64, 128, 256}) {
+    for (unsigned_t kc : {64, 128, 256}) {
+      CPUConvConfig candidate = config;
+      candidate.gemmMC = mc;
+      candidate.gemmKC = kc;
+      candidate.gemmNC = 4096;
+      candidates.push_back(candidate);
+    }
+  }
+  return candidates;
+}
+
+/// Replace the convolution \p CN with the implementation of the algorithm
+/// picked for it: the one forced by -cpu-conv-algorithm, else the one in the
+/// tuning database, else the one measured fastest if autotuning is enabled,
+/// else the heuristic one. Autotuning first picks the algorithm and its tile
+/// size, and then the blocking of its kernel. \returns the new node, or
+/// nullptr to keep the generic direct convolution.
+static Expected<Node *> optimizeCPUConvAlgorithm(ConvolutionNode *CN,
+                                                 Function *F) {
+  CPUConvConfig config{convAlgorithm, 0};
+  if (config.algorithm == CPUConvAlgorithm::Auto &&
+      CN->getResult().getElementType() == ElemKind::FloatTy) {
+    auto &database = CPUTuningDatabase::get();
+    std::string key = getConvTuningKey(CN);
+    config = database.lookup(key);
+    if (config.algorithm == CPUConvAlgorithm::Auto &&
+        isCPUAutotuningEnabled()) {
+      // There is nothing to measure if only one config applies.
+      auto candidates = getCPUConvCandidates(CN);
+      config = candidates[0];
+      if (candidates.size() > 1) {
+        ASSIGN_VALUE_OR_RETURN_ERR(
+            config, autotuneConv(CN, candidates, createCPUConv));
+      }
+      auto blockings = getCPUConvBlockingCandidates(CN, config);
+      if (blockings.size() > 1) {
+        ASSIGN_VALUE_OR_RETURN_ERR(config,
+                                   autotuneConv(CN, blockings, createCPUConv));
+      }
+      if (candidates.size() == 1 && blockings.size() == 1) {
+        return createCPUConv(CN, F, config);
+      }
+      database.insert(key, config);
+    }
+  }
+  if (config.algorithm == CPUConvAlgorithm::Auto) {
+    config.algorithm = selectCPUConvAlgorithm(CN);
+  }
+  return createCPUConv(CN, F, config);
 }
 
 /// Merge Max and Splat nodes into target-specific CPUMaxSplat node.
@@ -120,6 +448,200 @@ static Node *optimizeCPUMaxSplat(MaxNode *MN, Function *F) {
       new CPUMaxSplatNode(MN->getName(), input, splat->getValue()));
 }
 
+/// The libjit batched GEMM broadcasts an operand with a batch size of 1 without
+/// copying it, so feed it the input of a Tile along the batch dimension of
+/// \p BMMN instead of the materialized Tile. \returns the new BatchMatMul, or
+/// nullptr if neither operand is such a Tile.
+static Node *optimizeCPUBatchMatMul(BatchMatMulNode *BMMN, Function *F) {
+  auto getBroadcastInput = [](NodeValue operand) -> NodeValue {
+    auto *TN = dyn_cast<TileNode>(operand);
+    if (TN && TN->getAxis() == 0 && TN->getInput().dims()[0] == 1) {
+      return TN->getInput();
+    }
+    return operand;
+  };
+
+  // Only one of the operands may be broadcasted; the other one provides the
+  // batches of the result.
+  NodeValue LHS = getBroadcastInput(BMMN->getLHS());
+  NodeValue RHS = LHS.dims()[0] == 1 ? BMMN->getRHS()
+                                     : getBroadcastInput(BMMN->getRHS());
+  if (LHS == BMMN->getLHS() && RHS == BMMN->getRHS()) {
+    return nullptr;
+  }
+
+  return F->addNode(new BatchMatMulNode(BMMN->getName(),
+                                        BMMN->getResult().getType(), LHS, RHS));
+}
+
+/// Match the BatchedAdd(MatMul(Input, Weights), Bias) that a FullyConnected is
+/// lowered to, ending at \p BAN, together with the chain of single users that
+/// its GEMM epilogue can apply, and replace them with a CPUFullyConnected node.
+/// A float FullyConnected fuses a Relu, Tanh or Sigmoid and a Quantize of the
+/// result. An int8 FullyConnected fuses a Relu, which clips the requantized
+/// result, and RescaleQuantized nodes, which only change the scale of the
+/// requantization. \returns true if the pattern was replaced.
+static bool fuseCPUFullyConnected(BatchedAddNode *BAN, Function *F) {
+  auto *MMN = dyn_cast<MatMulNode>(BAN->getBatch());
+  if (!MMN || !MMN->getResult().hasOneUse() || BAN->hasPredicate() ||
+      MMN->hasPredicate()) {
+    return false;
+  }
+  ElemKind inputTy = MMN->getLHS().getElementType();
+  bool isQuantized = inputTy == ElemKind::Int8QTy;
+  NodeValue bias = BAN->getSlice();
+  if ((inputTy != ElemKind::FloatTy && !isQuantized) ||
+      MMN->getRHS().getElementType() != inputTy ||
+      BAN->getResult().getElementType() != inputTy || bias.dims().size() != 1) {
+    return false;
+  }
+  if (isQuantized ? bias.getElementType() != ElemKind::Int8QTy &&
+                        bias.getElementType() != ElemKind::Int32QTy
+                  : bias.getElementType() != ElemKind::FloatTy) {
+    return false;
+  }
+
+  NodeValue result = BAN->getResult();
+  FusedActivation activation = FusedActivation::NONE;
+  while (result.hasOneUse()) {
+    Node *user = (*result.getUsers().begin()).getUser();
+    bool noActivation = activation == FusedActivation::NONE;
+    if (auto *RN = dyn_cast<ReluNode>(user)) {
+      if (!noActivation) {
+        break;
+      }
+      activation = FusedActivation::RELU;
+      result = RN->getResult();
+    } else if (auto *TN = dyn_cast<TanhNode>(user)) {
+      if (isQuantized || !noActivation) {
+        break;
+      }
+      activation = FusedActivation::TANH;
+      result = TN->getResult();
+    } else if (auto *SN = dyn_cast<SigmoidNode>(user)) {
+      if (isQuantized || !noActivation) {
+        break;
+      }
+      activation = FusedActivation::SIGMOID;
+      result = SN->getResult();
+    } else if (auto *RQN = dyn_cast<RescaleQuantizedNode>(user)) {
+      if (!isQuantized) {
+        break;
+      }
+      result = RQN->getResult();
+    } else if (auto *QN = dyn_cast<QuantizeNode>(user)) {
+      if (isQuantized ||
+          QN->getResult().getElementType() != ElemKind::Int8QTy) {
+        break;
+      }
+      // Nothing can be fused after the quantization.
+      result = QN->getResult();
+      break;
+    } else {
+      break;
+    }
+  }
+  if (!isQuantized && result.getElementType() == ElemKind::FloatTy &&
+      result.getType() != BAN->getResult().getType()) {
+    return false;
+  }
+
+  auto *FCN = F->addNode(new CPUFullyConnectedNode(
+      BAN->getName(), result.getType(), MMN->getLHS(), MMN->getRHS(), bias,
+      activation));
+  result.replaceAllUsesOfWith(FCN->getResult());
+  return true;
+}
+
+/// Match softmax(scale * Q x K^T) x V ending at \p BMMN and replace it with a
+/// CPUAttention node, which never materializes the [Sq, Sk] score and
+/// probability matrices. The SoftMax is expected to be wrapped in the Reshapes
+/// that flatten the batched scores to 2D, and the scale to be a Splat that
+/// multiplies or divides the scores. \returns the new node, or nullptr if the
+/// pattern does not match or its intermediate results have other users.
+static Node *optimizeCPUAttention(BatchMatMulNode *BMMN, Function *F) {
+  NodeValue V = BMMN->getRHS();
+  if (BMMN->getResult().getElementType() != ElemKind::FloatTy ||
+      V.getElementType() != ElemKind::FloatTy) {
+    return nullptr;
+  }
+
+  // P = Reshape(SoftMax(Reshape(S))).
+  auto *RN = dyn_cast<ReshapeNode>(BMMN->getLHS());
+  if (!RN || !RN->getResult().hasOneUse()) {
+    return nullptr;
+  }
+  auto *SMN = dyn_cast<SoftMaxNode>(RN->getInput());
+  if (!SMN || !SMN->getResult().hasOneUse()) {
+    return nullptr;
+  }
+  auto *SRN = dyn_cast<ReshapeNode>(SMN->getInput());
+  if (!SRN || !SRN->getResult().hasOneUse()) {
+    return nullptr;
+  }
+
+  // S = scale * Q x K^T, where the scale may be missing.
+  NodeValue scores = SRN->getInput();
+  float scale = 1;
+  if (auto *MN = dyn_cast<MulNode>(scores)) {
+    if (auto *SN = dyn_cast<SplatNode>(MN->getRHS())) {
+      scale = SN->getValue();
+      scores = MN->getLHS();
+    } else if (auto *SN = dyn_cast<SplatNode>(MN->getLHS())) {
+      scale = SN->getValue();
+      scores = MN->getRHS();
+    } else {
+      return nullptr;
+    }
+    if (!MN->getResult().hasOneUse()) {
+      return nullptr;
+    }
+  } else if (auto *DN = dyn_cast<DivNode>(scores)) {
+    auto *SN = dyn_cast<SplatNode>(DN->getRHS());
+    if (!SN || SN->getValue() == 0 || !DN->getResult().hasOneUse()) {
+      return nullptr;
+    }
+    scale = 1 / SN->getValue();
+    scores = DN->getLHS();
+  }
+
+  auto *QKN = dyn_cast<BatchMatMulNode>(scores);
+  if (!QKN || !QKN->getResult().hasOneUse()) {
+    return nullptr;
+  }
+  NodeValue Q = QKN->getLHS();
+  NodeValue KT = QKN->getRHS();
+  if (Q.getElementType() != ElemKind::FloatTy ||
+      KT.getElementType() != ElemKind::FloatTy) {
+    return nullptr;
+  }
+
+  // The kernel does not broadcast operands, so all batches must match.
+  dim_t batches = BMMN->getResult().dims()[0];
+  if (Q.dims()[0] != batches || KT.dims()[0] != batches ||
+      V.dims()[0] != batches) {
+    return nullptr;
+  }
+
+  // The SoftMax must normalize the scores of each query over all keys.
+  auto smDims = SMN->getResult().dims();
+  if (smDims.size() != 2 || smDims[1] != KT.dims()[2]) {
+    return nullptr;
+  }
+
+  // The kernel reads K row by row, so look through the transpose of K^T.
+  NodeValue K;
+  auto *TN = dyn_cast<TransposeNode>(KT);
+  if (TN && TN->getShuffle().equals({0, 2, 1})) {
+    K = TN->getInput();
+  } else {
+    K = F->createTranspose(BMMN->getName().str() + ".key", KT, {0, 2, 1});
+  }
+
+  return F->addNode(new CPUAttentionNode(
+      BMMN->getName(), BMMN->getResult().getType(), Q, K, V, scale));
+}
+
 Expected<bool>
 CPUBackend::transformPostLowering(Function *F, CompilationContext &,
                                   const glow::runtime::DeviceInfo *) const {
@@ -129,13 +651,43 @@ CPUBackend::transformPostLowering(Function *F, CompilationContext &,
   for (auto &node : F->getNodes()) {
     // Try to replace generic convolution with cpu-optimized version.
     if (auto *CN = dyn_cast<ConvolutionNode>(&node)) {
-      if (Node *NCN = optimizeCPUConv(CN, F)) {
+      Node *NCN;
+      ASSIGN_VALUE_OR_RETURN_ERR(NCN, optimizeCPUConvAlgorithm(CN, F));
+      if (NCN) {
         CN->getResult().replaceAllUsesOfWith(NCN);
         changed = true;
         continue;
       }
     }
 
+    // Fuse scaled dot-product attention ending at this BatchMatMul.
+    if (auto *BMMN = dyn_cast<BatchMatMulNode>(&node)) {
+      if (fuseAttention) {
+        if (Node *AN = optimizeCPUAttention(BMMN, F)) {
+          BMMN->getResult().replaceAllUsesOfWith(AN);
+          changed = true;
+          continue;
+        }
+      }
+    }
+
+    // Broadcast BatchMatMul operands in the kernel rather than with a Tile.
+    if (auto *BMMN = dyn_cast<BatchMatMulNode>(&node)) {
+      if (Node *NBMMN = optimizeCPUBatchMatMul(BMMN, F)) {
+        BMMN->getResult().replaceAllUsesOfWith(NBMMN);
+        changed = true;
+        continue;
+      }
+    }
+
+    // Fuse the bias and activation of a lowered FullyConnected into its GEMM.
+    if (auto *BAN = dyn_cast<BatchedAddNode>(&node)) {
+      if (fuseFullyConnected && fuseCPUFullyConnected(BAN, F)) {
+        changed = true;
+        continue;
+      }
+    }
+
     // Merge Max and Splat nodes into CPUMaxSplat.
     if (auto *MN = dyn_cast<MaxNode>(&node)) {
       if (Node *MSN = optimizeCPUMaxSplat(MN, F)) {
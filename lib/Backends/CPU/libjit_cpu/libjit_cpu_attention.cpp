@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) Glow Contributors. See CONTRIBUTORS file.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <float.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../../LLVMIRCodeGen/libjit/libjit_defs.h"
+
+/// Number of keys whose scores are computed at once. Only this many scores
+/// are ever live for a query row.
+#define ATTENTION_KEY_TILE 64
+
+/// Number of query rows that share each tile of keys and values while it is
+/// in cache.
+#define ATTENTION_QUERY_TILE 8
+
+namespace {
+/// \returns the dot product of the \p n contiguous values at \p a and \p b.
+float libjit_attention_dot(const float *a, const float *b, dim_t n) {
+  float sum = 0;
+  for (dim_t i = 0; i < n; i++) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+} // namespace
+
+extern "C" {
+
+/// Computes softmax(\p scale * Q x K^T) x V for each of the batches of
+/// \p qW [B, Sq, D], \p kW [B, Sk, D] and \p vW [B, Sk, Dv] and stores the
+/// result in \p outW [B, Sq, Dv]. The softmax is streamed over tiles of keys
+/// (the "online softmax"): each output row keeps the running maximum and sum
+/// of its scores and is rescaled whenever the maximum grows, so the
+/// [Sq, Sk] score matrix is never materialized.
+void libjit_cpu_attention_f(float *outW, const float *qW, const float *kW,
+                            const float *vW, const dim_t *outWdims,
+                            const dim_t *qWdims, const dim_t *kWdims,
+                            const dim_t *vWdims, float scale) {
+  dim_t batches = qWdims[0];
+  dim_t Sq = qWdims[1];
+  dim_t D = qWdims[2];
+  dim_t Sk = kWdims[1];
+  dim_t Dv = vWdims[2];
+
+  float scores[ATTENTION_KEY_TILE];
+  float maxs[ATTENTION_QUERY_TILE];
+  float sums[ATTENTION_QUERY_TILE];
+
+  for (dim_t b = 0; b < batches; b++) {
+    const float *q = qW + b * Sq * D;
+    const float *k = kW + b * Sk * D;
+    const float *v = vW + b * Sk * Dv;
+    float *out = outW + b * Sq * Dv;
+
+    for (dim_t i0 = 0; i0 < Sq; i0 += ATTENTION_QUERY_TILE) {
+      dim_t ib = MIN(Sq - i0, ATTENTION_QUERY_TILE);
+      for (dim_t ii = 0; ii < ib; ii++) {
+        maxs[ii] = -FLT_MAX;
+        sums[ii] = 0;
+      }
+      memset(out + i0 * Dv, 0, ib * Dv * sizeof(float));
+
+      for (dim_t j0 = 0; j0 < Sk; j0 += ATTENTION_KEY_TILE) {
+        dim_t jb = MIN(Sk - j0, ATTENTION_KEY_TILE);
+        for (dim_t ii = 0; ii < ib; ii++) {
+          const float *qRow = q + (i0 + ii) * D;
+          float *outRow = out + (i0 + ii) * Dv;
+
+          // Scores of this query row against the tile of keys.
+          float tileMax = -FLT_MAX;
+          for (dim_t jj = 0; jj < jb; jj++) {
+            float s = scale * libjit_attention_dot(qRow, k + (j0 + jj) * D, D);
+            scores[jj] = s;
+            tileMax = MAX(tileMax, s);
+          }
+
+          // Rescale what was accumulated so far to the new maximum.
+          float newMax = MAX(maxs[ii], tileMax);
+          float correction = expf(maxs[ii] - newMax);
+          float sum = sums[ii] * correction;
+          for (dim_t d = 0; d < Dv; d++) {
+            outRow[d] *= correction;
+          }
+
+          // Accumulate the weighted values of the tile.
+          for (dim_t jj = 0; jj < jb; jj++) {
+            float p = expf(scores[jj] - newMax);
+            sum += p;
+            const float *vRow = v + (j0 + jj) * Dv;
+            for (dim_t d = 0; d < Dv; d++) {
+              outRow[d] += p * vRow[d];
+            }
+          }
+          maxs[ii] = newMax;
+          sums[ii] = sum;
+        }
+      }
+
+      // Normalize by the softmax denominators.
+      for (dim_t ii = 0; ii < ib; ii++) {
+        float invSum = 1 / sums[ii];
+        float *outRow = out + (i0 + ii) * Dv;
+        for (dim_t d = 0; d < Dv; d++) {
+          outRow[d] *= invSum;
+        }
+      }
+    }
+  }
+}
+
+} // extern "C"
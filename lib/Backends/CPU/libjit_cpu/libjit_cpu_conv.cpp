@@ -113,7 +113,8 @@ void libjit_convDKKC8_foreach_xy_filter_pixels(
     const float *inW, const float *filterW, const float *biasW,
     const dim_t *outWdims, const dim_t *inWdims, const dim_t *filterWdims,
     const dim_t *biasWdims, const dim_t *kernelSizes, const dim_t *strides,
-    const dim_t *pads, dim_t group, dim_t endChannelIndex) {
+    const dim_t *pads, dim_t group, dim_t endChannelIndex,
+    int32_t fusedActivation) {
   // The loops below look scary but the idea is simple. We iterate over
   // the pixels in the output tensor and calculate the coordinate of the source
   // tensor. When we process the Y row we try to process [sizeGroupY] elements
@@ -126,9 +127,14 @@ void libjit_convDKKC8_foreach_xy_filter_pixels(
   dim_t stride_w = strides[1];
   dim_t kernel_h = kernelSizes[0];
   dim_t kernel_w = kernelSizes[1];
+  dim_t endTileChannel =
+      MIN(outChannel + numDepthRegs * 8 * depthStrips, endChannelIndex);
   // For each element in the convolution-filter:
   for (dim_t fx = 0; fx < kernel_h; fx++) {
     for (dim_t fy = 0; fy < kernel_w; fy++) {
+      // The last filter element completes each output row, which then gets
+      // the fused activation.
+      bool lastTap = fx + 1 == kernel_h && fy + 1 == kernel_w;
 
       // For each x step in the input/output tensor:
       for (dim_t outx = 0; outx < outWdims[1]; outx++) {
@@ -136,6 +142,11 @@ void libjit_convDKKC8_foreach_xy_filter_pixels(
 
         // Ignore out-of-bounds X values.
         if (inx < 0 || inx >= (sdim_t)inWdims[1]) {
+          if (lastTap) {
+            libjit_conv_apply_fused_activation(outW, outWdims, sampleN, outx, 0,
+                                               outWdims[2], outChannel,
+                                               endTileChannel, fusedActivation);
+          }
           continue;
         }
 
@@ -195,6 +206,11 @@ void libjit_convDKKC8_foreach_xy_filter_pixels(
           }
         } // For each Y, in step of 1, in the output.
 
+        if (lastTap) {
+          libjit_conv_apply_fused_activation(outW, outWdims, sampleN, outx, 0,
+                                             outWdims[2], outChannel,
+                                             endTileChannel, fusedActivation);
+        }
       } // For each X in the output.
     }   // For each Y in the filter.
   }     // For each X in the filter.
@@ -209,7 +225,8 @@ void libjit_convDKKC8_foreach_xy_pixels_filter(
     const float *inW, const float *filterW, const float *biasW,
     const dim_t *outWdims, const dim_t *inWdims, const dim_t *filterWdims,
     const dim_t *biasWdims, const dim_t *kernelSizes, const dim_t *strides,
-    const dim_t *pads, dim_t group, dim_t endChannelIndex) {
+    const dim_t *pads, dim_t group, dim_t endChannelIndex,
+    int32_t fusedActivation) {
 
   dim_t pad_t = pads[0];
   dim_t pad_l = pads[1];
@@ -217,6 +234,8 @@ void libjit_convDKKC8_foreach_xy_pixels_filter(
   dim_t stride_w = strides[1];
   dim_t kernel_h = kernelSizes[0];
   dim_t kernel_w = kernelSizes[1];
+  dim_t endTileChannel =
+      MIN(outChannel + numDepthRegs * 8 * depthStrips, endChannelIndex);
   // For each (x,y) step in the input/output tensor:
   for (dim_t outx = 0; outx < outWdims[1]; outx++) {
     for (dim_t outy = 0; outy < outWdims[2]; outy++) {
@@ -246,8 +265,13 @@ void libjit_convDKKC8_foreach_xy_pixels_filter(
           }
         } // For each Y in the filter.
       }   // For each X in the filter.
-    }     // For each Y in the output.
-  }       // For each X in the output.
+
+      // The pixel is complete, apply the fused activation to it.
+      libjit_conv_apply_fused_activation(outW, outWdims, sampleN, outx, outy,
+                                         outy + 1, outChannel, endTileChannel,
+                                         fusedActivation);
+    } // For each Y in the output.
+  }   // For each X in the output.
 }
 
 } // namespace
@@ -259,7 +283,8 @@ void libjit_convDKKC8_f(float *outW, const float *inW, const float *filterW,
                         const dim_t *biasWdims, const dim_t *kernelSizes,
                         const dim_t *strides, const dim_t *pads, dim_t group,
                         unsigned pixelScanFirst, unsigned numDepthRegs,
-                        unsigned sizeGroupY, unsigned depthStrips) {
+                        unsigned sizeGroupY, unsigned depthStrips,
+                        int32_t fusedActivation) {
   dim_t inChannels = inWdims[3];
   dim_t outChannels = outWdims[3];
   dim_t inCperG = inChannels / group;
@@ -290,11 +315,185 @@ void libjit_convDKKC8_f(float *outW, const float *inW, const float *filterW,
         eachPixelConv(n, d, numDepthRegs, depthStrips, sizeGroupY, inCperG,
                       outW, inW, filterW, biasW, outWdims, inWdims, filterWdims,
                       biasWdims, kernelSizes, strides, pads, g,
-                      endChannelIndex);
+                      endChannelIndex, fusedActivation);
 
       } // For each D (the depth, or the output channel).
     }   // for each G, the group
   }     // For each N, the sample in the batch.
 }
 
+/// Defined in libjit_matmul.cpp.
+void libjit_matmul_f(float *c, const float *a, const float *b,
+                     const dim_t *cDims, const dim_t *aDims, const dim_t *bDims,
+                     dim_t mc, dim_t kc, dim_t nc);
+void libjit_matmul_fused_f(float *c, const float *a, const float *b,
+                           const float *bias, const dim_t *cDims,
+                           const dim_t *aDims, const dim_t *bDims,
+                           int32_t fusedActivation, dim_t mc, dim_t kc,
+                           dim_t nc);
+
+/// Convolution as a matrix multiplication: the input patches of \p tileSize
+/// output pixels are unrolled into the rows of \p colW, which are then
+/// multiplied with \p filterW, the filter transposed to [K * K * C, D], using
+/// a GEMM blocked by \p mc, \p kc and \p nc. 1x1 convolutions with unit
+/// stride and no padding use the input as is.
+void libjit_cpu_conv_im2col_f(float *outW, float *colW, const float *inW,
+                              const float *filterW, const float *biasW,
+                              const dim_t *outWdims, const dim_t *inWdims,
+                              const dim_t *filterWdims,
+                              const dim_t *kernelSizes, const dim_t *strides,
+                              const dim_t *pads, dim_t tileSize, dim_t mc,
+                              dim_t kc, dim_t nc, int32_t fusedActivation) {
+  dim_t kernelH = kernelSizes[0];
+  dim_t kernelW = kernelSizes[1];
+  dim_t inChannels = inWdims[3];
+  dim_t outChannels = outWdims[3];
+  dim_t patchSize = filterWdims[0];
+  dim_t numPixels = outWdims[0] * outWdims[1] * outWdims[2];
+  bool unrolled = kernelH == 1 && kernelW == 1 && strides[0] == 1 &&
+                  strides[1] == 1 && pads[0] == 0 && pads[1] == 0 &&
+                  pads[2] == 0 && pads[3] == 0;
+
+  for (dim_t p0 = 0; p0 < numPixels; p0 += tileSize) {
+    dim_t rows = MIN(numPixels - p0, tileSize);
+    const float *cols = inW + p0 * inChannels;
+
+    if (!unrolled) {
+      for (dim_t r = 0; r < rows; r++) {
+        dim_t pixel = p0 + r;
+        dim_t n = pixel / (outWdims[1] * outWdims[2]);
+        dim_t ox = (pixel / outWdims[2]) % outWdims[1];
+        dim_t oy = pixel % outWdims[2];
+        float *col = colW + r * patchSize;
+        for (dim_t kx = 0; kx < kernelH; kx++) {
+          ssize_t x = (ssize_t)(ox * strides[0] + kx) - (ssize_t)pads[0];
+          for (dim_t ky = 0; ky < kernelW; ky++) {
+            ssize_t y = (ssize_t)(oy * strides[1] + ky) - (ssize_t)pads[1];
+            float *dst = col + (kx * kernelW + ky) * inChannels;
+            if (x < 0 || y < 0 || x >= (ssize_t)inWdims[1] ||
+                y >= (ssize_t)inWdims[2]) {
+              memset(dst, 0, inChannels * sizeof(float));
+              continue;
+            }
+            memcpy(dst, inW + libjit_getXYZW(inWdims, n, x, y, 0),
+                   inChannels * sizeof(float));
+          }
+        }
+      }
+      cols = colW;
+    }
+
+    float *out = outW + p0 * outChannels;
+    dim_t outDims[] = {rows, outChannels};
+    dim_t colDims[] = {rows, patchSize};
+    libjit_matmul_fused_f(out, cols, filterW, biasW, outDims, colDims,
+                          filterWdims, fusedActivation, mc, kc, nc);
+  }
+}
+
+/// 3x3 stride 1 convolution using Winograd F(2x2, 3x3). Each 4x4 input tile
+/// is transformed to V = B^T d B, multiplied elementwise (as 16 matrix
+/// multiplications over the channels) with the transformed filter
+/// U = G g G^T in \p filterW [16, C, D], and transformed back to a 2x2 output
+/// tile with A^T M A. \p scratchW holds V and M for \p tileSize tiles. The
+/// GEMMs are blocked by \p mc, \p kc and \p nc.
+void libjit_cpu_conv_winograd_f(float *outW, float *scratchW, const float *inW,
+                                const float *filterW, const float *biasW,
+                                const dim_t *outWdims, const dim_t *inWdims,
+                                const dim_t *filterWdims, const dim_t *pads,
+                                dim_t tileSize, dim_t mc, dim_t kc, dim_t nc,
+                                int32_t fusedActivation) {
+  dim_t inChannels = filterWdims[1];
+  dim_t outChannels = filterWdims[2];
+  dim_t tilesX = (outWdims[1] + 1) / 2;
+  dim_t tilesY = (outWdims[2] + 1) / 2;
+  dim_t numTiles = outWdims[0] * tilesX * tilesY;
+  float *V = scratchW;
+  float *M = scratchW + 16 * tileSize * inChannels;
+
+  for (dim_t t0 = 0; t0 < numTiles; t0 += tileSize) {
+    dim_t tiles = MIN(numTiles - t0, tileSize);
+
+    // Input transform, V = B^T d B, stored as [16, tiles, C].
+    for (dim_t t = 0; t < tiles; t++) {
+      dim_t tile = t0 + t;
+      dim_t n = tile / (tilesX * tilesY);
+      ssize_t x0 = (ssize_t)((tile / tilesY) % tilesX * 2) - (ssize_t)pads[0];
+      ssize_t y0 = (ssize_t)(tile % tilesY * 2) - (ssize_t)pads[1];
+      const float *in[4][4];
+      for (dim_t i = 0; i < 4; i++) {
+        for (dim_t j = 0; j < 4; j++) {
+          ssize_t x = x0 + i;
+          ssize_t y = y0 + j;
+          bool inside = x >= 0 && y >= 0 && x < (ssize_t)inWdims[1] &&
+                        y < (ssize_t)inWdims[2];
+          in[i][j] = inside ? inW + libjit_getXYZW(inWdims, n, x, y, 0)
+                            : nullptr;
+        }
+      }
+      for (dim_t c = 0; c < inChannels; c++) {
+        float d[4][4], tmp[4][4];
+        for (dim_t i = 0; i < 4; i++) {
+          for (dim_t j = 0; j < 4; j++) {
+            d[i][j] = in[i][j] ? in[i][j][c] : 0;
+          }
+        }
+        for (dim_t j = 0; j < 4; j++) {
+          tmp[0][j] = d[0][j] - d[2][j];
+          tmp[1][j] = d[1][j] + d[2][j];
+          tmp[2][j] = d[2][j] - d[1][j];
+          tmp[3][j] = d[1][j] - d[3][j];
+        }
+        for (dim_t i = 0; i < 4; i++) {
+          float *v = V + (i * 4) * tiles * inChannels + t * inChannels + c;
+          dim_t stride = tiles * inChannels;
+          v[0] = tmp[i][0] - tmp[i][2];
+          v[stride] = tmp[i][1] + tmp[i][2];
+          v[2 * stride] = tmp[i][2] - tmp[i][1];
+          v[3 * stride] = tmp[i][1] - tmp[i][3];
+        }
+      }
+    }
+
+    // M = V * U for each of the 16 positions of the tile.
+    dim_t vDims[] = {tiles, inChannels};
+    dim_t mDims[] = {tiles, outChannels};
+    dim_t uDims[] = {inChannels, outChannels};
+    for (dim_t p = 0; p < 16; p++) {
+      libjit_matmul_f(M + p * tiles * outChannels, V + p * tiles * inChannels,
+                      filterW + p * inChannels * outChannels, mDims, vDims,
+                      uDims, mc, kc, nc);
+    }
+
+    // Output transform, Y = A^T M A, plus bias and activation.
+    for (dim_t t = 0; t < tiles; t++) {
+      dim_t tile = t0 + t;
+      dim_t n = tile / (tilesX * tilesY);
+      dim_t x0 = (tile / tilesY) % tilesX * 2;
+      dim_t y0 = tile % tilesY * 2;
+      for (dim_t d = 0; d < outChannels; d++) {
+        float m[4][4], tmp[2][4];
+        for (dim_t p = 0; p < 16; p++) {
+          m[p / 4][p % 4] = M[p * tiles * outChannels + t * outChannels + d];
+        }
+        for (dim_t j = 0; j < 4; j++) {
+          tmp[0][j] = m[0][j] + m[1][j] + m[2][j];
+          tmp[1][j] = m[1][j] - m[2][j] - m[3][j];
+        }
+        for (dim_t i = 0; i < 2; i++) {
+          float y[2] = {tmp[i][0] + tmp[i][1] + tmp[i][2],
+                        tmp[i][1] - tmp[i][2] - tmp[i][3]};
+          for (dim_t j = 0; j < 2; j++) {
+            if (x0 + i >= outWdims[1] || y0 + j >= outWdims[2]) {
+              continue;
+            }
+            outW[libjit_getXYZW(outWdims, n, x0 + i, y0 + j, d)] =
+                libjit_fused_activation_f(y[j] + biasW[d], fusedActivation);
+          }
+        }
+      }
+    }
+  }
+}
+
 } // extern "C"
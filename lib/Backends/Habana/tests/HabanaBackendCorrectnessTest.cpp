@@ -21,10 +21,15 @@ std::set<std::string> glow::backendTestBlacklist = {
     "AvgPoolGradTest/0",
     "basicFCNetQuantized/0",
     "complexNet1/0",
+    "convAlgorithmsTest/0",
     "convDKKC8Test/0",
     "convGradTest/0",
     "convOps/0",
+    "convReluTest/0",
+    "convSigmoidTest/0",
+    "convTanhTest/0",
     "convTest/0",
+    "fastTranscendentalsTest/0",
     "groupConvTest/0",
     "intLookupTable/0",
     "localResponseNormalizationGradTest/0",
@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 #include "glow/Backends/Interpreter/InterpreterDeviceManager.h"
+#include "glow/Backend/BackendUtils.h"
 #include "glow/Backends/Interpreter/Interpreter.h"
+#include "glow/Backends/Interpreter/InterpreterFunction.h"
 
 #include "glow/Flags/Flags.h"
 
@@ -148,6 +150,29 @@ void InterpreterDeviceManager::transferStaticPlaceholderToDevice(
   resultCB(Error::success());
 }
 
+void InterpreterDeviceManager::updateConstantRowsImpl(
+    std::string functionName, std::string name, dim_t firstRow,
+    const Tensor &rows, std::function<void(Error)> resultCB) {
+  auto it = functions_.find(functionName);
+  if (it == functions_.end()) {
+    resultCB(MAKE_ERR(
+        ErrorValue::ErrorCode::RUNTIME_NET_NOT_FOUND,
+        llvm::formatv("Function {0} not found", functionName).str()));
+    return;
+  }
+  auto *T = static_cast<InterpreterFunction *>(it->second)->getConstant(name);
+  if (!T) {
+    resultCB(MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_ERROR,
+                      llvm::formatv("Constant {0} not found in function {1}",
+                                    name, functionName)
+                          .str()));
+    return;
+  }
+  // Runs execute on this thread, so none of them sees a partial update.
+  resultCB(copyTensorRows(reinterpret_cast<uint8_t *>(T->getUnsafePtr()),
+                          T->getType(), firstRow, rows));
+}
+
 void InterpreterDeviceManager::evictNetworkImpl(std::string functionName,
                                                 EvictFunctionCBTy evictCB) {
   DCHECK(evictCB != nullptr);
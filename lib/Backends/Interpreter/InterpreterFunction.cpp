@@ -56,6 +56,11 @@ void InterpreterFunction::addConstant(std::string name, Tensor *T) {
   constants_[name] = newTensor;
 }
 
+Tensor *InterpreterFunction::getConstant(llvm::StringRef name) const {
+  auto it = constants_.find(name.str());
+  return it == constants_.end() ? nullptr : it->second;
+}
+
 Error InterpreterFunction::execute(ExecutionContext *context) {
   BoundInterpreterFunction boundFunc(constants_);
   boundFunc.setIRInstructionProcessingHandler(
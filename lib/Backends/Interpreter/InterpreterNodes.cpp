@@ -3465,6 +3465,16 @@ void BoundInterpreterFunction::fwdBatchMatMulInst(
   DCHECK(!"Found BatchMatMulInst but BatchMatMul is lowered on Interpreter");
 }
 
+void BoundInterpreterFunction::fwdLayerNormalizationInst(
+    const glow::LayerNormalizationInst *I) {
+  DCHECK(!"Found LayerNormalizationInst but LayerNormalization is lowered on "
+          "Interpreter");
+}
+
+void BoundInterpreterFunction::fwdGeluInst(const glow::GeluInst *I) {
+  DCHECK(!"Found GeluInst but Gelu is lowered on Interpreter");
+}
+
 void BoundInterpreterFunction::fwdReluGradInst(const glow::ReluGradInst *I) {
   DCHECK(!"Found ReluGradInst but ReluGrad is lowered on Interpreter");
 }
@@ -22,4 +22,6 @@ std::set<std::string> glow::backendTestBlacklist = {
     "dataParallelStackingTest/0",
     "SymmetricQuantizedConvReluFusionTest/0",
     "AsymmetricQuantizedConvReluFusionTest/0",
+    // Interpreter has no fast approximations of transcendental functions.
+    "fastTranscendentalsTest/0",
 };
@@ -26,9 +26,16 @@ struct BlacklistInitializer {
       {"basicFCNet/0", TestBlacklist::AnyDeviceAnyEngine},
       {"basicFCNetQuantized/0", TestBlacklist::AnyDeviceAnyEngine},
       {"complexNet1/0", TestBlacklist::AnyDeviceAnyEngine},
+      {"convAlgorithmsTest/0", TestBlacklist::AnyDeviceAnyEngine},
       {"convDKKC8Test/0", TestBlacklist::AnyDeviceAnyEngine},
       {"convGradTest/0", TestBlacklist::AnyDeviceAnyEngine},
       {"convTest/0", TestBlacklist::AnyDeviceAnyEngine},
+      {"convReluTest/0", TestBlacklist::AnyDeviceAnyEngine},
+      {"convSigmoidTest/0", TestBlacklist::AnyDeviceAnyEngine},
+      {"convTanhTest/0", TestBlacklist::AnyDeviceAnyEngine},
+      {"fastTranscendentalsTest/0", TestBlacklist::AnyDeviceAnyEngine},
+      {"fcActivationTest/0", TestBlacklist::AnyDeviceAnyEngine},
+      {"fcQuantizeTest/0", TestBlacklist::AnyDeviceAnyEngine},
       {"groupConvTest/0", TestBlacklist::AnyDeviceAnyEngine},
       {"localResponseNormalizationGradTest/0",
        TestBlacklist::AnyDeviceAnyEngine},
@@ -37,6 +44,7 @@ struct BlacklistInitializer {
       {"nonSquareKernelConvTest/0", TestBlacklist::AnyDeviceAnyEngine},
       {"nonSquarePaddingConvTest/0", TestBlacklist::AnyDeviceAnyEngine},
       {"quantizedConvTest/0", TestBlacklist::AnyDeviceAnyEngine},
+      {"quantizedFCActivationTest/0", TestBlacklist::AnyDeviceAnyEngine},
       {"softmaxGradTest/0", TestBlacklist::AnyDeviceAnyEngine},
       {"convOps/0", TestBlacklist::AnyDeviceHWEngine},
       {"localResponseNormalizationTest/0", TestBlacklist::AnyDeviceAnyEngine},
@@ -83,6 +83,7 @@ struct BlacklistInitializer {
       {"CumSum_WithZeroes/0", TestBlacklist::AnyDeviceAnyEngine},
       {"LayerNorm_BFloat16/0", TestBlacklist::AnyDeviceAnyEngine},
       {"LayerNorm_Float/0", TestBlacklist::AnyDeviceAnyEngine},
+      {"LayerNorm_Float_LargeOffset/0", TestBlacklist::AnyDeviceAnyEngine},
       {"LengthsSum/0", TestBlacklist::AnyDeviceAnyEngine},
       {"LengthsToRanges/0", TestBlacklist::AnyDeviceAnyEngine},
       {"ModuloInt64NoSignFollow/0", TestBlacklist::AnyDeviceAnyEngine},
@@ -22,4 +22,5 @@ std::set<std::string> glow::backendTestBlacklist = {
     "dataParallelStackingTest/0",
     "AvgPoolGradTest/0",
     "intLookupTable/0",
+    "fastTranscendentalsTest/0",
 };
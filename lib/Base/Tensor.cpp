@@ -22,6 +22,9 @@
 #include "llvm/Support/raw_ostream.h"
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <numeric>
+
 using namespace glow;
 
 namespace {
@@ -288,9 +291,164 @@ static bool tryTransposeFastImpl(const Handle<ElemTy> &src,
   return false;
 }
 
+/// Collapses the transpose of \p dims by \p shuffle into the smallest
+/// equivalent one: dims of size 1 are dropped and input dims that stay
+/// adjacent and in order in the output are merged. The collapsed input dims
+/// are stored in \p collapsedDims. \returns the collapsed shuffle.
+static std::vector<unsigned_t>
+collapseTranspose(llvm::ArrayRef<dim_t> dims,
+                  llvm::ArrayRef<unsigned_t> shuffle,
+                  std::vector<dim_t> &collapsedDims) {
+  // \returns true if only dims of size 1 lie between the input dims \p a
+  // and \p b.
+  auto isNextDim = [&](unsigned_t a, unsigned_t b) {
+    if (b <= a) {
+      return false;
+    }
+    for (unsigned_t d = a + 1; d < b; d++) {
+      if (dims[d] != 1) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Runs of consecutive input dims in the output as (first input dim, last
+  // input dim, size), in output order.
+  struct Run {
+    unsigned_t first;
+    unsigned_t last;
+    dim_t size;
+  };
+  std::vector<Run> runs;
+  for (auto d : shuffle) {
+    if (dims[d] == 1) {
+      continue;
+    }
+    if (!runs.empty() && isNextDim(runs.back().last, d)) {
+      runs.back().last = d;
+      runs.back().size *= dims[d];
+      continue;
+    }
+    runs.push_back({d, d, dims[d]});
+  }
+
+  collapsedDims.clear();
+  if (runs.empty()) {
+    collapsedDims.push_back(1);
+    return {0};
+  }
+  std::vector<unsigned_t> order(runs.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](unsigned_t a, unsigned_t b) {
+    return runs[a].first < runs[b].first;
+  });
+  std::vector<unsigned_t> collapsedShuffle(runs.size());
+  for (unsigned_t i = 0, e = order.size(); i < e; i++) {
+    collapsedDims.push_back(runs[order[i]].size);
+    collapsedShuffle[order[i]] = i;
+  }
+  return collapsedShuffle;
+}
+
+/// Computes dest[b][c][r][:] = src[b][r][c][:] for the \p batches x \p rows x
+/// \p cols blocks of \p inner elements of \p src. The matrices are walked in
+/// square tiles that stay in cache, and elements are moved in 8x8 blocks with
+/// constant trip counts, which the compiler keeps in registers.
+template <class ElemTy>
+static void transposeBlockedImpl(const ElemTy *src, ElemTy *dest,
+                                 dim_t batches, dim_t rows, dim_t cols,
+                                 dim_t inner) {
+  constexpr dim_t tileSize = 32;
+  constexpr dim_t blockSize = 8;
+  for (dim_t b = 0; b < batches; b++) {
+    const ElemTy *in = src + b * rows * cols * inner;
+    ElemTy *out = dest + b * rows * cols * inner;
+    for (dim_t r0 = 0; r0 < rows; r0 += tileSize) {
+      dim_t rEnd = std::min(rows, r0 + tileSize);
+      for (dim_t c0 = 0; c0 < cols; c0 += tileSize) {
+        dim_t cEnd = std::min(cols, c0 + tileSize);
+        if (inner != 1) {
+          for (dim_t c = c0; c < cEnd; c++) {
+            for (dim_t r = r0; r < rEnd; r++) {
+              std::copy_n(in + (r * cols + c) * inner, inner,
+                          out + (c * rows + r) * inner);
+            }
+          }
+          continue;
+        }
+        for (dim_t r1 = r0; r1 < rEnd; r1 += blockSize) {
+          for (dim_t c1 = c0; c1 < cEnd; c1 += blockSize) {
+            if (r1 + blockSize <= rEnd && c1 + blockSize <= cEnd) {
+              for (dim_t c = 0; c < blockSize; c++) {
+                for (dim_t r = 0; r < blockSize; r++) {
+                  out[(c1 + c) * rows + r1 + r] = in[(r1 + r) * cols + c1 + c];
+                }
+              }
+              continue;
+            }
+            for (dim_t c = c1; c < std::min(cEnd, c1 + blockSize); c++) {
+              for (dim_t r = r1; r < std::min(rEnd, r1 + blockSize); r++) {
+                out[c * rows + r] = in[r * cols + c];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/// Transposes the common permutations of unpadded tensors with blocked
+/// kernels: 2-D and batched 2-D transposes such as NCHW <-> NHWC, and swaps of
+/// two middle dims such as 0213, after collapsing the permutation. \returns
+/// true if \p src was transposed into \p dest.
+template <class ElemTy>
+static bool tryTransposeBlockedImpl(const Handle<ElemTy> &src,
+                                    Handle<ElemTy> &dest,
+                                    llvm::ArrayRef<unsigned_t> shuffle) {
+  if (src.size() == 0 || src.size() != src.actualSize() ||
+      dest.size() != dest.actualSize()) {
+    return false;
+  }
+  std::vector<dim_t> dims;
+  auto collapsed = collapseTranspose(src.dims(), shuffle, dims);
+  const ElemTy *in = &src.raw(0);
+  ElemTy *out = &dest.raw(0);
+  switch (collapsed.size()) {
+  case 1:
+    std::copy_n(in, dims[0], out);
+    return true;
+  case 2:
+    transposeBlockedImpl(in, out, 1, dims[0], dims[1], 1);
+    return true;
+  case 3:
+    if (collapsed[0] == 0) {
+      transposeBlockedImpl(in, out, dims[0], dims[1], dims[2], 1);
+      return true;
+    }
+    if (collapsed[2] == 2) {
+      transposeBlockedImpl(in, out, 1, dims[0], dims[1], dims[2]);
+      return true;
+    }
+    return false;
+  case 4:
+    if (collapsed[0] == 0 && collapsed[1] == 2 && collapsed[2] == 1) {
+      transposeBlockedImpl(in, out, dims[0], dims[1], dims[2], dims[3]);
+      return true;
+    }
+    return false;
+  default:
+    return false;
+  }
+}
+
 template <class ElemTy>
 static void transposeSelectImpl(const Handle<ElemTy> &src, Handle<ElemTy> &dest,
                                 llvm::ArrayRef<unsigned_t> shuffle) {
+  if (tryTransposeBlockedImpl(src, dest, shuffle)) {
+    return;
+  }
   bool transposeOccurred = tryTransposeFastImpl(src, dest, shuffle);
   if (!transposeOccurred) {
     dim_t srcCoor[max_tensor_dimensions];
@@ -22,6 +22,11 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <set>
+
 #define DEBUG_TYPE "memory-allocator"
 
 using namespace glow;
@@ -184,3 +189,188 @@ void MemoryAllocator::setHandle(uint64_t ptr, uint64_t size, Handle handle) {
   addrToHandle_[ptr] = handle;
   handleToAllocInfo_.insert(std::make_pair(handle, Segment(ptr, ptr + size)));
 }
+
+namespace {
+/// A buffer packed by MemoryAllocator::allocateAll, which is live in the
+/// half-open interval [begin, end) of positions in the schedule.
+struct LiveBuffer {
+  MemoryAllocator::Handle handle;
+  /// The requested size of the buffer.
+  uint64_t size;
+  /// The size of the buffer rounded up to the alignment of the allocator.
+  uint64_t alignedSize;
+  size_t begin;
+  size_t end;
+  /// The largest total size of the buffers live at some point of the live
+  /// interval of this buffer, including this one.
+  uint64_t breadth{0};
+
+  LiveBuffer(MemoryAllocator::Handle handle, uint64_t size,
+             uint64_t alignedSize, size_t begin, size_t end)
+      : handle(handle), size(size), alignedSize(alignedSize), begin(begin),
+        end(end) {}
+};
+
+/// A segment of memory occupied by a placed buffer during the half-open
+/// interval [liveBegin, liveEnd) of positions in the schedule.
+struct PlacedSegment {
+  uint64_t begin;
+  uint64_t end;
+  size_t liveBegin;
+  size_t liveEnd;
+
+  bool operator<(const PlacedSegment &other) const {
+    return begin < other.begin;
+  }
+};
+
+/// Places \p buffers in the order given by \p order, each at the lowest
+/// address where it overlaps neither the segments \p fixed nor the buffers
+/// placed before it whose live interval overlaps its own. The addresses are
+/// stored in \p offsets. \returns the end of the highest placed buffer.
+uint64_t placeBuffers(const std::vector<LiveBuffer> &buffers,
+                      const std::vector<size_t> &order,
+                      const std::list<Segment> &fixed,
+                      std::vector<uint64_t> &offsets) {
+  offsets.assign(buffers.size(), 0);
+  // The occupied segments ordered by address, so that the first fit search
+  // stops at the first gap large enough instead of visiting every placed
+  // buffer. The fixed segments are live at every position.
+  std::multiset<PlacedSegment> placed;
+  for (const Segment &S : fixed) {
+    placed.insert({S.begin_, S.end_, 0, std::numeric_limits<size_t>::max()});
+  }
+  uint64_t peak = 0;
+  for (size_t idx : order) {
+    const LiveBuffer &B = buffers[idx];
+    // Segments which are not live at the same time as B may overlap it and
+    // each other.
+    uint64_t addr = 0;
+    for (const PlacedSegment &S : placed) {
+      if (S.begin >= addr + B.alignedSize) {
+        break;
+      }
+      if (S.liveBegin < B.end && B.begin < S.liveEnd) {
+        addr = std::max(addr, S.end);
+      }
+    }
+    offsets[idx] = addr;
+    peak = std::max(peak, addr + B.alignedSize);
+    placed.insert({addr, addr + B.alignedSize, B.begin, B.end});
+  }
+  return peak;
+}
+
+/// \returns the name of \p strategy.
+const char *getStrategyName(AllocationStrategy strategy) {
+  switch (strategy) {
+  case AllocationStrategy::LiveIntervalOrder:
+    return "LiveIntervalOrder";
+  case AllocationStrategy::SizeFirst:
+    return "SizeFirst";
+  case AllocationStrategy::BreadthFirst:
+    return "BreadthFirst";
+  }
+  llvm_unreachable("Unknown allocation strategy");
+}
+} // namespace
+
+uint64_t
+MemoryAllocator::allocateAll(const std::vector<Allocation> &allocList) {
+  // Compute the live interval of every buffer.
+  const size_t numPositions = allocList.size();
+  std::vector<LiveBuffer> buffers;
+  std::unordered_map<Handle, size_t> handleToBuffer;
+  for (size_t pos = 0; pos < numPositions; pos++) {
+    const Allocation &A = allocList[pos];
+    if (A.alloc) {
+      assert(!handleToBuffer.count(A.handle) && "Buffer allocated twice");
+      handleToBuffer[A.handle] = buffers.size();
+      buffers.emplace_back(A.handle, A.size, alignedSize(A.size, alignment_),
+                           pos, numPositions);
+      continue;
+    }
+    auto it = handleToBuffer.find(A.handle);
+    assert(it != handleToBuffer.end() && "Unknown buffer to deallocate");
+    buffers[it->second].end = pos;
+  }
+
+  // Compute the total size of the buffers live at each position, and from it
+  // the breadth of every buffer and the lower bound of the peak.
+  std::vector<uint64_t> liveSize(numPositions + 1, 0);
+  for (const LiveBuffer &B : buffers) {
+    liveSize[B.begin] += B.alignedSize;
+    liveSize[B.end] -= B.alignedSize;
+  }
+  std::partial_sum(liveSize.begin(), liveSize.end(), liveSize.begin());
+  for (LiveBuffer &B : buffers) {
+    B.breadth = *std::max_element(liveSize.begin() + B.begin,
+                                  liveSize.begin() + B.end);
+  }
+  uint64_t fixedSize = 0;
+  for (const Segment &S : allocations_) {
+    fixedSize += S.size();
+  }
+  memoryLowerBound_ =
+      fixedSize + *std::max_element(liveSize.begin(), liveSize.end());
+
+  // Pack the buffers with every strategy and keep the smallest peak. Ties are
+  // broken in favor of the live interval order, which matches the online
+  // first-fit allocation.
+  const AllocationStrategy strategies[] = {
+      AllocationStrategy::LiveIntervalOrder, AllocationStrategy::SizeFirst,
+      AllocationStrategy::BreadthFirst};
+  uint64_t bestPeak = npos;
+  std::vector<uint64_t> bestOffsets;
+  std::vector<uint64_t> offsets;
+  std::vector<size_t> order(buffers.size());
+  for (AllocationStrategy strategy : strategies) {
+    std::iota(order.begin(), order.end(), 0);
+    switch (strategy) {
+    case AllocationStrategy::LiveIntervalOrder:
+      // Buffers are already ordered by the start of their live interval.
+      break;
+    case AllocationStrategy::SizeFirst:
+      std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return buffers[a].alignedSize > buffers[b].alignedSize;
+      });
+      break;
+    case AllocationStrategy::BreadthFirst:
+      std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (buffers[a].breadth != buffers[b].breadth) {
+          return buffers[a].breadth > buffers[b].breadth;
+        }
+        return buffers[a].alignedSize > buffers[b].alignedSize;
+      });
+      break;
+    }
+    uint64_t peak = placeBuffers(buffers, order, allocations_, offsets);
+    DEBUG_GLOW(llvm::dbgs() << "Packed " << buffers.size() << " buffers of '"
+                            << name_ << "' with " << getStrategyName(strategy)
+                            << ": peak " << peak << "\n");
+    if (peak < bestPeak) {
+      bestPeak = peak;
+      strategy_ = strategy;
+      bestOffsets.swap(offsets);
+    }
+  }
+  DEBUG_GLOW(llvm::dbgs() << "Packed " << buffers.size() << " buffers of '"
+                          << name_ << "' with " << getStrategyName(strategy_)
+                          << ": peak "
+                          << std::max(bestPeak, maxMemoryAllocated_)
+                          << ", lower bound " << memoryLowerBound_ << "\n");
+
+  // Check that we are not allocating memory beyond the pool size.
+  if (poolSize_ && bestPeak > poolSize_) {
+    return npos;
+  }
+
+  for (size_t i = 0, e = buffers.size(); i < e; i++) {
+    const LiveBuffer &B = buffers[i];
+    handleToAllocInfo_.erase(B.handle);
+    handleToAllocInfo_.emplace(
+        B.handle, Segment(bestOffsets[i], bestOffsets[i] + B.size));
+  }
+  maxMemoryAllocated_ = std::max(maxMemoryAllocated_, bestPeak);
+  return bestPeak;
+}
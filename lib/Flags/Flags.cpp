@@ -18,6 +18,7 @@
 
 namespace glow {
 bool GlowEnableLoadBalancedPartitioning = false;
+std::string GlowPartitionerCostProfile = "";
 bool GlowLogPartition = false;
 bool GlowDumpPartition = false;
 bool GlowDumpCompilationLog = false;
@@ -342,6 +343,15 @@ DEFINE_validator(glow_partitioner_enable_load_balance,
                    return true;
                  });
 
+DEFINE_string(glow_partitioner_cost_profile, "",
+              "File with measured per-node execution times used by the "
+              "partitioner in place of its roofline estimates");
+DEFINE_validator(glow_partitioner_cost_profile,
+                 [](const char * /* unused */, const std::string &value) {
+                   glow::GlowPartitionerCostProfile = value;
+                   return true;
+                 });
+
 DEFINE_bool(glow_save_onnxifi_model, false,
             "Package the glow function and weights right before lowering");
 DEFINE_validator(glow_save_onnxifi_model,
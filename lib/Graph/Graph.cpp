@@ -155,6 +155,21 @@ void Module::clearFunctions() {
   }
 }
 
+void NodeChangeTracker::getChangedSince(uint64_t epoch,
+                                        std::vector<Node *> &nodes) const {
+  std::vector<std::pair<uint64_t, Node *>> changed;
+  for (const auto &pair : changedNodes_) {
+    if (pair.second > epoch) {
+      changed.emplace_back(pair.second, const_cast<Node *>(pair.first));
+    }
+  }
+  std::sort(changed.begin(), changed.end());
+  nodes.reserve(nodes.size() + changed.size());
+  for (const auto &pair : changed) {
+    nodes.push_back(pair.second);
+  }
+}
+
 void Function::clear() {
   nodes_.clear();
   uniqueNodeNames_.clear();
@@ -5204,6 +5219,13 @@ void Function::eraseNode(NodesList::iterator I) {
   // Log node deletion.
   logCtx_->logNodeDeletion(*I);
 
+  // The inputs of the erased node lose a user.
+  if (changeTracker_) {
+    for (unsigned i = 0, e = I->getNumInputs(); i < e; i++) {
+      markNodeChanged(I->getNthInput(i).getNode());
+    }
+  }
+
   nodes_.erase(I);
 }
 
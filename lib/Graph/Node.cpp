@@ -40,6 +40,19 @@ void Node::setType(unsigned idx, TypeRef ty) {
 void Node::setTypeUnsafe(unsigned idx, TypeRef ty) {
   assert(idx < getNumResults() && "Result number does not exist.");
   types_[idx] = ty;
+  markChanged();
+}
+
+void Node::markChanged() {
+  if (getParent()) {
+    getParent()->markNodeChanged(this);
+  }
+  for (auto &U : getUsers()) {
+    Node *user = U.getUser();
+    if (user->getParent()) {
+      user->getParent()->markNodeChanged(user);
+    }
+  }
 }
 
 ElemKind Node::getElementType(unsigned resNo) const {
@@ -171,6 +184,9 @@ void Node::setNthInput(unsigned idx, NodeValue val) {
     if (getParent()) {                                                         \
       getParent()->getLogContext()->logNodeInputChange(                        \
           *this, this->getNthInput(idx), val);                                 \
+      getParent()->markNodeChanged(this);                                      \
+      getParent()->markNodeChanged(this->getNthInput(idx).getNode());          \
+      getParent()->markNodeChanged(val.getNode());                             \
     }                                                                          \
     return static_cast<CLASS *>(this)->setNthInput(idx, val);
 #include "glow/AutoGenNodes.def"
@@ -406,6 +422,9 @@ void llvm::ilist_traits<Node>::addNodeToList(Node *node) {
 void llvm::ilist_traits<Node>::removeNodeFromList(Node *node) {
   // When an instruction is removed from a function, clear the parent pointer.
   assert(node->getParent() && "Not in a list!");
+  if (auto *tracker = node->getParent()->getChangeTracker()) {
+    tracker->forget(node);
+  }
   node->setParent(nullptr);
 }
 
@@ -418,6 +437,11 @@ void llvm::ilist_traits<Node>::transferNodesFromList(
     return;
 
   // Update the parent fields in the nodes.
-  for (; first != last; ++first)
+  for (; first != last; ++first) {
+    if (auto *tracker = first->getParent()->getChangeTracker()) {
+      tracker->forget(&*first);
+    }
     first->setParent(ThisParent);
+    ThisParent->markNodeChanged(&*first);
+  }
 }
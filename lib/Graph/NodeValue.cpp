@@ -81,6 +81,14 @@ void NodeValue::typeUnsafeReplaceAllUsesOfWith(NodeValue v, const Function *F,
       userF->getLogContext()->logNodeInputChange(*(U.getUser()), *this, v);
     }
 
+    // The user gets a new input, while both the old and the new input get a
+    // different set of users.
+    if (userF) {
+      userF->markNodeChanged(U.getUser());
+      userF->markNodeChanged(getNode());
+      userF->markNodeChanged(v.getNode());
+    }
+
     site->setOperand(v.getNode(), v.getResNo());
   }
 }
@@ -956,12 +956,17 @@ bool BatchMatMulNode::verify() const {
                                RHS.dims().size(), size_t(3), this);
   isValid &= expectCompareTrue("Result must be 3 dimensional.",
                                dest.dims().size(), size_t(3), this);
-  isValid &= expectCompareTrue("LHS and RHS inputs must have same batch size.",
-                               LHS.dims()[0], RHS.dims()[0], this);
+  // One of the inputs may have a batch size of 1, in which case it is
+  // broadcasted over the batch of the other input.
+  const dim_t numBatches = std::max(LHS.dims()[0], RHS.dims()[0]);
+  if (LHS.dims()[0] != 1 && RHS.dims()[0] != 1) {
+    isValid &=
+        expectCompareTrue("LHS and RHS inputs must have same batch size.",
+                          LHS.dims()[0], RHS.dims()[0], this);
+  }
   isValid &= expectCompareTrue("Result must have same batch size as inputs.",
-                               LHS.dims()[0], dest.dims()[0], this);
+                               numBatches, dest.dims()[0], this);
 
-  const dim_t numBatches = LHS.dims()[0];
   const dim_t N = LHS.dims()[1];
   const dim_t M = LHS.dims()[2];
   const dim_t P = RHS.dims()[2];
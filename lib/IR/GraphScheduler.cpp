@@ -29,24 +29,54 @@ llvm::cl::opt<SchedulerKind> graphScheduler(
                                 "Use ChildMemSizeBased"),
                      clEnumValN(SchedulerKind::TopologicalSortBased,
                                 "topological-sort-based",
-                                "Use TopologicalSortBased")),
+                                "Use TopologicalSortBased"),
+                     clEnumValN(SchedulerKind::MemoryAware, "memory-aware",
+                                "Use MemoryAware")),
     llvm::cl::init(SchedulerKind::ChildMemSizeBased),
     llvm::cl::cat(graphSchedulerCat));
+
+llvm::cl::opt<unsigned> schedulerBeamWidth(
+    "scheduler-beam-width",
+    llvm::cl::desc("Number of partial schedules kept by the memory-aware "
+                   "scheduler"),
+    llvm::cl::Optional, llvm::cl::cat(graphSchedulerCat));
+
+llvm::cl::opt<unsigned> schedulerSearchBudget(
+    "scheduler-search-budget",
+    llvm::cl::desc("Maximum number of node visits of the memory-aware "
+                   "scheduler, after which it turns greedy and skips packing "
+                   "its schedules (0 means no limit)"),
+    llvm::cl::Optional, llvm::cl::cat(graphSchedulerCat));
 } // namespace
 
 namespace glow {
 Scheduler *createScheduler(SchedulerKind schedulerKind, Function &G,
-                           NodesPtrList &scheduled) {
+                           NodesPtrList &scheduled,
+                           const SchedulerOptions &opts) {
   switch (schedulerKind) {
   case SchedulerKind::ChildMemSizeBased:
     return new ChildMemSizeBasedScheduler(G, scheduled);
   case SchedulerKind::TopologicalSortBased:
     return new TopologicalSortBasedScheduler(G, scheduled);
+  case SchedulerKind::MemoryAware:
+    return new MemoryAwareScheduler(G, scheduled, opts);
   }
   llvm_unreachable("unreachable");
 }
 
-void IRFunction::scheduleGraph(NodesPtrList &Schedule) {
+void IRFunction::scheduleGraph(NodesPtrList &Schedule,
+                               const SchedulerOptions &opts) {
+  // Options given on the command line override the ones of the backend.
+  SchedulerOptions schedOpts = opts;
+  if (graphScheduler.getNumOccurrences()) {
+    schedOpts.kind = graphScheduler;
+  }
+  if (schedulerBeamWidth.getNumOccurrences()) {
+    schedOpts.beamWidth = schedulerBeamWidth;
+  }
+  if (schedulerSearchBudget.getNumOccurrences()) {
+    schedOpts.searchBudget = schedulerSearchBudget;
+  }
   Schedule.clear();
   auto constants = G_->findConstants();
   auto placeholders = G_->findPlaceholders();
@@ -65,7 +95,7 @@ void IRFunction::scheduleGraph(NodesPtrList &Schedule) {
   (void)numVars;
   (void)numPlaceholders;
   std::unique_ptr<Scheduler> scheduler{
-      createScheduler(graphScheduler, *G_, Schedule)};
+      createScheduler(schedOpts.kind, *G_, Schedule, schedOpts)};
   scheduler->schedule();
   assert(scheduler->getSchedule().size() ==
              G_->getNodes().size() + numPlaceholders + numVars &&
@@ -22,14 +22,6 @@
 
 namespace glow {
 
-/// Specifies the kind of graph scheduling to perform.
-enum class SchedulerKind {
-  /// This is a heuristics that tries to minimize memory usage.
-  ChildMemSizeBased,
-  /// Performs a standard topological search
-  TopologicalSortBased,
-};
-
 class Scheduler {
 protected:
   /// Graph being processed.
@@ -104,8 +96,38 @@ public:
   void schedule() override;
 };
 
+/// This scheduler searches over the topological orders of the graph with a
+/// beam search. Partial schedules are ranked by their peak live activation
+/// size, and ties are broken by the producer-consumer reuse distance, i.e. the
+/// number of bytes produced between a node and its consumers. The surviving
+/// complete schedules and the schedules of the other schedulers are then
+/// ranked the same way using the packed peak computed by
+/// MemoryAllocator::allocateAll, so the result is never worse than
+/// ChildMemSizeBasedScheduler under that metric. If the search budget does not
+/// cover the packing, the live peak is used instead.
+class MemoryAwareScheduler : public Scheduler {
+  /// Options of the search.
+  SchedulerOptions opts_;
+
+public:
+  MemoryAwareScheduler(Function &G, NodesPtrList &Schedule,
+                       const SchedulerOptions &opts = SchedulerOptions())
+      : Scheduler(G, Schedule), opts_(opts) {}
+
+  ~MemoryAwareScheduler() override = default;
+
+  void schedule() override;
+
+  /// \returns the peak activation memory needed to execute the nodes of \p G
+  /// in the order given by \p schedule once the results of the nodes are
+  /// packed by MemoryAllocator::allocateAll. Storage nodes are ignored.
+  static uint64_t getPackedPeakMemory(Function &G,
+                                      const NodesPtrList &schedule);
+};
+
 Scheduler *createScheduler(SchedulerKind schedulerKind, Function &G,
-                           NodesPtrList &scheduled);
+                           NodesPtrList &scheduled,
+                           const SchedulerOptions &opts = SchedulerOptions());
 
 } // namespace glow
 
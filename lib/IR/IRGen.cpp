@@ -526,7 +526,7 @@ void IRFunction::generateIR(const Backend &B) {
   assert(G_->verify(&B) && "Invalid function");
   // Schedule the nodes.
   NodesPtrList ScheduledNodes;
-  scheduleGraph(ScheduledNodes);
+  scheduleGraph(ScheduledNodes, B.getSchedulerOptions());
   IRGenVisitor irgen(this, B);
 
   for (auto &N : ScheduledNodes) {
@@ -0,0 +1,473 @@
+/**
+ * Copyright (c) Glow Contributors. See CONTRIBUTORS file.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GraphScheduler.h"
+
+#include "glow/CodeGen/MemoryAllocator.h"
+#include "glow/Support/Debug.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+
+#define DEBUG_TYPE "graph-scheduler"
+
+using llvm::isa;
+
+namespace glow {
+namespace {
+
+/// Dependence graph of the nodes of a Function that need to be scheduled.
+/// Nodes are identified by their index in \ref nodes.
+struct SchedulingGraph {
+  /// The nodes to schedule.
+  std::vector<Node *> nodes;
+  /// Maps a node to its index in \ref nodes.
+  llvm::DenseMap<const Node *, unsigned> index;
+  /// Number of bytes needed to hold the results of each node.
+  std::vector<uint64_t> resultBytes;
+  /// Distinct nodes whose results are read by each node.
+  std::vector<llvm::SmallVector<unsigned, 4>> producers;
+  /// Number of distinct nodes reading the results of each node.
+  std::vector<unsigned> numConsumers;
+  /// Distinct nodes which can only be scheduled after each node.
+  std::vector<llvm::SmallVector<unsigned, 4>> successors;
+  /// Number of distinct nodes which need to be scheduled before each node.
+  std::vector<unsigned> numPredecessors;
+  /// Random keys used to hash the set of scheduled nodes.
+  std::vector<uint64_t> keys;
+
+  explicit SchedulingGraph(Function &G) {
+    for (auto &N : G.getNodes()) {
+      if (isa<Storage>(&N)) {
+        continue;
+      }
+      index[&N] = nodes.size();
+      nodes.push_back(&N);
+    }
+    size_t numNodes = nodes.size();
+    resultBytes.resize(numNodes);
+    producers.resize(numNodes);
+    numConsumers.resize(numNodes);
+    successors.resize(numNodes);
+    numPredecessors.resize(numNodes);
+    keys.resize(numNodes);
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (unsigned i = 0; i < numNodes; ++i) {
+      Node *N = nodes[i];
+      for (size_t idx = 0, e = N->getNumResults(); idx < e; ++idx) {
+        resultBytes[i] += N->getType(idx)->getSizeInBytes();
+      }
+      // splitmix64.
+      uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      keys[i] = z ^ (z >> 31);
+
+      llvm::SmallVector<unsigned, 4> preds;
+      auto addDependency = [&](const Node *dep, bool readsResult) {
+        auto it = index.find(dep);
+        if (it == index.end() || it->second == i) {
+          return;
+        }
+        unsigned depIdx = it->second;
+        if (readsResult && std::find(producers[i].begin(), producers[i].end(),
+                                     depIdx) == producers[i].end()) {
+          producers[i].push_back(depIdx);
+          numConsumers[depIdx]++;
+        }
+        if (std::find(preds.begin(), preds.end(), depIdx) == preds.end()) {
+          preds.push_back(depIdx);
+        }
+      };
+
+      for (unsigned idx = 0, e = N->getNumInputs(); idx < e; ++idx) {
+        addDependency(N->getNthInput(idx).getNode(), /* readsResult */ true);
+      }
+      if (N->hasPredicate()) {
+        addDependency(N->getPredicate().getNode(), /* readsResult */ true);
+      }
+      // A node mutating one of its inputs has to run after the other users of
+      // the mutated value, see ChildMemSizeBasedScheduler.
+      for (unsigned idx = 0, e = N->getNumInputs(); idx < e; ++idx) {
+        if (!N->isOverwrittenNthInput(idx)) {
+          continue;
+        }
+        for (NodeUse &use : N->getNthInput(idx).getNode()->getUsers()) {
+          Node *user = use.getUser();
+          if (user != N && user->getParent() == &G) {
+            addDependency(user, /* readsResult */ false);
+          }
+        }
+      }
+
+      numPredecessors[i] = preds.size();
+      for (unsigned pred : preds) {
+        successors[pred].push_back(i);
+      }
+    }
+  }
+
+  /// \returns true if the dependencies of the graph admit a schedule.
+  bool isAcyclic() const {
+    std::vector<unsigned> remaining = numPredecessors;
+    std::vector<unsigned> worklist;
+    for (unsigned i = 0, e = nodes.size(); i < e; ++i) {
+      if (!remaining[i]) {
+        worklist.push_back(i);
+      }
+    }
+    size_t numVisited = 0;
+    while (!worklist.empty()) {
+      unsigned i = worklist.back();
+      worklist.pop_back();
+      ++numVisited;
+      for (unsigned succ : successors[i]) {
+        if (!--remaining[succ]) {
+          worklist.push_back(succ);
+        }
+      }
+    }
+    return numVisited == nodes.size();
+  }
+};
+
+/// A partially scheduled graph kept in the beam.
+struct PartialSchedule {
+  /// Scheduled nodes, in order.
+  std::vector<unsigned> order;
+  /// Nodes whose dependencies are all scheduled.
+  std::vector<unsigned> ready;
+  /// Number of unscheduled dependencies of each node.
+  std::vector<unsigned> remainingPreds;
+  /// Number of unscheduled consumers of the results of each node.
+  std::vector<unsigned> remainingConsumers;
+  /// Value of \ref bytesProduced right after each node got scheduled.
+  std::vector<uint64_t> producedAt;
+  /// Hash of the set of scheduled nodes.
+  uint64_t signature{0};
+  /// Size of the results which are still to be consumed.
+  uint64_t liveBytes{0};
+  /// Largest live size seen so far.
+  uint64_t peakBytes{0};
+  /// Total size of the results produced so far.
+  uint64_t bytesProduced{0};
+  /// Sum of the reuse distances of the edges consumed so far.
+  uint64_t reuseDistance{0};
+  /// Number of edges consumed so far.
+  uint64_t numReuses{0};
+};
+
+/// A candidate extension of a PartialSchedule by one ready node.
+struct Candidate {
+  /// Index of the extended schedule in the beam.
+  unsigned parent;
+  /// Position of the scheduled node in the ready list of the parent.
+  unsigned readyPos;
+  /// Index of the scheduled node.
+  unsigned node;
+  uint64_t signature;
+  uint64_t liveBytes;
+  uint64_t peakBytes;
+  uint64_t reuseDistance;
+  uint64_t numReuses;
+};
+
+/// \returns true if a schedule with peak memory \p LPeak and \p LNumReuses
+/// consumed edges of total reuse distance \p LDistance is better than one
+/// with \p RPeak, \p RDistance and \p RNumReuses. The peak decides, and the
+/// mean reuse distance only breaks ties.
+bool isBetterSchedule(uint64_t LPeak, uint64_t LDistance, uint64_t LNumReuses,
+                      uint64_t RPeak, uint64_t RDistance,
+                      uint64_t RNumReuses) {
+  if (LPeak != RPeak) {
+    return LPeak < RPeak;
+  }
+  double LMean = LNumReuses ? double(LDistance) / double(LNumReuses) : 0.0;
+  double RMean = RNumReuses ? double(RDistance) / double(RNumReuses) : 0.0;
+  return LMean < RMean;
+}
+
+/// Computes the peak memory and the reuse distance of the complete schedule
+/// \p order of \p graph. The peak is the one of the results packed by
+/// MemoryAllocator::allocateAll if \p pack, or the largest live size
+/// otherwise.
+void evaluateSchedule(const SchedulingGraph &graph,
+                      llvm::ArrayRef<unsigned> order, bool pack,
+                      uint64_t &peak, uint64_t &reuseDistance,
+                      uint64_t &numReuses) {
+  std::vector<unsigned> remainingConsumers = graph.numConsumers;
+  std::vector<uint64_t> producedAt(graph.nodes.size());
+  std::vector<Allocation> allocList;
+  uint64_t bytesProduced = 0;
+  uint64_t liveBytes = 0;
+  peak = 0;
+  reuseDistance = 0;
+  numReuses = 0;
+  for (unsigned i : order) {
+    uint64_t size = graph.resultBytes[i];
+    if (size && pack) {
+      allocList.emplace_back(graph.nodes[i], /* alloc */ true, size);
+    }
+    liveBytes += size;
+    peak = std::max(peak, liveBytes);
+    // Inputs stay alive while the node executes.
+    for (unsigned p : graph.producers[i]) {
+      reuseDistance += bytesProduced - producedAt[p];
+      ++numReuses;
+      if (!--remainingConsumers[p]) {
+        liveBytes -= graph.resultBytes[p];
+        if (graph.resultBytes[p] && pack) {
+          allocList.emplace_back(graph.nodes[p], /* alloc */ false);
+        }
+      }
+    }
+    if (!graph.numConsumers[i]) {
+      liveBytes -= size;
+      if (size && pack) {
+        allocList.emplace_back(graph.nodes[i], /* alloc */ false);
+      }
+    }
+    bytesProduced += size;
+    producedAt[i] = bytesProduced;
+  }
+  if (pack) {
+    MemoryAllocator allocator("scheduler", /* poolSize */ 0);
+    peak = allocator.allocateAll(allocList);
+  }
+}
+
+/// \returns the indices in \p graph of the non-storage nodes of \p schedule.
+std::vector<unsigned> getOrder(const SchedulingGraph &graph,
+                               const NodesPtrList &schedule) {
+  std::vector<unsigned> order;
+  order.reserve(graph.nodes.size());
+  for (const Node *N : schedule) {
+    auto it = graph.index.find(N);
+    if (it != graph.index.end()) {
+      order.push_back(it->second);
+    }
+  }
+  return order;
+}
+
+/// Runs a beam search of width \p opts.beamWidth over the topological orders
+/// of \p graph, adding the work it does to \p work. \returns the complete
+/// schedules left in the beam.
+std::vector<PartialSchedule> beamSearch(const SchedulingGraph &graph,
+                                        const SchedulerOptions &opts,
+                                        size_t &work) {
+  size_t numNodes = graph.nodes.size();
+  std::vector<PartialSchedule> beam(1);
+  PartialSchedule &init = beam.front();
+  init.order.reserve(numNodes);
+  init.remainingPreds = graph.numPredecessors;
+  init.remainingConsumers = graph.numConsumers;
+  init.producedAt.resize(numNodes);
+  for (unsigned i = 0; i < numNodes; ++i) {
+    if (!graph.numPredecessors[i]) {
+      init.ready.push_back(i);
+    }
+  }
+
+  std::vector<Candidate> candidates;
+  for (size_t step = 0; step < numNodes; ++step) {
+    // Once the budget is exhausted only extend the best schedule greedily,
+    // which needs no copies of the schedules.
+    size_t width = std::max(opts.beamWidth, 1u);
+    if (opts.searchBudget && work >= opts.searchBudget) {
+      width = 1;
+    }
+
+    candidates.clear();
+    for (unsigned s = 0, e = beam.size(); s < e; ++s) {
+      const PartialSchedule &PS = beam[s];
+      for (unsigned pos = 0, pe = PS.ready.size(); pos < pe; ++pos) {
+        unsigned n = PS.ready[pos];
+        Candidate C;
+        C.parent = s;
+        C.readyPos = pos;
+        C.node = n;
+        C.signature = PS.signature ^ graph.keys[n];
+        C.liveBytes = PS.liveBytes + graph.resultBytes[n];
+        C.peakBytes = std::max(PS.peakBytes, C.liveBytes);
+        C.reuseDistance = PS.reuseDistance;
+        C.numReuses = PS.numReuses + graph.producers[n].size();
+        for (unsigned p : graph.producers[n]) {
+          C.reuseDistance += PS.bytesProduced - PS.producedAt[p];
+          if (PS.remainingConsumers[p] == 1) {
+            C.liveBytes -= graph.resultBytes[p];
+          }
+        }
+        if (!graph.numConsumers[n]) {
+          C.liveBytes -= graph.resultBytes[n];
+        }
+        candidates.push_back(C);
+      }
+    }
+    work += candidates.size();
+    assert(!candidates.empty() && "The dependence graph has a cycle");
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate &LHS, const Candidate &RHS) {
+                if (isBetterSchedule(LHS.peakBytes, LHS.reuseDistance,
+                                     LHS.numReuses, RHS.peakBytes,
+                                     RHS.reuseDistance, RHS.numReuses)) {
+                  return true;
+                }
+                if (isBetterSchedule(RHS.peakBytes, RHS.reuseDistance,
+                                     RHS.numReuses, LHS.peakBytes,
+                                     LHS.reuseDistance, LHS.numReuses)) {
+                  return false;
+                }
+                if (LHS.liveBytes != RHS.liveBytes) {
+                  return LHS.liveBytes < RHS.liveBytes;
+                }
+                if (LHS.parent != RHS.parent) {
+                  return LHS.parent < RHS.parent;
+                }
+                return LHS.node < RHS.node;
+              });
+
+    // Keep the best candidates, skipping the ones which schedule the same set
+    // of nodes as a better candidate.
+    llvm::SmallVector<const Candidate *, 8> selected;
+    for (const Candidate &C : candidates) {
+      if (selected.size() == width) {
+        break;
+      }
+      bool isDuplicate = false;
+      for (const Candidate *S : selected) {
+        isDuplicate |= S->signature == C.signature;
+      }
+      if (!isDuplicate) {
+        selected.push_back(&C);
+      }
+    }
+
+    std::vector<unsigned> numUses(beam.size());
+    for (const Candidate *C : selected) {
+      numUses[C->parent]++;
+    }
+    std::vector<PartialSchedule> nextBeam;
+    nextBeam.reserve(selected.size());
+    for (const Candidate *C : selected) {
+      // The last extension of a schedule can take over its state. The others
+      // copy it, which costs a visit of every node.
+      if (--numUses[C->parent]) {
+        nextBeam.push_back(beam[C->parent]);
+        work += numNodes;
+      } else {
+        nextBeam.push_back(std::move(beam[C->parent]));
+      }
+      PartialSchedule &PS = nextBeam.back();
+      unsigned n = C->node;
+      PS.order.push_back(n);
+      PS.ready[C->readyPos] = PS.ready.back();
+      PS.ready.pop_back();
+      for (unsigned p : graph.producers[n]) {
+        PS.remainingConsumers[p]--;
+      }
+      for (unsigned succ : graph.successors[n]) {
+        if (!--PS.remainingPreds[succ]) {
+          PS.ready.push_back(succ);
+        }
+      }
+      PS.signature = C->signature;
+      PS.liveBytes = C->liveBytes;
+      PS.peakBytes = C->peakBytes;
+      PS.reuseDistance = C->reuseDistance;
+      PS.numReuses = C->numReuses;
+      PS.bytesProduced += graph.resultBytes[n];
+      PS.producedAt[n] = PS.bytesProduced;
+    }
+    beam = std::move(nextBeam);
+  }
+
+  DEBUG_GLOW(llvm::dbgs() << "Memory-aware scheduler did " << work
+                          << " units of work for " << numNodes << " nodes\n");
+  return beam;
+}
+
+} // namespace
+
+uint64_t MemoryAwareScheduler::getPackedPeakMemory(
+    Function &G, const NodesPtrList &schedule) {
+  SchedulingGraph graph(G);
+  uint64_t packedPeak, reuseDistance, numReuses;
+  evaluateSchedule(graph, getOrder(graph, schedule), /* pack */ true,
+                   packedPeak, reuseDistance, numReuses);
+  return packedPeak;
+}
+
+void MemoryAwareScheduler::schedule() {
+  SchedulingGraph graph(G_);
+
+  // The existing schedulers are always candidates, which makes sure the result
+  // is never worse than theirs. The first one wins ties.
+  std::vector<std::vector<unsigned>> orders;
+  {
+    NodesPtrList baseline(scheduled_);
+    ChildMemSizeBasedScheduler(G_, baseline).schedule();
+    orders.push_back(getOrder(graph, baseline));
+  }
+  {
+    NodesPtrList baseline(scheduled_);
+    TopologicalSortBasedScheduler(G_, baseline).schedule();
+    orders.push_back(getOrder(graph, baseline));
+  }
+  // Memory dependencies which cannot all be honored are left to the
+  // ChildMemSizeBasedScheduler.
+  size_t work = 0;
+  if (graph.isAcyclic()) {
+    for (auto &PS : beamSearch(graph, opts_, work)) {
+      orders.push_back(std::move(PS.order));
+    }
+  }
+
+  // Packing a schedule is quadratic in the number of nodes. If the budget does
+  // not cover packing them all, every schedule is compared by its live peak.
+  size_t numNodes = graph.nodes.size();
+  bool pack = !opts_.searchBudget ||
+              work + orders.size() * numNodes * numNodes <= opts_.searchBudget;
+  size_t best = 0;
+  uint64_t bestPeak = 0, bestDistance = 0, bestNumReuses = 0;
+  for (size_t i = 0, e = orders.size(); i < e; ++i) {
+    uint64_t peak, reuseDistance, numReuses;
+    evaluateSchedule(graph, orders[i], pack, peak, reuseDistance, numReuses);
+    DEBUG_GLOW(llvm::dbgs()
+               << "Schedule " << i << ": " << (pack ? "packed" : "live")
+               << " peak " << peak << ", reuse distance " << reuseDistance
+               << " over " << numReuses << " edges\n");
+    if (i == 0 || isBetterSchedule(peak, reuseDistance, numReuses, bestPeak,
+                                   bestDistance, bestNumReuses)) {
+      best = i;
+      bestPeak = peak;
+      bestDistance = reuseDistance;
+      bestNumReuses = numReuses;
+    }
+  }
+
+  for (unsigned i : orders[best]) {
+    scheduled_.push_back(graph.nodes[i]);
+  }
+}
+
+} // namespace glow
@@ -20,8 +20,13 @@
 #include "glow/Graph/Nodes.h"
 #include "glow/Runtime/RuntimeTypes.h"
 #include "glow/Support/Error.h"
+#include "glow/Support/Support.h"
+#include "glow/Support/ThreadPool.h"
 
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Path.h"
 
 #include "caffe2/proto/caffe2.pb.h"
 #include <google/protobuf/io/coded_stream.h>
@@ -29,14 +34,31 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace glow;
 using llvm::cast;
 
+namespace {
+
+llvm::cl::OptionCategory caffe2ModelLoaderCat("Caffe2 Model Loader Options");
+
+llvm::cl::opt<unsigned> caffe2LoadWeightsThreadsOpt(
+    "caffe2-load-weights-threads", llvm::cl::init(0), llvm::cl::Optional,
+    llvm::cl::desc("Number of threads used to materialize the weights of the\n"
+                   "init net of Caffe2 models. Default is 0, which uses one\n"
+                   "thread per hardware thread."),
+    llvm::cl::cat(caffe2ModelLoaderCat));
+
+} // namespace
+
 using ArgumentDictionaryTy =
     std::unordered_map<std::string, const caffe2::Argument *>;
 
@@ -257,15 +279,25 @@ Caffe2ModelLoader::loadProtoFile(const std::string &filename) {
                               filename.c_str()));
   caffe2::NetDef net;
 
+  // Parse the proto from the file mapped into memory if possible, which avoids
+  // copying the file contents into a string or through the buffers of the
+  // stream.
+  std::unique_ptr<google::protobuf::io::ZeroCopyInputStream> filestr;
+  auto fileOrErr = llvm::MemoryBuffer::getFile(filename);
+  if (fileOrErr &&
+      (*fileOrErr)->getBufferSize() <= std::numeric_limits<int>::max()) {
+    filestr = glow::make_unique<google::protobuf::io::ArrayInputStream>(
+        (*fileOrErr)->getBufferStart(), (*fileOrErr)->getBufferSize());
+  } else {
+    filestr = glow::make_unique<google::protobuf::io::IstreamInputStream>(&ff);
+  }
+
   bool parseNet = false;
   if (filename.find(".pbtxt") != std::string::npos) {
-    std::string str((std::istreambuf_iterator<char>(ff)),
-                    std::istreambuf_iterator<char>());
-    parseNet = google::protobuf::TextFormat::ParseFromString(str, &net);
+    parseNet = google::protobuf::TextFormat::Parse(filestr.get(), &net);
   } else {
     // Construct and configure a Coded Input Stream
-    google::protobuf::io::IstreamInputStream filestr(&ff);
-    google::protobuf::io::CodedInputStream codedstr(&filestr);
+    google::protobuf::io::CodedInputStream codedstr(filestr.get());
     // Don't warn about large file sizes.
     codedstr.SetTotalBytesLimit(MAX_PROTO_SIZE, MAX_PROTO_SIZE);
     parseNet = net.ParseFromCodedStream(&codedstr);
@@ -1780,13 +1812,114 @@ static Error fillTensor(Tensor &T, ElemKind kind, llvm::ArrayRef<dim_t> dim,
   return Error::success();
 }
 
+/// \returns whether \p op is a GivenTensorFill, GivenTensorIntFill or
+/// GivenTensorInt64Fill.
+static bool isGivenTensorFill(const caffe2::OperatorDef &op) {
+  const std::string &typeName = op.type();
+  return typeName == "GivenTensorFill" || typeName == "GivenTensorIntFill" ||
+         typeName == "GivenTensorInt64Fill";
+}
+
+Expected<llvm::StringRef>
+Caffe2ModelLoader::getExternalWeightData(const caffe2::OperatorDef &op) {
+  ArgumentDictionaryTy dict = loadArgumentMap(op);
+  if (!dict.count("external_data")) {
+    return llvm::StringRef();
+  }
+  std::string location;
+  ASSIGN_VALUE_OR_RETURN_ERR(location, loadStr(dict["external_data"]));
+  RETURN_ERR_IF_NOT(!location.empty(),
+                    opErrMsg(op, "Empty external weight file name"));
+  int64_t offset = 0;
+  if (dict.count("external_offset")) {
+    const caffe2::Argument *offsetArg = dict["external_offset"];
+    RETURN_ERR_IF_NOT(offsetArg->has_i() && offsetArg->i() >= 0,
+                      opErrMsg(op, "Invalid external weight offset"));
+    offset = offsetArg->i();
+  }
+
+  llvm::SmallString<128> path(externalWeightsDir_);
+  llvm::sys::path::append(path, location);
+  auto &file = externalWeightsFiles_[path];
+  if (!file) {
+    auto fileOrErr = llvm::MemoryBuffer::getFile(path);
+    RETURN_ERR_IF_NOT(
+        fileOrErr,
+        opErrMsg(op, strFormat("Cannot open external weight file %s",
+                               path.c_str())));
+    file = std::move(*fileOrErr);
+  }
+  llvm::StringRef buffer = file->getBuffer();
+  RETURN_ERR_IF_NOT(
+      uint64_t(offset) <= buffer.size(),
+      opErrMsg(op, strFormat("External weight offset %lld is out of bounds "
+                             "of %s",
+                             (long long)offset, path.c_str())));
+  return buffer.drop_front(offset);
+}
+
+Error Caffe2ModelLoader::materializeGivenTensorFill(
+    const caffe2::OperatorDef &op, llvm::StringRef externalData, Tensor &T) {
+  ArgumentDictionaryTy dict = loadArgumentMap(op);
+  const std::string &typeName = op.type();
+
+  // Note: Explicitly allow for an empty dim here, representing a scalar value
+  // will be loaded below.
+  std::vector<dim_t> dim;
+  ASSIGN_VALUE_OR_RETURN_ERR(
+      dim, getShape<dim_t>(dict["shape"], /* allowEmptyShape */ true));
+  RETURN_ERR_IF_NOT(
+      op.output_size() == 1,
+      opErrMsg(op,
+               strFormat(
+                   "GivenTensorFill must have exactly 1 output, but found %d ",
+                   op.output_size())));
+
+  // External weights are stored as the raw bytes of the payload of T.
+  if (externalData.data()) {
+    if (typeName == "GivenTensorFill") {
+      T.reset(ElemKind::FloatTy, dim);
+    } else if (typeName == "GivenTensorIntFill") {
+      T.reset(ElemKind::Int32ITy, dim);
+    } else if (typeName == "GivenTensorInt64Fill") {
+      T.reset(ElemKind::Int64ITy, dim);
+    } else {
+      return MAKE_ERR(
+          strFormat("Unhandled tensor fill type: %s", typeName.c_str()));
+    }
+    RETURN_ERR_IF_NOT(
+        externalData.size() >= T.getSizeInBytes(),
+        opErrMsg(op, strFormat("External weight data holds %zu bytes but %zu "
+                               "are expected",
+                               externalData.size(), T.getSizeInBytes())));
+    std::memcpy(T.getUnsafePtr(), externalData.data(), T.getSizeInBytes());
+    return Error::success();
+  }
+
+  auto const &values = dict["values"];
+  RETURN_ERR_IF_NOT(values, opErrMsg(op, "GivenTensorFill has no values"));
+  if (typeName == "GivenTensorFill") {
+    RETURN_IF_ERR(
+        fillTensor<float>(T, ElemKind::FloatTy, dim, values->floats()));
+  } else if (typeName == "GivenTensorIntFill") {
+    RETURN_IF_ERR(
+        fillTensor<int32_t>(T, ElemKind::Int32ITy, dim, values->ints()));
+  } else if (typeName == "GivenTensorInt64Fill") {
+    RETURN_IF_ERR(
+        fillTensor<int64_t>(T, ElemKind::Int64ITy, dim, values->ints()));
+  } else {
+    return MAKE_ERR(
+        strFormat("Unhandled tensor fill type: %s", typeName.c_str()));
+  }
+  return Error::success();
+}
+
 Error Caffe2ModelLoader::loadWeight(const caffe2::OperatorDef &op) {
   ArgumentDictionaryTy dict = loadArgumentMap(op);
   const std::string &typeName = op.type();
 
   // Load tensors with values:
-  if (typeName == "GivenTensorFill" || typeName == "GivenTensorIntFill" ||
-      typeName == "GivenTensorInt64Fill") {
+  if (isGivenTensorFill(op)) {
     /*
      * op {
      *   output: "conv1_w"
@@ -1805,34 +1938,24 @@ Error Caffe2ModelLoader::loadWeight(const caffe2::OperatorDef &op) {
      *     ...
      *   }
      * }
+     *
+     * Instead of values, the payload may be stored as raw bytes in an external
+     * weight file, resolved relative to the init net:
+     *
+     *   arg {
+     *     name: "external_data"
+     *     s: "weights.bin"
+     *   }
+     *   arg {
+     *     name: "external_offset"
+     *     i: 0
+     *   }
      */
 
-    // Note: Explicitly allow for an empty dim here, representing a scalar value
-    // will be loaded below.
-    std::vector<dim_t> dim;
-    ASSIGN_VALUE_OR_RETURN_ERR(
-        dim, getShape<dim_t>(dict["shape"], /* allowEmptyShape */ true));
-    auto const &values = dict["values"];
-    RETURN_ERR_IF_NOT(
-        op.output_size() == 1,
-        opErrMsg(
-            op, strFormat(
-                    "GivenTensorFill must have exactly 1 output, but found %d ",
-                    op.output_size())));
+    llvm::StringRef externalData;
+    ASSIGN_VALUE_OR_RETURN_ERR(externalData, getExternalWeightData(op));
     Tensor T;
-    if (typeName == "GivenTensorFill") {
-      RETURN_IF_ERR(
-          fillTensor<float>(T, ElemKind::FloatTy, dim, values->floats()));
-    } else if (typeName == "GivenTensorIntFill") {
-      RETURN_IF_ERR(
-          fillTensor<int32_t>(T, ElemKind::Int32ITy, dim, values->ints()));
-    } else if (typeName == "GivenTensorInt64Fill") {
-      RETURN_IF_ERR(
-          fillTensor<int64_t>(T, ElemKind::Int64ITy, dim, values->ints()));
-    } else {
-      return MAKE_ERR(
-          strFormat("Unhandled tensor fill type: %s", typeName.c_str()));
-    }
+    RETURN_IF_ERR(materializeGivenTensorFill(op, externalData, T));
     RETURN_IF_ERR(createAndRegisterConstant(op.output().Get(0), std::move(T)));
     return Error::success();
   }
@@ -2085,8 +2208,74 @@ Error Caffe2ModelLoader::loadWeight(const caffe2::OperatorDef &op) {
 }
 
 Error Caffe2ModelLoader::loadWeightsFromNet(caffe2::NetDef &net) {
-  for (auto &op : net.op()) {
-    RETURN_IF_ERR(loadWeight(op));
+  // Unmap the external weight files once all weights are loaded.
+  ScopeGuard unmapExternalWeightsGuard(
+      [&]() { externalWeightsFiles_.clear(); });
+
+  // Given tensor fills do not depend on any other weight, so their payloads
+  // are materialized in parallel upfront. Mapping the external weight files
+  // is done serially, before any worker is started.
+  const size_t numOps = net.op_size();
+  std::vector<size_t> fillOps;
+  std::vector<llvm::StringRef> externalData(numOps);
+  for (size_t i = 0; i < numOps; i++) {
+    const auto &op = net.op(i);
+    if (isGivenTensorFill(op)) {
+      fillOps.push_back(i);
+      ASSIGN_VALUE_OR_RETURN_ERR(externalData[i], getExternalWeightData(op));
+    }
+  }
+
+  // Release the arguments of each fill as soon as it is materialized, so that
+  // peak memory stays close to the size of the weights.
+  std::vector<Tensor> tensors(numOps);
+  OneErrOnly materializeErr;
+  auto materialize = [&](size_t i) {
+    auto &op = *net.mutable_op(i);
+    if (materializeErr.set(
+            materializeGivenTensorFill(op, externalData[i], tensors[i]))) {
+      return;
+    }
+    google::protobuf::RepeatedPtrField<caffe2::Argument>().Swap(
+        op.mutable_arg());
+  };
+  const size_t numFills = fillOps.size();
+  unsigned numThreads = caffe2LoadWeightsThreadsOpt;
+  if (numThreads == 0) {
+    numThreads = std::thread::hardware_concurrency();
+  }
+  numThreads = std::min<size_t>(numThreads, numFills);
+  if (numThreads > 1) {
+    ThreadPool pool(numThreads, "Caffe2Weights");
+    std::vector<std::future<void>> futures;
+    for (unsigned t = 0; t < numThreads; t++) {
+      futures.push_back(
+          pool.submit([&materialize, &fillOps, t, numThreads, numFills]() {
+            for (size_t i = t; i < numFills; i += numThreads) {
+              materialize(fillOps[i]);
+            }
+          }));
+    }
+    for (auto &future : futures) {
+      future.wait();
+    }
+  } else {
+    for (size_t i : fillOps) {
+      materialize(i);
+    }
+  }
+  RETURN_IF_ERR(materializeErr.get());
+
+  // Create the Constants in order, as the Module is not thread-safe and other
+  // fills may refer to previously loaded weights.
+  for (size_t i = 0; i < numOps; i++) {
+    const auto &op = net.op(i);
+    if (isGivenTensorFill(op)) {
+      RETURN_IF_ERR(
+          createAndRegisterConstant(op.output(0), std::move(tensors[i])));
+    } else {
+      RETURN_IF_ERR(loadWeight(op));
+    }
   }
   return Error::success();
 }
@@ -2121,6 +2310,7 @@ Caffe2ModelLoader::Caffe2ModelLoader(const std::string &netDescFilename,
     // The caffe2 weights that we are deserializing.
     caffe2::NetDef weightsDef;
     ASSIGN_VALUE_OR_RETURN_ERR(weightsDef, loadProtoFile(netWeightFilename));
+    externalWeightsDir_ = llvm::sys::path::parent_path(netWeightFilename).str();
 
     RETURN_IF_ERR(loadWeightsFromNet(weightsDef));
     RETURN_IF_ERR(loadNetwork(networkDef));
@@ -2237,6 +2427,7 @@ Caffe2ModelLoader::Caffe2ModelLoader(const std::string &netDescFilename,
     // The caffe2 weights that we are deserializing.
     caffe2::NetDef weightsDef;
     ASSIGN_VALUE_OR_RETURN_ERR(weightsDef, loadProtoFile(netWeightFilename));
+    externalWeightsDir_ = llvm::sys::path::parent_path(netWeightFilename).str();
 
     RETURN_IF_ERR(loadWeightsFromNet(weightsDef));
 
@@ -21,10 +21,13 @@
 #include "glow/Graph/Nodes.h"
 #include "glow/Importer/Caffe2ModelLoader.h"
 #include "glow/Support/Support.h"
+#include "glow/Support/ThreadPool.h"
 #include "glow/Support/ZipUtils.h"
 
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Path.h"
 
 #include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
@@ -33,8 +36,11 @@
 #include <cstddef>
 #include <cstdint>
 #include <fstream>
+#include <future>
+#include <limits>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace glow;
@@ -75,6 +81,13 @@ llvm::cl::opt<bool> onnxExportRnnStatesOpt(
         "each inference. Default is false."),
     llvm::cl::cat(onnxModelLoaderCat));
 
+llvm::cl::opt<unsigned> onnxLoadInitializersThreadsOpt(
+    "onnx-load-initializers-threads", llvm::cl::init(0), llvm::cl::Optional,
+    llvm::cl::desc("Number of threads used to decode the initializers of ONNX\n"
+                   "models. Default is 0, which uses one thread per hardware\n"
+                   "thread."),
+    llvm::cl::cat(onnxModelLoaderCat));
+
 /// Parse the command line option and get the user defined map of symbols.
 /// The command line option has the format <symbol_name>,<symbol_value>.
 Expected<std::unordered_map<std::string, dim_t>> getSymbolMap() {
@@ -538,9 +551,25 @@ void glow::fillPlaceholders(const std::string &fileName,
                    usingGlowCustomOps);
 }
 
+/// Copies the raw data of \p in into \p T, using \p data instead of the
+/// raw_data field of \p in if it is not empty.
+static Error loadRawTensorData(const ONNX_NAMESPACE::TensorProto &in,
+                               llvm::StringRef data, Tensor *T) {
+  if (data.empty()) {
+    data = in.raw_data();
+  }
+  RETURN_ERR_IF_NOT(
+      data.size() >= T->getSizeInBytes(),
+      strFormat("Raw data of %s holds %zu bytes but %zu are expected",
+                in.name().c_str(), data.size(), T->getSizeInBytes()),
+      ErrorValue::ErrorCode::MODEL_LOADER_INVALID_PROTOBUF);
+  std::memcpy(T->getUnsafePtr(), data.data(), T->getSizeInBytes());
+  return Error::success();
+}
+
 /// Loads tensor \p T from the input \p in.
 Error glow::loadTensor(const ONNX_NAMESPACE::TensorProto &in, Tensor *T,
-                       bool useGlowCustomOps, const std::string &data) {
+                       bool useGlowCustomOps, llvm::StringRef data) {
   std::vector<dim_t> dim;
   for (auto d : in.dims()) {
     dim.push_back(d);
@@ -556,9 +585,7 @@ Error glow::loadTensor(const ONNX_NAMESPACE::TensorProto &in, Tensor *T,
         TH.raw(i++) = f;
       }
     } else if (in.has_raw_data() || !data.empty()) {
-      std::istringstream inStream(data.empty() ? in.raw_data() : data,
-                                  std::stringstream::binary);
-      inStream.read(T->getUnsafePtr(), T->size() * sizeof(float));
+      RETURN_IF_ERR(loadRawTensorData(in, data, T));
     } else {
       return MAKE_ERR("Unsupported Tensor format for FLOAT, name: " + in.name(),
                       ErrorValue::ErrorCode::MODEL_LOADER_UNSUPPORTED_DATATYPE);
@@ -566,9 +593,7 @@ Error glow::loadTensor(const ONNX_NAMESPACE::TensorProto &in, Tensor *T,
   } else if (in.data_type() == ONNX_NAMESPACE::TensorProto::FLOAT16) {
     T->reset(ElemKind::Float16Ty, dim);
     if (in.has_raw_data() || !data.empty()) {
-      std::istringstream inStream(data.empty() ? in.raw_data() : data,
-                                  std::stringstream::binary);
-      inStream.read(T->getUnsafePtr(), T->size() * (sizeof(float) / 2));
+      RETURN_IF_ERR(loadRawTensorData(in, data, T));
     } else {
       return MAKE_ERR("Unsupported Tensor format for FLOAT16, name: " +
                           in.name(),
@@ -577,9 +602,7 @@ Error glow::loadTensor(const ONNX_NAMESPACE::TensorProto &in, Tensor *T,
   } else if (in.data_type() == ONNX_NAMESPACE::TensorProto::BFLOAT16) {
     T->reset(ElemKind::BFloat16Ty, dim);
     if (in.has_raw_data() || !data.empty()) {
-      std::istringstream inStream(data.empty() ? in.raw_data() : data,
-                                  std::stringstream::binary);
-      inStream.read(T->getUnsafePtr(), T->size() * (sizeof(float) / 2));
+      RETURN_IF_ERR(loadRawTensorData(in, data, T));
     } else {
       return MAKE_ERR("Unsupported Tensor format for BFLOAT16, name: " +
                           in.name(),
@@ -595,9 +618,7 @@ Error glow::loadTensor(const ONNX_NAMESPACE::TensorProto &in, Tensor *T,
         TH.raw(i++) = f;
       }
     } else if (in.has_raw_data() || !data.empty()) {
-      std::istringstream inStream(data.empty() ? in.raw_data() : data,
-                                  std::stringstream::binary);
-      inStream.read(T->getUnsafePtr(), T->size() * sizeof(int64_t));
+      RETURN_IF_ERR(loadRawTensorData(in, data, T));
     } else {
       return MAKE_ERR("Unsupported Tensor format for INT64, name: " + in.name(),
                       ErrorValue::ErrorCode::MODEL_LOADER_UNSUPPORTED_DATATYPE);
@@ -609,9 +630,7 @@ Error glow::loadTensor(const ONNX_NAMESPACE::TensorProto &in, Tensor *T,
     T->reset(ty);
 
     if (in.has_raw_data() || !data.empty()) {
-      std::istringstream inStream(data.empty() ? in.raw_data() : data,
-                                  std::stringstream::binary);
-      inStream.read(T->getUnsafePtr(), T->size() * sizeof(int8_t));
+      RETURN_IF_ERR(loadRawTensorData(in, data, T));
     } else {
       return MAKE_ERR("Unsupported Tensor format for INT8, name: " + in.name(),
                       ErrorValue::ErrorCode::MODEL_LOADER_UNSUPPORTED_DATATYPE);
@@ -623,9 +642,7 @@ Error glow::loadTensor(const ONNX_NAMESPACE::TensorProto &in, Tensor *T,
     T->reset(ty);
 
     if (in.has_raw_data() || !data.empty()) {
-      std::istringstream inStream(data.empty() ? in.raw_data() : data,
-                                  std::stringstream::binary);
-      inStream.read(T->getUnsafePtr(), T->size() * sizeof(int16_t));
+      RETURN_IF_ERR(loadRawTensorData(in, data, T));
     } else {
       return MAKE_ERR("Unsupported Tensor format for INT16, name: " + in.name(),
                       ErrorValue::ErrorCode::MODEL_LOADER_UNSUPPORTED_DATATYPE);
@@ -649,9 +666,7 @@ Error glow::loadTensor(const ONNX_NAMESPACE::TensorProto &in, Tensor *T,
         TH.raw(i++) = f;
       }
     } else if (in.has_raw_data() || !data.empty()) {
-      std::istringstream inStream(data.empty() ? in.raw_data() : data,
-                                  std::stringstream::binary);
-      inStream.read(T->getUnsafePtr(), T->size() * sizeof(int32_t));
+      RETURN_IF_ERR(loadRawTensorData(in, data, T));
     } else {
       return MAKE_ERR("Unsupported Tensor format for INT32, name: " + in.name(),
                       ErrorValue::ErrorCode::MODEL_LOADER_UNSUPPORTED_DATATYPE);
@@ -663,9 +678,7 @@ Error glow::loadTensor(const ONNX_NAMESPACE::TensorProto &in, Tensor *T,
     T->reset(ty);
 
     if (in.has_raw_data() || !data.empty()) {
-      std::istringstream inStream(data.empty() ? in.raw_data() : data,
-                                  std::stringstream::binary);
-      inStream.read(T->getUnsafePtr(), T->size() * sizeof(uint8_t));
+      RETURN_IF_ERR(loadRawTensorData(in, data, T));
     } else {
       return MAKE_ERR("Unsupported Tensor format for UINT8, name: " + in.name(),
                       ErrorValue::ErrorCode::MODEL_LOADER_UNSUPPORTED_DATATYPE);
@@ -673,9 +686,7 @@ Error glow::loadTensor(const ONNX_NAMESPACE::TensorProto &in, Tensor *T,
   } else if (in.data_type() == ONNX_NAMESPACE::TensorProto::BOOL) {
     T->reset(ElemKind::BoolTy, dim);
     if (in.has_raw_data() || !data.empty()) {
-      std::istringstream inStream(data.empty() ? in.raw_data() : data,
-                                  std::stringstream::binary);
-      inStream.read(T->getUnsafePtr(), T->size() * sizeof(bool));
+      RETURN_IF_ERR(loadRawTensorData(in, data, T));
     } else if (in.int32_data_size() > 0) {
       // Some ONNX models use int32_data to initialize bool type (e.g., when
       // converted from Keras).
@@ -1028,6 +1039,15 @@ ONNXModelLoader::loadProto(const std::string &filename, bool zipMode,
     google::protobuf::io::IstreamInputStream stringStream(&iss);
     return loadProto(stringStream);
   }
+  // Parse the proto from the file mapped into memory if possible, which avoids
+  // copying the file contents through the buffers of the stream.
+  auto fileOrErr = llvm::MemoryBuffer::getFile(filename);
+  if (fileOrErr &&
+      (*fileOrErr)->getBufferSize() <= std::numeric_limits<int>::max()) {
+    google::protobuf::io::ArrayInputStream arrayStream(
+        (*fileOrErr)->getBufferStart(), (*fileOrErr)->getBufferSize());
+    return loadProto(arrayStream);
+  }
   google::protobuf::io::IstreamInputStream fileStream(&ff);
   return loadProto(fileStream);
 }
@@ -4842,9 +4862,89 @@ Expected<Constant *> ONNXModelLoader::replaySerializedConstFold(
   return runDeserializedConstFold(in.name(), subgraph->output(resNo).name());
 }
 
+Expected<llvm::StringRef>
+ONNXModelLoader::getExternalData(const ONNX_NAMESPACE::TensorProto &in) {
+  if (in.data_location() != ONNX_NAMESPACE::TensorProto::EXTERNAL) {
+    return llvm::StringRef();
+  }
+  llvm::StringRef location;
+  uint64_t offset = 0;
+  uint64_t length = 0;
+  bool hasLength = false;
+  for (const auto &keyVal : in.external_data()) {
+    llvm::StringRef value = keyVal.value();
+    if (keyVal.key() == "location") {
+      location = value;
+    } else if (keyVal.key() == "offset") {
+      RETURN_ERR_IF_NOT(!value.getAsInteger(10, offset),
+                        "Invalid external data offset for " + in.name());
+    } else if (keyVal.key() == "length") {
+      RETURN_ERR_IF_NOT(!value.getAsInteger(10, length),
+                        "Invalid external data length for " + in.name());
+      hasLength = true;
+    }
+  }
+  RETURN_ERR_IF_NOT(!location.empty(),
+                    "Missing external data location for " + in.name(),
+                    ErrorValue::ErrorCode::MODEL_LOADER_INVALID_PROTOBUF);
+
+  llvm::SmallString<128> path(externalDataDir_);
+  llvm::sys::path::append(path, location);
+  auto &file = externalDataFiles_[path];
+  if (!file) {
+    auto fileOrErr = llvm::MemoryBuffer::getFile(path);
+    RETURN_ERR_IF_NOT(fileOrErr,
+                      strFormat("Cannot open external data file %s for %s",
+                                path.c_str(), in.name().c_str()),
+                      ErrorValue::ErrorCode::MODEL_LOADER_INVALID_PROTOBUF);
+    file = std::move(*fileOrErr);
+  }
+  llvm::StringRef buffer = file->getBuffer();
+  RETURN_ERR_IF_NOT(offset <= buffer.size() &&
+                        (!hasLength || length <= buffer.size() - offset),
+                    strFormat("External data of %s is out of bounds of %s",
+                              in.name().c_str(), path.c_str()),
+                    ErrorValue::ErrorCode::MODEL_LOADER_INVALID_PROTOBUF);
+  buffer = buffer.drop_front(offset);
+  return hasLength ? buffer.take_front(length) : buffer;
+}
+
+/// Frees the memory held by the payload of \p in, which is not needed anymore
+/// once it has been loaded into a Tensor.
+static void releaseTensorPayload(ONNX_NAMESPACE::TensorProto &in) {
+  if (in.has_raw_data()) {
+    std::string().swap(*in.mutable_raw_data());
+  }
+  google::protobuf::RepeatedField<float>().Swap(in.mutable_float_data());
+  google::protobuf::RepeatedField<int32_t>().Swap(in.mutable_int32_data());
+  google::protobuf::RepeatedField<int64_t>().Swap(in.mutable_int64_data());
+}
+
+/// \returns whether any initializer of \p net has some constant folding node
+/// associated with it.
+static bool hasSerializedConstFolds(const ONNX_NAMESPACE::GraphProto &net) {
+  for (const auto &in : net.initializer()) {
+    for (const auto &keyVal : in.external_data()) {
+      if (keyVal.key() == "ConstFoldNodeName") {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 Error ONNXModelLoader::loadInitializers(ONNX_NAMESPACE::GraphProto &net) {
+  // Unmap the external data files once all initializers are loaded.
+  ScopeGuard unmapExternalDataGuard([&]() { externalDataFiles_.clear(); });
+
+  // Initializers which are matched with existing Constants, or which may be
+  // needed to replay constant folding, are loaded in order one at a time.
+  if (!loadIntoExistingModule_ && !hasSerializedConstFolds(net)) {
+    return loadInitializersInParallel(net);
+  }
+
   // Load the network initializers:
-  for (const auto &in : net.initializer()) {
+  for (auto &in : *net.mutable_initializer()) {
     // Replay any constant folding that occurred from previous optimization if
     // necessary. foldedC will be left as nullptr if no constant folding occurs.
     Constant *foldedC;
@@ -4880,13 +4980,77 @@ Error ONNXModelLoader::loadInitializers(ONNX_NAMESPACE::GraphProto &net) {
     // If we are loading into an existing module then we would expect this
     // initializer doesn't have any data associated with it.
     Tensor T;
-    RETURN_IF_ERR(loadTensor(in, &T, useGlowCustomOps_));
+    llvm::StringRef data;
+    ASSIGN_VALUE_OR_RETURN_ERR(data, getExternalData(in));
+    RETURN_IF_ERR(loadTensor(in, &T, useGlowCustomOps_, data));
+    releaseTensorPayload(in);
     RETURN_IF_ERR(createAndRegisterConstant(in.name(), std::move(T), layout));
   }
 
   return Error::success();
 }
 
+Error ONNXModelLoader::loadInitializersInParallel(
+    ONNX_NAMESPACE::GraphProto &net) {
+  const size_t numInitializers = net.initializer_size();
+  std::vector<std::string> layouts(numInitializers, ANY_LAYOUT);
+  std::vector<llvm::StringRef> externalData(numInitializers);
+  for (size_t i = 0; i < numInitializers; i++) {
+    const auto &in = net.initializer(i);
+    if (useGlowCustomOps_) {
+      ASSIGN_VALUE_OR_RETURN_ERR(
+          layouts[i], getAttrFromDocString(layoutSignifier, in.doc_string()));
+    }
+    ASSIGN_VALUE_OR_RETURN_ERR(externalData[i], getExternalData(in));
+  }
+
+  // Decode the payloads into Tensors in parallel, releasing each payload from
+  // the proto as soon as it is decoded to keep peak memory close to the size
+  // of the weights.
+  std::vector<Tensor> tensors(numInitializers);
+  OneErrOnly decodeErr;
+  auto decode = [&](size_t i) {
+    auto &in = *net.mutable_initializer(i);
+    if (decodeErr.set(
+            loadTensor(in, &tensors[i], useGlowCustomOps_, externalData[i]))) {
+      return;
+    }
+    releaseTensorPayload(in);
+  };
+  unsigned numThreads = onnxLoadInitializersThreadsOpt;
+  if (numThreads == 0) {
+    numThreads = std::thread::hardware_concurrency();
+  }
+  numThreads = std::min<size_t>(numThreads, numInitializers);
+  if (numThreads > 1) {
+    ThreadPool pool(numThreads, "ONNXInitializers");
+    std::vector<std::future<void>> futures;
+    for (unsigned t = 0; t < numThreads; t++) {
+      futures.push_back(pool.submit([&decode, t, numThreads,
+                                     numInitializers]() {
+        for (size_t i = t; i < numInitializers; i += numThreads) {
+          decode(i);
+        }
+      }));
+    }
+    for (auto &future : futures) {
+      future.wait();
+    }
+  } else {
+    for (size_t i = 0; i < numInitializers; i++) {
+      decode(i);
+    }
+  }
+  RETURN_IF_ERR(decodeErr.get());
+
+  // Create the Constants in order, as the Module is not thread-safe.
+  for (size_t i = 0; i < numInitializers; i++) {
+    RETURN_IF_ERR(createAndRegisterConstant(net.initializer(i).name(),
+                                            std::move(tensors[i]), layouts[i]));
+  }
+  return Error::success();
+}
+
 Error ONNXModelLoader::setOutputNodes(ONNX_NAMESPACE::GraphProto &net) {
   if (net.output_size() == 0) {
     return MAKE_ERR("Net output size must be greater than 0");
@@ -5095,7 +5259,9 @@ Error ONNXModelLoader::loadModel(ONNX_NAMESPACE::ModelProto &modelDef,
 
   RETURN_IF_ERR(setVersion(modelDef));
 
-  ONNX_NAMESPACE::GraphProto graphDef = modelDef.graph();
+  // Load from the graph of modelDef in place rather than from a copy of it,
+  // which would duplicate all of the weights.
+  ONNX_NAMESPACE::GraphProto &graphDef = *modelDef.mutable_graph();
   RETURN_IF_ERR(checkInputs(graphDef, tensorNames, types));
   RETURN_IF_ERR(collectStaticInputs(graphDef));
   RETURN_IF_ERR(setupOrigStaticTypeMap(graphDef));
@@ -5146,6 +5312,7 @@ ONNXModelLoader::ONNXModelLoader(const std::string &modelDescFilename,
     ONNX_NAMESPACE::ModelProto modelDef;
     ASSIGN_VALUE_OR_RETURN_ERR(
         modelDef, loadProto(modelDescFilename, zipMode, inputStringPtr));
+    externalDataDir_ = llvm::sys::path::parent_path(modelDescFilename).str();
     RETURN_IF_ERR(loadModel(modelDef, tensorNames, types, B,
                             /* loadInputsAsPlaceholdersForOnnx */ true));
     return Error::success();
@@ -5371,6 +5538,7 @@ ONNXModelLoader::ONNXModelLoader(
     ONNX_NAMESPACE::ModelProto modelDef;
     ASSIGN_VALUE_OR_RETURN_ERR(
         modelDef, loadProto(modelDescFilename, zipMode, inputStringPtr));
+    externalDataDir_ = llvm::sys::path::parent_path(modelDescFilename).str();
 
     auto numPartitionsOrErr = getIntMetadataProp(modelDef, "numPartitions");
     if (!numPartitionsOrErr) {
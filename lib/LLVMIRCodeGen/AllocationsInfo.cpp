@@ -97,32 +97,33 @@ void AllocationsInfo::allocateWeightVars(const IRFunction *F) {
 }
 
 void AllocationsInfo::allocateActivations(const IRFunction *F) {
-  // Maps activations and views to some offset within the heap.
-  llvm::DenseMap<const Value *, uint64_t> activationAddr;
-
-  // Assign device-space addresses to the activations.
+  // Collect the live intervals of all activations, so that they can be packed
+  // at once rather than first-fit in schedule order.
+  std::vector<Allocation> allocList;
+  std::vector<const AllocActivationInst *> activations;
   for (const auto &I : F->getInstrs()) {
     if (auto *A = dyn_cast<AllocActivationInst>(&I)) {
-      auto numBytes = I.getSizeInBytes();
-      size_t addr = activationsAllocator.allocate(numBytes, A);
-      assert(!activationAddr.count(A) && "Allocation already made!");
-      activationAddr[A] = addr;
+      allocList.emplace_back(A, /* alloc */ true, I.getSizeInBytes());
+      activations.push_back(A);
       continue;
     }
 
     if (auto *D = dyn_cast<DeallocActivationInst>(&I)) {
-      auto *A = D->getAlloc();
-      assert(activationAddr.count(A) && "Invalid deallocation!");
-      activationsAllocator.deallocate(A);
+      allocList.emplace_back(D->getAlloc(), /* alloc */ false);
       continue;
     }
   }
 
+  // Assign device-space addresses to the activations.
+  auto peak = activationsAllocator.allocateAll(allocList);
+  (void)peak;
+  assert(peak != MemoryAllocator::npos && "Activations do not fit!");
   activationsMemSize_ = activationsAllocator.getMaxMemoryUsage();
 
   // Register specific addresses within the heap to activations.
-  for (auto &A : activationAddr) {
-    allocatedAddress_[A.first] = A.second;
+  for (const auto *A : activations) {
+    assert(!allocatedAddress_.count(A) && "Allocation already made!");
+    allocatedAddress_[A] = activationsAllocator.getAddress(A);
   }
   DEBUG_GLOW(for (auto &A
                   : allocatedAddress_) {
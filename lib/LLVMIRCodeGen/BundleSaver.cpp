@@ -179,6 +179,7 @@ BundleSaver::BundleSaver(const LLVMBackend &llvmBackend,
   auto opts = llvmBackend.getOptions();
   opts.setCodeModel(opts.getBundleCodeModel());
   irgen_->initTargetMachine(opts);
+  irgen_->setFastTranscendentals(opts.getFastTranscendentals());
   irgen_->initCodeGen();
 }
 
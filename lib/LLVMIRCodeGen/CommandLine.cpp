@@ -92,6 +92,12 @@ llvm::cl::opt<llvm::FloatABI::ABIType>
                                          "Hard float ABI (hardfp)")),
              llvm::cl::init(llvm::FloatABI::Default));
 
+llvm::cl::opt<bool> llvmFastTranscendentals(
+    "fast-transcendentals",
+    llvm::cl::desc("Use fast polynomial approximations of exp, log, tanh, "
+                   "sigmoid and gelu instead of the libm based kernels"),
+    llvm::cl::init(false), llvm::cl::cat(getLLVMBackendCat()));
+
 static llvm::cl::OptionCategory bundleSaverCat("Bundle Options");
 
 llvm::cl::opt<glow::BundleApiType>
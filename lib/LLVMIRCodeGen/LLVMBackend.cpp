@@ -72,6 +72,7 @@ bool LLVMBackend::isOpSupported(const NodeInfo &NI) const {
   case Kinded::Kind::MinNodeKind:
   case Kinded::Kind::BatchedReduceAddNodeKind:
   case Kinded::Kind::MatMulNodeKind:
+  case Kinded::Kind::BatchMatMulNodeKind:
   case Kinded::Kind::AvgPoolNodeKind:
     return NI.allInputsAndOutputsHaveSameElemKind(
         {ElemKind::FloatTy, ElemKind::Int8QTy});
@@ -384,6 +385,10 @@ bool LLVMBackend::isOpSupported(const NodeInfo &NI) const {
     return (NI.getInElemTy(DequantizeNode::InputIdx) == ElemKind::Int8QTy) &&
            (NI.getOutElemTy(DequantizeNode::ResultIdx) == ElemKind::FloatTy);
 
+  case Kinded::Kind::LayerNormalizationNodeKind:
+  case Kinded::Kind::GeluNodeKind:
+    return NI.allInputsAndOutputsHaveSameElemKind({ElemKind::FloatTy});
+
   case Kinded::Kind::SoftMaxNodeKind:
     return NI.allInputsAndOutputsHaveSameElemKind({ElemKind::FloatTy},
                                                   {SoftMaxNode::SelectedIdx}) &&
@@ -539,6 +544,7 @@ LLVMBackendOptions::LLVMBackendOptions() {
   bundleCodeModel_ = llvmBundleCodeModel;
   relocModel_ = llvmRelocModel;
   bundleAPI_ = bundleAPI;
+  fastTranscendentals_ = llvmFastTranscendentals;
   targetFeatures_.append(llvmTargetFeatures.begin(), llvmTargetFeatures.end());
 }
 
@@ -548,14 +554,17 @@ std::string LLVMBackend::getHostTarget() {
   return llvm::sys::getDefaultTargetTriple();
 }
 
-std::string LLVMBackend::getHostCPU() {
+std::string LLVMBackend::getHostCPU(bool withAVX512) {
   auto cpu_name = llvm::sys::getHostCPUName();
   // Skip avx512 because LLVM does not support it well.
-  cpu_name.consume_back("-avx512");
+  if (!withAVX512) {
+    cpu_name.consume_back("-avx512");
+  }
   return cpu_name.str();
 }
 
-llvm::SmallVector<std::string, 0> LLVMBackend::getHostFeatures() {
+llvm::SmallVector<std::string, 0>
+LLVMBackend::getHostFeatures(bool withAVX512) {
   llvm::SmallVector<std::string, 0> result;
   llvm::StringMap<bool> hostFeatures;
   if (llvm::sys::getHostCPUFeatures(hostFeatures)) {
@@ -563,7 +572,7 @@ llvm::SmallVector<std::string, 0> LLVMBackend::getHostFeatures() {
       if (feature.second) {
         llvm::StringRef fn = feature.first();
         // Skip avx512 because LLVM does not support it well.
-        if (fn.startswith("avx512")) {
+        if (!withAVX512 && fn.startswith("avx512")) {
           continue;
         }
         result.push_back(fn);
@@ -631,11 +640,18 @@ LLVMBackend::compileIR(std::unique_ptr<IRFunction> IR) const {
 
 std::unique_ptr<CompiledFunction>
 LLVMBackend::compileIRWithoutConstants(IRFunction *IR) const {
+  return compileIRWithOptions(IR, getOptions());
+}
+
+std::unique_ptr<CompiledFunction>
+LLVMBackend::compileIRWithOptions(IRFunction *IR,
+                                  const LLVMBackendOptions &options) const {
   AllocationsInfo allocationsInfo;
   std::unique_ptr<LLVMIRGen> irgen = createIRGen(IR, allocationsInfo);
   llvm::SmallVector<std::string, 8> targetFeatures(llvmTargetFeatures.begin(),
                                                    llvmTargetFeatures.end());
-  irgen->initTargetMachine(getOptions());
+  irgen->initTargetMachine(options);
+  irgen->setFastTranscendentals(options.getFastTranscendentals());
   irgen->initCodeGen();
   irgen->setIRFunction(IR);
   // Perform the address assignment for activations and WeightVars.
@@ -657,8 +673,31 @@ LLVMBackend::compileIRWithoutConstants(IRFunction *IR) const {
   return createCompiledFunction(std::move(JIT), std::move(runtimeInfo));
 }
 
+/// Overrides the LLVM backend options \p options with the backend specific
+/// options of \p opts.
+static Error applyBackendSpecificOptions(const BackendOptions &opts,
+                                         LLVMBackendOptions &options) {
+  auto it = opts.backendSpecificOpts.find("fast-transcendentals");
+  if (it != opts.backendSpecificOpts.end()) {
+    if (it->second == "true") {
+      options.setFastTranscendentals(true);
+    } else if (it->second == "false") {
+      options.setFastTranscendentals(false);
+    } else {
+      return MAKE_ERR(ErrorValue::ErrorCode::COMPILE_CONTEXT_MALFORMED,
+                      "Invalid fast-transcendentals, expected true or false "
+                      "got: " +
+                          it->second);
+    }
+  }
+  return Error::success();
+}
+
 Expected<std::unique_ptr<CompiledFunction>>
 LLVMBackend::compile(Function *F, const BackendOptions &opts) const {
+  LLVMBackendOptions options = getOptions();
+  RETURN_IF_ERR(applyBackendSpecificOptions(opts, options));
+
   TraceInfo traceInfo = buildManualTraceInfo(F);
   auto IR = generateAndOptimizeIR(F, *this, shouldShareBuffers());
 
@@ -666,11 +705,12 @@ LLVMBackend::compile(Function *F, const BackendOptions &opts) const {
     autoInstrument(traceInfo, IR.get());
   }
 
-  std::unique_ptr<CompiledFunction> compiledFunc;
+  std::unique_ptr<CompiledFunction> compiledFunc =
+      compileIRWithOptions(IR.get(), options);
   if (opts.collectConstants) {
-    compiledFunc = compileIR(std::move(IR));
-  } else {
-    compiledFunc = compileIRWithoutConstants(IR.get());
+    static_cast<LLVMCompiledFunction *>(compiledFunc.get())
+        ->getRuntimeBundle()
+        .collectConstants(IR.get());
   }
 
   compiledFunc->setTraceInfo(std::move(traceInfo));
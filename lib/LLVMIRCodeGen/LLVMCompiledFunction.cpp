@@ -74,16 +74,30 @@ void LLVMCompiledFunction::updatePlaceholders(
 Error LLVMCompiledFunction::execute(ExecutionContext *context) {
   uint8_t *baseActivationsAddress{nullptr};
 
-  /// Base address for Mutable weights memory block, Inputs and Outputs.
-  uint8_t *baseMutableWeightVarsAddress{nullptr};
-
   {
-    TRACE_EVENT_SCOPE(context, TraceLevel::RUNTIME, "allocBuffers");
+    TRACE_EVENT_SCOPE(context, TraceLevel::RUNTIME, "allocActivations");
     if (runtimeBundle_.getActivationsSize() != 0) {
       baseActivationsAddress = (uint8_t *)alignedAlloc(
           runtimeBundle_.getActivationsSize(), TensorAlignment);
     }
+  }
+
+  auto err = executeWithActivations(context, baseActivationsAddress);
+
+  {
+    TRACE_EVENT_SCOPE(context, TraceLevel::RUNTIME, "freeActivations");
+    alignedFree(baseActivationsAddress);
+  }
+  return err;
+}
+
+Error LLVMCompiledFunction::executeWithActivations(
+    ExecutionContext *context, uint8_t *baseActivationsAddress) {
+  /// Base address for Mutable weights memory block, Inputs and Outputs.
+  uint8_t *baseMutableWeightVarsAddress{nullptr};
 
+  {
+    TRACE_EVENT_SCOPE(context, TraceLevel::RUNTIME, "allocBuffers");
     if (runtimeBundle_.getMutableWeightSize() != 0) {
       baseMutableWeightVarsAddress = (uint8_t *)alignedAlloc(
           runtimeBundle_.getMutableWeightSize(), TensorAlignment);
@@ -127,6 +141,7 @@ Error LLVMCompiledFunction::execute(ExecutionContext *context) {
     funcPtr(runtimeBundle_.getConstants(), baseMutableWeightVarsAddress,
             baseActivationsAddress);
   } else {
+    alignedFree(baseMutableWeightVarsAddress);
     return MAKE_ERR("Error getting address");
   }
 
@@ -139,7 +154,6 @@ Error LLVMCompiledFunction::execute(ExecutionContext *context) {
   {
     TRACE_EVENT_SCOPE(context, TraceLevel::RUNTIME, "freeBuffers");
     alignedFree(baseMutableWeightVarsAddress);
-    alignedFree(baseActivationsAddress);
   }
 
   {
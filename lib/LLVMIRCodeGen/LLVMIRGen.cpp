@@ -1097,10 +1097,36 @@ void LLVMIRGen::generateLLVMIRForDataParallelInstr(
     break;                                                                     \
   }
 
-    ARITHMETIC_UNARY_OP_CASE(Sigmoid, "sigmoid");
-    ARITHMETIC_UNARY_OP_CASE(Tanh, "tanh");
-    ARITHMETIC_UNARY_OP_CASE(ElementLog, "element_log");
-    ARITHMETIC_UNARY_OP_CASE(ElementExp, "element_exp");
+/// Same as ARITHMETIC_UNARY_OP_CASE, but calls the fast float kernel when
+/// fast transcendentals are enabled.
+#define TRANSCENDENTAL_UNARY_OP_CASE(INST_NAME_, FUN_NAME_)                    \
+  case Kinded::Kind::INST_NAME_##InstKind: {                                   \
+    auto *AN = cast<INST_NAME_##Inst>(I);                                      \
+    auto *dest = AN->getDest();                                                \
+    auto *destPtr = emitBufferAddress(builder, dest, kernel, bufferToArgNum);  \
+    auto *srcPtr =                                                             \
+        emitBufferAddress(builder, AN->getSrc(), kernel, bufferToArgNum);      \
+    bool fast =                                                                \
+        fastTranscendentals_ && dest->getElementType() == ElemKind::FloatTy;   \
+    auto *F = getFunction(fast ? FUN_NAME_ "_fast_kernel"                      \
+                               : FUN_NAME_ "_kernel",                          \
+                          dest->getElementType());                             \
+    auto *elementTy = getElementType(builder, dest);                           \
+    auto *pointerNull =                                                        \
+        llvm::ConstantPointerNull::get(elementTy->getPointerTo());             \
+    auto *stackedOpCall = createUncheckedCall(                                 \
+        builder, F, {loopCount, srcPtr, pointerNull, pointerNull});            \
+    auto *destAddr = builder.CreateGEP(builder.getFloatTy(), destPtr,          \
+                                       loopCount, "buffer.element.addr");      \
+    builder.CreateStore(stackedOpCall, destAddr);                              \
+    break;                                                                     \
+  }
+
+    TRANSCENDENTAL_UNARY_OP_CASE(Sigmoid, "sigmoid");
+    TRANSCENDENTAL_UNARY_OP_CASE(Tanh, "tanh");
+    TRANSCENDENTAL_UNARY_OP_CASE(Gelu, "gelu");
+    TRANSCENDENTAL_UNARY_OP_CASE(ElementLog, "element_log");
+    TRANSCENDENTAL_UNARY_OP_CASE(ElementExp, "element_exp");
     ARITHMETIC_UNARY_OP_CASE(ElementAbs, "element_abs");
     ARITHMETIC_UNARY_OP_CASE(ElementNeg, "element_neg");
     ARITHMETIC_UNARY_OP_CASE(ElementFloor, "element_floor");
@@ -1111,6 +1137,7 @@ void LLVMIRGen::generateLLVMIRForDataParallelInstr(
     ARITHMETIC_UNARY_OP_CASE(ElementReciprocal, "element_reciprocal");
     ARITHMETIC_UNARY_OP_CASE(ElementSin, "element_sin");
     ARITHMETIC_UNARY_OP_CASE(ElementCos, "element_cos");
+#undef TRANSCENDENTAL_UNARY_OP_CASE
 #undef ARITHMETIC_UNARY_OP_CASE
 
   case Kinded::Kind::ReluInstKind: {
@@ -1745,6 +1772,50 @@ void LLVMIRGen::generateLLVMIRForInstr(llvm::IRBuilder<> &builder,
 
     auto *F = getFunction("matmul", dest->getElementType());
 
+    if (lhs->getType()->isQuantizedType()) {
+      auto *destTy = dest->getType();
+      auto *lhsTy = lhs->getType();
+      auto *rhsTy = rhs->getType();
+
+      auto *destOffset = emitConstI32(builder, destTy->getOffset());
+      auto *lhsOffset = emitConstI32(builder, lhsTy->getOffset());
+      auto *rhsOffset = emitConstI32(builder, rhsTy->getOffset());
+
+      auto outScaleParams = quantization::quantizeScaleOffset32To8(
+          lhsTy->getScale() * rhsTy->getScale() / destTy->getScale(), 0);
+
+      auto *outPre = emitConstI32(builder, outScaleParams.pre);
+      auto *outPost = emitConstI32(builder, outScaleParams.post);
+      auto *outScale = emitConstI32(builder, outScaleParams.scale);
+
+      createCall(builder, F,
+                 {destPtr, lhsPtr, rhsPtr, destDims, lhsDims, rhsDims,
+                  destOffset, lhsOffset, rhsOffset, outPre, outPost, outScale});
+    } else {
+      // Use the default blocking of the GEMM.
+      auto *zero = emitConstDimT(builder, 0);
+      createCall(builder, F,
+                 {destPtr, lhsPtr, rhsPtr, destDims, lhsDims, rhsDims, zero,
+                  zero, zero});
+    }
+    break;
+  }
+
+  case Kinded::Kind::BatchMatMulInstKind: {
+    auto *BMM = cast<BatchMatMulInst>(I);
+    auto *dest = BMM->getDest();
+    auto *lhs = BMM->getLHS();
+    auto *rhs = BMM->getRHS();
+    auto *destPtr = emitValueAddress(builder, dest);
+    auto *lhsPtr = emitValueAddress(builder, lhs);
+    auto *rhsPtr = emitValueAddress(builder, rhs);
+
+    auto *destDims = emitValueDims(builder, dest);
+    auto *lhsDims = emitValueDims(builder, lhs);
+    auto *rhsDims = emitValueDims(builder, rhs);
+
+    auto *F = getFunction("batchmatmul", dest->getElementType());
+
     if (lhs->getType()->isQuantizedType()) {
       auto *destTy = dest->getType();
       auto *lhsTy = lhs->getType();
@@ -2047,8 +2118,6 @@ void LLVMIRGen::generateLLVMIRForInstr(llvm::IRBuilder<> &builder,
     auto *CI = cast<ConvolutionInst>(I);
     assert(CI->getLayout() == NHWC &&
            "Glow CPU Backend supports only NHWC Convolutions");
-    assert(CI->getFusedActivation() == FusedActivation::NONE &&
-           "Glow CPU Backend does not support fused activations.");
     auto *dest = CI->getDest();
     auto *src = CI->getSrc();
     auto *filter = CI->getFilter();
@@ -2084,6 +2153,8 @@ void LLVMIRGen::generateLLVMIRForInstr(llvm::IRBuilder<> &builder,
     }
 
     auto *unrollD = emitConstI32(builder, unrollDFactor);
+    auto *fusedActivation =
+        emitConstI32(builder, static_cast<int32_t>(CI->getFusedActivation()));
 
     if (src->getType()->isQuantizedType()) {
       auto *destTy = dest->getType();
@@ -2119,11 +2190,13 @@ void LLVMIRGen::generateLLVMIRForInstr(llvm::IRBuilder<> &builder,
                             {dest->getElementType(), bias->getElementType()});
 
       createCall(builder, F,
-                 {destPtr,    srcPtr,     filterPtr,  biasPtr,   destDims,
-                  srcDims,    filterDims, biasDims,   kernels,   strides,
-                  pads,       group,      destOffset, srcOffset, filterOffset,
-                  biasOffset, biasPre,    biasPost,   biasScale, outPre,
-                  outPost,    outScale,   unrollD,    dilation});
+                 {destPtr,    srcPtr,     filterPtr,      biasPtr,
+                  destDims,   srcDims,    filterDims,     biasDims,
+                  kernels,    strides,    pads,           group,
+                  destOffset, srcOffset,  filterOffset,   biasOffset,
+                  biasPre,    biasPost,   biasScale,      outPre,
+                  outPost,    outScale,   unrollD,        dilation,
+                  fusedActivation});
     } else {
 
       auto *F = getFunction("conv2d", dest->getElementType());
@@ -2131,7 +2204,7 @@ void LLVMIRGen::generateLLVMIRForInstr(llvm::IRBuilder<> &builder,
       createCall(builder, F,
                  {destPtr, srcPtr, filterPtr, biasPtr, destDims, srcDims,
                   filterDims, biasDims, kernels, strides, pads, group, unrollD,
-                  dilation});
+                  dilation, fusedActivation});
     }
     break;
   }
@@ -2641,6 +2714,29 @@ void LLVMIRGen::generateLLVMIRForInstr(llvm::IRBuilder<> &builder,
     break;
   }
 
+  case Kinded::Kind::LayerNormalizationInstKind: {
+    auto *LN = cast<LayerNormalizationInst>(I);
+    auto *dest = LN->getDest();
+    auto *src = LN->getSrc();
+    auto *scale = LN->getScale();
+    auto *destPtr = emitValueAddress(builder, dest);
+    auto *srcPtr = emitValueAddress(builder, src);
+    auto *scalePtr = emitValueAddress(builder, LN->getScale());
+    auto *biasPtr = emitValueAddress(builder, LN->getBias());
+
+    // Each layer has the size of Scale, and the layers are contiguous.
+    dim_t rowSize = scale->size();
+    auto *numRows = emitConstDimT(builder, src->size() / rowSize);
+    auto *rowSizeVal = emitConstDimT(builder, rowSize);
+    auto *epsilon = emitConstF32(builder, LN->getEpsilon());
+
+    auto *F = getFunction("layernorm", dest->getElementType());
+    createCall(builder, F,
+               {destPtr, srcPtr, scalePtr, biasPtr, numRows, rowSizeVal,
+                epsilon});
+    break;
+  }
+
   case Kinded::Kind::SoftMaxGradInstKind: {
     auto *SMG = cast<SoftMaxGradInst>(I);
     auto *srcGrad = SMG->getSrcGrad();
@@ -608,6 +608,195 @@ static void libjit_transpose_generic(const T *inW, T *outW, const dim_t *idim,
   }
 }
 
+/// Collapses the transpose of the \p numDims dims \p idim by \p shuffle into
+/// the smallest equivalent transpose: dims of size 1 are dropped, and input
+/// dims that stay adjacent and in order in the output are merged. The
+/// collapsed input dims and shuffle are stored in \p cdim and \p cshuffle.
+/// \returns the number of collapsed dims.
+static dim_t libjit_collapse_transpose(const dim_t *idim, const dim_t *shuffle,
+                                       dim_t numDims, dim_t *cdim,
+                                       dim_t *cshuffle) {
+  // Rank of each input dim among the input dims of size > 1.
+  dim_t rank[6];
+  dim_t numKept = 0;
+  for (dim_t d = 0; d < numDims; d++) {
+    rank[d] = numKept;
+    numKept += idim[d] != 1;
+  }
+  // Split the output dims of size > 1 into runs of consecutive input dims.
+  dim_t groupRank[6];
+  dim_t groupSize[6];
+  dim_t numGroups = 0;
+  for (dim_t i = 0; i < numDims; i++) {
+    dim_t d = shuffle[i];
+    if (idim[d] == 1) {
+      continue;
+    }
+    if (numGroups &&
+        rank[d] == groupRank[numGroups - 1] + groupSize[numGroups - 1]) {
+      cdim[numGroups - 1] *= idim[d];
+      groupSize[numGroups - 1]++;
+      continue;
+    }
+    groupRank[numGroups] = rank[d];
+    groupSize[numGroups] = 1;
+    cdim[numGroups] = idim[d];
+    numGroups++;
+  }
+  if (numGroups == 0) {
+    cdim[0] = 1;
+    cshuffle[0] = 0;
+    return 1;
+  }
+  // The input position of a group is the number of groups before it in the
+  // input.
+  dim_t outDims[6];
+  for (dim_t i = 0; i < numGroups; i++) {
+    cshuffle[i] = 0;
+    for (dim_t j = 0; j < numGroups; j++) {
+      cshuffle[i] += groupRank[j] < groupRank[i];
+    }
+    outDims[i] = cdim[i];
+  }
+  for (dim_t i = 0; i < numGroups; i++) {
+    cdim[cshuffle[i]] = outDims[i];
+  }
+  return numGroups;
+}
+
+/// Size of the square tiles of the blocked transposes, small enough for the
+/// input and output tiles to stay in L1 cache.
+#define TRANSPOSE_TILE 32
+
+/// Transposes the \p rows x \p cols tile at \p in, whose rows are \p ldIn
+/// apart, into \p out, whose rows are \p ldOut apart.
+template <typename T>
+static void libjit_transpose_tile(const T *in, dim_t ldIn, T *out,
+                                  dim_t ldOut, dim_t rows, dim_t cols) {
+  for (dim_t c = 0; c < cols; c++) {
+    for (dim_t r = 0; r < rows; r++) {
+      out[c * ldOut + r] = in[r * ldIn + c];
+    }
+  }
+}
+
+/// Transposes the 8x8 tile of floats at \p in, whose rows are \p ldIn apart,
+/// into \p out, whose rows are \p ldOut apart, in registers. Each round of
+/// shuffles swaps one bit of the row index with the same bit of the column
+/// index, so three rounds move element (r, c) to (c, r).
+static void libjit_transpose_8x8_f(const float *in, dim_t ldIn, float *out,
+                                   dim_t ldOut) {
+  float8 r[8];
+  for (dim_t i = 0; i < 8; i++) {
+    r[i] = LoaduFloat8(in + i * ldIn);
+  }
+  for (dim_t i = 0; i < 8; i += 2) {
+    float8 a = r[i];
+    float8 b = r[i + 1];
+    r[i] = ShuffleFloat8(a, b, 0, 8, 2, 10, 4, 12, 6, 14);
+    r[i + 1] = ShuffleFloat8(a, b, 1, 9, 3, 11, 5, 13, 7, 15);
+  }
+  for (dim_t h = 0; h < 8; h += 4) {
+    for (dim_t i = h; i < h + 2; i++) {
+      float8 a = r[i];
+      float8 b = r[i + 2];
+      r[i] = ShuffleFloat8(a, b, 0, 1, 8, 9, 4, 5, 12, 13);
+      r[i + 2] = ShuffleFloat8(a, b, 2, 3, 10, 11, 6, 7, 14, 15);
+    }
+  }
+  for (dim_t i = 0; i < 4; i++) {
+    float8 a = r[i];
+    float8 b = r[i + 4];
+    r[i] = ShuffleFloat8(a, b, 0, 1, 2, 3, 8, 9, 10, 11);
+    r[i + 4] = ShuffleFloat8(a, b, 4, 5, 6, 7, 12, 13, 14, 15);
+  }
+  for (dim_t i = 0; i < 8; i++) {
+    StoreuFloat8(out + i * ldOut, r[i]);
+  }
+}
+
+/// Float tiles are transposed in 8x8 blocks in registers.
+template <>
+void libjit_transpose_tile<float>(const float *in, dim_t ldIn, float *out,
+                                  dim_t ldOut, dim_t rows, dim_t cols) {
+  dim_t rows8 = rows / 8 * 8;
+  dim_t cols8 = cols / 8 * 8;
+  for (dim_t r = 0; r < rows8; r += 8) {
+    for (dim_t c = 0; c < cols8; c += 8) {
+      libjit_transpose_8x8_f(in + r * ldIn + c, ldIn, out + c * ldOut + r,
+                             ldOut);
+    }
+  }
+  for (dim_t c = 0; c < cols; c++) {
+    for (dim_t r = (c < cols8 ? rows8 : 0); r < rows; r++) {
+      out[c * ldOut + r] = in[r * ldIn + c];
+    }
+  }
+}
+
+/// Computes out[b][c][r][:] = in[b][r][c][:] for the \p batches x \p rows x
+/// \p cols blocks of \p inner elements of \p inW, one square tile at a
+/// time.
+template <typename T>
+static void libjit_transpose_blocked(const T *inW, T *outW, dim_t batches,
+                                     dim_t rows, dim_t cols, dim_t inner) {
+  for (dim_t b = 0; b < batches; b++) {
+    const T *in = inW + b * rows * cols * inner;
+    T *out = outW + b * rows * cols * inner;
+    for (dim_t r0 = 0; r0 < rows; r0 += TRANSPOSE_TILE) {
+      dim_t rb = MIN(rows - r0, TRANSPOSE_TILE);
+      for (dim_t c0 = 0; c0 < cols; c0 += TRANSPOSE_TILE) {
+        dim_t cb = MIN(cols - c0, TRANSPOSE_TILE);
+        if (inner == 1) {
+          libjit_transpose_tile(in + r0 * cols + c0, cols, out + c0 * rows + r0,
+                                rows, rb, cb);
+          continue;
+        }
+        for (dim_t c = c0; c < c0 + cb; c++) {
+          for (dim_t r = r0; r < r0 + rb; r++) {
+            memcpy(out + (c * rows + r) * inner, in + (r * cols + c) * inner,
+                   inner * sizeof(T));
+          }
+        }
+      }
+    }
+  }
+}
+
+/// Transposes \p inW into \p outW. The permutation is collapsed first, and
+/// the common ones (2-D and batched 2-D transposes such as NCHW <-> NHWC, and
+/// swaps of two middle dims such as 0213) run as blocked transposes. The
+/// others fall back to libjit_transpose_generic.
+template <typename T>
+static void libjit_transpose(const T *inW, T *outW, const dim_t *idim,
+                             const dim_t *odim, const dim_t *shuffle,
+                             dim_t numDims) {
+  dim_t cdim[6];
+  dim_t cshuffle[6];
+  dim_t n = libjit_collapse_transpose(idim, shuffle, numDims, cdim, cshuffle);
+  if (n == 1) {
+    memcpy(outW, inW, cdim[0] * sizeof(T));
+    return;
+  }
+  if (n == 2) {
+    libjit_transpose_blocked(inW, outW, 1, cdim[0], cdim[1], 1);
+    return;
+  }
+  if (n == 3 && cshuffle[0] == 0) {
+    libjit_transpose_blocked(inW, outW, cdim[0], cdim[1], cdim[2], 1);
+    return;
+  }
+  if (n == 3 && cshuffle[2] == 2) {
+    libjit_transpose_blocked(inW, outW, 1, cdim[0], cdim[1], cdim[2]);
+    return;
+  }
+  if (n == 4 && cshuffle[0] == 0 && cshuffle[1] == 2 && cshuffle[2] == 1) {
+    libjit_transpose_blocked(inW, outW, cdim[0], cdim[1], cdim[2], cdim[3]);
+    return;
+  }
+  libjit_transpose_generic(inW, outW, idim, odim, shuffle, numDims);
+}
+
 template <typename T>
 static void libjit_flip_generic(const T *inW, T *outW, const dim_t *dims,
                                 dim_t axis, dim_t numDims) {
@@ -1042,6 +1231,160 @@ DEFINE_REDUCE_MINMAX_KERNEL(min)
 
 #undef DEFINE_REDUCE_MINMAX_KERNEL
 
+/// Collapses the reduction of \p batchDims into \p destDims, both expanded to
+/// 6 dims, into the reduction of the middle dim of an [outer, len, inner]
+/// tensor, skipping dims of size 1. \returns false if the reduced dims are not
+/// adjacent, in which case the reduction cannot be collapsed.
+static bool libjit_collapse_reduce(const dim_t *batchDims,
+                                   const dim_t *destDims, dim_t *outer,
+                                   dim_t *len, dim_t *inner) {
+  *outer = *len = *inner = 1;
+  // Whether the dims seen so far are before, in or after the reduced dims.
+  enum { Before, In, After } state = Before;
+  for (dim_t i = 0; i < 6; i++) {
+    if (batchDims[i] == 1) {
+      continue;
+    }
+    if (destDims[i] == 1) {
+      if (state == After) {
+        return false;
+      }
+      state = In;
+      *len *= batchDims[i];
+    } else if (state == Before) {
+      *outer *= batchDims[i];
+    } else {
+      state = After;
+      *inner *= batchDims[i];
+    }
+  }
+  return true;
+}
+
+/// Reduction operators of the collapsed reduce kernels.
+struct libjit_reduce_add {
+  template <typename T> static T apply(T a, T b) { return a + b; }
+};
+struct libjit_reduce_min {
+  template <typename T> static T apply(T a, T b) { return std::min(a, b); }
+};
+struct libjit_reduce_max {
+  template <typename T> static T apply(T a, T b) { return std::max(a, b); }
+};
+
+/// Number of rows reduced together by the contiguous reductions, so that the
+/// loads of the rows overlap.
+#define REDUCE_ROWS 4
+
+/// Number of elements of the destination that are accumulated at once by the
+/// strided reductions, small enough to stay in L1 cache.
+#define REDUCE_BLOCK 1024
+
+/// Reduces each of the \p rows contiguous rows of \p len elements of \p batch
+/// into an element of \p dest, starting from \p init. Each row is accumulated
+/// in 8 independent lanes that the compiler maps to a vector register.
+template <typename T, typename Op, dim_t rows>
+static void libjit_reduce_rows(T *dest, const T *batch, dim_t len, T init) {
+  T acc[rows][8];
+  for (dim_t r = 0; r < rows; r++) {
+    for (dim_t j = 0; j < 8; j++) {
+      acc[r][j] = init;
+    }
+  }
+  dim_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    for (dim_t r = 0; r < rows; r++) {
+      for (dim_t j = 0; j < 8; j++) {
+        acc[r][j] = Op::apply(acc[r][j], batch[r * len + i + j]);
+      }
+    }
+  }
+  for (dim_t r = 0; r < rows; r++) {
+    T res = acc[r][0];
+    for (dim_t j = 1; j < 8; j++) {
+      res = Op::apply(res, acc[r][j]);
+    }
+    for (dim_t k = i; k < len; k++) {
+      res = Op::apply(res, batch[r * len + k]);
+    }
+    dest[r] = res;
+  }
+}
+
+/// Float sums accumulate explicitly in float8 registers.
+template <>
+void libjit_reduce_rows<float, libjit_reduce_add, REDUCE_ROWS>(
+    float *dest, const float *batch, dim_t len, float init) {
+  float8 acc[REDUCE_ROWS];
+  for (dim_t r = 0; r < REDUCE_ROWS; r++) {
+    acc[r] = BroadcastFloat8(0.0f);
+  }
+  dim_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    for (dim_t r = 0; r < REDUCE_ROWS; r++) {
+      acc[r] += LoaduFloat8(batch + r * len + i);
+    }
+  }
+  for (dim_t r = 0; r < REDUCE_ROWS; r++) {
+    float res = init;
+    for (dim_t j = 0; j < 8; j++) {
+      res += acc[r][j];
+    }
+    for (dim_t k = i; k < len; k++) {
+      res += batch[r * len + k];
+    }
+    dest[r] = res;
+  }
+}
+
+/// Reduces the [outer, len, inner] tensor \p batch over its middle dim into
+/// the [outer, inner] tensor \p dest, starting from \p init. Contiguous rows
+/// (inner == 1) are reduced REDUCE_ROWS at a time. Otherwise whole rows of
+/// \p inner elements are accumulated into a block of \p dest at a time, so
+/// that the reduced dim is never transposed to the end.
+template <typename T, typename Op>
+static void libjit_reduce_collapsed(T *dest, const T *batch, dim_t outer,
+                                    dim_t len, dim_t inner, T init) {
+  if (inner == 1) {
+    dim_t o = 0;
+    for (; o + REDUCE_ROWS <= outer; o += REDUCE_ROWS) {
+      libjit_reduce_rows<T, Op, REDUCE_ROWS>(dest + o, batch + o * len, len,
+                                             init);
+    }
+    for (; o < outer; o++) {
+      libjit_reduce_rows<T, Op, 1>(dest + o, batch + o * len, len, init);
+    }
+    return;
+  }
+  for (dim_t o = 0; o < outer; o++) {
+    for (dim_t i0 = 0; i0 < inner; i0 += REDUCE_BLOCK) {
+      dim_t ib = MIN(inner - i0, REDUCE_BLOCK);
+      T *d = dest + o * inner + i0;
+      const T *b = batch + o * len * inner + i0;
+      for (dim_t i = 0; i < ib; i++) {
+        d[i] = init;
+      }
+      dim_t a = 0;
+      for (; a + REDUCE_ROWS <= len; a += REDUCE_ROWS) {
+        const T *b0 = b + a * inner;
+        const T *b1 = b0 + inner;
+        const T *b2 = b1 + inner;
+        const T *b3 = b2 + inner;
+        for (dim_t i = 0; i < ib; i++) {
+          d[i] = Op::apply(Op::apply(d[i], Op::apply(b0[i], b1[i])),
+                           Op::apply(b2[i], b3[i]));
+        }
+      }
+      for (; a < len; a++) {
+        const T *row = b + a * inner;
+        for (dim_t i = 0; i < ib; i++) {
+          d[i] = Op::apply(d[i], row[i]);
+        }
+      }
+    }
+  }
+}
+
 template <typename T, typename T2>
 static void libjit_cross_entropy_loss_generic(T *CE, T *P, T2 *labels,
                                               dim_t *dims) {
@@ -1447,6 +1790,33 @@ void libjit_max_pool_argmax_grad_generic(T *inG, const T *outG,
     }     // C
   }       // N
 }
+
+/// Number of independent accumulators used by the row-wise kernels below.
+/// Keeping the partial results in separate lanes lets the compiler vectorize
+/// the reductions without reassociating floating point math.
+#define LIBJIT_ROW_LANES 8
+
+/// \returns the maximum of the \p n > 0 contiguous values at \p row.
+float libjit_row_max_f(const float *row, dim_t n) {
+  float lanes[LIBJIT_ROW_LANES];
+  for (dim_t l = 0; l < LIBJIT_ROW_LANES; l++) {
+    lanes[l] = row[0];
+  }
+  dim_t i = 0;
+  for (; i + LIBJIT_ROW_LANES <= n; i += LIBJIT_ROW_LANES) {
+    for (dim_t l = 0; l < LIBJIT_ROW_LANES; l++) {
+      lanes[l] = MAX(lanes[l], row[i + l]);
+    }
+  }
+  float max = lanes[0];
+  for (dim_t l = 1; l < LIBJIT_ROW_LANES; l++) {
+    max = MAX(max, lanes[l]);
+  }
+  for (; i < n; i++) {
+    max = MAX(max, row[i]);
+  }
+  return max;
+}
 } // namespace
 
 extern "C" {
@@ -1541,6 +1911,10 @@ DEFINE_DATA_PARALLEL_KERNEL(libjit_element_pow_kernel_f, float,
                             pow(LHS[idx], RHS[idx]))
 DEFINE_DATA_PARALLEL_KERNEL(libjit_element_log_kernel_f, float, log(LHS[idx]))
 DEFINE_DATA_PARALLEL_KERNEL(libjit_element_exp_kernel_f, float, exp(LHS[idx]))
+DEFINE_DATA_PARALLEL_KERNEL(libjit_element_log_fast_kernel_f, float,
+                            libjit_fast_logf(LHS[idx]))
+DEFINE_DATA_PARALLEL_KERNEL(libjit_element_exp_fast_kernel_f, float,
+                            libjit_fast_expf(LHS[idx]))
 DEFINE_DATA_PARALLEL_KERNEL(libjit_element_abs_kernel_f, float,
                             std::abs(LHS[idx]))
 DEFINE_DATA_PARALLEL_KERNEL(libjit_element_neg_kernel_f, float, -LHS[idx])
@@ -1698,6 +2072,33 @@ DEFINE_DATA_PARALLEL_KERNEL_FUNC(libjit_tanh_kernel_f) {
 }
 #endif // FFAST_MATH
 
+// GeLU with the tanh approximation used by the lowering of the Gelu node:
+// 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))). The tanh is
+// computed from exp(-2 * |z|) so that it does not overflow.
+DEFINE_DATA_PARALLEL_KERNEL_FUNC(libjit_gelu_kernel_f) {
+  float x = LHS[idx];
+  float z = 0.7978845608f * (x + 0.044715f * x * x * x);
+  float tanhVal = -1 + 2 / (expf(-2 * std::abs(z)) + 1);
+  return 0.5f * x * (1 + std::copysignf(tanhVal, z));
+}
+
+// The fast kernels are selected instead of the ones above when compiling with
+// fast transcendentals. They use the polynomial approximations of
+// libjit_defs.h, which LLVM vectorizes.
+DEFINE_DATA_PARALLEL_KERNEL_FUNC(libjit_tanh_fast_kernel_f) {
+  return libjit_fast_tanhf(LHS[idx]);
+}
+
+// 0.5 * (1 + tanh(z)) is sigmoid(2 * z), which does not cancel for negative z.
+// The error is dominated by the rounding of z, as for the kernel above: it is
+// at most 16 ULP for x >= -3 and grows to 2^8 ULP at x = -9.6, where the kernel
+// above already returns 0.
+DEFINE_DATA_PARALLEL_KERNEL_FUNC(libjit_gelu_fast_kernel_f) {
+  float x = LHS[idx];
+  float z = 0.7978845608f * (x + 0.044715f * x * x * x);
+  return x * libjit_fast_sigmoidf(2 * z);
+}
+
 int8_t libjit_intlookuptable_kernel_i8(dim_t idx, const int8_t *src,
                                        const int8_t *mapping) {
   return mapping[src[idx] + 128];
@@ -1788,6 +2189,10 @@ DEFINE_DATA_PARALLEL_KERNEL_FUNC(libjit_sigmoid_kernel_f) {
 }
 #endif // FFAST_MATH
 
+DEFINE_DATA_PARALLEL_KERNEL_FUNC(libjit_sigmoid_fast_kernel_f) {
+  return libjit_fast_sigmoidf(LHS[idx]);
+}
+
 DEFINE_DATA_PARALLEL_KERNEL_WITH_IMM_OPERAND(libjit_splat_kernel_f, float, val)
 DEFINE_DATA_PARALLEL_KERNEL_WITH_IMM_OPERAND(libjit_splat_kernel_u, int64_t,
                                              val)
@@ -1807,8 +2212,13 @@ void libjit_batchedadd_f(float *dest, const float *batch, const float *slice,
   // For each layer in the batch:
   for (dim_t n = 0; n < numSlice; n++) {
     dim_t base = n * sliceSize;
-    // For each element in the slice.
-    for (dim_t i = 0; i < sliceSize; i++) {
+    // For each element in the slice, eight at a time.
+    dim_t i = 0;
+    for (; i + 8 <= sliceSize; i += 8) {
+      StoreuFloat8(dest + base + i,
+                   LoaduFloat8(batch + base + i) + LoaduFloat8(slice + i));
+    }
+    for (; i < sliceSize; i++) {
       dest[base + i] = batch[base + i] + slice[i];
     }
   }
@@ -1842,9 +2252,18 @@ void libjit_batchedadd_i32_i8(int8_t *dest, const int8_t *batch,
 
 /// The dimensions passed in here are pre-expanded in LLVMIRGen with 1s so that
 /// we can iterate over the shape here, regardless of the shape of the tensor.
+/// The reduction is collapsed to the [outer, len, inner] view and vectorized;
+/// the loops over all the dims are the fallback.
 void libjit_batchedreduceadd_f(float *dest, const float *batch, dim_t destSize,
                                const dim_t *destDims, const dim_t *batchDims,
                                dim_t axis) {
+  dim_t outer, len, inner;
+  if (libjit_collapse_reduce(batchDims, destDims, &outer, &len, &inner)) {
+    libjit_reduce_collapsed<float, libjit_reduce_add>(dest, batch, outer, len,
+                                                      inner, 0.0f);
+    return;
+  }
+
   for (dim_t i = 0; i < destSize; i++)
     dest[i] = 0.0;
 
@@ -1862,27 +2281,33 @@ void libjit_batchedreduceadd_f(float *dest, const float *batch, dim_t destSize,
             }
 }
 
-/// Macro to reducemin/max wrapper kernels.
-#define DEFINE_REDUCE_MINMAX(func, suffix, type, init)                         \
+/// Macro to reducemin/max wrapper kernels. Reductions over adjacent axes are
+/// collapsed and vectorized, the others use the generic kernels.
+#define DEFINE_REDUCE_MINMAX(func, op, suffix, type, init)                     \
   void func##_##suffix(type *dest, const type *batch, size_t destSize,         \
                        const dim_t *destDims, const dim_t *batchDims) {        \
+    dim_t outer, len, inner;                                                   \
+    if (libjit_collapse_reduce(batchDims, destDims, &outer, &len, &inner)) {   \
+      libjit_reduce_collapsed<type, op>(dest, batch, outer, len, inner, init); \
+      return;                                                                  \
+    }                                                                          \
     func(dest, batch, destSize, destDims, batchDims, init);                    \
   }
 
 /// Define reducemin wrapper kernels for float, int32_t and int64_t
-DEFINE_REDUCE_MINMAX(libjit_reducemin, f, float,
+DEFINE_REDUCE_MINMAX(libjit_reducemin, libjit_reduce_min, f, float,
                      std::numeric_limits<float>::infinity());
-DEFINE_REDUCE_MINMAX(libjit_reducemin, u, int64_t,
+DEFINE_REDUCE_MINMAX(libjit_reducemin, libjit_reduce_min, u, int64_t,
                      std::numeric_limits<int64_t>::max());
-DEFINE_REDUCE_MINMAX(libjit_reducemin, i32, int32_t,
+DEFINE_REDUCE_MINMAX(libjit_reducemin, libjit_reduce_min, i32, int32_t,
                      std::numeric_limits<int32_t>::max());
 
 /// Define reducemax wrapper kernels for float, int32_t and int64_t
-DEFINE_REDUCE_MINMAX(libjit_reducemax, f, float,
+DEFINE_REDUCE_MINMAX(libjit_reducemax, libjit_reduce_max, f, float,
                      (-std::numeric_limits<float>::infinity()));
-DEFINE_REDUCE_MINMAX(libjit_reducemax, u, int64_t,
+DEFINE_REDUCE_MINMAX(libjit_reducemax, libjit_reduce_max, u, int64_t,
                      std::numeric_limits<int64_t>::min());
-DEFINE_REDUCE_MINMAX(libjit_reducemax, i32, int32_t,
+DEFINE_REDUCE_MINMAX(libjit_reducemax, libjit_reduce_max, i32, int32_t,
                      std::numeric_limits<int32_t>::min());
 
 #undef DEF_REDUCE_MINMAX_WRAPPER_F
@@ -2779,26 +3204,104 @@ int8_t libjit_element_rescale_kernel_i8(dim_t idx, const int8_t *inW,
 
 void libjit_softmax_f(const float *inW, float *outW, const dim_t *idim,
                       const dim_t *odim) {
+  dim_t size = idim[1];
   for (dim_t n = 0; n < idim[0]; n++) {
-    float max = inW[libjit_getXY(idim, n, 0)];
-
-    // Find Max.
-    for (dim_t i = 1; i < idim[1]; i++) {
-      max = MAX(max, inW[libjit_getXY(idim, n, i)]);
+    const float *in = inW + n * idim[1];
+    float *out = outW + n * odim[1];
+
+    float max = libjit_row_max_f(in, size);
+
+    // Compute exp and accumulate the sum in the same pass.
+    float sums[LIBJIT_ROW_LANES] = {0};
+    dim_t i = 0;
+    for (; i + LIBJIT_ROW_LANES <= size; i += LIBJIT_ROW_LANES) {
+      for (dim_t l = 0; l < LIBJIT_ROW_LANES; l++) {
+        float e = expf(in[i + l] - max);
+        sums[l] += e;
+        out[i + l] = e;
+      }
     }
-
     float sum = 0;
-
-    // Compute exp.
-    for (dim_t i = 0; i < idim[1]; i++) {
-      float e = expf(inW[libjit_getXY(idim, n, i)] - max);
+    for (dim_t l = 0; l < LIBJIT_ROW_LANES; l++) {
+      sum += sums[l];
+    }
+    for (; i < size; i++) {
+      float e = expf(in[i] - max);
       sum += e;
-      outW[libjit_getXY(odim, n, i)] = e;
+      out[i] = e;
     }
 
     // Normalize the output.
-    for (dim_t i = 0; i < idim[1]; i++) {
-      outW[libjit_getXY(odim, n, i)] = outW[libjit_getXY(odim, n, i)] / sum;
+    float invSum = 1 / sum;
+    for (i = 0; i < size; i++) {
+      out[i] *= invSum;
+    }
+  } // N
+}
+
+/// Performs layer normalization of the \p numRows contiguous rows of
+/// \p rowSize elements in \p inW, followed by the element-wise \p scaleW and
+/// \p biasW of size \p rowSize, and stores the result to \p outW. The mean
+/// and variance are computed in two passes over the row shifted by its first
+/// element, so that rows with a large common offset do not lose the variance
+/// to cancellation. The shifted row is kept in \p outW, which also stops
+/// -ffast-math from folding the shift back into the mean.
+void libjit_layernorm_f(float *outW, const float *inW, const float *scaleW,
+                        const float *biasW, dim_t numRows, dim_t rowSize,
+                        float epsilon) {
+  for (dim_t n = 0; n < numRows; n++) {
+    const float *in = inW + n * rowSize;
+    float *out = outW + n * rowSize;
+    float shift = in[0];
+
+    // First pass: shift the row and compute its mean.
+    float sums[LIBJIT_ROW_LANES] = {0};
+    dim_t i = 0;
+    for (; i + LIBJIT_ROW_LANES <= rowSize; i += LIBJIT_ROW_LANES) {
+      for (dim_t l = 0; l < LIBJIT_ROW_LANES; l++) {
+        out[i + l] = in[i + l] - shift;
+        sums[l] += out[i + l];
+      }
+    }
+    float sum = 0;
+    for (dim_t l = 0; l < LIBJIT_ROW_LANES; l++) {
+      sum += sums[l];
+    }
+    for (; i < rowSize; i++) {
+      out[i] = in[i] - shift;
+      sum += out[i];
+    }
+    float mean = sum / rowSize;
+
+    // Second pass: the centered sum of squares. The centered sum corrects the
+    // rounding error of the mean (the corrected two-pass algorithm).
+    float sumsC[LIBJIT_ROW_LANES] = {0};
+    float sumsSq[LIBJIT_ROW_LANES] = {0};
+    for (i = 0; i + LIBJIT_ROW_LANES <= rowSize; i += LIBJIT_ROW_LANES) {
+      for (dim_t l = 0; l < LIBJIT_ROW_LANES; l++) {
+        float c = out[i + l] - mean;
+        sumsC[l] += c;
+        sumsSq[l] += c * c;
+      }
+    }
+    float sumC = 0;
+    float sumSq = 0;
+    for (dim_t l = 0; l < LIBJIT_ROW_LANES; l++) {
+      sumC += sumsC[l];
+      sumSq += sumsSq[l];
+    }
+    for (; i < rowSize; i++) {
+      float c = out[i] - mean;
+      sumC += c;
+      sumSq += c * c;
+    }
+    float correction = sumC / rowSize;
+    float var = MAX(sumSq / rowSize - correction * correction, 0.0f);
+    mean += correction;
+
+    float invStdDev = 1 / sqrtf(var + epsilon);
+    for (i = 0; i < rowSize; i++) {
+      out[i] = (out[i] - mean) * invStdDev * scaleW[i] + biasW[i];
     }
   } // N
 }
@@ -2837,25 +3340,25 @@ void libjit_topk_i8_i32(int8_t *values, int32_t *indices, const int8_t *input,
 void libjit_transpose_i8(const int8_t *inW, int8_t *outW, const dim_t *idim,
                          const dim_t *odim, const dim_t *shuffle,
                          dim_t numDims) {
-  libjit_transpose_generic(inW, outW, idim, odim, shuffle, numDims);
+  libjit_transpose(inW, outW, idim, odim, shuffle, numDims);
 }
 
 void libjit_transpose_f(const float *inW, float *outW, const dim_t *idim,
                         const dim_t *odim, const dim_t *shuffle,
                         dim_t numDims) {
-  libjit_transpose_generic(inW, outW, idim, odim, shuffle, numDims);
+  libjit_transpose(inW, outW, idim, odim, shuffle, numDims);
 }
 
 void libjit_transpose_u(const int64_t *inW, int64_t *outW, const dim_t *idim,
                         const dim_t *odim, const dim_t *shuffle,
                         dim_t numDims) {
-  libjit_transpose_generic(inW, outW, idim, odim, shuffle, numDims);
+  libjit_transpose(inW, outW, idim, odim, shuffle, numDims);
 }
 
 void libjit_transpose_b(const bool *inW, bool *outW, const dim_t *idim,
                         const dim_t *odim, const dim_t *shuffle,
                         dim_t numDims) {
-  libjit_transpose_generic(inW, outW, idim, odim, shuffle, numDims);
+  libjit_transpose(inW, outW, idim, odim, shuffle, numDims);
 }
 
 void libjit_flip_i8(const int8_t *inW, int8_t *outW, const dim_t *dims,
@@ -54,7 +54,13 @@ void libjit_quantized_conv2d_generic(
     const dim_t *strides, const dim_t *pads, dim_t group, int32_t outOffset,
     int32_t inOffset, int32_t filterOffset, int32_t biasOffset, int32_t biasPre,
     int32_t biasPost, int32_t biasScale, int32_t outPre, int32_t outPost,
-    int32_t outScale, unsigned depthUnroll, const dim_t *dilation) {
+    int32_t outScale, unsigned depthUnroll, const dim_t *dilation,
+    int32_t fusedActivation) {
+  // Only ReLU is fused into quantized convolutions. It clamps the result at
+  // the quantized zero.
+  int32_t minOut = fusedActivation == LIBJIT_FUSED_ACTIVATION_RELU
+                       ? MAX(outOffset, -128)
+                       : -128;
   dim_t inChannels = inWdims[3];
   dim_t outChannels = outWdims[3];
   dim_t inCperG = inChannels / group;
@@ -134,7 +140,7 @@ void libjit_quantized_conv2d_generic(
               int32_t scaledSum = libjit_scale_i32i8(sum[i], outPre, outPost,
                                                      outScale, outOffset);
               outW[libjit_getXYZW(outWdims, n, ax, ay, d + i)] =
-                  libjit_clip(scaledSum);
+                  libjit_clip(MAX(scaledSum, minOut));
             }
           } // W
         }   // H
@@ -346,7 +352,8 @@ void libjit_conv2d_f(float *outW, const float *inW, const float *filterW,
                      const dim_t *inWdims, const dim_t *filterWdims,
                      const dim_t *biasWdims, const dim_t *kernelSizes,
                      const dim_t *strides, const dim_t *pads, dim_t group,
-                     unsigned depthUnroll, const dim_t *dilation) {
+                     unsigned depthUnroll, const dim_t *dilation,
+                     int32_t fusedActivation) {
   dim_t inChannels = inWdims[3];
   dim_t outChannels = outWdims[3];
   dim_t inCperG = inChannels / group;
@@ -387,6 +394,10 @@ void libjit_conv2d_f(float *outW, const float *inW, const float *filterW,
           // For each element in the convolution-filter:
           for (dim_t fx = 0; fx < kernel_h; fx++) {
             for (dim_t fy = 0; fy < kernel_w; fy++) {
+              // The last filter element of the last channel block completes
+              // the output pixels, which then get the fused activation.
+              bool lastTap = cb + cbSize >= inCperG && fx + 1 == kernel_h &&
+                             fy + 1 == kernel_w;
 
               // For each convolution 'jump' in the input tensor:
               for (dim_t outx = 0; outx < outWdims[1]; outx++) {
@@ -413,6 +424,11 @@ void libjit_conv2d_f(float *outW, const float *inW, const float *filterW,
                   // Ignore index access below zero (this is due to padding).
                   if (inx < 0 || iny < 0 || inx >= (sdim_t)inWdims[1] ||
                       iny >= (sdim_t)inWdims[2]) {
+                    if (lastTap) {
+                      libjit_conv_apply_fused_activation(
+                          outW, outWdims, n, outx, outy, outy + 1, d,
+                          d + depthUnroll, fusedActivation);
+                    }
                     continue;
                   }
 
@@ -446,10 +462,19 @@ void libjit_conv2d_f(float *outW, const float *inW, const float *filterW,
                     }
                   }
 
-                  // Store the results to the output buffer.
-                  for (unsigned i = 0; i < depthUnroll; i++) {
-                    outW[libjit_getXYZW(outWdims, n, outx, outy, d + i)] +=
-                        sum[i];
+                  // Store the results to the output buffer, applying the
+                  // fused activation once they are complete.
+                  float *out =
+                      &outW[libjit_getXYZW(outWdims, n, outx, outy, d)];
+                  if (lastTap) {
+                    for (unsigned i = 0; i < depthUnroll; i++) {
+                      out[i] = libjit_fused_activation_f(out[i] + sum[i],
+                                                         fusedActivation);
+                    }
+                  } else {
+                    for (unsigned i = 0; i < depthUnroll; i++) {
+                      out[i] += sum[i];
+                    }
                   }
                 }
               }
@@ -468,12 +493,13 @@ void libjit_conv2d_i8_i32(
     const dim_t *strides, const dim_t *pads, dim_t group, int32_t outOffset,
     int32_t inOffset, int32_t filterOffset, int32_t biasOffset, int32_t biasPre,
     int32_t biasPost, int32_t biasScale, int32_t outPre, int32_t outPost,
-    int32_t outScale, unsigned depthUnroll, const dim_t *dilation) {
+    int32_t outScale, unsigned depthUnroll, const dim_t *dilation,
+    int32_t fusedActivation) {
   libjit_quantized_conv2d_generic<int8_t, int32_t>(
       outW, inW, filterW, biasW, outWdims, inWdims, filterWdims, biasWdims,
       kernelSizes, strides, pads, group, outOffset, inOffset, filterOffset,
       biasOffset, biasPre, biasPost, biasScale, outPre, outPost, outScale,
-      depthUnroll, dilation);
+      depthUnroll, dilation, fusedActivation);
 }
 
 void libjit_conv2d_i8_i8(int8_t *outW, const int8_t *inW, const int8_t *filterW,
@@ -485,12 +511,13 @@ void libjit_conv2d_i8_i8(int8_t *outW, const int8_t *inW, const int8_t *filterW,
                          int32_t filterOffset, int32_t biasOffset,
                          int32_t biasPre, int32_t biasPost, int32_t biasScale,
                          int32_t outPre, int32_t outPost, int32_t outScale,
-                         unsigned depthUnroll, const dim_t *dilation) {
+                         unsigned depthUnroll, const dim_t *dilation,
+                         int32_t fusedActivation) {
   libjit_quantized_conv2d_generic<int8_t, int8_t>(
       outW, inW, filterW, biasW, outWdims, inWdims, filterWdims, biasWdims,
       kernelSizes, strides, pads, group, outOffset, inOffset, filterOffset,
       biasOffset, biasPre, biasPost, biasScale, outPre, outPost, outScale,
-      depthUnroll, dilation);
+      depthUnroll, dilation, fusedActivation);
 }
 
 void libjit_channelwise_quantized_conv2d_i8_i32(
@@ -17,6 +17,7 @@
 #define GLOW_LLVMIRCODEGEN_LIBJIT_LIBJIT_DEFS_H
 
 #include <cstdlib>
+#include <math.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -51,6 +52,16 @@ using float8 = float __attribute__((vector_size(32)));
 #define BroadcastFloat8(VAL) ((VAL) - (float8){0})
 #endif
 
+/// Shuffles the elements of the float8 values A and B into a float8, where the
+/// indices 0-7 select elements of A and the indices 8-15 elements of B.
+#if defined(__clang__)
+#define ShuffleFloat8(A, B, ...) __builtin_shufflevector(A, B, __VA_ARGS__)
+#elif defined(__GNUC__) || defined(__GNUG__)
+using shufflemask8 = int32_t __attribute__((vector_size(32)));
+#define ShuffleFloat8(A, B, ...)                                               \
+  __builtin_shuffle(A, B, (shufflemask8){__VA_ARGS__})
+#endif
+
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 #define AT(tensor, dims, numDims, indices, numIndices)                         \
@@ -109,6 +120,160 @@ inline int8_t libjit_clip(int32_t val) {
   return (int8_t)MIN(MAX(val, -128), 127);
 }
 
+/// \returns the bits of \p x.
+inline int32_t libjit_float_as_bits(float x) {
+  int32_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+/// \returns the float whose bits are \p bits.
+inline float libjit_bits_as_float(int32_t bits) {
+  float x;
+  memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+/// \returns true if \p x is a NaN. The bits are tested so that the check
+/// survives -ffast-math.
+inline bool libjit_is_nan(float x) {
+  return (libjit_float_as_bits(x) & 0x7fffffff) > 0x7f800000;
+}
+
+/// The fast approximations below evaluate polynomials with no calls into
+/// libm and no data-dependent branches, so that LLVM vectorizes the loops of
+/// the data-parallel kernels that use them. The coefficients are the Cephes
+/// single precision ones. libjit is built with -ffast-math, so they are
+/// written to stay accurate under reassociation: the argument reductions are
+/// done in double precision instead of with a split ln(2), and powers of two
+/// are applied to the exponent bits instead of by chained multiplications.
+/// The error bounds are measured against a double precision reference over
+/// all finite floats, both with and without -ffast-math.
+
+/// The largest float whose exponential is finite.
+#define LIBJIT_FAST_EXPF_MAX 88.72283172607421875f
+
+/// Fast approximation of expf(\p x), with an error of at most 2 ULP (1 ULP
+/// without -ffast-math). Results below FLT_MIN are denormals, and results
+/// above FLT_MAX are +inf.
+inline float libjit_fast_expf(float x) {
+  // exp(x) = 2^n * exp(r) with |r| <= ln(2) / 2. n is rounded with a
+  // truncation, which rounds down as the argument is positive.
+  float xc = MIN(MAX(x, -104.0f), LIBJIT_FAST_EXPF_MAX);
+  int32_t n = (int32_t)(xc * 1.44269504088896341f + 150.5f) - 150;
+  float r = (float)((double)xc - (double)n * 0.693147180559945309);
+  float p = 1.9875691500e-4f;
+  p = p * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  float y = p * r * r + r + 1;
+  // y is in [0.7, 1.5], so adding n to its exponent keeps it normal down to
+  // n = -120. Smaller results are scaled the rest of the way by a single
+  // multiplication, which rounds denormals correctly.
+  int32_t ny = MAX(n, -120);
+  y = libjit_bits_as_float(libjit_float_as_bits(y) + ny * (1 << 23)) *
+      libjit_bits_as_float((n - ny + 127) << 23);
+  y = x > LIBJIT_FAST_EXPF_MAX ? libjit_bits_as_float(0x7f800000) : y;
+  return libjit_is_nan(x) ? x : y;
+}
+
+/// Fast approximation of logf(\p x), with an error of at most 1 ULP.
+inline float libjit_fast_logf(float x) {
+  int32_t bits = libjit_float_as_bits(x);
+  // Scale denormals up into the normal range.
+  bool denormal = bits < 0x00800000;
+  int32_t scaledBits = libjit_float_as_bits(denormal ? x * 8388608.0f : x);
+  // x = 2^e * m with m in [sqrt(2) / 2, sqrt(2)).
+  int32_t e = ((scaledBits >> 23) & 0xff) - 126 - (denormal ? 23 : 0);
+  float m = libjit_bits_as_float((scaledBits & 0x007fffff) | 0x3f000000);
+  bool low = m < 0.707106781186547524f;
+  e = low ? e - 1 : e;
+  m = low ? m + m - 1 : m - 1;
+  float z = m * m;
+  float p = 7.0376836292e-2f;
+  p = p * m - 1.1514610310e-1f;
+  p = p * m + 1.1676998740e-1f;
+  p = p * m - 1.2420140846e-1f;
+  p = p * m + 1.4249322787e-1f;
+  p = p * m - 1.6668057665e-1f;
+  p = p * m + 2.0000714765e-1f;
+  p = p * m - 2.4999993993e-1f;
+  p = p * m + 3.3333331174e-1f;
+  float y = m + (p * m * z - 0.5f * z);
+  y = (float)((double)y + (double)e * 0.693147180559945309);
+  // log(+-0) = -inf, log(x < 0) = NaN and log(+inf) = +inf.
+  y = bits < 0 ? libjit_bits_as_float(0x7fc00000) : y;
+  y = (bits & 0x7fffffff) == 0 ? libjit_bits_as_float((int32_t)0xff800000) : y;
+  return bits >= 0x7f800000 ? x : y;
+}
+
+/// Fast approximation of tanhf(\p x), with an error of at most 2 ULP.
+inline float libjit_fast_tanhf(float x) {
+  float a = fabsf(x);
+  float z = x * x;
+  float p = -5.70498872745e-3f;
+  p = p * z + 2.06390887954e-2f;
+  p = p * z - 5.37397155531e-2f;
+  p = p * z + 1.33314422036e-1f;
+  p = p * z - 3.33332819422e-1f;
+  float small = p * z * x + x;
+  float large = copysignf(1 - 2 / (libjit_fast_expf(2 * a) + 1), x);
+  return a < 0.625f ? small : large;
+}
+
+/// Fast approximation of 1 / (1 + expf(-\p x)), with an error of at most
+/// 3 ULP. Like the libm based kernel, results below 3e-39, i.e. for \p x below
+/// -88.7, are flushed to 0.
+inline float libjit_fast_sigmoidf(float x) {
+  return 1 / (1 + libjit_fast_expf(-x));
+}
+
+/// Activations fused into the convolution kernels. The values match the
+/// glow::FusedActivation enum.
+enum libjit_fused_activation {
+  LIBJIT_FUSED_ACTIVATION_NONE = 0,
+  LIBJIT_FUSED_ACTIVATION_RELU = 1,
+  LIBJIT_FUSED_ACTIVATION_TANH = 2,
+  LIBJIT_FUSED_ACTIVATION_SIGMOID = 3,
+};
+
+/// \returns \p x with the fused activation \p activation applied. Tanh and
+/// Sigmoid are computed from exp(-|x|) so that they do not overflow.
+inline float libjit_fused_activation_f(float x, int32_t activation) {
+  switch (activation) {
+  case LIBJIT_FUSED_ACTIVATION_RELU:
+    return MAX(x, 0.0f);
+  case LIBJIT_FUSED_ACTIVATION_TANH:
+    return copysignf(-1 + 2 / (expf(-2 * fabsf(x)) + 1), x);
+  case LIBJIT_FUSED_ACTIVATION_SIGMOID:
+    return (float)signbit(x) + copysignf(1 / (1 + expf(-fabsf(x))), x);
+  default:
+    return x;
+  }
+}
+
+/// Applies the fused activation \p activation to the channels [\p dBegin,
+/// \p dEnd) of the output pixels (\p x, [\p yBegin, \p yEnd)) of sample \p n in
+/// \p outW, which has dims \p outWdims. The convolution kernels call this as
+/// soon as these outputs are complete, while they are still in cache.
+inline void libjit_conv_apply_fused_activation(float *outW,
+                                               const dim_t *outWdims, dim_t n,
+                                               dim_t x, dim_t yBegin,
+                                               dim_t yEnd, dim_t dBegin,
+                                               dim_t dEnd, int32_t activation) {
+  if (activation == LIBJIT_FUSED_ACTIVATION_NONE) {
+    return;
+  }
+  for (dim_t y = yBegin; y < yEnd; y++) {
+    float *pixel = outW + libjit_getXYZW(outWdims, n, x, y, 0);
+    for (dim_t d = dBegin; d < dEnd; d++) {
+      pixel[d] = libjit_fused_activation_f(pixel[d], activation);
+    }
+  }
+}
+
 /// Scales a 32-bit integer using the integer shift-mult-shift method.
 /// See QuantizationTransform32To8 for more details.
 inline int32_t libjit_scale_i32i8(int32_t input, int32_t pre, int32_t post,
@@ -15,6 +15,10 @@
  */
 #include "libjit_defs.h"
 
+#ifdef __AVX512VNNI__
+#include <immintrin.h>
+#endif
+
 namespace {
 
 /// Macros for accessing submatrices of a matmul using the leading dimension.
@@ -38,7 +42,13 @@ void libjit_matmul_odd(int m, int n, int k, const float *a, int lda,
 /// Number of registers to use for rows of A in the dot-product kernel.
 constexpr int regsA = 4;
 /// Number of registers to use for columns of B in the dot-product kernel.
+/// AVX-512 has 32 vector registers instead of 16, which fit twice as many
+/// accumulators.
+#ifdef __AVX512F__
+constexpr int regsB = 6;
+#else
 constexpr int regsB = 3;
+#endif
 
 /// Number of rows of A to process in the kernel.  Vector loads are used for A,
 /// so we load eight times as many floats as we use registers.
@@ -46,12 +56,13 @@ constexpr int mr = regsA * 8;
 /// Number of columns of B to process in the kernel.
 constexpr int nr = regsB;
 
-/// Blocking parameters for the outer kernel.  We multiply mc x kc blocks of A
-/// with kc x nc panels of B (this approach is referred to as `gebp` in the
-/// literature).  TODO: Generalize these parameters for other cache sizes.
-constexpr int mc = 256;
-constexpr int kc = 128;
-constexpr int nc = 4096;
+/// Default blocking parameters for the outer kernel.  We multiply mc x kc
+/// blocks of A with kc x nc panels of B (this approach is referred to as `gebp`
+/// in the literature).  Callers may pass their own, e.g. tuned per shape by the
+/// CPU autotuner.
+constexpr dim_t defaultMC = 256;
+constexpr dim_t defaultKC = 128;
+constexpr dim_t defaultNC = 4096;
 
 /// Compute a RAxRB block of C using a vectorized dot product, where RA is the
 /// number of registers to load from matrix A, and RB is the number of registers
@@ -183,7 +194,7 @@ void libjit_matmul_inner(int m, int n, int k, const float *a, int lda,
   // perfectly-tiled portion, which we handly with a 4x16 dot-product kernel.
   // The ragged edges are (ideally) less critical, so we handle them with a call
   // to a general matrix-multiplication for odd sizes.
-  float packedA[m * k] __attribute__((aligned(64)));
+  float packedA[pack ? m * k : 1] __attribute__((aligned(64)));
   if (pack) {
     pack_matrix_a<regsA>(m, k, &A(0, 0), lda, packedA);
   }
@@ -208,18 +219,50 @@ void libjit_matmul_inner(int m, int n, int k, const float *a, int lda,
   }
 }
 
-/// Tile A into mc * kc blocks, where mc and kc are chosen to approximately fit
-/// the L2 cache on recent Intel processors (e.g., 256 KB for Skylake).  Stream
-/// kc * n panels of B through memory to compute each mc * n block of C.
+/// Add \p bias, which may be null, to each column of the \p m x \p n block of C
+/// at \p c and apply the fused activation \p activation to it. If \p q is
+/// given, the block is also quantized with \p qScale and \p qOffset into the
+/// int8 matrix at \p q, which has the leading dimension of C.
+void libjit_matmul_epilogue(dim_t m, dim_t n, const float *bias,
+                            int32_t activation, float *c, dim_t ldc,
+                            int8_t *q, float qScale, int32_t qOffset) {
+  for (dim_t j = 0; j < n; j++) {
+    for (dim_t i = 0; i < m; i++) {
+      float x = bias ? C(i, j) + bias[i] : C(i, j);
+      C(i, j) = libjit_fused_activation_f(x, activation);
+      if (q) {
+        q[j * ldc + i] =
+            libjit_clip((int32_t)nearbyintf(C(i, j) / qScale + qOffset));
+      }
+    }
+  }
+}
+
+/// Tile A into \p mc * \p kc blocks, where mc and kc should approximately fit
+/// the L2 cache (e.g., 256 KB for Skylake).  Stream kc * \p nc panels of B
+/// through memory to compute each mc * n block of C.  Blocking parameters that
+/// are 0 take the defaults, which suit recent Intel processors.
 /// \p a is an \p m x \p k column-major matrix;
 /// \p b is a \p k x \p n column-major matrix;
 /// \p c is a \p m x \p n column-major matrix.
 /// \p lda, \p ldb, and \p ldc are the leading dimensions of A, B, and C,
 /// respectively.
+/// If \p bias is given it is added to each column of C, and the fused
+/// activation \p activation is applied to C, one block at a time as soon as
+/// the block is final. If \p q is given, each final block is then quantized
+/// into it, see libjit_matmul_epilogue.
 template <bool pack>
 void __attribute__((noinline))
 libjit_matmul_outer(dim_t m, dim_t n, dim_t k, const float *a, dim_t lda,
-                    const float *b, dim_t ldb, float *c, dim_t ldc) {
+                    const float *b, dim_t ldb, float *c, dim_t ldc, dim_t mc,
+                    dim_t kc, dim_t nc, const float *bias = nullptr,
+                    int32_t activation = LIBJIT_FUSED_ACTIVATION_NONE,
+                    int8_t *q = nullptr, float qScale = 1,
+                    int32_t qOffset = 0) {
+  mc = mc ? mc : defaultMC;
+  kc = kc ? kc : defaultKC;
+  nc = nc ? nc : defaultNC;
+  bool epilogue = bias || activation != LIBJIT_FUSED_ACTIVATION_NONE || q;
   float *packedB = nullptr;
   if (pack) {
     libjit_aligned_malloc((void **)&packedB, 64, kc * nc);
@@ -236,6 +279,12 @@ libjit_matmul_outer(dim_t m, dim_t n, dim_t k, const float *a, dim_t lda,
         dim_t ib = MIN(m - i, mc);
         libjit_matmul_inner<pack>(ib, jb, pb, &A(i, p), lda, &B(p, j), ldb,
                                   &C(i, j), ldc, packedB);
+        // After the last panel the block is final and still in cache.
+        if (epilogue && p + pb == k) {
+          libjit_matmul_epilogue(ib, jb, bias ? bias + i : nullptr, activation,
+                                 &C(i, j), ldc, q ? &q[j * ldc + i] : nullptr,
+                                 qScale, qOffset);
+        }
       }
     }
   }
@@ -249,6 +298,154 @@ libjit_matmul_outer(dim_t m, dim_t n, dim_t k, const float *a, dim_t lda,
 #undef B
 #undef A
 
+/// Requantizes the int32 accumulator \p sum of column \p y of a quantized
+/// matmul to int8. \p biasW, which may be null, has one value per column that
+/// is scaled to the accumulator with \p biasPre, \p biasPost and
+/// \p biasScale before it is added. The result is clipped to
+/// [\p minOut, 127], where \p minOut is above -128 if a ReLU is fused.
+template <typename BiasElemTy>
+inline int8_t libjit_matmul_i8_epilogue(int32_t sum, const BiasElemTy *biasW,
+                                        dim_t y, int32_t biasOffset,
+                                        int32_t biasPre, int32_t biasPost,
+                                        int32_t biasScale, int32_t outOffset,
+                                        int32_t outPre, int32_t outPost,
+                                        int32_t outScale, int32_t minOut) {
+  if (biasW) {
+    sum += libjit_scale_i32i8((int32_t)biasW[y] - biasOffset, biasPre,
+                              biasPost, biasScale, 0);
+  }
+  int32_t s = libjit_scale_i32i8(sum, outPre, outPost, outScale, outOffset);
+  return libjit_clip(MAX(s, minOut));
+}
+
+#ifdef __AVX512VNNI__
+/// Number of int32 lanes of an AVX-512 register, which is the number of
+/// columns computed at once by the VNNI int8 matmul.
+constexpr dim_t vnniCols = 16;
+
+/// Computes into \p sums the dot products of the \p k values at \p lhs with
+/// the 16 columns at \p rhs of a row-major matrix with \p n columns, four
+/// values at a time using the AVX-512 VNNI instruction vpdpbusd. Since
+/// vpdpbusd multiplies unsigned by signed bytes, 128 is added to the lhs
+/// values, which the caller has to subtract again. The last k % 4 values are
+/// left out.
+void libjit_matmul_i8_vnni_dot(int32_t *sums, const int8_t *lhs,
+                               const int8_t *rhs, dim_t n, dim_t k) {
+  __m512i acc = _mm512_setzero_si512();
+  for (dim_t p = 0; p + 4 <= k; p += 4) {
+    uint32_t a;
+    memcpy(&a, lhs + p, sizeof(a));
+    __m512i aa = _mm512_set1_epi32(a ^ 0x80808080u);
+    // Interleave four rows of 16 columns so that each int32 lane holds the
+    // four values of one column.
+    __m128i r0 = _mm_loadu_si128((const __m128i *)(rhs + p * n));
+    __m128i r1 = _mm_loadu_si128((const __m128i *)(rhs + (p + 1) * n));
+    __m128i r2 = _mm_loadu_si128((const __m128i *)(rhs + (p + 2) * n));
+    __m128i r3 = _mm_loadu_si128((const __m128i *)(rhs + (p + 3) * n));
+    __m128i r01lo = _mm_unpacklo_epi8(r0, r1);
+    __m128i r01hi = _mm_unpackhi_epi8(r0, r1);
+    __m128i r23lo = _mm_unpacklo_epi8(r2, r3);
+    __m128i r23hi = _mm_unpackhi_epi8(r2, r3);
+    __m512i bb = _mm512_castsi128_si512(_mm_unpacklo_epi16(r01lo, r23lo));
+    bb = _mm512_inserti32x4(bb, _mm_unpackhi_epi16(r01lo, r23lo), 1);
+    bb = _mm512_inserti32x4(bb, _mm_unpacklo_epi16(r01hi, r23hi), 2);
+    bb = _mm512_inserti32x4(bb, _mm_unpackhi_epi16(r01hi, r23hi), 3);
+    acc = _mm512_dpbusd_epi32(acc, aa, bb);
+  }
+  _mm512_storeu_si512(sums, acc);
+}
+
+/// Computes the columns of the quantized matmul libjit_matmul_i8 in blocks of
+/// 16 with AVX-512 VNNI. \returns the number of columns computed, the rest
+/// are left to the generic loop. The parameters are those of
+/// libjit_matmul_i8_generic.
+template <typename BiasElemTy>
+dim_t libjit_matmul_i8_vnni(int8_t *outW, const int8_t *lhsW,
+                            const int8_t *rhsW, const BiasElemTy *biasW,
+                            const dim_t *outWdims, const dim_t *lhsWdims,
+                            int32_t outOffset, int32_t lhsOffset,
+                            int32_t rhsOffset, int32_t biasOffset,
+                            int32_t biasPre, int32_t biasPost,
+                            int32_t biasScale, int32_t outPre, int32_t outPost,
+                            int32_t outScale, int32_t minOut) {
+  dim_t m = outWdims[0];
+  dim_t n = outWdims[1];
+  dim_t k = lhsWdims[1];
+  dim_t k4 = k / 4 * 4;
+  dim_t vecN = n / vnniCols * vnniCols;
+  for (dim_t y = 0; y < vecN; y += vnniCols) {
+    // Column sums to remove the lhs bias and to apply the lhs offset.
+    int32_t biasSums[vnniCols];
+    int32_t colSums[vnniCols];
+    for (dim_t c = 0; c < vnniCols; c++) {
+      int32_t sum = 0;
+      for (dim_t i = 0; i < k4; i++) {
+        sum += rhsW[i * n + y + c];
+      }
+      biasSums[c] = sum;
+      for (dim_t i = k4; i < k; i++) {
+        sum += rhsW[i * n + y + c];
+      }
+      colSums[c] = sum;
+    }
+    for (dim_t x = 0; x < m; x++) {
+      const int8_t *lhs = lhsW + x * k;
+      int32_t rowSum = 0;
+      for (dim_t i = 0; i < k; i++) {
+        rowSum += lhs[i];
+      }
+      int32_t sums[vnniCols];
+      libjit_matmul_i8_vnni_dot(sums, lhs, rhsW + y, n, k);
+      for (dim_t c = 0; c < vnniCols; c++) {
+        int32_t sum = sums[c] - 128 * biasSums[c];
+        for (dim_t i = k4; i < k; i++) {
+          sum += lhs[i] * rhsW[i * n + y + c];
+        }
+        sum += -rhsOffset * rowSum - lhsOffset * colSums[c] +
+               int32_t(k) * lhsOffset * rhsOffset;
+        outW[x * n + y + c] = libjit_matmul_i8_epilogue(
+            sum, biasW, y + c, biasOffset, biasPre, biasPost, biasScale,
+            outOffset, outPre, outPost, outScale, minOut);
+      }
+    }
+  }
+  return vecN;
+}
+#endif // __AVX512VNNI__
+
+/// Computes the quantized matmul out = clip(lhs * rhs + bias) of the row-major
+/// \p lhsW and \p rhsW into \p outW, requantizing each int32 accumulator
+/// once, as libjit_matmul_i8_epilogue describes.
+template <typename BiasElemTy>
+void libjit_matmul_i8_generic(
+    int8_t *outW, const int8_t *lhsW, const int8_t *rhsW,
+    const BiasElemTy *biasW, const dim_t *outWdims, const dim_t *lhsWdims,
+    const dim_t *rhsWdims, int32_t outOffset, int32_t lhsOffset,
+    int32_t rhsOffset, int32_t biasOffset, int32_t biasPre, int32_t biasPost,
+    int32_t biasScale, int32_t outPre, int32_t outPost, int32_t outScale,
+    int32_t minOut) {
+  dim_t startY = 0;
+#ifdef __AVX512VNNI__
+  startY = libjit_matmul_i8_vnni(outW, lhsW, rhsW, biasW, outWdims, lhsWdims,
+                                 outOffset, lhsOffset, rhsOffset, biasOffset,
+                                 biasPre, biasPost, biasScale, outPre, outPost,
+                                 outScale, minOut);
+#endif
+  for (dim_t x = 0; x < outWdims[0]; x++) {
+    for (dim_t y = startY; y < outWdims[1]; y++) {
+      int32_t sum = 0;
+      for (dim_t i = 0; i < lhsWdims[1]; i++) {
+        int32_t lhs = lhsW[libjit_getXY(lhsWdims, x, i)] - lhsOffset;
+        int32_t rhs = rhsW[libjit_getXY(rhsWdims, i, y)] - rhsOffset;
+        sum += lhs * rhs;
+      }
+      outW[libjit_getXY(outWdims, x, y)] = libjit_matmul_i8_epilogue(
+          sum, biasW, y, biasOffset, biasPre, biasPost, biasScale, outOffset,
+          outPre, outPost, outScale, minOut);
+    }
+  }
+}
+
 /// Generic template for rowwise quantized FullyConnected. The template allows
 /// choosing element type and bias type.
 template <typename ElemTy, typename BiasElemTy>
@@ -293,9 +490,11 @@ extern "C" {
 /// \p c is a m x n matrix, so \p cDims = {m, n}
 /// \p a is a m x k matrix, so \p aDims = {m, k}
 /// \p b is a k x n matrix, so \p bDims = {k, n}
+/// \p mc, \p kc and \p nc are the blocking of libjit_matmul_outer, where 0
+/// takes the default.
 void libjit_matmul_f(float *c, const float *a, const float *b,
-                     const dim_t *cDims, const dim_t *aDims,
-                     const dim_t *bDims) {
+                     const dim_t *cDims, const dim_t *aDims, const dim_t *bDims,
+                     dim_t mc, dim_t kc, dim_t nc) {
   memset(c, 0, cDims[0] * cDims[1] * sizeof(float));
   // Call the matrix multiplication routine with appropriate dimensions and
   // leading dimensions. The "leading dimension" for a row-major matrix is equal
@@ -317,7 +516,41 @@ void libjit_matmul_f(float *c, const float *a, const float *b,
   // bundles (AOT) for MCU targets where the HEAP and STACK are relatively
   // limited in size. By avoiding heap/stack usage the memory consumption
   // is controlled and perfectly known (e.g. printed in the bundle API).
-  libjit_matmul_outer<false>(m, n, k, b, bDims[1], a, aDims[1], c, cDims[1]);
+  libjit_matmul_outer<false>(m, n, k, b, bDims[1], a, aDims[1], c, cDims[1],
+                             mc, kc, nc);
+}
+
+/// Performs c = act(a * b + bias) like libjit_matmul_f, where \p bias has the
+/// n elements of a row of c and act is \p fusedActivation. The bias and the
+/// activation are applied to each block of c right after its last GEMM panel,
+/// rather than in separate passes over c.
+void libjit_matmul_fused_f(float *c, const float *a, const float *b,
+                           const float *bias, const dim_t *cDims,
+                           const dim_t *aDims, const dim_t *bDims,
+                           int32_t fusedActivation, dim_t mc, dim_t kc,
+                           dim_t nc) {
+  memset(c, 0, cDims[0] * cDims[1] * sizeof(float));
+  // See libjit_matmul_f for why the operands are swapped. The bias is indexed
+  // by the rows of the column-major C.
+  libjit_matmul_outer<false>(cDims[1], cDims[0], aDims[1], b, bDims[1], a,
+                             aDims[1], c, cDims[1], mc, kc, nc, bias,
+                             fusedActivation);
+}
+
+/// Performs q = quantize(act(a * b + bias)) like libjit_matmul_fused_f, where
+/// each block of the float result is quantized into the int8 matrix \p q with
+/// \p qScale and \p qOffset while it is in cache. \p c is the float scratch
+/// buffer that holds the result before it is quantized.
+void libjit_matmul_fused_quantize_f(int8_t *q, float *c, const float *a,
+                                    const float *b, const float *bias,
+                                    const dim_t *cDims, const dim_t *aDims,
+                                    const dim_t *bDims, int32_t fusedActivation,
+                                    dim_t mc, dim_t kc, dim_t nc, float qScale,
+                                    int32_t qOffset) {
+  memset(c, 0, cDims[0] * cDims[1] * sizeof(float));
+  libjit_matmul_outer<false>(cDims[1], cDims[0], aDims[1], b, bDims[1], a,
+                             aDims[1], c, cDims[1], mc, kc, nc, bias,
+                             fusedActivation, q, qScale, qOffset);
 }
 
 void libjit_matmul_i8(int8_t *outW, const int8_t *lhsW, const int8_t *rhsW,
@@ -325,17 +558,92 @@ void libjit_matmul_i8(int8_t *outW, const int8_t *lhsW, const int8_t *rhsW,
                       const dim_t *rhsWdims, int32_t outOffset,
                       int32_t lhsOffset, int32_t rhsOffset, int32_t outPre,
                       int32_t outPost, int32_t outScale) {
-  for (dim_t x = 0; x < outWdims[0]; x++) {
-    for (dim_t y = 0; y < outWdims[1]; y++) {
-      int32_t sum = 0;
-      for (dim_t i = 0; i < lhsWdims[1]; i++) {
-        int32_t lhs = lhsW[libjit_getXY(lhsWdims, x, i)] - lhsOffset;
-        int32_t rhs = rhsW[libjit_getXY(rhsWdims, i, y)] - rhsOffset;
-        sum += lhs * rhs;
-      }
-      int32_t s = libjit_scale_i32i8(sum, outPre, outPost, outScale, outOffset);
-      outW[libjit_getXY(outWdims, x, y)] = libjit_clip(s);
-    }
+  libjit_matmul_i8_generic<int8_t>(outW, lhsW, rhsW, nullptr, outWdims,
+                                   lhsWdims, rhsWdims, outOffset, lhsOffset,
+                                   rhsOffset, 0, 0, 0, 0, outPre, outPost,
+                                   outScale, -128);
+}
+
+/// Performs out = act(lhs * rhs + bias) like libjit_matmul_i8, where \p biasW
+/// has the n elements of a row of out. The int32 accumulators are
+/// requantized only once, with the bias added to them, and only ReLU is fused
+/// as \p fusedActivation: it clips the result at the quantized zero.
+void libjit_matmul_fused_i8_i8(
+    int8_t *outW, const int8_t *lhsW, const int8_t *rhsW, const int8_t *biasW,
+    const dim_t *outWdims, const dim_t *lhsWdims, const dim_t *rhsWdims,
+    int32_t outOffset, int32_t lhsOffset, int32_t rhsOffset,
+    int32_t biasOffset, int32_t biasPre, int32_t biasPost, int32_t biasScale,
+    int32_t outPre, int32_t outPost, int32_t outScale,
+    int32_t fusedActivation) {
+  int32_t minOut = fusedActivation == LIBJIT_FUSED_ACTIVATION_RELU
+                       ? MAX(outOffset, -128)
+                       : -128;
+  libjit_matmul_i8_generic(outW, lhsW, rhsW, biasW, outWdims, lhsWdims,
+                           rhsWdims, outOffset, lhsOffset, rhsOffset,
+                           biasOffset, biasPre, biasPost, biasScale, outPre,
+                           outPost, outScale, minOut);
+}
+
+/// Like libjit_matmul_fused_i8_i8 with an int32 bias.
+void libjit_matmul_fused_i8_i32(
+    int8_t *outW, const int8_t *lhsW, const int8_t *rhsW, const int32_t *biasW,
+    const dim_t *outWdims, const dim_t *lhsWdims, const dim_t *rhsWdims,
+    int32_t outOffset, int32_t lhsOffset, int32_t rhsOffset,
+    int32_t biasOffset, int32_t biasPre, int32_t biasPost, int32_t biasScale,
+    int32_t outPre, int32_t outPost, int32_t outScale,
+    int32_t fusedActivation) {
+  int32_t minOut = fusedActivation == LIBJIT_FUSED_ACTIVATION_RELU
+                       ? MAX(outOffset, -128)
+                       : -128;
+  libjit_matmul_i8_generic(outW, lhsW, rhsW, biasW, outWdims, lhsWdims,
+                           rhsWdims, outOffset, lhsOffset, rhsOffset,
+                           biasOffset, biasPre, biasPost, biasScale, outPre,
+                           outPost, outScale, minOut);
+}
+
+/// Performs the batched matrix multiplication c[i] = a[i] * b[i] as a strided
+/// batched GEMM, where c, a, and b are stacks of row-major matrices.
+/// \p c is a batches x m x n tensor, so \p cDims = {batches, m, n}
+/// \p a is a batches x m x k tensor, so \p aDims = {batches, m, k}
+/// \p b is a batches x k x n tensor, so \p bDims = {batches, k, n}
+/// An operand with a batch size of 1 is broadcasted by using a batch stride of
+/// zero, so it is never copied.
+void libjit_batchmatmul_f(float *c, const float *a, const float *b,
+                          const dim_t *cDims, const dim_t *aDims,
+                          const dim_t *bDims) {
+  dim_t batches = cDims[0];
+  dim_t m = cDims[1];
+  dim_t n = cDims[2];
+  dim_t k = aDims[2];
+  dim_t aStride = aDims[0] == 1 ? 0 : m * k;
+  dim_t bStride = bDims[0] == 1 ? 0 : k * n;
+  memset(c, 0, batches * m * n * sizeof(float));
+  // See libjit_matmul_f for why the operands are swapped.
+  for (dim_t i = 0; i < batches; i++) {
+    libjit_matmul_outer<false>(n, m, k, b + i * bStride, n, a + i * aStride, k,
+                               c + i * m * n, n, defaultMC, defaultKC,
+                               defaultNC);
+  }
+}
+
+/// Quantized version of libjit_batchmatmul_f. All the matrices share the same
+/// quantization parameters.
+void libjit_batchmatmul_i8(int8_t *outW, const int8_t *lhsW,
+                           const int8_t *rhsW, const dim_t *outWdims,
+                           const dim_t *lhsWdims, const dim_t *rhsWdims,
+                           int32_t outOffset, int32_t lhsOffset,
+                           int32_t rhsOffset, int32_t outPre, int32_t outPost,
+                           int32_t outScale) {
+  const dim_t outDims[] = {outWdims[1], outWdims[2]};
+  const dim_t lhsDims[] = {lhsWdims[1], lhsWdims[2]};
+  const dim_t rhsDims[] = {rhsWdims[1], rhsWdims[2]};
+  dim_t outStride = outDims[0] * outDims[1];
+  dim_t lhsStride = lhsWdims[0] == 1 ? 0 : lhsDims[0] * lhsDims[1];
+  dim_t rhsStride = rhsWdims[0] == 1 ? 0 : rhsDims[0] * rhsDims[1];
+  for (dim_t i = 0; i < outWdims[0]; i++) {
+    libjit_matmul_i8(outW + i * outStride, lhsW + i * lhsStride,
+                     rhsW + i * rhsStride, outDims, lhsDims, rhsDims, outOffset,
+                     lhsOffset, rhsOffset, outPre, outPost, outScale);
   }
 }
 
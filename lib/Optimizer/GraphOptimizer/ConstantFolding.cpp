@@ -26,14 +26,25 @@
 #include "glow/Graph/TensorLayout.h"
 #include "glow/Graph/Utils.h"
 #include "glow/Optimizer/GraphOptimizer/FunctionPasses.h"
+#include "glow/Support/Register.h"
+#include "glow/Support/ThreadPool.h"
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
+
+#include <deque>
+#include <future>
+#include <mutex>
 
 using namespace glow;
 using llvm::cast;
 using llvm::dyn_cast;
 using llvm::isa;
 
+extern llvm::cl::OptionCategory graphOptCat;
+
 namespace {
 /// The name of the temporary function to be used to perform constant folding.
 constexpr const char *constEvaluationFunctionName =
@@ -305,19 +316,10 @@ Error verifyConstantFunction(Backend &backend, Function &F,
   return Error::success();
 }
 
-/// Perform a compile-time constant folding of the node \p N using the provided
-/// \p backend. If \p record is not a nullptr then the Constant created is added
-/// to the map, pointing to the SaveNode that generated that Constant.
-/// \returns list of constants which are the result of the
-/// constant-folding. These constants correspond to results of the node. If no
-/// constant folding was possible an empty vector will be returned. If
-/// \p foldSingleSplats then single splat subgraphs will be forced to fold.
-bool constantFoldNodeImpl(
-    Backend &backend, Node *N, std::vector<Constant *> &constResults,
-    ConstantFoldingRecordMap *record = nullptr,
-    const CompilationContext &origCctx = CompilationContext(),
-    bool foldSingleSplats = false) {
-  CompilationContext cctx;
+/// Initialize \p cctx for compiling the temporary Functions used for constant
+/// folding, copying the relevant options from \p origCctx.
+void initConstantFoldingContext(CompilationContext &cctx,
+                                const CompilationContext &origCctx) {
   // Do not recursively call constant folding.
   cctx.optimizationOpts.enableConstantFolding = false;
   cctx.optimizationOpts.enableConstantDeduplication = false;
@@ -332,10 +334,416 @@ bool constantFoldNodeImpl(
   cctx.optimizationOpts.materializeSplatsUsedBySet =
       origCctx.optimizationOpts.materializeSplatsUsedBySet;
   assert(!ERR_TO_BOOL(cctx.verify()) && "cctx for const folding must be valid");
+}
+
+/// Perform a compile-time constant folding of the node \p N using the provided
+/// \p backend. If \p record is not a nullptr then the Constant created is added
+/// to the map, pointing to the SaveNode that generated that Constant.
+/// \returns list of constants which are the result of the
+/// constant-folding. These constants correspond to results of the node. If no
+/// constant folding was possible an empty vector will be returned. If
+/// \p foldSingleSplats then single splat subgraphs will be forced to fold.
+bool constantFoldNodeImpl(
+    Backend &backend, Node *N, std::vector<Constant *> &constResults,
+    ConstantFoldingRecordMap *record = nullptr,
+    const CompilationContext &origCctx = CompilationContext(),
+    bool foldSingleSplats = false) {
+  CompilationContext cctx;
+  initConstantFoldingContext(cctx, origCctx);
   return evaluateConstantOperation(backend, cctx, N, constResults, record,
                                    foldSingleSplats);
 }
 
+/// A temporary Function evaluating several constant operations at once.
+struct ConstantEvaluationGroup {
+  /// The temporary Function.
+  Function *F{nullptr};
+  /// Mapping from the original nodes to their clones in F.
+  NodeMap currToNew;
+  /// Indices of the evaluated constant operations along with the SaveNodes
+  /// of their results.
+  std::vector<std::pair<size_t, llvm::SmallVector<SaveNode *, 2>>> evaluated;
+  /// Bindings of the Placeholders of the SaveNodes.
+  PlaceholderBindings bindings;
+  /// F compiled for the constant folding backend.
+  std::unique_ptr<CompiledFunction> compiledF;
+  /// Whether compiling or running F failed.
+  bool failed{false};
+};
+
+/// Evaluates the constant operations \p nodes using the provided \p backend and
+/// the compilation context \p cctx. The operations are distributed over at
+/// most \p numThreads temporary Functions, which are compiled one after the
+/// other and then run in parallel. Constant subgraphs shared by operations
+/// evaluated in the same Function are only computed once. \p constResults[i]
+/// is set to the results of \p nodes[i], or left empty if it could not be
+/// evaluated.
+void evaluateConstantOperations(
+    Backend &backend, CompilationContext &cctx, llvm::ArrayRef<Node *> nodes,
+    unsigned numThreads, std::vector<std::vector<Constant *>> &constResults) {
+  constResults.assign(nodes.size(), {});
+  if (nodes.empty()) {
+    return;
+  }
+  Module &mod = *nodes.front()->getParent()->getParent();
+  std::vector<ConstantEvaluationGroup> groups(
+      std::min<size_t>(numThreads, nodes.size()));
+  for (size_t i = 0, e = nodes.size(); i < e; i++) {
+    auto &group = groups[i % groups.size()];
+    if (!group.F) {
+      group.F = mod.createFunction(std::string(constEvaluationFunctionName) +
+                                   std::to_string(numFolds++) + "__batch");
+    }
+    auto *clonedN = recursiveClone(group.F, nodes[i], group.currToNew);
+    bool isCanonical = true;
+    for (size_t idx = 0, e = clonedN->getNumResults(); idx < e; ++idx) {
+      isCanonical &=
+          isCanonicalLayout(clonedN->getNthResult(idx), backend, clonedN, idx);
+    }
+    // Leave operations with non-canonical results unevaluated, see
+    // bailOnNonCanonicalLayout(). Their clones are dead and will be removed.
+    if (!isCanonical) {
+      continue;
+    }
+    llvm::SmallVector<SaveNode *, 2> savedResults;
+    for (size_t idx = 0, e = clonedN->getNumResults(); idx < e; ++idx) {
+      auto *SN =
+          group.F->createSave(clonedN->getName(), clonedN->getNthResult(idx));
+      group.bindings.allocate(SN->getPlaceholder());
+      savedResults.push_back(SN);
+    }
+    group.evaluated.emplace_back(i, std::move(savedResults));
+  }
+
+  // Compile all Functions first, as compilation modifies the Module.
+  for (auto &group : groups) {
+    if (group.evaluated.empty()) {
+      continue;
+    }
+    auto compiledOrErr = compile(backend, *group.F, cctx);
+    if (!compiledOrErr) {
+      group.failed = ERR_TO_BOOL(compiledOrErr.takeError(), /* log */ false);
+      continue;
+    }
+    group.compiledF = std::move(*compiledOrErr);
+  }
+
+  // Run the compiled Functions, which only touches their own bindings.
+  auto runGroup = [&backend](ConstantEvaluationGroup &group) {
+    if (group.compiledF) {
+      group.failed = ERR_TO_BOOL(run(backend, *group.compiledF, group.bindings),
+                                 /* log */ false);
+    }
+  };
+  if (groups.size() > 1) {
+    ThreadPool pool(groups.size(), "ConstantFolding");
+    std::vector<std::future<void>> futures;
+    for (auto &group : groups) {
+      futures.push_back(pool.submit([&runGroup, &group]() { runGroup(group); }));
+    }
+    for (auto &future : futures) {
+      future.wait();
+    }
+  } else {
+    runGroup(groups.front());
+  }
+
+  // Create Constants from the results and clean up.
+  auto &vars = mod.getPlaceholders();
+  for (auto &group : groups) {
+    for (auto &evaluated : group.evaluated) {
+      for (auto *SN : evaluated.second) {
+        if (!group.failed) {
+          Tensor *outputTensor = group.bindings.get(SN->getPlaceholder());
+          constResults[evaluated.first].push_back(mod.createConstant(
+              SN->getInput().getNode()->getName().str() + ".constfold",
+              std::move(*outputTensor)));
+        }
+        mod.erasePlaceholder(
+            std::find(vars.begin(), vars.end(), SN->getPlaceholder()));
+      }
+    }
+    mod.eraseFunction(group.F);
+  }
+}
+
+/// The key of a constant operation in the ConstantFoldingCache. Besides the
+/// content hash it keeps the material the hash is computed from, which is
+/// compared on a hit, so that a hash collision never returns the results of
+/// another operation.
+struct ConstantOperationKey {
+  llvm::hash_code hash;
+  /// The kinds and parameters of the Nodes of the constant subgraph, and the
+  /// positions of their inputs, in post-order.
+  std::string description;
+  /// The result types of the Nodes, in the same order.
+  std::vector<Type> types;
+  /// The payloads of the Constants, in the same order. They are unowned views
+  /// of the payloads until the key is inserted in the cache.
+  std::vector<Tensor> payloads;
+
+  bool operator==(const ConstantOperationKey &other) const {
+    if (hash != other.hash || description != other.description ||
+        types.size() != other.types.size() ||
+        payloads.size() != other.payloads.size()) {
+      return false;
+    }
+    for (size_t i = 0, e = types.size(); i < e; i++) {
+      if (!types[i].isEqual(other.types[i])) {
+        return false;
+      }
+    }
+    for (size_t i = 0, e = payloads.size(); i < e; i++) {
+      if (!payloads[i].getType().isEqual(other.payloads[i].getType()) ||
+          !payloads[i].isBitwiseEqual(other.payloads[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// \returns the number of bytes held by the key once it owns its payloads.
+  size_t getSizeInBytes() const {
+    size_t sizeInBytes = description.size() + types.size() * sizeof(Type);
+    for (const auto &T : payloads) {
+      sizeInBytes += T.getSizeInBytes();
+    }
+    return sizeInBytes;
+  }
+};
+
+/// Computes content hashes of constant operations, which only depend on the
+/// kinds, parameters and result types of the operations in the constant
+/// subgraph and on the payloads of its Constants. Hence equal subgraphs get
+/// equal hashes even if they belong to different Modules. Hashes are
+/// memoized, so that subgraphs shared by several operations are hashed once.
+class ConstantOperationHasher {
+  llvm::DenseMap<const Node *, llvm::hash_code> hashes_;
+
+  /// \returns a copy of \p N with all of its inputs replaced by \p dummyInput
+  /// and no name, which only differs from another such copy in its kind,
+  /// parameters and result types. It must be destroyed by the caller.
+  static Node *cloneWithoutInputs(const Node *N, SplatNode &dummyInput) {
+    Node *copy = N->clone();
+    copy->setName("");
+    for (unsigned idx = 0, e = copy->getNumInputs(); idx < e; ++idx) {
+      copy->setNthInput(idx, NodeValue(&dummyInput));
+    }
+    return copy;
+  }
+
+  /// \returns the hash of the parameters of \p N, i.e. of everything but its
+  /// name, inputs and result types.
+  static llvm::hash_code getParameterHash(const Node *N) {
+    if (N->getNumInputs() == 0) {
+      return N->getHash();
+    }
+    // Node::getHash() recursively hashes the inputs too, including data
+    // specific to their Module like Constant names and Type addresses. Hence
+    // hash a copy of N with all of its inputs replaced by the same
+    // parameter-less node instead.
+    SplatNode dummyInput("dummyInput", N->getType(0), 0);
+    Node *copy = cloneWithoutInputs(N, dummyInput);
+    auto hash = copy->getHash();
+    Node::destroyNode(copy);
+    return hash;
+  }
+
+  /// Appends the key material of the subgraph of \p N to \p key, where
+  /// \p positions maps the Nodes already in \p key to their positions.
+  static void describe(const Node *N, ConstantOperationKey &key,
+                       llvm::DenseMap<const Node *, size_t> &positions) {
+    if (positions.count(N)) {
+      return;
+    }
+    std::string inputs;
+    for (unsigned idx = 0, e = N->getNumInputs(); idx < e; ++idx) {
+      auto input = N->getNthInput(idx);
+      describe(input.getNode(), key, positions);
+      inputs += " " + std::to_string(positions[input.getNode()]) + ":" +
+                std::to_string(input.getResNo());
+    }
+    size_t position = positions.size();
+    positions[N] = position;
+
+    if (auto *C = dyn_cast<Constant>(N)) {
+      key.description += "Constant " + C->getLayout() + "\n";
+      key.payloads.push_back(C->getPayload().getUnowned());
+      return;
+    }
+    SplatNode dummyInput("dummyInput", N->getType(0), 0);
+    Node *copy = cloneWithoutInputs(N, dummyInput);
+    key.description += copy->getDebugDesc() + "inputs :" + inputs + "\n";
+    Node::destroyNode(copy);
+    for (unsigned idx = 0, e = N->getNumResults(); idx < e; ++idx) {
+      key.types.push_back(*N->getType(idx));
+    }
+  }
+
+public:
+  /// \returns the content hash of the constant operation \p N.
+  llvm::hash_code hash(const Node *N) {
+    auto it = hashes_.find(N);
+    if (it != hashes_.end()) {
+      return it->second;
+    }
+    llvm::hash_code hash;
+    if (auto *C = dyn_cast<Constant>(N)) {
+      const auto &payload = C->getPayload();
+      const char *data = payload.getUnsafePtr();
+      hash = llvm::hash_combine(
+          N->getKind(), payload.getType().equals_hash(), C->getLayout(),
+          llvm::hash_combine_range(data, data + payload.getSizeInBytes()));
+    } else {
+      hash = llvm::hash_combine(N->getKind(), getParameterHash(N));
+      for (unsigned idx = 0, e = N->getNumResults(); idx < e; ++idx) {
+        hash = llvm::hash_combine(hash, N->getType(idx)->equals_hash());
+      }
+      for (unsigned idx = 0, e = N->getNumInputs(); idx < e; ++idx) {
+        auto input = N->getNthInput(idx);
+        hash = llvm::hash_combine(hash, this->hash(input.getNode()),
+                                  input.getResNo());
+      }
+    }
+    hashes_[N] = hash;
+    return hash;
+  }
+
+  /// \returns the cache key of the constant operation \p N. Its payloads are
+  /// views of the payloads of the Constants of \p N.
+  ConstantOperationKey getKey(const Node *N) {
+    ConstantOperationKey key;
+    key.hash = hash(N);
+    llvm::DenseMap<const Node *, size_t> positions;
+    describe(N, key, positions);
+    return key;
+  }
+};
+
+llvm::cl::opt<unsigned> constFoldingCacheSizeOpt(
+    "const-folding-cache-size",
+    llvm::cl::desc("Max total size in MB of the keys and results kept by the "
+                   "constant folding cache. The oldest entries are evicted "
+                   "first once it is exceeded. Default is 1024."),
+    llvm::cl::Optional, llvm::cl::init(1024), llvm::cl::cat(graphOptCat));
+
+/// Process-wide memo of the results of constant folding, keyed on the content
+/// hashes of the folded operations.
+class ConstantFoldingCache {
+  struct Entry {
+    ConstantOperationKey key;
+    std::vector<Tensor> results;
+    size_t sizeInBytes;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<size_t, Entry> entries_;
+  std::deque<size_t> insertionOrder_;
+  size_t sizeInBytes_{0};
+
+  /// \returns the maximum total size of the entries.
+  static size_t getMaxSizeInBytes() {
+    return size_t(constFoldingCacheSizeOpt) << 20;
+  }
+
+public:
+  static ConstantFoldingCache &get() {
+    static ConstantFoldingCache cache;
+    return cache;
+  }
+
+  /// Looks up the results of the constant operation \p N with key \p key and
+  /// creates Constants holding them in \p constResults. \returns whether the
+  /// results were found.
+  bool lookup(const ConstantOperationKey &key, Node *N,
+              std::vector<Constant *> &constResults) {
+    std::vector<Tensor> results;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = entries_.find(key.hash);
+      if (it == entries_.end() || !(it->second.key == key) ||
+          it->second.results.size() != N->getNumResults()) {
+        return false;
+      }
+      for (unsigned idx = 0, e = N->getNumResults(); idx < e; ++idx) {
+        if (!it->second.results[idx].getType().isEqual(*N->getType(idx))) {
+          return false;
+        }
+        results.push_back(it->second.results[idx].clone());
+      }
+    }
+    Module &mod = *N->getParent()->getParent();
+    for (auto &result : results) {
+      constResults.push_back(mod.createConstant(
+          N->getName().str() + ".constfold", std::move(result)));
+    }
+    return true;
+  }
+
+  /// Inserts the results \p constResults of the operation with key \p key.
+  /// An entry with the same hash is kept, even if its key differs.
+  void insert(const ConstantOperationKey &key,
+              llvm::ArrayRef<Constant *> constResults) {
+    Entry entry;
+    entry.key.hash = key.hash;
+    entry.key.description = key.description;
+    entry.key.types = key.types;
+    for (const auto &T : key.payloads) {
+      entry.key.payloads.push_back(T.clone());
+    }
+    entry.sizeInBytes = entry.key.getSizeInBytes();
+    for (auto *C : constResults) {
+      entry.results.push_back(C->getPayload().clone());
+      entry.sizeInBytes += entry.results.back().getSizeInBytes();
+    }
+    const size_t maxSizeInBytes = getMaxSizeInBytes();
+    if (entry.sizeInBytes > maxSizeInBytes) {
+      return;
+    }
+    size_t sizeInBytes = entry.sizeInBytes;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!entries_.emplace(key.hash, std::move(entry)).second) {
+      return;
+    }
+    insertionOrder_.push_back(key.hash);
+    sizeInBytes_ += sizeInBytes;
+    while (sizeInBytes_ > maxSizeInBytes) {
+      sizeInBytes_ -= entries_[insertionOrder_.front()].sizeInBytes;
+      entries_.erase(insertionOrder_.front());
+      insertionOrder_.pop_front();
+    }
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    insertionOrder_.clear();
+    sizeInBytes_ = 0;
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+};
+
+/// \returns the backend to be used for compile-time computations given
+/// \p cctx, falling back to the Interpreter.
+std::unique_ptr<Backend>
+createConstantFoldingBackend(const CompilationContext &cctx) {
+  const auto &backendName = cctx.optimizationOpts.constantFoldingBackendName;
+  if (backendName != Interpreter::getName()) {
+    if (auto *backend =
+            FactoryRegistry<std::string, Backend>::get(backendName)) {
+      return std::unique_ptr<Backend>(backend);
+    }
+    LOG(WARNING) << "Backend " << backendName
+                 << " is not registered, constant folding with "
+                 << Interpreter::getName();
+  }
+  return glow::make_unique<Interpreter>();
+}
+
 } // namespace
 
 Error glow::executeConstantFunction(Backend &backend, Function &F,
@@ -351,14 +759,44 @@ Error glow::executeConstantFunction(Backend &backend, Function &F,
   return run(backend, *compiledF, bindings);
 }
 
+/// \returns the constant operations of \p F which may have become foldable
+/// because of the changes to the Nodes in \p changedNodes, i.e. the changed
+/// Nodes and all of the Nodes using them through chains of constant
+/// operations. \p backend and \p enableQuantizeConstFolding are used to
+/// determine what is valid for folding.
+static std::vector<Node *>
+collectChangedConstantOperations(Function *F,
+                                 llvm::ArrayRef<Node *> changedNodes,
+                                 const Backend &backend,
+                                 bool enableQuantizeConstFolding) {
+  std::vector<Node *> nodes;
+  std::unordered_set<Node *> visited;
+  std::vector<Node *> worklist(changedNodes.begin(), changedNodes.end());
+  while (!worklist.empty()) {
+    Node *N = worklist.back();
+    worklist.pop_back();
+    if (N->getParent() != F || !visited.insert(N).second ||
+        !isConstantOperation(N, backend, enableQuantizeConstFolding)) {
+      continue;
+    }
+    nodes.push_back(N);
+    for (auto &U : N->getUsers()) {
+      worklist.push_back(U.getUser());
+    }
+  }
+  return nodes;
+}
+
 /// Perform constant folding in the function \p F . Any non-trivial node (i.e.
 /// not a constant or a splat) that can be computed at compile-time is going to
 /// be computed at compile-time. \returns true if any foldings were performed.
 /// If \p record is not a nullptr then the Constants created for any constant
 /// chain of Nodes is added to the map, pointing to the SaveNode that generated
-/// that Constant.
+/// that Constant. If \p changedNodes is not a nullptr then only the constant
+/// operations reachable from the Nodes it contains are considered for folding.
 static bool constantFoldFun(Function *F, const CompilationContext &cctx,
-                            ConstantFoldingRecordMap *record = nullptr) {
+                            ConstantFoldingRecordMap *record = nullptr,
+                            llvm::ArrayRef<Node *> *changedNodes = nullptr) {
   // Skip if specified in the cctx.
   if (!cctx.optimizationOpts.enableConstantFolding) {
     return false;
@@ -370,11 +808,19 @@ static bool constantFoldFun(Function *F, const CompilationContext &cctx,
   LOG_SCOPE(F->getLogContext(), "glow::constantFold")
   bool changed = false;
   // Backend to be used for compile-time computations.
-  std::unique_ptr<Backend> backend(new Interpreter());
-  // Traverse nodes in post-order, so that children are seen before parents.
-  GraphPostOrderVisitor postOrderVisitor(*F);
-  auto nodes = postOrderVisitor.getPostOrder();
+  std::unique_ptr<Backend> backend = createConstantFoldingBackend(cctx);
+  std::vector<Node *> nodes;
+  if (changedNodes) {
+    nodes = collectChangedConstantOperations(F, *changedNodes, *backend,
+                                             enableQuantizeConstFolding);
+  } else {
+    // Traverse nodes in post-order, so that children are seen before parents.
+    GraphPostOrderVisitor postOrderVisitor(*F);
+    auto postOrder = postOrderVisitor.getPostOrder();
+    nodes.assign(postOrder.begin(), postOrder.end());
+  }
   // Collect all non-trivial constant operations.
+  std::vector<Node *> constOps;
   for (auto *N : nodes) {
     // Skip trivial nodes/operations that do not require any constant
     // computations.
@@ -398,23 +844,95 @@ static bool constantFoldFun(Function *F, const CompilationContext &cctx,
     if (!hasNonConstantOperationUser(N, *backend, enableQuantizeConstFolding)) {
       continue;
     }
+    constOps.push_back(N);
+  }
 
-    // Compute the constant value of the node.
-    std::vector<Constant *> constResults;
-    if (!constantFoldNodeImpl(*backend, N, constResults, record, cctx)) {
-      continue;
+  // Batching and caching are only done when not recording the SaveNodes which
+  // computed the folded Constants.
+  const auto &opts = cctx.optimizationOpts;
+  const bool useCache = !record && opts.enableConstantFoldingCache;
+  const bool useBatching = !record && opts.enableBatchedConstantFolding;
+
+  // Compute the cache keys before any operation gets folded, so that they do
+  // not depend on the order of folding.
+  std::vector<ConstantOperationKey> keys;
+  if (useCache) {
+    ConstantOperationHasher hasher;
+    for (auto *N : constOps) {
+      keys.push_back(hasher.getKey(N));
     }
-    // Replace all results of the original operation by the computed
-    // compile-time results of this operation.
-    for (size_t idx = 0, e = constResults.size(); idx < e; ++idx) {
-      auto constResult = constResults[idx];
+  }
+
+  std::vector<std::vector<Constant *>> constResults(constOps.size());
+  std::vector<bool> folded(constOps.size(), false);
+  // Replace all results of the i-th constant operation by the computed
+  // compile-time results of this operation.
+  auto replaceByConstResults = [&](size_t i) {
+    auto *N = constOps[i];
+    for (size_t idx = 0, e = constResults[i].size(); idx < e; ++idx) {
+      auto constResult = constResults[i][idx];
       assert(N->getNthResult(idx).getType() ==
                  constResult->getOutput().getType() &&
              "Constant replacement type must match.");
       // Replace the old result by the new constant result.
       N->getNthResult(idx).replaceAllUsesOfWith(constResult);
     }
+    folded[i] = true;
     changed = true;
+  };
+
+  if (useCache) {
+    for (size_t i = 0, e = constOps.size(); i < e; i++) {
+      if (ConstantFoldingCache::get().lookup(keys[i], constOps[i],
+                                             constResults[i])) {
+        replaceByConstResults(i);
+      }
+    }
+  }
+
+  if (useBatching) {
+    std::vector<Node *> batch;
+    std::vector<size_t> batchIndices;
+    for (size_t i = 0, e = constOps.size(); i < e; i++) {
+      if (!folded[i]) {
+        batch.push_back(constOps[i]);
+        batchIndices.push_back(i);
+      }
+    }
+    CompilationContext foldCctx;
+    initConstantFoldingContext(foldCctx, cctx);
+    std::vector<std::vector<Constant *>> batchResults;
+    evaluateConstantOperations(*backend, foldCctx, batch,
+                               opts.numConstantFoldingThreads, batchResults);
+    for (size_t j = 0, e = batch.size(); j < e; j++) {
+      if (batchResults[j].empty()) {
+        continue;
+      }
+      size_t i = batchIndices[j];
+      constResults[i] = std::move(batchResults[j]);
+      if (useCache) {
+        ConstantFoldingCache::get().insert(keys[i], constResults[i]);
+      }
+      replaceByConstResults(i);
+    }
+  }
+
+  // Fold the remaining operations one at a time. Operations whose batched
+  // evaluation failed are retried here too, so that one failing operation
+  // does not prevent folding the others evaluated with it.
+  for (size_t i = 0, e = constOps.size(); i < e; i++) {
+    if (folded[i]) {
+      continue;
+    }
+    // Compute the constant value of the node.
+    if (!constantFoldNodeImpl(*backend, constOps[i], constResults[i], record,
+                              cctx)) {
+      continue;
+    }
+    if (useCache) {
+      ConstantFoldingCache::get().insert(keys[i], constResults[i]);
+    }
+    replaceByConstResults(i);
   }
   return changed;
 }
@@ -426,6 +944,22 @@ bool glow::ConstantFold::run(Function *F, const CompilationContext &cctx) {
   return constantFoldFun(F, cctx);
 }
 
+bool glow::ConstantFold::supportsIncrementalMode(
+    const CompilationContext &cctx) const {
+  // While constant folding is disabled no Node is looked at, so the pass needs
+  // to start from scratch once it gets enabled again.
+  return cctx.optimizationOpts.enableConstantFolding;
+}
+
+/// Perform constant folding in the function \p F, only considering constant
+/// operations which may have become foldable because of the changes to the
+/// Nodes in \p worklist. \returns true if any foldings were performed.
+bool glow::ConstantFold::runOnNodes(Function *F,
+                                    llvm::ArrayRef<Node *> worklist,
+                                    const CompilationContext &cctx) {
+  return constantFoldFun(F, cctx, /* record */ nullptr, &worklist);
+}
+
 ConstantFoldingRecordMap
 glow::constantFoldAndRecord(Function *F, const CompilationContext &cctx) {
   ConstantFoldingRecordMap record;
@@ -448,6 +982,12 @@ std::vector<Constant *> glow::constantFold(Node *N, bool foldSingleSplats) {
   return constResults;
 }
 
+void glow::clearConstantFoldingCache() { ConstantFoldingCache::get().clear(); }
+
+size_t glow::getConstantFoldingCacheSize() {
+  return ConstantFoldingCache::get().size();
+}
+
 void glow::cleanupConstantFolding(Module &mod,
                                   const ConstantFoldingRecordMap &record,
                                   PlaceholderBindings *bindings) {
@@ -15,6 +15,7 @@
  */
 
 #include "glow/Optimizer/GraphOptimizer/FunctionPassManager.h"
+#include "glow/Graph/Graph.h"
 #include "glow/Optimizer/GraphOptimizer/FunctionPasses.h"
 
 #include <glog/logging.h>
@@ -71,8 +72,40 @@ bool ThePassManager::runPassHook(const PassConfigBase &passConfig, PassBase &P,
   if (thePassConfig->getDCERequiredMode() == DCERequiredMode::BeforePass) {
     runPass(getDCEPassConfig(), static_cast<IRContainerTy *>(C), cctx);
   }
-  return static_cast<IRPassTy *>(&P)->run(static_cast<IRContainerTy *>(C),
-                                          cctx);
+
+  auto *F = static_cast<IRContainerTy *>(C);
+  auto *FP = static_cast<IRPassTy *>(&P);
+  const unsigned passID = static_cast<unsigned>(FP->getID());
+  NodeChangeTracker *tracker = F->getChangeTracker();
+  if (!cctx.optimizationOpts.enableIncrementalGraphOptimization ||
+      !FP->supportsIncrementalMode(cctx)) {
+    // The pass may not see some of the changes done so far, so it has to
+    // start from scratch when it is run incrementally the next time.
+    if (tracker) {
+      tracker->resetConsumerEpoch(passID);
+    }
+    recordNodeVisits(F->getNodes().size());
+    return FP->run(F, cctx);
+  }
+
+  F->enableChangeTracking();
+  tracker = F->getChangeTracker();
+  // Changes done by the pass itself are revisited the next time it runs.
+  const uint64_t startEpoch = tracker->getEpoch();
+  uint64_t lastEpoch;
+  bool changed;
+  if (tracker->getConsumerEpoch(passID, lastEpoch)) {
+    std::vector<Node *> worklist;
+    tracker->getChangedSince(lastEpoch, worklist);
+    recordNodeVisits(worklist.size(), /* incremental */ true);
+    changed = !worklist.empty() && FP->runOnNodes(F, worklist, cctx);
+  } else {
+    // The first time around the pass has to visit the whole Function.
+    recordNodeVisits(F->getNodes().size());
+    changed = FP->run(F, cctx);
+  }
+  tracker->setConsumerEpoch(passID, startEpoch);
+  return changed;
 }
 
 bool runDCEPass(ThePassManager::IRContainerTy *F, CompilationContext &cctx) {
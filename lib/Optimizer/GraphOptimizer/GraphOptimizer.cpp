@@ -176,6 +176,55 @@ bool EmptyPass::run(Function *F, const CompilationContext &cctx) {
   return false;
 }
 
+/// Delete the Constants of the Module of \p F which became unused, unless
+/// \p cctx or the state of the other Functions of the Module prevent it.
+static void deleteUnusedConstantsAfterDCE(Function *F,
+                                          const CompilationContext &cctx) {
+  // Don't remove unused Constants since many may be temporarily unused during
+  // optimizations.
+  if (cctx.optimizationOpts.delayAndRecordConstantModification) {
+    return;
+  }
+
+  if (!shouldDeleteConstants(F)) {
+    return;
+  }
+
+  // Delete unused Constants.
+  deleteUnusedConstants(*F->getParent());
+}
+
+bool DCE::supportsIncrementalMode(const CompilationContext &cctx) const {
+  return true;
+}
+
+bool DCE::runOnNodes(Function *F, llvm::ArrayRef<Node *> worklist,
+                     const CompilationContext &cctx) {
+  LOG_SCOPE(F->getLogContext(), getName());
+
+  // Only Nodes whose users changed can become dead. Erasing a Node removes a
+  // user from each of its inputs, so they need to be visited as well.
+  std::vector<Node *> nodesToVisit(worklist.begin(), worklist.end());
+  std::unordered_set<Node *> erasedNodes;
+  bool changed = false;
+  while (!nodesToVisit.empty()) {
+    Node *N = nodesToVisit.back();
+    nodesToVisit.pop_back();
+    if (erasedNodes.count(N) || N->getParent() != F || !shouldDeleteNode(N)) {
+      continue;
+    }
+    for (unsigned i = 0, e = N->getNumInputs(); i < e; i++) {
+      nodesToVisit.push_back(N->getNthInput(i).getNode());
+    }
+    erasedNodes.insert(N);
+    F->eraseNode(N->getIterator());
+    changed = true;
+  }
+
+  deleteUnusedConstantsAfterDCE(F, cctx);
+  return changed;
+}
+
 bool DCE::run(Function *F, const CompilationContext &cctx) {
   LOG_SCOPE(F->getLogContext(), getName());
 
@@ -211,19 +260,7 @@ bool DCE::run(Function *F, const CompilationContext &cctx) {
     }
   }
 
-  // Don't remove unused Constants since many may be temporarily unused during
-  // optimizations.
-  if (cctx.optimizationOpts.delayAndRecordConstantModification) {
-    return changed;
-  }
-
-  if (!shouldDeleteConstants(F)) {
-    return changed;
-  }
-
-  // Delete unused Constants.
-  deleteUnusedConstants(*F->getParent());
-
+  deleteUnusedConstantsAfterDCE(F, cctx);
   return changed;
 }
 
@@ -1436,10 +1473,21 @@ bool ConvertBroadcastedBatchMatMul::run(Function *F,
     NodeValue LHS = BMMN->getLHS();
     NodeValue RHS = BMMN->getRHS();
 
-    // If RHS is a Tile along axis 0 and the input's dims()[0] == 1, then the
-    // RHS is fully broadcasted and we can perform the optimization.
+    // The LHS must provide all of the batches of the result.
+    if (LHS.dims()[0] != BMMN->getResult().dims()[0]) {
+      continue;
+    }
+
+    // If RHS is a Tile along axis 0 and the input's dims()[0] == 1, or if the
+    // RHS itself has a batch size of 1, then the RHS is fully broadcasted and
+    // we can perform the optimization.
+    NodeValue broadcastRHS;
     TileNode *TN = dyn_cast<TileNode>(RHS);
-    if (!TN || TN->getAxis() != 0 || TN->getInput().dims()[0] != 1) {
+    if (TN && TN->getAxis() == 0 && TN->getInput().dims()[0] == 1) {
+      broadcastRHS = TN->getInput();
+    } else if (RHS.dims()[0] == 1) {
+      broadcastRHS = RHS;
+    } else {
       continue;
     }
 
@@ -1458,9 +1506,9 @@ bool ConvertBroadcastedBatchMatMul::run(Function *F,
     // essentially concatenated onto itself in the 0th dimension.
     ReshapeNode *reshapeLHS =
         F->createReshape(name.str() + ".reshapeLHS", LHS, {numBatches * N, M});
-    // Squeeze out the first dimension of the original Tile's input.
+    // Squeeze out the first dimension of the broadcasted RHS.
     ReshapeNode *squeezedRHS =
-        F->createSqueeze(name.str() + ".squeezedRHS", TN->getInput(), {0});
+        F->createSqueeze(name.str() + ".squeezedRHS", broadcastRHS, {0});
 
     // Perform a normal matmul, implementing the batch matmul.
     MatMulNode *MMN = F->createMatMul(name, reshapeLHS, squeezedRHS);
@@ -2810,23 +2858,12 @@ bool FoldSlicesIntoConstants::run(Function *F, const CompilationContext &cctx) {
   return changed;
 }
 
-/// Simplify and canonicalize arithmetic nodes by detecting simple arithmetic
-/// identities.
-bool OptimizeArithmeticNodes::run(Function *F, const CompilationContext &cctx) {
-  LOG_SCOPE(F->getLogContext(), getName());
+/// Simplify the arithmetic nodes in \p worklist of \p F, processing them from
+/// the back of \p worklist. Simplified nodes and their inputs are added back to
+/// \p worklist. \returns whether \p F was modified.
+static bool simplifyArithmeticNodes(Function *F,
+                                    std::vector<Node *> &worklist) {
   bool changed = false;
-  // A worklist that contains the nodes to process.
-  std::vector<Node *> worklist;
-
-  // Add all of the arithmetic nodes to the worklist, with a node's
-  // dependencies added after itself so they are processed before the node.
-  GraphPreOrderVisitor visitor(*F);
-  worklist.reserve(visitor.getPreOrder().size());
-  for (auto *N : visitor.getPreOrder()) {
-    if (N->isArithmetic()) {
-      worklist.push_back(N);
-    }
-  }
   while (!worklist.empty()) {
     Node *N = worklist.back();
     assert(N->isArithmetic() && "Must be an Arithmetic node.");
@@ -2859,6 +2896,45 @@ bool OptimizeArithmeticNodes::run(Function *F, const CompilationContext &cctx) {
   return changed;
 }
 
+/// Simplify and canonicalize arithmetic nodes by detecting simple arithmetic
+/// identities.
+bool OptimizeArithmeticNodes::run(Function *F, const CompilationContext &cctx) {
+  LOG_SCOPE(F->getLogContext(), getName());
+  // A worklist that contains the nodes to process.
+  std::vector<Node *> worklist;
+
+  // Add all of the arithmetic nodes to the worklist, with a node's
+  // dependencies added after itself so they are processed before the node.
+  GraphPreOrderVisitor visitor(*F);
+  worklist.reserve(visitor.getPreOrder().size());
+  for (auto *N : visitor.getPreOrder()) {
+    if (N->isArithmetic()) {
+      worklist.push_back(N);
+    }
+  }
+  return simplifyArithmeticNodes(F, worklist);
+}
+
+bool OptimizeArithmeticNodes::supportsIncrementalMode(
+    const CompilationContext &cctx) const {
+  return true;
+}
+
+bool OptimizeArithmeticNodes::runOnNodes(Function *F,
+                                         llvm::ArrayRef<Node *> changedNodes,
+                                         const CompilationContext &cctx) {
+  LOG_SCOPE(F->getLogContext(), getName());
+  // Whether an arithmetic node can be simplified only depends on its inputs,
+  // so only the changed arithmetic nodes need to be revisited.
+  std::vector<Node *> worklist;
+  for (auto *N : changedNodes) {
+    if (N->isArithmetic()) {
+      worklist.push_back(N);
+    }
+  }
+  return simplifyArithmeticNodes(F, worklist);
+}
+
 /// Statically transpose Constants.
 bool TransposeConstants::run(Function *F, const CompilationContext &cctx) {
   LOG_SCOPE(F->getLogContext(), getName());
@@ -3040,6 +3116,95 @@ static bool deduplicateConstants(Module *M) {
   return changed;
 }
 
+bool CSE::supportsIncrementalMode(const CompilationContext &cctx) const {
+  return true;
+}
+
+/// \returns a Node of \p F other than \p N and not in \p replacedNodes which is
+/// CSE-equivalent to \p N, or nullptr if there is none. \p N must have inputs.
+static Node *
+findCSEEquivalentNode(Function *F, Node *N,
+                      const std::unordered_set<Node *> &replacedNodes) {
+  assert(N->getNumInputs() && "Nodes without inputs are looked up by hash.");
+  // An equivalent Node has the same inputs, so it is one of the users of the
+  // first input of N.
+  for (auto &U : N->getNthInput(0).getNode()->getUsers()) {
+    Node *candidate = U.getUser();
+    if (candidate == N || candidate->getParent() != F ||
+        candidate->getKind() != N->getKind() ||
+        replacedNodes.count(candidate)) {
+      continue;
+    }
+    if (candidate->isEqual(*N)) {
+      return candidate;
+    }
+  }
+  return nullptr;
+}
+
+/// Common Subexpression Elimination restricted to the Nodes changed since the
+/// last time CSE ran. All other Nodes were already CSE'd against each other,
+/// so only the changed ones can have an equivalent.
+bool CSE::runOnNodes(Function *F, llvm::ArrayRef<Node *> worklist,
+                     const CompilationContext &cctx) {
+  LOG_SCOPE(F->getLogContext(), getName());
+  bool changed = false;
+  if (cctx.optimizationOpts.enableConstantDeduplication) {
+    changed |= deduplicateConstants(F->getParent());
+  }
+
+  // Nodes without inputs (e.g. Splats) can only be equivalent to other Nodes
+  // without inputs, which are collected once when first needed.
+  std::unordered_map<Node *, Node *, NodeHasher, NodeEq> inputlessNodes;
+  bool collectedInputlessNodes = false;
+
+  // Process the changed Nodes in the order in which they were changed.
+  std::vector<Node *> nodesToVisit(worklist.rbegin(), worklist.rend());
+  std::unordered_set<Node *> replacedNodes;
+  while (!nodesToVisit.empty()) {
+    Node *N = nodesToVisit.back();
+    nodesToVisit.pop_back();
+    if (replacedNodes.count(N) || N->getParent() != F) {
+      continue;
+    }
+
+    Node *foundN = nullptr;
+    if (N->getNumInputs()) {
+      foundN = findCSEEquivalentNode(F, N, replacedNodes);
+    } else {
+      if (!collectedInputlessNodes) {
+        for (auto &node : F->getNodes()) {
+          if (!node.getNumInputs()) {
+            inputlessNodes.insert({&node, &node});
+          }
+        }
+        collectedInputlessNodes = true;
+      }
+      auto foundI = inputlessNodes.find(N);
+      if (foundI != inputlessNodes.end() && foundI->second != N) {
+        foundN = foundI->second;
+      }
+    }
+    if (!foundN) {
+      continue;
+    }
+
+    for (unsigned i = 0; i < N->getNumResults(); i++) {
+      NodeValue FV(foundN, i);
+      N->getNthResult(i).replaceAllUsesOfWith(FV);
+    }
+    replacedNodes.insert(N);
+    changed = true;
+
+    // The users of N now use foundN, so they may have become equivalent to
+    // other users of foundN.
+    for (auto &U : foundN->getUsers()) {
+      nodesToVisit.push_back(U.getUser());
+    }
+  }
+  return changed;
+}
+
 /// Common Subexpression Elimination.
 bool CSE::run(Function *F, const CompilationContext &cctx) {
   LOG_SCOPE(F->getLogContext(), getName());
@@ -3107,6 +3272,46 @@ bool OptimizeSplat::run(Function *F, const CompilationContext &cctx) {
   return changed;
 }
 
+/// Replace \p TR in \p F by a ReshapeNode if it actually moves no data.
+/// \returns whether \p TR was replaced.
+static bool optimizeTransposeIntoReshape(Function *F, TransposeNode *TR) {
+  auto inputNode = TR->getInput();
+  auto inputDims = inputNode.dims();
+  auto outputDims = TR->getResult().dims();
+  // The transformation is not possible if alignments different from 1 are
+  // used for any dimension.
+  if (!inputNode.getType()->isEqual(F->getParent()->uniqueTypeWithNewShape(
+          inputNode.getType(), inputDims))) {
+    return false;
+  }
+  if (!TR->getResult().getType()->isEqual(
+          F->getParent()->uniqueTypeWithNewShape(TR->getResult().getType(),
+                                                 outputDims))) {
+    return false;
+  }
+  // Transpose moves no data if input/output dimensions match after they both
+  // drop dimensions of size 1. E.g. transposing [1 5 1 15] into [5 15 1 1]
+  // produces vectors (1, 3) for both dimensions so optimization is executed.
+  auto shuffle = TR->getShuffle();
+  ShapeVector inDims;
+  ShapeVector outDims;
+  for (size_t i = 0; i < inputDims.size(); i++) {
+    if (inputDims[i] != 1) {
+      inDims.push_back(i);
+    }
+    if (outputDims[i] != 1) {
+      outDims.push_back(shuffle[i]);
+    }
+  }
+  if (inDims != outDims) {
+    return false;
+  }
+  auto *RS =
+      F->createReshape(TR->getName(), inputNode, outputDims, TR->getLayout());
+  TR->getResult().replaceAllUsesOfWith(RS);
+  return true;
+}
+
 /// Optimize TransposeNode into ReshapeNode when it actually moves no data.
 bool OptimizeTransposeIntoReshape::run(Function *F,
                                        const CompilationContext &cctx) {
@@ -3114,45 +3319,31 @@ bool OptimizeTransposeIntoReshape::run(Function *F,
   bool changed = false;
 
   for (auto &node : F->getNodes()) {
-    auto *TR = dyn_cast<TransposeNode>(&node);
-    if (!TR) {
-      continue;
+    if (auto *TR = dyn_cast<TransposeNode>(&node)) {
+      changed |= optimizeTransposeIntoReshape(F, TR);
     }
-    auto inputNode = TR->getInput();
-    auto inputDims = inputNode.dims();
-    auto outputDims = TR->getResult().dims();
-    // The transformation is not possible if alignments different from 1 are
-    // used for any dimension.
-    if (!inputNode.getType()->isEqual(F->getParent()->uniqueTypeWithNewShape(
-            inputNode.getType(), inputDims))) {
-      continue;
-    }
-    if (!TR->getResult().getType()->isEqual(
-            F->getParent()->uniqueTypeWithNewShape(TR->getResult().getType(),
-                                                   outputDims))) {
-      continue;
-    }
-    // Transpose moves no data if input/output dimensions match after they both
-    // drop dimensions of size 1. E.g. transposing [1 5 1 15] into [5 15 1 1]
-    // produces vectors (1, 3) for both dimensions so optimization is executed.
-    auto shuffle = TR->getShuffle();
-    ShapeVector inDims;
-    ShapeVector outDims;
-    for (size_t i = 0; i < inputDims.size(); i++) {
-      if (inputDims[i] != 1) {
-        inDims.push_back(i);
-      }
-      if (outputDims[i] != 1) {
-        outDims.push_back(shuffle[i]);
-      }
-    }
-    if (inDims != outDims) {
-      continue;
+  }
+
+  return changed;
+}
+
+bool OptimizeTransposeIntoReshape::supportsIncrementalMode(
+    const CompilationContext &cctx) const {
+  return true;
+}
+
+bool OptimizeTransposeIntoReshape::runOnNodes(Function *F,
+                                              llvm::ArrayRef<Node *> worklist,
+                                              const CompilationContext &cctx) {
+  LOG_SCOPE(F->getLogContext(), getName());
+  bool changed = false;
+
+  // Only the shapes of a Transpose and of its input matter, so a Transpose
+  // which was not changed cannot become a Reshape.
+  for (auto *N : worklist) {
+    if (auto *TR = dyn_cast<TransposeNode>(N)) {
+      changed |= optimizeTransposeIntoReshape(F, TR);
     }
-    auto *RS =
-        F->createReshape(TR->getName(), inputNode, outputDims, TR->getLayout());
-    TR->getResult().replaceAllUsesOfWith(RS);
-    changed = true;
   }
 
   return changed;
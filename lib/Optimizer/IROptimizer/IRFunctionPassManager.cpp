@@ -61,8 +61,9 @@ template <>
 bool ThePassManager::runPassHook(const PassConfigBase &passConfig, PassBase &P,
                                  IRContainer *C,
                                  const CompilationContext &cctx) {
-  return static_cast<IRPassTy *>(&P)->run(static_cast<IRContainerTy *>(C),
-                                          cctx);
+  auto *F = static_cast<IRContainerTy *>(C);
+  recordNodeVisits(F->getInstrs().size());
+  return static_cast<IRPassTy *>(&P)->run(F, cctx);
 }
 
 } // namespace glow
@@ -646,21 +646,26 @@ static void lowerLayerNormalizationNode(Function *F, CompilationContext &cctx,
 
   // Compute mean and standard deviation for each layer using the formula from
   // https://pytorch.org/docs/stable/nn.html#torch.nn.LayerNorm
+  // The layers are shifted by their first element and the variance is
+  // computed from the centered layers, so that layers with a large common
+  // offset do not lose the variance to cancellation.
+
+  // {M, N} -> {M, 1} -> {M, N}
+  auto shift =
+      F->createSlice(DECORATE_NODE_NAME(LN, "shift", "slice"), in, {0, 0},
+                     {M, 1})
+          ->getResult();
+  shift = F->createTile(DECORATE_NODE_NAME(LN, "shift", "tile"), shift, N, 1)
+              ->getResult();
+  auto shifted =
+      F->createSub(DECORATE_NODE_NAME(LN, "shifted"), in, shift)->getResult();
 
   // {M, N} -> {M}
   auto mean =
-      F->createBatchedReduceAdd(DECORATE_NODE_NAME(LN, "mean", "add"), in,
+      F->createBatchedReduceAdd(DECORATE_NODE_NAME(LN, "mean", "add"), shifted,
                                 /*axes*/ {1})
           ->getResult();
 
-  // {M, N} -> {M}
-  auto inSquared =
-      F->createMul(DECORATE_NODE_NAME(LN, "squared"), in, in)->getResult();
-  auto stdDev = F->createBatchedReduceAdd(
-                     DECORATE_NODE_NAME(LN, "stddev", "add"), inSquared,
-                     /*axes*/ {1})
-                    ->getResult();
-
   // {M}
   auto nSplat = F->createSplat(DECORATE_NODE_NAME(LN, "n"), mean.getType(), N)
                     ->getResult();
@@ -668,25 +673,32 @@ static void lowerLayerNormalizationNode(Function *F, CompilationContext &cctx,
       F->createSplat(DECORATE_NODE_NAME(LN, "epsilon"), mean.getType(), epsilon)
           ->getResult();
   auto oneSplat = F->createSplat("one", mean.getType(), 1.0)->getResult();
-  auto negOneSplat =
-      F->createSplat("minusOne", mean.getType(), -1.0)->getResult();
 
   // {M}
   mean = F->createDiv(DECORATE_NODE_NAME(LN, "mean", "div"), mean, nSplat)
              ->getResult();
 
-  // {M}
-  stdDev = F->createDiv(DECORATE_NODE_NAME(LN, "stddev", "div"), stdDev, nSplat)
-               ->getResult();
-
-  // {M}
-  auto meanSquared =
-      F->createMul(DECORATE_NODE_NAME(LN, "mean", "squared"), mean, mean)
+  // {M} -> {M, N}
+  mean = F->createReshape(DECORATE_NODE_NAME(LN, "mean", "reshape"), mean,
+                          {M, 1})
+             ->getResult();
+  mean = F->createTile(DECORATE_NODE_NAME(LN, "mean", "tile"), mean, N, 1)
+             ->getResult();
+  auto centered =
+      F->createSub(DECORATE_NODE_NAME(LN, "centered"), shifted, mean)
           ->getResult();
-  stdDev =
-      F->createSub(DECORATE_NODE_NAME(LN, "stddev", "sub"), stdDev, meanSquared)
+
+  // {M, N} -> {M}
+  auto centeredSquared =
+      F->createMul(DECORATE_NODE_NAME(LN, "squared"), centered, centered)
           ->getResult();
-  stdDev = F->createRELU(DECORATE_NODE_NAME(LN, "stddev", "relu"), stdDev)
+  auto stdDev = F->createBatchedReduceAdd(
+                     DECORATE_NODE_NAME(LN, "stddev", "add"), centeredSquared,
+                     /*axes*/ {1})
+                    ->getResult();
+
+  // {M}
+  stdDev = F->createDiv(DECORATE_NODE_NAME(LN, "stddev", "div"), stdDev, nSplat)
                ->getResult();
   stdDev =
       F->createAdd(DECORATE_NODE_NAME(LN, "stddev", "add"), stdDev, epsSplat)
@@ -697,26 +709,13 @@ static void lowerLayerNormalizationNode(Function *F, CompilationContext &cctx,
                         oneSplat, stdDev)
                ->getResult();
 
-  // {M}
-  auto scale = stdDev;
-  auto bias =
-      F->createMul(DECORATE_NODE_NAME(LN, "bias", "mul"), stdDev, negOneSplat)
-          ->getResult();
-  bias = F->createMul(DECORATE_NODE_NAME(LN, "bias", "mul"), bias, mean)
-             ->getResult();
-
-  // Broadcast mean and std deviation to the size of each batch
+  // Broadcast the std deviation to the size of each batch
   // {M} -> {M, N}
-  scale = F->createReshape(DECORATE_NODE_NAME(LN, "scale", "reshape"), scale,
-                           {M, 1})
-              ->getResult();
-  bias =
-      F->createReshape(DECORATE_NODE_NAME(LN, "bias", "reshape"), bias, {M, 1})
-          ->getResult();
+  auto scale = F->createReshape(DECORATE_NODE_NAME(LN, "scale", "reshape"),
+                                stdDev, {M, 1})
+                   ->getResult();
   scale = F->createTile(DECORATE_NODE_NAME(LN, "scale", "tile"), scale, N, 1)
               ->getResult();
-  bias = F->createTile(DECORATE_NODE_NAME(LN, "bias", "tile"), bias, N, 1)
-             ->getResult();
 
   // Broadcast beta and gamma across batches
   // {N} -> {M, N}
@@ -734,10 +733,8 @@ static void lowerLayerNormalizationNode(Function *F, CompilationContext &cctx,
   // Normalize layers
   // {M, N}
   auto output =
-      F->createMul(DECORATE_NODE_NAME(LN, "output", "scale"), in, scale)
+      F->createMul(DECORATE_NODE_NAME(LN, "output", "scale"), centered, scale)
           ->getResult();
-  output = F->createAdd(DECORATE_NODE_NAME(LN, "output", "bias"), output, bias)
-               ->getResult();
   output =
       F->createMul(DECORATE_NODE_NAME(LN, "output", "gamma"), output, gamma)
           ->getResult();
@@ -1314,7 +1311,8 @@ static void lowerBatchMatMulNode(Function *F, CompilationContext &cctx,
 
   // LHS = {numBatches, N, M}
   // RHS = {numBatches, M, P}
-  const dim_t numBatches = lhs.dims()[0];
+  // Either input may instead have a batch size of 1 and be broadcasted.
+  const dim_t numBatches = dest.dims()[0];
   const dim_t N = lhs.dims()[1];
   const dim_t M = lhs.dims()[2];
   const dim_t P = rhs.dims()[2];
@@ -1326,12 +1324,14 @@ static void lowerBatchMatMulNode(Function *F, CompilationContext &cctx,
   const TypeRef outTy = F->getParent()->uniqueTypeWithNewShape(
       BMMN.getResult().getType(), {N, P});
   for (dim_t i = 0; i < numBatches; i++) {
+    const dim_t iA = lhs.dims()[0] == 1 ? 0 : i;
+    const dim_t iB = rhs.dims()[0] == 1 ? 0 : i;
     SliceNode *sliceA =
         F->createSlice(name.str() + ".sliceA." + std::to_string(i), lhs,
-                       {i, 0, 0}, {i + 1, N, M});
+                       {iA, 0, 0}, {iA + 1, N, M});
     SliceNode *sliceB =
         F->createSlice(name.str() + ".sliceB." + std::to_string(i), rhs,
-                       {i, 0, 0}, {i + 1, M, P});
+                       {iB, 0, 0}, {iB + 1, M, P});
     ReshapeNode *reshapeA =
         F->createReshape(sliceA->getName().str() + ".reshape", sliceA, {N, M});
     ReshapeNode *reshapeB =
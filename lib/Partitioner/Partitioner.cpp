@@ -36,6 +36,15 @@ static llvm::cl::opt<bool, /* ExternalStorage */ true>
             "Enable a partitioner pass to optimize for "
             "load balance in addition to memory capacity constraints"),
         llvm::cl::location(GlowEnableLoadBalancedPartitioning));
+
+static llvm::cl::opt<std::string, /* ExternalStorage */ true>
+    GlowPartitionerCostProfileOpt(
+        "partitioner-cost-profile",
+        llvm::cl::desc("File with measured per-node execution times, as "
+                       "written by saveNodeCostProfile(), used in place of "
+                       "the roofline estimates"),
+        llvm::cl::value_desc("file"),
+        llvm::cl::location(GlowPartitionerCostProfile));
 } // namespace glow
 
 /// -log-partition - Command line option to dump Partitioner logs.
@@ -160,7 +169,8 @@ Function *Partitioner::selectRepFunc(Module *parent, uint64_t &memSize) {
 }
 
 void Partitioner::partitionsAdjust(NodeToFunctionMap &partitions,
-                                   uint64_t availableMemory) {
+                                   uint64_t availableMemory,
+                                   bool sharedActivations) {
   // For each partition, create a node set.
   FunctionToNodesMap nodesSet;
   for (auto it = partitions.begin(); it != partitions.end(); ++it) {
@@ -168,10 +178,12 @@ void Partitioner::partitionsAdjust(NodeToFunctionMap &partitions,
   }
 
   // Optimize the communication cost.
-  optimizeCommunicationCost(partitions, nodesSet, module_, availableMemory);
+  optimizeCommunicationCost(partitions, nodesSet, module_, availableMemory,
+                            sharedActivations);
 
   // Combine the current partitions if necessary.
-  partitionsCombine(partitions, nodesSet, module_, availableMemory);
+  partitionsCombine(partitions, nodesSet, module_, availableMemory,
+                    sharedActivations);
 }
 
 /// Assign nodes to partitions and return the mapping.
@@ -181,6 +193,9 @@ NodeToFunctionMap Partitioner::selectPartitions(Function *F,
   NodeToFunctionMap mapping;
   BFSLevel bfs = getBFSLevel(F);
   size_t level = bfs.size();
+  auto backendIt = backendMap_.find(backendName.str());
+  bool sharedActivations =
+      backendIt != backendMap_.end() && backendIt->second.sharedActivations;
 
   // Step 1 : get the initial cut based on BFS levels and availableMemory.
   int color = 0;
@@ -199,7 +214,7 @@ NodeToFunctionMap Partitioner::selectPartitions(Function *F,
       // If after adding node N, the memory usage of this partition exceeds the
       // device memory limitations, N can't be added into the current partition
       // and a new partition is created.
-      if (graphMem.getTotalMemSize() > availableMemory) {
+      if (graphMem.getTotalMemSize(sharedActivations) > availableMemory) {
         newF = F->getParent()->createFunction(
             std::string(F->getName()) + "_part" + std::to_string(++color));
         mapping.createPartition(newF, backendName);
@@ -215,7 +230,7 @@ NodeToFunctionMap Partitioner::selectPartitions(Function *F,
   }
 
   // Step 2 : adjust the partition based on performance.
-  partitionsAdjust(mapping, availableMemory);
+  partitionsAdjust(mapping, availableMemory, sharedActivations);
 
   return mapping;
 }
@@ -378,10 +393,12 @@ void Partitioner::genBackendMap(
       // TODO : will improve the algorithm for different memory size.
       backendInfo.memSize = deviceInfo_[i].availableMemory;
       backendInfo.inputCountMax = deviceInfo_[i].inputCountMax;
+      backendInfo.sharedActivations = deviceInfo_[i].sharedActivations;
       backendInfo.peakDramBw = deviceInfo_[i].peakDramBw;
       backendInfo.peakSramBw = deviceInfo_[i].peakSramBw;
       backendInfo.sramCapacity = deviceInfo_[i].sramCapacity;
       backendInfo.peakCompute = deviceInfo_[i].peakCompute;
+      backendInfo.costProfile = costProfile_.empty() ? nullptr : &costProfile_;
       backendInfo.nonSupportedNodesKinds =
           generateNodeKindsSet(deviceInfo_[i].nonSupportedNodes);
       backendInfo.supportedNodesKinds =
@@ -620,6 +637,18 @@ Expected<DAGListTy> Partitioner::loadBalancedPartition(CompilationContext &cctx,
   for (size_t i = 0; i < numDevices; i++) {
     VLOG(1) << "Partition #" << i << " has estimated runtime " << deviceTime[i];
   }
+  // Show how far the roofline model is from the measured times.
+  if (!costProfile_.empty() && logPartition) {
+    for (size_t i = 0; i < numDevices; i++) {
+      auto comparison = comparePartitionCost(
+          nodesInPartitions[i], backendMap_[deviceInfo_[0].backendName]);
+      LOG(INFO) << "Partition #" << i << ": roofline runtime "
+                << comparison.predicted << "s, observed runtime "
+                << comparison.observed << "s over "
+                << comparison.numProfiledNodes << "/" << comparison.numNodes
+                << " profiled nodes";
+    }
+  }
   // Check if the memory usage meets the device memory limitation.
   RETURN_IF_ERR(memoryUsageValidation(partitionMap, backendMap_));
 
@@ -1494,6 +1523,11 @@ Expected<DAGListTy> Partitioner::partitionSparseNN(CompilationContext &cctx) {
 }
 
 Expected<DAGListTy> Partitioner::partition(CompilationContext &cctx) {
+  if (costProfile_.empty() && !GlowPartitionerCostProfile.empty()) {
+    ASSIGN_VALUE_OR_RETURN_ERR(costProfile_,
+                               loadNodeCostProfile(GlowPartitionerCostProfile));
+  }
+
   if (cctx.prepartitionedConfig &&
       cctx.prepartitionedConfig->funcs.size() != 0) {
     VLOG(1) << "Using prepartitioned config";
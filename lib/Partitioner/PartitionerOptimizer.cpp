@@ -30,7 +30,8 @@ bool sortMinMemory(const std::pair<Function *, uint64_t> &a,
 
 void optimizeCommunicationCost(NodeToFunctionMap &partitions,
                                FunctionToNodesMap &nodesSet, Module *mod,
-                               uint64_t availableMemory) {
+                               uint64_t availableMemory,
+                               bool sharedActivations) {
   // Move/Exchange nodes between any two connected partitions, until no gain is
   // get.
   // Step1 Move: Assume Partition1 -> Partition2, try to move nodes from
@@ -59,7 +60,7 @@ void optimizeCommunicationCost(NodeToFunctionMap &partitions,
             updateGraphMemInfoByAddingNode(curSet, curCost, outUsers[i]);
 
         // Rule 1: this move won't break memory constraint.
-        if (newCurCost.getTotalMemSize() > availableMemory) {
+        if (newCurCost.getTotalMemSize(sharedActivations) > availableMemory) {
           continue;
         }
         // Rule 2: this move won't cause constant duplication.
@@ -108,7 +109,7 @@ void optimizeCommunicationCost(NodeToFunctionMap &partitions,
 
 void partitionsCombine(NodeToFunctionMap &partitions,
                        FunctionToNodesMap &nodesSet, Module *mod,
-                       uint64_t availableMemory) {
+                       uint64_t availableMemory, bool sharedActivations) {
 
   size_t origPartitions = 0;
 
@@ -137,8 +138,10 @@ void partitionsCombine(NodeToFunctionMap &partitions,
         NodesSet tmp = (nodesSet.find(suc))->second;
         GraphMemInfo cost1 = partitions.getGraphMemInfo(cur);
         GraphMemInfo cost2 = partitions.getGraphMemInfo(suc);
-        if (cost1.getTotalMemSize() + cost2.getTotalMemSize() -
-                cost1.outMemSize <
+        // The outputs of cur become activations of the combined partition.
+        if (cost1.getTotalMemSize(sharedActivations) +
+                cost2.getTotalMemSize(sharedActivations) - cost1.outMemSize +
+                (sharedActivations ? cost1.outMemSize : 0) <
             availableMemory) {
           // We can combine the two partitions to fit one device.
           for (NodesSet::iterator it2 = tmp.begin(); it2 != tmp.end(); ++it2) {
@@ -149,6 +152,9 @@ void partitionsCombine(NodeToFunctionMap &partitions,
           newCost.inMemSize =
               cost1.inMemSize + cost2.inMemSize - cost1.outMemSize;
           newCost.outMemSize = cost2.outMemSize;
+          newCost.activationMemSize = cost1.activationMemSize +
+                                      cost2.activationMemSize +
+                                      cost1.outMemSize;
           partitions.setGraphMemInfo((*it).first, newCost);
           (*it).second.insert(tmp.begin(), tmp.end());
           partitions.deletePartition(suc);
@@ -210,18 +216,30 @@ assignLogicalDeviceID(NodeToFunctionMap &mapping,
     // Step 2 : let n = N, m = M.
     size_t m = p.second.size();
     size_t n = backendMap.at(p.first).num;
+    bool sharedActivations = backendMap.at(p.first).sharedActivations;
     while (m > 0) {
       // Step 3 : find the first k partitions whose total memory usage still
-      // under the memory limitation (k should be max).
+      // under the memory limitation (k should be max). If the device shares
+      // one activation arena among its partitions, only the largest of their
+      // activations is counted.
       uint64_t usedMem = 0;
+      uint64_t activationMem = 0;
       size_t numOfPartitionsWithSameID = (m - 1) / n + 1;
       size_t start = p.second.size() - m;
       size_t i;
       for (i = start; i < p.second.size(); i++) {
-        if (usedMem + nodeSize[i].second > backendMap.at(p.first).memSize) {
+        uint64_t newActivationMem = activationMem;
+        if (sharedActivations) {
+          newActivationMem = std::max(
+              activationMem,
+              mapping.getGraphMemInfo(nodeSize[i].first).activationMemSize);
+        }
+        if (usedMem + nodeSize[i].second + newActivationMem >
+            backendMap.at(p.first).memSize) {
           break;
         }
         usedMem += nodeSize[i].second;
+        activationMem = newActivationMem;
       }
       // Step 4 : if k = start - i found in step 3 is smaller than (m - 1) / n +
       // 1, this means we can't find a proper assignment to fit the number of
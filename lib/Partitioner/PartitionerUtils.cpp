@@ -16,6 +16,14 @@
 
 #include "glow/Partitioner/PartitionerUtils.h"
 #include "glow/Partitioner/PartitionerTypes.h"
+
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
 #include <unordered_set>
 
 using llvm::isa;
@@ -187,6 +195,16 @@ uint64_t getNodeMemUsage(const Node *node) {
 }
 
 float getNodeComputeTime(const Node *node, const BackendInfo &backendInfo) {
+  // Measured times are more accurate than any estimate, in particular for
+  // memory bound nodes such as gathers and SLS whose access pattern the
+  // roofline does not capture.
+  if (backendInfo.costProfile) {
+    auto it = backendInfo.costProfile->find(node->getName());
+    if (it != backendInfo.costProfile->end()) {
+      return it->second;
+    }
+  }
+
   // This code assumes all ops are BW limited from SRAM; except
   // if the input does not fit in SRAM -- then it is DRAM BW limited
   float peakDramBw = backendInfo.peakDramBw;
@@ -377,6 +395,138 @@ float getNodeComputeTime(const Node *node, const BackendInfo &backendInfo) {
                            sizeSram * 1.0f / std::max(peakSramBw, 1e-6f)));
 }
 
+/// \returns the name of the node of the output name \p outputName, as
+/// generated by NodeValue::generateNodeOutputName().
+static llvm::StringRef getNodeNameOfOutput(llvm::StringRef outputName) {
+  return outputName.rsplit(':').first;
+}
+
+/// Adds to \p origins the names of the nodes which \p name was lowered from
+/// according to \p loweredFrom, following chains of lowerings, or \p name
+/// itself if it was not lowered. \p visited guards against cycles.
+static void
+collectLoweringOrigins(llvm::StringRef name,
+                       const llvm::StringMap<llvm::StringSet<>> &loweredFrom,
+                       llvm::StringSet<> &visited,
+                       llvm::SmallVectorImpl<std::string> &origins) {
+  if (!visited.insert(name).second) {
+    return;
+  }
+  auto it = loweredFrom.find(name);
+  if (it == loweredFrom.end()) {
+    origins.push_back(name);
+    return;
+  }
+  for (const auto &origin : it->second) {
+    collectLoweringOrigins(origin.getKey(), loweredFrom, visited, origins);
+  }
+}
+
+NodeCostProfile getNodeCostProfile(const std::list<TraceEvent> &events,
+                                   const LoweredInfoMap *loweredMap) {
+  llvm::StringMap<std::pair<uint64_t, uint64_t>> durations;
+  for (const auto &event : events) {
+    if (event.level != TraceLevel::OPERATOR ||
+        event.type != TraceEvent::CompleteType) {
+      continue;
+    }
+    auto &entry = durations[event.name];
+    entry.first += event.duration;
+    entry.second++;
+  }
+
+  // Lowering renames nodes, but records which nodes each lowered node was
+  // created from. Index that record by node name.
+  llvm::StringMap<llvm::StringSet<>> loweredFrom;
+  if (loweredMap) {
+    for (const auto &entry : *loweredMap) {
+      llvm::StringRef name = getNodeNameOfOutput(entry.getKey());
+      for (const auto &origin : entry.second) {
+        llvm::StringRef originName = getNodeNameOfOutput(origin.getName());
+        if (originName != name) {
+          loweredFrom[name].insert(originName);
+        }
+      }
+    }
+  }
+
+  NodeCostProfile profile;
+  for (const auto &entry : durations) {
+    // TraceEvent durations are in microseconds.
+    float seconds =
+        entry.second.first * 1e-6f / std::max<uint64_t>(entry.second.second, 1);
+    // Charge the time of a lowered node to the nodes it was lowered from,
+    // which are the ones the partitioner sees.
+    llvm::SmallVector<std::string, 2> origins;
+    llvm::StringSet<> visited;
+    collectLoweringOrigins(entry.getKey(), loweredFrom, visited, origins);
+    for (const auto &origin : origins) {
+      profile[origin] += seconds / origins.size();
+    }
+  }
+  return profile;
+}
+
+Error saveNodeCostProfile(const NodeCostProfile &profile,
+                          llvm::StringRef fileName) {
+  std::error_code EC;
+  llvm::raw_fd_ostream os(fileName, EC, llvm::sys::fs::F_Text);
+  RETURN_ERR_IF_NOT(!EC, "Unable to open the cost profile file " +
+                             fileName.str() + ": " + EC.message());
+  // Sort the entries so that the file does not depend on the hash order.
+  std::vector<llvm::StringRef> names;
+  for (const auto &entry : profile) {
+    names.push_back(entry.getKey());
+  }
+  std::sort(names.begin(), names.end());
+  for (auto name : names) {
+    os << llvm::format("%.9e", profile.lookup(name)) << " " << name << "\n";
+  }
+  return Error::success();
+}
+
+Expected<NodeCostProfile> loadNodeCostProfile(llvm::StringRef fileName) {
+  auto bufferOrErr = llvm::MemoryBuffer::getFile(fileName);
+  RETURN_ERR_IF_NOT(bufferOrErr, "Unable to read the cost profile file " +
+                                     fileName.str());
+  NodeCostProfile profile;
+  llvm::SmallVector<llvm::StringRef, 128> lines;
+  bufferOrErr.get()->getBuffer().split(lines, '\n', /* MaxSplit */ -1,
+                                       /* KeepEmpty */ false);
+  for (auto line : lines) {
+    auto timeAndName = line.trim().split(' ');
+    if (timeAndName.first.empty()) {
+      continue;
+    }
+    double seconds;
+    RETURN_ERR_IF_NOT(!timeAndName.first.getAsDouble(seconds) &&
+                          !timeAndName.second.empty(),
+                      "Invalid cost profile entry: " + line.str());
+    profile[timeAndName.second] = seconds;
+  }
+  return std::move(profile);
+}
+
+PartitionCostComparison comparePartitionCost(const NodesSet &nodes,
+                                             const BackendInfo &backendInfo) {
+  BackendInfo rooflineInfo = backendInfo;
+  rooflineInfo.costProfile = nullptr;
+  PartitionCostComparison comparison;
+  for (const Node *N : nodes) {
+    comparison.predicted += getNodeComputeTime(N, rooflineInfo);
+    comparison.numNodes++;
+    if (!backendInfo.costProfile) {
+      continue;
+    }
+    auto it = backendInfo.costProfile->find(N->getName());
+    if (it != backendInfo.costProfile->end()) {
+      comparison.observed += it->second;
+      comparison.numProfiledNodes++;
+    }
+  }
+  return comparison;
+}
+
 /// Given nodes set \p currNodes and its memory usage info \p info, \returns the
 /// new memory usage if \p newNode is added into \p currNodes.
 GraphMemInfo updateGraphMemInfoByAddingNode(const NodesSet &currNodes,
@@ -451,6 +601,20 @@ GraphMemInfo updateGraphMemInfoByAddingNode(const NodesSet &currNodes,
       ret.inMemSize += nodeVal.getType()->getSizeInBytes();
       ret.inputCount += 1;
       usedNodeValue.insert(nodeVal);
+      continue;
+    }
+
+    // This input is a result of currNodes. If no node of currNodes consumed
+    // it before, it now becomes an activation of this subgraph.
+    bool consumedInside = false;
+    for (auto &U : nodeVal.getUsers()) {
+      if (currNodes.count(U.getUser())) {
+        consumedInside = true;
+        break;
+      }
+    }
+    if (!consumedInside && usedNodeValue.insert(nodeVal).second) {
+      ret.activationMemSize += nodeVal.getType()->getSizeInBytes();
     }
   }
 
@@ -468,6 +632,7 @@ GraphMemInfo updateGraphMemInfoByAddingNode(const NodesSet &currNodes,
       // removed.
       ret.inMemSize -= nodeVal.getType()->getSizeInBytes();
       ret.inputCount -= 1;
+      ret.activationMemSize += nodeVal.getType()->getSizeInBytes();
       break;
     }
   }
@@ -511,6 +676,16 @@ GraphMemInfo getFunctionMemory(Function *func) {
     }
   }
 
+  // Every consumed result of a node is an activation of the function.
+  for (auto &node : func->getNodes()) {
+    for (size_t i = 0, e = node.getNumResults(); i < e; i++) {
+      NodeValue nodeVal = node.getNthResult(i);
+      if (nodeVal.getNumUsers()) {
+        graphMem.activationMemSize += nodeVal.getType()->getSizeInBytes();
+      }
+    }
+  }
+
   return graphMem;
 }
 
@@ -546,7 +721,9 @@ void logPartitionInfo(const NodeToFunctionMap &partitions) {
               << "\t\t\t output size:\t"
               << partitions.getGraphMemInfo(subF).outMemSize << "\n"
               << "\t\t\t constant size:\t"
-              << partitions.getGraphMemInfo(subF).constMemSize << "\n";
+              << partitions.getGraphMemInfo(subF).constMemSize << "\n"
+              << "\t\t\t activation size:\t"
+              << partitions.getGraphMemInfo(subF).activationMemSize << "\n";
     // This may be called before logicalDevices are assigned so check before
     // printing.
     if (partitions.getLogicalDeviceIDList(subF).size()) {
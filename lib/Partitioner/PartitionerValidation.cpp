@@ -98,8 +98,10 @@ Error memoryUsageValidation(
   VLOG(1) << "Entering mem validation";
   for (auto &func : partitions.getPartitions()) {
     auto backendName = partitions.getPartitionBackendName(func);
-    auto usedMemSize = partitions.getGraphMemInfo(func).getTotalMemSize();
-    auto availableMemSize = backendMap.at(backendName).memSize;
+    auto &backendInfo = backendMap.at(backendName);
+    auto usedMemSize = partitions.getGraphMemInfo(func).getTotalMemSize(
+        backendInfo.sharedActivations);
+    auto availableMemSize = backendInfo.memSize;
     VLOG(1) << "Comparing " << usedMemSize << " " << availableMemSize << " for "
             << backendName;
     if (usedMemSize > availableMemSize) {
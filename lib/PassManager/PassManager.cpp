@@ -16,10 +16,78 @@
 
 #include "glow/PassManager/PassManager.h"
 
+#include "llvm/Support/Format.h"
+
 #include <glog/logging.h>
 
+#include <chrono>
+#include <mutex>
+
 using namespace glow;
 
+namespace {
+/// Statistics accumulated by all pass managers, keyed by pass manager id.
+struct AccumulatedPassStatistics {
+  std::mutex lock;
+  std::map<std::string, PassStatisticsMap> stats;
+};
+
+AccumulatedPassStatistics &getAccumulatedStats() {
+  static AccumulatedPassStatistics accumulatedStats;
+  return accumulatedStats;
+}
+} // namespace
+
+void PassStatistics::merge(const PassStatistics &other) {
+  numRuns += other.numRuns;
+  numChangedRuns += other.numChangedRuns;
+  numIncrementalRuns += other.numIncrementalRuns;
+  numNodesVisited += other.numNodesVisited;
+  timeUs += other.timeUs;
+}
+
+/// Dump a row of the pass statistics table named \p name to \p os.
+static void dumpPassStatisticsRow(llvm::StringRef name,
+                                  const PassStatistics &S,
+                                  llvm::raw_ostream &os) {
+  os << llvm::left_justify(name, 40) << llvm::format_decimal(S.numRuns, 8)
+     << llvm::format_decimal(S.numChangedRuns, 9)
+     << llvm::format_decimal(S.numIncrementalRuns, 9)
+     << llvm::format_decimal(S.numNodesVisited, 14)
+     << llvm::format_decimal(S.timeUs, 12) << "\n";
+}
+
+void glow::dumpPassStatistics(const PassStatisticsMap &stats,
+                              llvm::raw_ostream &os) {
+  os << llvm::left_justify("Pass", 40) << llvm::right_justify("Runs", 8)
+     << llvm::right_justify("Changed", 9) << llvm::right_justify("Incr", 9)
+     << llvm::right_justify("NodesVisited", 14)
+     << llvm::right_justify("Time(us)", 12) << "\n";
+  PassStatistics total;
+  for (const auto &pair : stats) {
+    dumpPassStatisticsRow(pair.first, pair.second, os);
+    total.merge(pair.second);
+  }
+  dumpPassStatisticsRow("Total", total, os);
+}
+
+PassStatisticsMap
+glow::getAccumulatedPassStatistics(llvm::StringRef passManagerID) {
+  auto &accumulated = getAccumulatedStats();
+  std::lock_guard<std::mutex> guard(accumulated.lock);
+  auto it = accumulated.stats.find(passManagerID.str());
+  if (it == accumulated.stats.end()) {
+    return {};
+  }
+  return it->second;
+}
+
+void glow::resetAccumulatedPassStatistics() {
+  auto &accumulated = getAccumulatedStats();
+  std::lock_guard<std::mutex> guard(accumulated.lock);
+  accumulated.stats.clear();
+}
+
 /// Helper to check if \p otherStr is in \p strList.
 bool PassManagerOptions::listContainsString(
     const llvm::cl::list<std::string> &strList, llvm::StringRef otherStr) {
@@ -105,7 +173,13 @@ PassManagerOptions::PassManagerOptions(const char *id)
               "Number of passes to run before preventing running any "
               "passes. Used for debugging."),
           llvm::cl::init(std::numeric_limits<unsigned>::max()),
-          llvm::cl::cat(passManagerCat)} {}
+          llvm::cl::cat(passManagerCat)},
+
+      printPassStatsOpt{
+          llvm::StringRef(staticStrFormat("print-%s-pass-stats", id)),
+          llvm::cl::desc("Print the number of runs, visited nodes and time "
+                         "spent for each pass run by the pass manager."),
+          llvm::cl::Optional, llvm::cl::cat(passManagerCat)} {}
 
 void PassManagerBase::dump(llvm::raw_ostream &os) const {
   os << getOptions().passManagerID << "PassManager " << getName()
@@ -186,17 +260,68 @@ void PassManagerBase::runPostPassHook(IRContainer *C,
   }
 }
 
+void PassManagerBase::recordNodeVisits(uint64_t numNodes, bool incremental) {
+  if (!currentPassStats_) {
+    return;
+  }
+  currentPassStats_->numNodesVisited += numNodes;
+  currentPassStats_->numIncrementalRuns += incremental;
+}
+
+void PassManagerBase::recordPassStatistics(llvm::StringRef passName,
+                                           const PassStatistics &stats) {
+  passStats_[passName.str()].merge(stats);
+  auto &accumulated = getAccumulatedStats();
+  std::lock_guard<std::mutex> guard(accumulated.lock);
+  accumulated.stats[getOptions().passManagerID][passName.str()].merge(stats);
+}
+
 bool PassManagerBase::runPass(const PassConfigBase &passConfig, IRContainer *F,
                               const CompilationContext &cctx) {
   auto pass = createFunctionPass(passConfig);
   auto &P = *pass;
+
+  // Passes may run other passes on their behalf, e.g. a DCE required before
+  // them. Save the statistics of the enclosing pass so that the nested pass
+  // gets its own.
+  PassStatistics stats;
+  PassStatistics *parentStats = currentPassStats_;
+  uint64_t parentNestedTimeUs = currentNestedTimeUs_;
+  currentPassStats_ = &stats;
+  currentNestedTimeUs_ = 0;
+
+  auto startTime = std::chrono::steady_clock::now();
   bool changed = runPrePass(F, cctx, P);
   changed |= runPassHook(passConfig, P, F, cctx);
   changed |= runPostPass(F, cctx, P);
+  uint64_t elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - startTime)
+                           .count();
+
+  stats.numRuns = 1;
+  stats.numChangedRuns = changed;
+  stats.timeUs = elapsedUs - std::min(elapsedUs, currentNestedTimeUs_);
+  currentPassStats_ = parentStats;
+  currentNestedTimeUs_ = parentNestedTimeUs + elapsedUs;
+  recordPassStatistics(P.getName(), stats);
   return changed;
 }
 
 bool PassManagerBase::run(IRContainer *C, const CompilationContext &cctx) {
+  bool changed = runPipeline(C, cctx);
+  if (getOptions().printPassStatsOpt) {
+    std::string str;
+    llvm::raw_string_ostream os(str);
+    os << getOptions().passManagerID << "PassManager " << getName()
+       << " statistics for Function \"" << C->getName() << "\":\n";
+    dumpPassStatistics(passStats_, os);
+    LOG(INFO) << os.str();
+  }
+  return changed;
+}
+
+bool PassManagerBase::runPipeline(IRContainer *C,
+                                  const CompilationContext &cctx) {
   bool changed = false;
   size_t e = getPipelineSize();
   for (passIdx_ = 0; passIdx_ < e; passIdx_++) {
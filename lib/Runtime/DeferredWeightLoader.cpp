@@ -19,6 +19,180 @@
 namespace glow {
 namespace runtime {
 
+/// \returns the seconds elapsed since \p start.
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+AsyncDeferredWeightLoader::AsyncDeferredWeightLoader(
+    DeferredWeightLoader *loader, unsigned prefetchCount,
+    unsigned numConversionThreads, ConvertFn convert,
+    uint64_t maxPrefetchBytes)
+    : loader_(loader), prefetchCount_(std::max(prefetchCount, 1u)),
+      maxPrefetchBytes_(maxPrefetchBytes), convert_(std::move(convert)),
+      startTime_(std::chrono::steady_clock::now()),
+      conversionPool_(std::max(numConversionThreads, 1u),
+                      "DeferredWeightConversion") {
+  DCHECK(loader_) << "An underlying loader is required.";
+}
+
+AsyncDeferredWeightLoader::~AsyncDeferredWeightLoader() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (prefetchThread_.joinable()) {
+    prefetchThread_.join();
+  }
+  // Conversions refer to the weights in prefetched_, so wait for them before
+  // the weights are freed.
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&]() { return numConverting_ == 0; });
+  for (auto &weight : prefetched_) {
+    ERR_TO_VOID(std::move(weight->err));
+  }
+}
+
+Error AsyncDeferredWeightLoader::setSrc(void *loaderObject) {
+  return loader_->setSrc(loaderObject);
+}
+
+void AsyncDeferredWeightLoader::setTypeInfo(std::map<std::string, Type> info) {
+  loader_->setTypeInfo(std::move(info));
+}
+
+bool AsyncDeferredWeightLoader::canPrefetch() const {
+  if (prefetched_.size() >= prefetchCount_) {
+    return false;
+  }
+  return maxPrefetchBytes_ == 0 || prefetched_.empty() ||
+         prefetchedBytes_ < maxPrefetchBytes_;
+}
+
+void AsyncDeferredWeightLoader::prefetch() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&]() { return stop_ || canPrefetch(); });
+      if (stop_) {
+        prefetchDone_ = true;
+        return;
+      }
+    }
+
+    // Only this thread touches loader_ once prefetching has started.
+    auto readStart = std::chrono::steady_clock::now();
+    auto weight = glow::make_unique<PrefetchedWeight>();
+    Error err = loader_->loadNextWeight();
+    if (!err) {
+      weight->name = loader_->getName();
+      Tensor *T = weight->name.empty() ? nullptr : loader_->getTensor();
+      if (!weight->name.empty() && !T) {
+        err = MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_ERROR,
+                       "No Tensor for deferred weight " + weight->name);
+      } else if (T && T->isUnowned()) {
+        // The underlying loader may free unowned memory on its next
+        // loadNextWeight(), so copy it.
+        weight->tensor = T->clone();
+      } else if (T) {
+        weight->tensor = std::move(*T);
+      }
+    }
+    const double readSeconds = secondsSince(readStart);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    stats_.readSeconds += readSeconds;
+    if (err) {
+      weight->err = std::move(err);
+      weight->ready = true;
+      prefetched_.push_back(std::move(weight));
+      prefetchDone_ = true;
+      cv_.notify_all();
+      return;
+    }
+    if (weight->name.empty()) {
+      prefetchDone_ = true;
+      cv_.notify_all();
+      return;
+    }
+
+    PrefetchedWeight *W = weight.get();
+    prefetchedBytes_ += W->tensor.getSizeInBytes();
+    prefetched_.push_back(std::move(weight));
+    if (!convert_) {
+      W->ready = true;
+      cv_.notify_all();
+      continue;
+    }
+    numConverting_++;
+    lock.unlock();
+    conversionPool_.submit([this, W]() {
+      auto convertStart = std::chrono::steady_clock::now();
+      Error err = convert_(W->name, W->tensor);
+      const double convertSeconds = secondsSince(convertStart);
+      std::unique_lock<std::mutex> lock(mutex_);
+      stats_.convertSeconds += convertSeconds;
+      W->err = std::move(err);
+      W->ready = true;
+      numConverting_--;
+      cv_.notify_all();
+    });
+  }
+}
+
+Error AsyncDeferredWeightLoader::loadNextWeight() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!started_) {
+    started_ = true;
+    prefetchThread_ = std::thread([this]() { prefetch(); });
+  }
+
+  // Free the current weight and make room for the next one to be prefetched.
+  current_.reset();
+  cv_.notify_all();
+
+  auto stallStart = std::chrono::steady_clock::now();
+  cv_.wait(lock, [&]() {
+    return (!prefetched_.empty() && prefetched_.front()->ready) ||
+           (prefetched_.empty() && prefetchDone_);
+  });
+  stats_.stallSeconds += secondsSince(stallStart);
+  if (prefetched_.empty()) {
+    return Error::success();
+  }
+
+  current_ = std::move(prefetched_.front());
+  prefetched_.pop_front();
+  prefetchedBytes_ -= current_->tensor.getSizeInBytes();
+  cv_.notify_all();
+  if (current_->err) {
+    return std::move(current_->err);
+  }
+  stats_.numWeightsLoaded++;
+  stats_.numBytesLoaded += current_->tensor.getSizeInBytes();
+  return Error::success();
+}
+
+std::string AsyncDeferredWeightLoader::getName() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return current_ ? current_->name : "";
+}
+
+Tensor *AsyncDeferredWeightLoader::getTensor() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return current_ ? &current_->tensor : nullptr;
+}
+
+DeferredWeightLoaderStats AsyncDeferredWeightLoader::getStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  DeferredWeightLoaderStats stats = stats_;
+  stats.elapsedSeconds = secondsSince(startTime_);
+  return stats;
+}
+
 DeferredWeightLoader *DeferredWeightLoaderRegistry::getLoader() {
   return loader_;
 }
@@ -39,7 +39,9 @@
 #include "folly/executors/CPUThreadPoolExecutor.h"
 
 #include <algorithm>
+#include <condition_variable>
 #include <future>
+#include <numeric>
 #include <queue>
 #include <shared_mutex>
 
@@ -116,7 +118,7 @@ Expected<DAG *> HostManager::getNetworkDAG(llvm::StringRef network) {
   if (it == networks_.end()) {
     return MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_ERROR, "Network not found.");
   }
-  return &it->second.dag;
+  return &it->second->dag;
 }
 
 Error HostManager::startDeviceTrace() {
@@ -269,7 +271,7 @@ Error HostManager::addNetwork(std::unique_ptr<Module> module,
     for (auto &F : functions) {
       std::string name = F->getName();
       auto it = networks_.find(name);
-      if (it != networks_.end() ||
+      if (it != networks_.end() || networkVariants_.count(name) ||
           processingNetworks_.find(name) != processingNetworks_.end()) {
         cleanupAddNetwork(names);
         return MAKE_ERR(
@@ -567,9 +569,10 @@ Error HostManager::addNetwork(std::unique_ptr<Module> module,
     std::unique_lock<std::shared_timed_mutex> networkLock(networkLock_);
     for (auto &node : nodeList) {
       LOG(INFO) << "Successfully compiled and provisioned " << node.root->name;
-      auto &networkData = networks_[(node.root)->name];
-      networkData.dag = std::move(node);
-      networkData.module = sharedModule;
+      auto networkData = glow::make_unique<NetworkData>();
+      networkData->dag = std::move(node);
+      networkData->module = sharedModule;
+      networks_[networkData->dag.root->name] = std::move(networkData);
     }
     cleanupAddNetwork(names);
   }
@@ -582,7 +585,7 @@ HostManager::getDevicePartitionMapping(llvm::StringRef network) {
   std::unordered_map<std::string, std::vector<DeviceIDTy>> mapping;
   auto it = networks_.find(network);
   if (it != networks_.end()) {
-    auto &nodeList = it->second.dag.nodes;
+    auto &nodeList = it->second->dag.nodes;
     for (auto &node : nodeList) {
       std::vector<DeviceIDTy> devices;
       for (auto &dev : node->deviceRuntimeInfos) {
@@ -594,8 +597,7 @@ HostManager::getDevicePartitionMapping(llvm::StringRef network) {
   return mapping;
 }
 
-Error HostManager::removeNetwork(llvm::StringRef networkName) {
-  std::unique_lock<std::shared_timed_mutex> networkLock(networkLock_);
+Error HostManager::checkNetworkRemovable(llvm::StringRef networkName) {
   auto networkIterator = networks_.find(networkName);
   if (networkIterator == networks_.end()) {
     return Error::success();
@@ -612,18 +614,56 @@ Error HostManager::removeNetwork(llvm::StringRef networkName) {
   }
 
   // Issue an error as there are outstanding runs for the network
-  if (networkIterator->second.refcount != 0) {
+  if (networkIterator->second->refcount != 0) {
     return MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_NET_BUSY,
                     llvm::formatv("Cannot remove the network {0}, as there are "
                                   "still outstanding runs",
                                   networkName)
                         .str());
   }
+  return Error::success();
+}
+
+Error HostManager::removeNetwork(llvm::StringRef networkName) {
+  std::unique_lock<std::shared_timed_mutex> networkLock(networkLock_);
+  auto variantsIt = networkVariants_.find(networkName);
+  if (variantsIt != networkVariants_.end()) {
+    // Check every variant before removing any, so that a busy variant leaves
+    // the whole network in place.
+    for (auto &variant : *variantsIt->second) {
+      RETURN_IF_ERR(checkNetworkRemovable(variant->name));
+    }
+    std::shared_ptr<NetworkVariants> variants = std::move(variantsIt->second);
+    networkVariants_.erase(variantsIt);
+    OneErrOnly err;
+    for (auto &variant : *variants) {
+      auto networkIterator = networks_.find(variant->name);
+      if (networkIterator != networks_.end()) {
+        err.set(evictNetworkData(*networkIterator->second));
+        networks_.erase(networkIterator);
+      }
+    }
+    exportMemoryCounters();
+    return err.get();
+  }
 
+  RETURN_IF_ERR(checkNetworkRemovable(networkName));
+  auto networkIterator = networks_.find(networkName);
+  if (networkIterator == networks_.end()) {
+    return Error::success();
+  }
+
+  auto err = evictNetworkData(*networkIterator->second);
+  networks_.erase(networkIterator);
+  exportMemoryCounters();
+  RETURN_ERR(err);
+}
+
+Error HostManager::evictNetworkData(NetworkData &network) {
   OneErrOnly err;
-  auto &nodes = networkIterator->second.dag.nodes;
+  auto &nodes = network.dag.nodes;
   // Free the pool of executionStates.
-  executor_->freePool(networkIterator->second.dag.root.get());
+  executor_->freePool(network.dag.root.get());
   for (auto &node : nodes) {
     for (auto device : node->deviceRuntimeInfos) {
       Error evictErr =
@@ -633,14 +673,431 @@ Error HostManager::removeNetwork(llvm::StringRef networkName) {
     // Also remove compiledFunction from Provisioner.
     err.set(provisioner_->removeFunction(node->name));
   }
-  networks_.erase(networkIterator);
+  return err.get();
+}
+
+Error HostManager::replaceNetwork(std::unique_ptr<Module> module,
+                                  CompilationContext &cctx) {
+  RETURN_ERR_IF_NOT(module->getFunctions().size() == 1,
+                    "Expected a single Function in the new network version.");
+  Function *F = *module->getFunctions().begin();
+  std::string name = F->getName();
+
+  // Claim the network so it is not removed or replaced concurrently, and pick
+  // a unique name to compile the new version under.
+  std::string stagedName;
+  {
+    std::unique_lock<std::shared_timed_mutex> networkLock(networkLock_);
+    if (networks_.find(name) == networks_.end()) {
+      return MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_NET_NOT_FOUND,
+                      "Cannot replace the network " + name +
+                          ", as it was not added.");
+    }
+    if (processingNetworks_.count(name)) {
+      return MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_NET_BUSY,
+                      "Cannot replace the network " + name +
+                          ", as it is currently being modified.");
+    }
+    do {
+      stagedName = strFormat("%s_v%zu", name.c_str(), ++stagedNetworkCount_);
+    } while (networks_.count(stagedName) ||
+             processingNetworks_.count(stagedName));
+    processingNetworks_.insert(name);
+  }
+  ScopeGuard releaseName([&]() {
+    std::unique_lock<std::shared_timed_mutex> networkLock(networkLock_);
+    processingNetworks_.erase(name);
+  });
+
+  // Add the new version alongside the current one. A user defined partition
+  // of the network has to follow the staged name, and its partitions need
+  // names that do not clash with the ones of the current version.
+  F->setName(stagedName);
+  PartitionConfig stagedPartitionConfig;
+  auto *partitionConfig = cctx.partitionConfig;
+  ScopeGuard restorePartitionConfig(
+      [&]() { cctx.partitionConfig = partitionConfig; });
+  if (partitionConfig && partitionConfig->funcName == name) {
+    stagedPartitionConfig = *partitionConfig;
+    stagedPartitionConfig.funcName = stagedName;
+    for (auto &partitionName : stagedPartitionConfig.partitionNames) {
+      partitionName = stagedName + "_" + partitionName;
+    }
+    cctx.partitionConfig = &stagedPartitionConfig;
+  }
+  RETURN_IF_ERR(addNetwork(std::move(module), cctx));
+  restorePartitionConfig.runAndDismiss();
+
+  // Switch the network over to the new version.
+  std::unique_ptr<NetworkData> previous;
+  {
+    std::unique_lock<std::shared_timed_mutex> networkLock(networkLock_);
+    auto stagedIt = networks_.find(stagedName);
+    auto &current = networks_[name];
+    auto &staged = *stagedIt->second;
+    staged.dag.root->name = name;
+
+    // Let callers keep using the Placeholders of the last few versions.
+    auto &previousModules = staged.previousModules;
+    previousModules = std::move(current->previousModules);
+    previousModules.push_back(current->module);
+    if (previousModules.size() > config_.maxPreviousNetworkVersions) {
+      previousModules.erase(previousModules.begin(),
+                            previousModules.end() -
+                                config_.maxPreviousNetworkVersions);
+    }
+    for (const auto &previousModule : previousModules) {
+      for (const auto *PH : previousModule->getPlaceholders()) {
+        auto *newPH = staged.module->getPlaceholderByNameSlow(PH->getName());
+        if (newPH && newPH->getType()->isEqual(*PH->getType())) {
+          staged.placeholderRemap[PH] = newPH;
+        }
+      }
+    }
+
+    previous = std::move(current);
+    current = std::move(stagedIt->second);
+    networks_.erase(stagedIt);
+  }
+
+  // Wait for the runs holding a reference on the previous version to drain.
+  // Queued requests move their reference to the new version when they are
+  // dispatched, so only runs that already started keep it for long.
+  {
+    std::unique_lock<std::mutex> drainLock(drainLock_);
+    drainCV_.wait(drainLock, [&]() { return previous->refcount == 0; });
+  }
+
+  std::unique_lock<std::shared_timed_mutex> networkLock(networkLock_);
+  auto err = evictNetworkData(*previous);
   exportMemoryCounters();
-  RETURN_ERR(err.get());
+  RETURN_ERR(err);
+}
+
+void HostManager::releaseNetwork(NetworkData *network) {
+  if (--network->refcount == 0) {
+    // Take the lock so the wakeup cannot be lost between the check of a
+    // waiter and its wait.
+    std::lock_guard<std::mutex> drainLock(drainLock_);
+    drainCV_.notify_all();
+  }
+}
+
+Error HostManager::updateConstantRows(llvm::StringRef networkName,
+                                      llvm::StringRef name, dim_t firstRow,
+                                      const Tensor &rows) {
+  std::shared_lock<std::shared_timed_mutex> networkLock(networkLock_);
+  auto networkIterator = networks_.find(networkName);
+  if (networkIterator == networks_.end()) {
+    return MAKE_ERR(
+        ErrorValue::ErrorCode::RUNTIME_NET_NOT_FOUND,
+        llvm::formatv("Network {0} not found", networkName).str());
+  }
+
+  // Collect every loaded copy of the partitions that use the constant.
+  std::vector<std::pair<DeviceManager *, std::string>> targets;
+  for (auto &node : networkIterator->second->dag.nodes) {
+    if (!node->runtimeBundle ||
+        !node->runtimeBundle->getSymbolTable().count(name.str())) {
+      continue;
+    }
+    for (auto &device : node->deviceRuntimeInfos) {
+      for (unsigned i = 0; i < node->replicationCount; i++) {
+        targets.emplace_back(devices_[device.first].get(),
+                             node->getReplicaName(i));
+      }
+    }
+  }
+  RETURN_ERR_IF_NOT(!targets.empty(),
+                    llvm::formatv("Network {0} has no constant named {1}",
+                                  networkName, name)
+                        .str());
+
+  std::vector<std::promise<void>> promises(targets.size());
+  std::vector<std::future<void>> futures;
+  OneErrOnly err;
+  for (size_t i = 0; i < targets.size(); i++) {
+    futures.push_back(promises[i].get_future());
+    targets[i].first->updateConstantRows(
+        targets[i].second, name, firstRow, rows,
+        [&err, &promise = promises[i]](Error updateErr) {
+          err.set(std::move(updateErr));
+          promise.set_value();
+        });
+  }
+  for (auto &future : futures) {
+    future.wait();
+  }
+  return err.get();
+}
+
+/// Copies the elements of \p src into the elements of \p dst with the same
+/// coordinates, dropping those that are out of the bounds of \p dst and
+/// zeroing the rest of \p dst. Both tensors have the same element type and
+/// rank.
+static void copyPadded(const Tensor &src, Tensor &dst) {
+  dst.zero();
+  auto srcDims = src.dims();
+  auto dstDims = dst.dims();
+  auto srcStrides = src.getType().strides();
+  auto dstStrides = dst.getType().strides();
+  size_t elementSize = src.getType().getElementSize();
+  const char *srcData = src.getUnsafePtr();
+  char *dstData = dst.getUnsafePtr();
+  if (srcDims.empty()) {
+    memcpy(dstData, srcData, elementSize);
+    return;
+  }
+
+  size_t rank = srcDims.size();
+  std::vector<dim_t> extent(rank);
+  for (size_t i = 0; i < rank; i++) {
+    extent[i] = std::min(srcDims[i], dstDims[i]);
+    if (!extent[i]) {
+      return;
+    }
+  }
+  // Copy the innermost rows of the overlap, walking over their coordinates.
+  size_t rowBytes = extent[rank - 1] * elementSize;
+  std::vector<dim_t> coord(rank - 1, 0);
+  while (true) {
+    size_t srcOffset = 0;
+    size_t dstOffset = 0;
+    for (size_t i = 0; i < rank - 1; i++) {
+      srcOffset += coord[i] * srcStrides[i];
+      dstOffset += coord[i] * dstStrides[i];
+    }
+    memcpy(dstData + dstOffset * elementSize,
+           srcData + srcOffset * elementSize, rowBytes);
+    size_t dim = rank - 1;
+    for (; dim > 0; dim--) {
+      if (++coord[dim - 1] < extent[dim - 1]) {
+        break;
+      }
+      coord[dim - 1] = 0;
+    }
+    if (dim == 0) {
+      return;
+    }
+  }
+}
+
+Error HostManager::addNetworkVariants(
+    std::vector<std::unique_ptr<Module>> modules, CompilationContext &cctx) {
+  RETURN_ERR_IF_NOT(!modules.empty(), "Expected at least one variant.");
+  std::string name;
+  auto variants = std::make_shared<NetworkVariants>();
+  for (auto &module : modules) {
+    RETURN_ERR_IF_NOT(module->getFunctions().size() == 1,
+                      "Expected a single Function in each variant.");
+    Function *F = *module->getFunctions().begin();
+    if (name.empty()) {
+      name = F->getName();
+    }
+    RETURN_ERR_IF_NOT(F->getName() == name,
+                      "Variants of the network " + name +
+                          " have Functions with different names.");
+    auto variant = glow::make_unique<NetworkVariant>();
+    for (auto *PH : module->getPlaceholders()) {
+      if (isOutput(PH, *F)) {
+        variant->outputs[PH->getName()] = PH;
+      } else if (isInput(PH, *F)) {
+        variant->inputs[PH->getName()] = PH;
+      }
+    }
+    variants->push_back(std::move(variant));
+  }
+
+  // All variants have the same inputs and outputs, up to their shapes.
+  auto matches = [](const llvm::StringMap<Placeholder *> &a,
+                    const llvm::StringMap<Placeholder *> &b) {
+    if (a.size() != b.size()) {
+      return false;
+    }
+    for (const auto &entry : a) {
+      auto it = b.find(entry.getKey());
+      if (it == b.end() ||
+          it->second->getElementType() != entry.second->getElementType() ||
+          it->second->dims().size() != entry.second->dims().size()) {
+        return false;
+      }
+    }
+    return true;
+  };
+  for (auto &variant : *variants) {
+    RETURN_ERR_IF_NOT(matches(variant->inputs, variants->front()->inputs) &&
+                          matches(variant->outputs, variants->front()->outputs),
+                      "Variants of the network " + name +
+                          " have different inputs or outputs.");
+  }
+
+  // Order the variants, and their modules, from the smallest to the largest.
+  auto inputsSize = [](const NetworkVariant &variant) {
+    uint64_t size = 0;
+    for (const auto &entry : variant.inputs) {
+      size += entry.second->getType()->getSizeInBytes();
+    }
+    return size;
+  };
+  std::vector<size_t> order(variants->size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return inputsSize(*(*variants)[a]) < inputsSize(*(*variants)[b]);
+  });
+
+  // Claim the name of the network while its variants are added.
+  {
+    std::unique_lock<std::shared_timed_mutex> networkLock(networkLock_);
+    if (networks_.count(name) || networkVariants_.count(name) ||
+        processingNetworks_.count(name)) {
+      return MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_ERROR,
+                      "Failed to add network: already have a function called " +
+                          name);
+    }
+    processingNetworks_.insert(name);
+  }
+  ScopeGuard releaseName([&]() {
+    std::unique_lock<std::shared_timed_mutex> networkLock(networkLock_);
+    processingNetworks_.erase(name);
+  });
+
+  NetworkVariants sorted;
+  for (size_t i = 0; i < order.size(); i++) {
+    auto &variant = (*variants)[order[i]];
+    auto &module = modules[order[i]];
+    variant->name = strFormat("%s_variant%zu", name.c_str(), i);
+    variant->hitsCounter =
+        strFormat("glow.network_variants.%s.hits", variant->name.c_str());
+    (*module->getFunctions().begin())->setName(variant->name);
+    auto err = addNetwork(std::move(module), cctx);
+    if (err) {
+      for (auto &added : sorted) {
+        ERR_TO_VOID(removeNetwork(added->name));
+      }
+      return err;
+    }
+    sorted.push_back(std::move(variant));
+  }
+
+  std::unique_lock<std::shared_timed_mutex> networkLock(networkLock_);
+  for (auto &variant : sorted) {
+    variant->module = networks_[variant->name]->module;
+  }
+  *variants = std::move(sorted);
+  networkVariants_.emplace(name, std::move(variants));
+  return Error::success();
+}
+
+std::vector<uint64_t>
+HostManager::getNetworkVariantHits(llvm::StringRef networkName) {
+  std::shared_lock<std::shared_timed_mutex> networkLock(networkLock_);
+  std::vector<uint64_t> hits;
+  auto it = networkVariants_.find(networkName);
+  if (it != networkVariants_.end()) {
+    for (auto &variant : *it->second) {
+      hits.push_back(variant->hits);
+    }
+  }
+  return hits;
+}
+
+RunIdentifierTy
+HostManager::runNetworkVariant(std::shared_ptr<NetworkVariants> variants,
+                               std::unique_ptr<ExecutionContext> context,
+                               ResultCBTy callback, uint64_t priority) {
+  auto *bindings = context->getPlaceholderBindings();
+
+  // Route the request to the smallest variant its inputs fit in. Outputs can
+  // have any shape, as they are cropped or padded.
+  NetworkVariant *variant = nullptr;
+  for (auto &candidate : *variants) {
+    bool fits = true;
+    for (auto &PT : bindings->pairs()) {
+      auto name = PT.first->getName();
+      auto inputIt = candidate->inputs.find(name);
+      bool isInput = inputIt != candidate->inputs.end();
+      auto outputIt = candidate->outputs.find(name);
+      if (!isInput && outputIt == candidate->outputs.end()) {
+        continue;
+      }
+      auto *PH = isInput ? inputIt->second : outputIt->second;
+      auto dims = PT.second.dims();
+      auto phDims = PH->dims();
+      fits &= PT.second.getElementType() == PH->getElementType() &&
+              dims.size() == phDims.size();
+      for (size_t i = 0; fits && isInput && i < dims.size(); i++) {
+        fits &= dims[i] <= phDims[i];
+      }
+    }
+    if (fits) {
+      variant = candidate.get();
+      break;
+    }
+  }
+  if (!variant) {
+    auto currentRun = totalRequestCount_++;
+    callback(currentRun,
+             MAKE_ERR(ErrorValue::ErrorCode::RUNTIME_ERROR,
+                      "No variant of the network fits the request."),
+             std::move(context));
+    return currentRun;
+  }
+  variant->hits++;
+  statsExporterRegistry_->incrementCounter(variant->hitsCounter);
+
+  // Bind the Placeholders of the variant. Tensors of the right type are bound
+  // as views, other inputs are padded and other outputs are copied back once
+  // the run is done.
+  auto variantContext = glow::make_unique<ExecutionContext>();
+  variantContext->setTraceContext(context->setTraceContext(nullptr));
+  auto *variantBindings = variantContext->getPlaceholderBindings();
+  std::vector<std::pair<Tensor *, Placeholder *>> outputs;
+  for (auto &PT : bindings->pairs()) {
+    auto name = PT.first->getName();
+    auto inputIt = variant->inputs.find(name);
+    bool isInput = inputIt != variant->inputs.end();
+    auto outputIt = variant->outputs.find(name);
+    if (!isInput && outputIt == variant->outputs.end()) {
+      continue;
+    }
+    auto *PH = isInput ? inputIt->second : outputIt->second;
+    if (PT.second.getType().isEqual(*PH->getType())) {
+      variantBindings->insert(PH, PT.second.getUnowned());
+      continue;
+    }
+    Tensor T(PH->getType());
+    if (isInput) {
+      copyPadded(PT.second, T);
+    } else {
+      outputs.emplace_back(&PT.second, PH);
+    }
+    variantBindings->insert(PH, std::move(T));
+  }
+
+  // The callback is called once, and returns the caller's context.
+  auto *callerContext = context.release();
+  return runNetwork(
+      variant->name, std::move(variantContext),
+      [callback, variants, callerContext,
+       outputs](RunIdentifierTy runID, Error err,
+                std::unique_ptr<ExecutionContext> variantContext) {
+        std::unique_ptr<ExecutionContext> context(callerContext);
+        if (variantContext) {
+          context->setTraceContext(variantContext->setTraceContext(nullptr));
+          auto *variantBindings = variantContext->getPlaceholderBindings();
+          for (auto &output : outputs) {
+            copyPadded(*variantBindings->get(output.second), *output.first);
+          }
+        }
+        callback(runID, std::move(err), std::move(context));
+      },
+      priority);
 }
 
 bool HostManager::networkAdded(llvm::StringRef networkName) {
   std::shared_lock<std::shared_timed_mutex> networkLock(networkLock_);
-  return networks_.find(networkName) != networks_.end();
+  return networks_.find(networkName) != networks_.end() ||
+         networkVariants_.count(networkName);
 }
 
 Error HostManager::clearHost() {
@@ -652,6 +1109,7 @@ Error HostManager::clearHost() {
       << "All requests should be finished when shutting down HostManager.";
 
   // Remove all networks from the host and device(s).
+  networkVariants_.clear();
   while (networks_.size() != 0) {
     RETURN_IF_ERR(removeNetwork(networks_.begin()->first));
   }
@@ -717,6 +1175,93 @@ Error HostManager::runNetworkBlocking(
   return runErr;
 }
 
+Error HostManager::runNetworkMicroBatched(llvm::StringRef networkName,
+                                          PlaceholderBindings &bindings,
+                                          unsigned maxInFlight) {
+  if (!maxInFlight) {
+    std::shared_lock<std::shared_timed_mutex> networkLock(networkLock_);
+    DAG *dag;
+    ASSIGN_VALUE_OR_RETURN_ERR(dag, getNetworkDAG(networkName));
+    maxInFlight = dag->nodes.size() + 1;
+  }
+
+  // Tensors larger than their Placeholder give the number of micro-batches.
+  dim_t numMicroBatches = 1;
+  bool isBatched = false;
+  for (auto &PT : bindings.pairs()) {
+    auto phDims = PT.first->dims();
+    auto dims = PT.second.dims();
+    if (dims == phDims) {
+      continue;
+    }
+    RETURN_ERR_IF_NOT(!phDims.empty() && phDims[0] &&
+                          dims.size() == phDims.size() &&
+                          dims[0] % phDims[0] == 0 &&
+                          dims.drop_front() == phDims.drop_front() &&
+                          PT.second.getSizeInBytes() ==
+                              PT.second.getUnpaddedSizeInBytes(),
+                      "Tensor bound to " + PT.first->getName().str() +
+                          " is not a batch of its Placeholder");
+    dim_t batches = dims[0] / phDims[0];
+    RETURN_ERR_IF_NOT(!isBatched || batches == numMicroBatches,
+                      "Inconsistent number of micro-batches for " +
+                          PT.first->getName().str());
+    numMicroBatches = batches;
+    isBatched = true;
+  }
+  // Every micro-batch would write the same output.
+  for (auto &PT : bindings.pairs()) {
+    Placeholder *PH = PT.first;
+    bool isOutput = false;
+    for (const auto &use : PH->getUsers()) {
+      auto *SN = llvm::dyn_cast<SaveNode>(use.getUser());
+      isOutput |= SN && SN->getPlaceholder() == PH;
+    }
+    RETURN_ERR_IF_NOT(!isOutput || numMicroBatches == 1 ||
+                          PT.second.dims() != PH->dims(),
+                      "Output " + PH->getName().str() + " is not batched");
+  }
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  unsigned numInFlight = 0;
+  OneErrOnly runErr;
+  for (dim_t i = 0; i < numMicroBatches && !runErr.containsErr(); i++) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv.wait(lock, [&] { return numInFlight < maxInFlight; });
+      ++numInFlight;
+    }
+    // Bind views into the tensors of the batch, which avoids copying inputs
+    // and outputs.
+    auto context = glow::make_unique<ExecutionContext>();
+    auto *microBatchBindings = context->getPlaceholderBindings();
+    for (auto &PT : bindings.pairs()) {
+      auto phDims = PT.first->dims();
+      if (PT.second.dims() == phDims) {
+        microBatchBindings->insert(PT.first, PT.second.getUnowned());
+        continue;
+      }
+      std::vector<dim_t> offsets(phDims.size(), 0);
+      offsets[0] = i * phDims[0];
+      microBatchBindings->insert(PT.first,
+                                 PT.second.getUnowned(phDims, offsets));
+    }
+    runNetwork(networkName, std::move(context),
+               [&](RunIdentifierTy, Error err,
+                   std::unique_ptr<ExecutionContext> /* unused */) {
+                 runErr.set(std::move(err));
+                 std::lock_guard<std::mutex> lock(mtx);
+                 --numInFlight;
+                 cv.notify_all();
+               });
+  }
+
+  std::unique_lock<std::mutex> lock(mtx);
+  cv.wait(lock, [&] { return numInFlight == 0; });
+  return runErr.get();
+}
+
 void HostManager::dispatchNextRun() {
   int requestId = -1;
   llvm::Optional<InferRequest> pRequest;
@@ -744,18 +1289,49 @@ void HostManager::dispatchNextRun() {
   InferRequest request = std::move(pRequest.getValue());
   auto startTime = TraceEvent::now();
   auto requestReceived = request.startTime;
+
+  // If the network was replaced while the request was queued, move its
+  // reference to the current version, which it runs on.
+  NetworkData *network = networks_[request.networkName].get();
+  if (network != request.network) {
+    network->refcount++;
+    releaseNetwork(request.network);
+  }
+
+  // Bind the current Placeholders to views of the tensors bound to
+  // Placeholders of previous versions of the network, so the caller's tensors
+  // are used in place. The views are dropped before the results are returned.
+  std::vector<Placeholder *> remapped;
+  if (!network->placeholderRemap.empty()) {
+    auto *bindings = request.context->getPlaceholderBindings();
+    std::vector<std::pair<Placeholder *, Tensor>> views;
+    for (auto &pair : bindings->pairs()) {
+      auto it = network->placeholderRemap.find(pair.first);
+      if (it != network->placeholderRemap.end() &&
+          !bindings->count(it->second)) {
+        views.emplace_back(it->second, pair.second.getUnowned());
+      }
+    }
+    for (auto &view : views) {
+      remapped.push_back(view.first);
+      bindings->insert(view.first, std::move(view.second));
+    }
+  }
+
   executor_->run(
-      networks_[request.networkName].dag.root.get(), std::move(request.context),
-      request.requestID,
-      [this, callback = request.callback, name = request.networkName, startTime,
+      network->dag.root.get(), std::move(request.context), request.requestID,
+      [this, callback = request.callback, name = request.networkName, network,
+       remapped = std::move(remapped), startTime,
        requestReceived](RunIdentifierTy runID, Error err,
                         std::unique_ptr<ExecutionContext> context) mutable {
+        if (context) {
+          for (auto *PH : remapped) {
+            context->getPlaceholderBindings()->erase(PH);
+          }
+        }
         {
           std::shared_lock<std::shared_timed_mutex> netLock(networkLock_);
-          auto it = networks_.find(name);
-          if (it != networks_.end()) {
-            it->second.refcount--;
-          }
+          releaseNetwork(network);
         }
 
         updateExecutionStats(startTime, context, name, err);
@@ -778,6 +1354,20 @@ HostManager::runNetwork(llvm::StringRef networkName,
                         ResultCBTy callback, uint64_t priority) {
   DCHECK(callback != nullptr);
 
+  // Networks compiled for several input shapes run on one of their variants.
+  std::shared_ptr<NetworkVariants> variants;
+  {
+    std::shared_lock<std::shared_timed_mutex> networkLock(networkLock_);
+    auto it = networkVariants_.find(networkName);
+    if (it != networkVariants_.end()) {
+      variants = it->second;
+    }
+  }
+  if (variants) {
+    return runNetworkVariant(std::move(variants), std::move(context),
+                             std::move(callback), priority);
+  }
+
   TRACE_EVENT_SCOPE(context->getTraceContext(), TraceLevel::RUNTIME,
                     "HostManager::runNetwork");
   auto currentRun = totalRequestCount_++;
@@ -789,7 +1379,7 @@ HostManager::runNetwork(llvm::StringRef networkName,
     std::shared_lock<std::shared_timed_mutex> networkLock(networkLock_);
     auto it = networks_.find(networkName);
     if (it != networks_.end()) {
-      network = &it->second;
+      network = it->second.get();
       network->refcount++;
     }
 
@@ -808,7 +1398,7 @@ HostManager::runNetwork(llvm::StringRef networkName,
       queueSize = inferQueue_.size();
       if (queueSize >= config_.maxQueueSize) {
         // The queue is full, return an error.
-        network->refcount--;
+        releaseNetwork(network);
         TRACE_EVENT_SCOPE_END();
         callback(
             currentRun,
@@ -824,8 +1414,8 @@ HostManager::runNetwork(llvm::StringRef networkName,
     }
     reportCurrentQueueSize(queueSize);
     // Setup the request
-    InferRequest queuedRequest(networkName, std::move(context), callback,
-                               priority, currentRun, requestReceived);
+    InferRequest queuedRequest(networkName, network, std::move(context),
+                               callback, priority, currentRun, requestReceived);
     {
       std::unique_lock<std::shared_timed_mutex> lock(inferQueueLock_);
       TRACE_EVENT_SCOPE_END();
@@ -27,6 +27,7 @@
 #include <future>
 #include <map>
 #include <queue>
+#include <unordered_map>
 
 using namespace glow;
 using namespace runtime;
@@ -58,6 +59,24 @@ auto sortMostMemory = [](const std::pair<DeviceIDTy, uint64_t> &a,
                          const std::pair<DeviceIDTy, uint64_t> &b) -> bool {
   return a.second > b.second;
 };
+
+/// Converts the deferred weight \p weight to the type of the static
+/// Placeholder \p PH it is loaded into, if they differ.
+void convertDeferredWeight(const Placeholder *PH, Tensor *weight) {
+  auto newTy = PH->getType();
+  auto oldKind = weight->getElementType();
+  if (weight->getType().isEqual(newTy)) {
+    return;
+  }
+  ElemKind newK = newTy->getElementType();
+  if (!isQuantizedElemKind(oldKind) && isQuantizedElemKind(newK)) {
+    Tensor QT = quantization::quantizeTensor(
+        *weight, {newTy->getScale(), newTy->getOffset()}, newK);
+    weight->assign(&QT);
+  } else {
+    weight->convertToType(newK);
+  }
+}
 } // namespace
 
 Provisioner::Provisioner(DeviceManagerMapTy &devices) {
@@ -140,6 +159,15 @@ static std::vector<std::pair<DeviceIDTy, uint64_t>> calculateLogicalDeviceSize(
   return logicalDeviceSize;
 }
 
+/// \returns the root of the DAG \p node belongs to, or \p node itself if its
+/// parents are not known.
+static const DAGNode *getDAGRoot(const DAGNode *node) {
+  while (!node->parents.empty()) {
+    node = node->parents[0];
+  }
+  return node;
+}
+
 Expected<std::map<DeviceIDTy, DeviceIDTy>>
 Provisioner::generateDeviceAssignments(
     const std::vector<std::pair<DeviceIDTy, uint64_t>> &logicalDeviceSize,
@@ -153,6 +181,14 @@ Provisioner::generateDeviceAssignments(
   for (auto &device : deviceMemoryMap) {
     positions[device.first] = 0;
   }
+  // NUMA node of each physical device, and the NUMA node the partitions of
+  // each network have been placed on so far. Partitions of one network
+  // exchange activations, so we keep them on a single node when we can.
+  std::vector<int> deviceNumaNodes;
+  for (auto *device : devices_) {
+    deviceNumaNodes.push_back(device->getDeviceInfo().numaNode);
+  }
+  std::unordered_map<const DAGNode *, int> networkNumaNodes;
   // Walk through the logical devices and assign them a physical device.
   // This approach will try to evenly spread networks across devices, we first
   // sort all devices by available space and then assign in descending order.
@@ -175,9 +211,34 @@ Provisioner::generateDeviceAssignments(
               .str());
     }
 
+    // If another partition of the same network is already on a NUMA node,
+    // prefer the device on that node with the most available memory.
+    int numaNode{-1};
+    for (auto *node : logicalDevices[logicalDevice.first]) {
+      auto it = networkNumaNodes.find(getDAGRoot(node));
+      if (it != networkNumaNodes.end()) {
+        numaNode = it->second;
+        break;
+      }
+    }
+    auto &devices = deviceMemoryMap[backendName];
+    auto numaDevice = devices.end();
+    if (numaNode >= 0) {
+      for (auto it = devices.begin(); it != devices.end(); ++it) {
+        if (deviceNumaNodes[it->first] == numaNode &&
+            it->second >= logicalDevice.second &&
+            (numaDevice == devices.end() || it->second > numaDevice->second)) {
+          numaDevice = it;
+        }
+      }
+    }
+
     auto currentPosition = positions[backendName];
-    if (deviceMemoryMap[backendName][currentPosition].second >=
-        logicalDevice.second) {
+    if (numaDevice != devices.end()) {
+      deviceAssignment.emplace(logicalDevice.first, numaDevice->first);
+      numaDevice->second -= logicalDevice.second;
+    } else if (deviceMemoryMap[backendName][currentPosition].second >=
+               logicalDevice.second) {
       // There is enough space, assign the logical device to this physical
       // device, increment the iterator and update the available memory.
       deviceAssignment.emplace(
@@ -221,6 +282,15 @@ Provisioner::generateDeviceAssignments(
             "Logical Device is too large to fit in available device memory.");
       }
     }
+
+    // Remember the NUMA node the partitions of these networks went to.
+    int assignedNumaNode =
+        deviceNumaNodes[deviceAssignment[logicalDevice.first]];
+    if (assignedNumaNode >= 0) {
+      for (auto *node : logicalDevices[logicalDevice.first]) {
+        networkNumaNodes.emplace(getDAGRoot(node), assignedNumaNode);
+      }
+    }
   }
 
   // Update nodes in logicalDevices with their assignments.
@@ -577,7 +647,31 @@ Error Provisioner::provision(DAGListTy &networks, Module &module,
     LOG(INFO) << "Loading " << totalNumDeferredWeights << " deferred weights";
 
     auto startTime = std::chrono::steady_clock::now();
-    auto loader = cctx.deferredWeightLoader;
+    DeferredWeightLoader *loader = cctx.deferredWeightLoader;
+    // Read and convert the next weights on worker threads while the current
+    // one is transferred to devices.
+    std::unique_ptr<AsyncDeferredWeightLoader> asyncLoader;
+    if (cctx.deferredWeightPrefetchCount > 0) {
+      std::unordered_map<std::string, const Placeholder *> deferredPHs;
+      for (const auto &PHDevices : placeholderToDeviceManager) {
+        deferredPHs[PHDevices.first->getName().str()] = PHDevices.first;
+      }
+      asyncLoader = glow::make_unique<AsyncDeferredWeightLoader>(
+          loader, cctx.deferredWeightPrefetchCount,
+          cctx.numDeferredWeightConversionThreads,
+          [deferredPHs = std::move(deferredPHs)](const std::string &name,
+                                                 Tensor &weight) -> Error {
+            // Weights missing from the module are reported once they are
+            // handed out below.
+            auto it = deferredPHs.find(name);
+            if (it != deferredPHs.end()) {
+              convertDeferredWeight(it->second, &weight);
+            }
+            return Error::success();
+          },
+          cctx.deferredWeightPrefetchMaxBytes);
+      loader = asyncLoader.get();
+    }
     // Load the first weight.
     auto err = loader->loadNextWeight();
     if (err) {
@@ -599,23 +693,12 @@ Error Provisioner::provision(DAGListTy &networks, Module &module,
                                       weightName)
                             .str());
       }
-      // Convert the weight if needed.
-      auto newTy = PH->getType();
+      // Convert the weight if needed. This is a no-op for weights already
+      // converted by the async loader.
       auto weight = loader->getTensor();
-      auto oldKind = weight->getElementType();
       // Ensure we are working with a static PH.
       assert(PH->isStatic());
-      if (!weight->getType().isEqual(newTy)) {
-        ElemKind newK = newTy->getElementType();
-
-        if (!isQuantizedElemKind(oldKind) && isQuantizedElemKind(newK)) {
-          Tensor QT = quantization::quantizeTensor(
-              *weight, {newTy->getScale(), newTy->getOffset()}, newK);
-          weight->assign(&QT);
-        } else {
-          weight->convertToType(newK);
-        }
-      }
+      convertDeferredWeight(PH, weight);
       // Transfer weight to all devices needed.
       std::list<Error> errors;
       std::list<std::future<void>> futures;
@@ -658,6 +741,14 @@ Error Provisioner::provision(DAGListTy &networks, Module &module,
         std::chrono::steady_clock::now() - startTime;
     LOG(INFO) << "Done loading deferred weights in " << duration.count()
               << " seconds";
+    if (asyncLoader) {
+      const auto stats = asyncLoader->getStats();
+      LOG(INFO) << "Loaded " << stats.numBytesLoaded << " bytes of deferred "
+                << "weights at " << stats.getThroughput() / (1 << 20)
+                << " MB/s; read " << stats.readSeconds << " s, converted "
+                << stats.convertSeconds << " s, stalled "
+                << stats.stallSeconds << " s";
+    }
   }
   // Init alternate name states.
   for (auto &network : networks) {
@@ -216,6 +216,18 @@ deserializeStrStrMapFromYaml(llvm::StringRef fileName) {
   return deserializeFromYaml<std::map<std::string, std::string>>(fileName);
 }
 
+void serializeStrStrMapToYaml(llvm::StringRef fileName,
+                              const std::map<std::string, std::string> &map) {
+  std::error_code EC;
+  llvm::raw_fd_ostream outputStream(fileName, EC, llvm::sys::fs::F_None);
+  assert(!EC && "Unable to create output stream");
+
+  llvm::yaml::Output yout(outputStream);
+  // yaml::Output only serializes through non-const references.
+  auto mapCopy = map;
+  yout << mapCopy;
+}
+
 Expected<int> getIntFromStr(llvm::StringRef input) {
   // StringRef not necessarily null terminated, so get a str from it.
   const std::string inputStr = input.str();
@@ -0,0 +1,214 @@
+/**
+ * Copyright (c) Glow Contributors. See CONTRIBUTORS file.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <future>
+#include <random>
+
+#include "Bench.h"
+
+#include "glow/Backend/Backend.h"
+#include "glow/ExecutionEngine/ExecutionEngine.h"
+#include "glow/Optimizer/GraphOptimizer/GraphOptimizer.h"
+
+using namespace glow;
+
+/*
+ * This class implements the scaled dot-product attention of a multi-head
+ * attention layer, as found in BERT:
+ *   softmax(Q x K^T / sqrt(headDim)) x V
+ * The heads are folded into the batch dimension, so Q, K and V have the shape
+ * [batchSize * numHeads, seqLen, headDim].
+ *
+ * Besides the runtime, the benchmark reports the activation memory of the
+ * compiled function. On the CPU backend the chain is fused into a single
+ * CPUAttention node, which never materializes the [seqLen, seqLen] scores;
+ * pass GLOW_OPTS="-cpu-fuse-attention=0" to measure the unfused chain.
+ */
+class AttentionBench : public Benchmark {
+  dim_t batchSize_;
+  dim_t numHeads_;
+  dim_t seqLen_;
+  dim_t headDim_;
+  std::unique_ptr<runtime::HostManager> hostManager_;
+  std::vector<std::unique_ptr<ExecutionContext>> contexts_;
+  dim_t asyncLaunchSize_;
+  const char *backendStr_;
+  size_t activationsSize_{0};
+
+public:
+  AttentionBench(dim_t batchSize_, dim_t numHeads_, dim_t seqLen_,
+                 dim_t headDim_, dim_t asyncLaunchSize_,
+                 const char *backendStr_)
+      : batchSize_(batchSize_), numHeads_(numHeads_), seqLen_(seqLen_),
+        headDim_(headDim_), asyncLaunchSize_(asyncLaunchSize_),
+        backendStr_(backendStr_) {}
+
+  /// Build the attention chain into \p fn, reading the placeholders \p Q,
+  /// \p K and \p V. \returns the Save node of the result.
+  SaveNode *createAttention(Function *fn, Placeholder *Q, Placeholder *K,
+                            Placeholder *V) {
+    dim_t batches = batchSize_ * numHeads_;
+    auto *KT = fn->createTranspose("key_transpose", K, {0, 2, 1});
+    auto *scores = fn->createBatchMatMul("scores", Q, KT);
+    auto *scale = fn->createSplat("scale", scores->getResult().getType(),
+                                  1.0f / std::sqrt(float(headDim_)));
+    auto *scaled = fn->createMul("scaled_scores", scores, scale);
+    auto *flat =
+        fn->createReshape("flat_scores", scaled, {batches * seqLen_, seqLen_});
+    auto *selected = fn->getParent()->createConstant(
+        ElemKind::Int64ITy, {batches * seqLen_, 1}, "selected");
+    auto *probs = fn->createSoftMax("probs", flat, selected);
+    auto *probs3D =
+        fn->createReshape("probs_3d", probs, {batches, seqLen_, seqLen_});
+    auto *context = fn->createBatchMatMul("context", probs3D, V);
+    return fn->createSave("save", context);
+  }
+
+  void setup() override {
+    for (dim_t i = 0; i < asyncLaunchSize_; i++) {
+      std::unique_ptr<ExecutionContext> context(new ExecutionContext);
+      contexts_.push_back(std::move(context));
+    }
+
+    std::vector<std::unique_ptr<runtime::DeviceConfig>> configs;
+    auto config = glow::make_unique<runtime::DeviceConfig>(backendStr_);
+    configs.push_back(std::move(config));
+    hostManager_ = glow::make_unique<runtime::HostManager>(std::move(configs));
+
+    std::unique_ptr<Module> mod(new Module);
+    auto *fn = mod->createFunction("singleNode");
+
+    dim_t batches = batchSize_ * numHeads_;
+    auto *Q = mod->createPlaceholder(ElemKind::FloatTy,
+                                     {batches, seqLen_, headDim_}, "Q", false);
+    auto *K = mod->createPlaceholder(ElemKind::FloatTy,
+                                     {batches, seqLen_, headDim_}, "K", false);
+    auto *V = mod->createPlaceholder(ElemKind::FloatTy,
+                                     {batches, seqLen_, headDim_}, "V", false);
+    auto *S = createAttention(fn, Q, K, V);
+
+    for (dim_t i = 0; i < asyncLaunchSize_; i++) {
+      auto *bindings = contexts_[i]->getPlaceholderBindings();
+      for (auto *PH : {Q, K, V}) {
+        bindings->allocate(PH)->getHandle<float>().randomize(-1.0f, 1.0f,
+                                                             mod->getPRNG());
+      }
+      bindings->allocate(S->getPlaceholder());
+    }
+
+    // Compile a copy of the function on its own to learn how much activation
+    // memory it needs.
+    std::unique_ptr<Backend> backend(createBackend(backendStr_));
+    std::unique_ptr<Module> memMod(mod->clone());
+    Function *memFn = memMod->getFunction("singleNode");
+    CompilationContext memCtx;
+    EXIT_ON_ERR(optimizeFunction(memFn, *backend, memCtx));
+    auto compiled = EXIT_ON_ERR(backend->compile(memFn));
+    activationsSize_ = compiled->getRuntimeBundle().getActivationsSize();
+
+    CompilationContext ctx;
+    EXIT_ON_ERR(hostManager_->addNetwork(std::move(mod), ctx));
+  }
+
+  void run() override {
+    std::vector<std::unique_ptr<ExecutionContext>> localContexts(
+        asyncLaunchSize_);
+    std::vector<std::promise<void>> promises(asyncLaunchSize_);
+    std::vector<std::future<void>> futures;
+
+    // Launch a number of independent requests.
+    int i = 0;
+    for (auto &promise : promises) {
+      futures.push_back(promise.get_future());
+      hostManager_->runNetwork(
+          "singleNode", std::move(contexts_[i]),
+          [&localContexts, &promise,
+           i](runtime::RunIdentifierTy, Error err,
+              std::unique_ptr<ExecutionContext> contextPtr) {
+            EXIT_ON_ERR(std::move(err));
+            localContexts[i] = std::move(contextPtr);
+            promise.set_value();
+          });
+      i++;
+    }
+    for (auto &fut : futures) {
+      fut.wait();
+    }
+    for (dim_t j = 0; j < asyncLaunchSize_; j++) {
+      contexts_[j] = std::move(localContexts[j]);
+    }
+  }
+
+  void teardown() override {}
+
+  /// \returns the activation memory of the compiled function in bytes.
+  size_t activationsSize() const { return activationsSize_; }
+
+  double gflops() const {
+    return 4.0 * batchSize_ * numHeads_ * seqLen_ * seqLen_ * headDim_ / 1e9;
+  }
+};
+
+int main(int argc, char *argv[]) {
+  printf("Attention Microbenchmark\n");
+  printf("Usage: AttentionBench batchSize(Int) numHeads(Int) seqLen(Int) "
+         "headDim(Int) numReps(Int) numAsyncLaunches(Int) "
+         "backendStr(String)\n");
+  printf("Standard Glow command-line options may be passed via the GLOW_OPTS "
+         "environment variable\n");
+  llvm::cl::ParseEnvironmentOptions(argv[0], "GLOW_OPTS", "");
+
+  assert(argc == 8);
+  size_t batchSize = atoi(argv[1]);
+  size_t numHeads = atoi(argv[2]);
+  size_t seqLen = atoi(argv[3]);
+  size_t headDim = atoi(argv[4]);
+  size_t numReps = atoi(argv[5]);
+  size_t numAsyncLaunches = atoi(argv[6]);
+  const char *backendStr = argv[7];
+  assert(numReps > 0);
+
+  AttentionBench b(batchSize, numHeads, seqLen, headDim, numAsyncLaunches,
+                   backendStr);
+
+  auto times = bench(&b, numReps);
+  printf("_,benchName,_,batchSize,numHeads,seqLen,headDim,numReps,"
+         "numAsyncLaunches,backendStr,activationsBytes,runtime,"
+         "gflopsPerSec\n");
+  for (auto t : times) {
+    printf("BenchResult,AttentionBench,SW,%zu,%zu,%zu,%zu,%zu,%zu,%s,%zu,%f,"
+           "%f\n",
+           batchSize, numHeads, seqLen, headDim, numReps, numAsyncLaunches,
+           backendStr, b.activationsSize(), t / numAsyncLaunches,
+           b.gflops() * numAsyncLaunches / t);
+  }
+  double min = *(std::min_element(times.begin(), times.end()));
+  size_t midElt = times.size() / 2;
+  std::nth_element(times.begin(), times.begin() + midElt, times.end());
+  double median = times[midElt];
+  double median_runtime = median / ((double)numAsyncLaunches);
+  double min_runtime = min / ((double)numAsyncLaunches);
+  printf("_,benchName,_,batchSize,numHeads,seqLen,headDim,numReps,"
+         "numAsyncLaunches,backendStr,activationsBytes,medianRuntime,"
+         "minRuntime,medianGflopsPerSec,maxGflopsPerSec\n");
+  printf("BenchSummary,AttentionBench,SW,%zu,%zu,%zu,%zu,%zu,%zu,%s,%zu,%f,%f,"
+         "%f,%f\n",
+         batchSize, numHeads, seqLen, headDim, numReps, numAsyncLaunches,
+         backendStr, b.activationsSize(), median_runtime, min_runtime,
+         b.gflops() / median_runtime, b.gflops() / min_runtime);
+}
@@ -18,19 +18,25 @@
 
 #include "Bench.h"
 
+#include "glow/Graph/Nodes.h"
+
 using namespace glow;
 
 extern "C" {
 // Forward declare functions from libjit.
 extern void libjit_conv2d_f(float *outW, const float *inW, const float *filterW,
-                            const float *biasW, const size_t *outWdims,
-                            const size_t *inWdims, const size_t *filterWdims,
-                            const size_t *biasWdims, const size_t *kernelSizes,
-                            const size_t *strides, const size_t *pads,
-                            size_t group, unsigned depthUnroll);
+                            const float *biasW, const dim_t *outWdims,
+                            const dim_t *inWdims, const dim_t *filterWdims,
+                            const dim_t *biasWdims, const dim_t *kernelSizes,
+                            const dim_t *strides, const dim_t *pads,
+                            dim_t group, unsigned depthUnroll,
+                            const dim_t *dilation, int32_t fusedActivation);
 }
 
-/// Benchmark a convolution with specified parameters on square inputs.
+/// Benchmark a convolution with specified parameters on square inputs,
+/// followed by a ReLU. If the ReLU is fused it is applied by the convolution
+/// kernel to each output pixel while it is in cache, otherwise by a separate
+/// pass over the output.
 class ConvBench : public Benchmark {
   /// Matrices
   std::vector<float> outW;
@@ -40,25 +46,27 @@ class ConvBench : public Benchmark {
 
   /// Dimensions
   // [batch, h, w, channels]
-  size_t outWdims[4];
-  size_t inWdims[4];
+  dim_t outWdims[4];
+  dim_t inWdims[4];
   // [outputChannels, h, w, inputChannels]
-  size_t filterWdims[4];
+  dim_t filterWdims[4];
 
   /// Parameters
-  size_t kernelSizes[2];
-  size_t strides[2];
-  size_t pads[2];
+  dim_t kernelSizes[2];
+  dim_t strides[2];
+  dim_t pads[2];
+  dim_t dilation[2];
   size_t group;
   unsigned depthUnroll;
+  bool fuseActivation;
 
 public:
   ConvBench(size_t inputBatch, size_t inputEdgeSize, size_t inputChannels,
             size_t filterMultiplier, size_t kernelSize, size_t stride,
-            size_t pad, size_t group)
-      : kernelSizes{kernelSize, kernelSize}, strides{stride, stride}, pads{pad,
-                                                                           pad},
-        group(group) {
+            size_t pad, size_t group, bool fuseActivation)
+      : kernelSizes{kernelSize, kernelSize}, strides{stride, stride},
+        pads{pad, pad}, dilation{1, 1}, group(group),
+        fuseActivation(fuseActivation) {
 
     inWdims[0] = inputBatch;
     inWdims[1] = inputEdgeSize;
@@ -100,13 +108,20 @@ public:
     // biasWDims isn't used in libjit_conv2d_f, so we're passing NULL.
     libjit_conv2d_f(outW.data(), inW.data(), filterW.data(), biasW.data(),
                     outWdims, inWdims, filterWdims, NULL, kernelSizes, strides,
-                    pads, group, depthUnroll);
+                    pads, group, depthUnroll, dilation,
+                    fuseActivation ? FusedActivation::RELU
+                                   : FusedActivation::NONE);
+    if (!fuseActivation) {
+      for (auto &x : outW) {
+        x = std::max(x, 0.0f);
+      }
+    }
   }
 
   virtual void teardown() override {}
 
 private:
-  size_t mapMult(size_t *vec, int size) {
+  size_t mapMult(dim_t *vec, int size) {
     size_t result = 1;
     for (int i = 0; i < size; i++) {
       result *= vec[i];
@@ -123,10 +138,12 @@ private:
   }
 };
 
-int main() {
+int main(int argc, char *argv[]) {
+  printf("Usage: ConvBench [fuseActivation(0|1)]\n");
+  bool fuseActivation = argc < 2 || atoi(argv[1]) != 0;
   constexpr int reps = 10;
   printf("inputBatch, inputEdgeSize, inputChannels, filterMultiplier, "
-         "kernelSize, stride, pad, group, bestInSeconds\n");
+         "kernelSize, stride, pad, group, fuseActivation, bestInSeconds\n");
 
   for (size_t inputBatch : {1, 3}) {
     for (size_t inputEdgeSize : {7, 56, 224}) {
@@ -141,12 +158,14 @@ int main() {
                 if (inputChannels % group != 0)
                   continue;
                 ConvBench b(inputBatch, inputEdgeSize, inputChannels,
-                            filterMultiplier, kernelSize, stride, pad, group);
+                            filterMultiplier, kernelSize, stride, pad, group,
+                            fuseActivation);
                 auto times = bench(&b, reps);
                 double time = *(std::min_element(times.begin(), times.end()));
-                printf("%zu, %zu, %zu, %zu, %zu, %zu, %zu, %zu, %f\n",
+                printf("%zu, %zu, %zu, %zu, %zu, %zu, %zu, %zu, %d, %f\n",
                        inputBatch, inputEdgeSize, inputChannels,
-                       filterMultiplier, kernelSize, stride, pad, group, time);
+                       filterMultiplier, kernelSize, stride, pad, group,
+                       int(fuseActivation), time);
               } // group
             }   // stride
           }     // kernelSize
@@ -115,6 +115,13 @@ llvm::cl::opt<bool>
               llvm::cl::desc("Add fp AdaptiveAvgPool node to the graph."),
               llvm::cl::init(false), llvm::cl::cat(category));
 
+llvm::cl::opt<unsigned> numClasses(
+    "numClasses",
+    llvm::cl::desc("Add the final FullyConnected classifier with N outputs "
+                   "to the graph, 0 to leave it out. If fpEverywhere then it "
+                   "is fp, otherwise it is quantized."),
+    llvm::cl::init(0), llvm::cl::value_desc("N"), llvm::cl::cat(category));
+
 enum class Block {
   Bottleneck,
   BasicBlock,
@@ -220,6 +227,35 @@ private:
     return createConv(input, outPlanes, /*kernel*/ 1, stride);
   }
 
+  NodeValue createFC(NodeValue input, unsigned_t outFeatures) {
+    Module *mod = F_->getParent();
+    dim_t inFeatures = input.dims()[1];
+    if (fpEverywhere) {
+      auto *weights = mod->createConstant(
+          ElemKind::FloatTy, {inFeatures, outFeatures}, "fc_weights");
+      weights->getPayloadMutable().init(Tensor::InitKind::Xavier, inFeatures,
+                                        mod->getPRNG());
+      auto *bias =
+          mod->createConstant(ElemKind::FloatTy, {outFeatures}, "fc_bias");
+      bias->getPayloadMutable().zero();
+      return F_->createFullyConnected("fc", input, weights, bias)->getResult();
+    }
+
+    auto *weights = mod->createConstant(
+        ElemKind::Int8QTy, {inFeatures, outFeatures}, 1.0, 0, "fc_weights");
+    weights->getPayloadMutable().init(Tensor::InitKind::Broadcast,
+                                      float(nextFilterValue_++ % 8),
+                                      mod->getPRNG());
+    auto *bias =
+        mod->createConstant(ElemKind::Int32QTy, {outFeatures},
+                            input.getType()->getScale(), 0, "fc_bias");
+    bias->getPayloadMutable().zero();
+    auto *outTy = mod->uniqueType(ElemKind::Int8QTy,
+                                  {input.dims()[0], outFeatures}, 1.0, 0);
+    return F_->createFullyConnected("fc", input, weights, bias, outTy)
+        ->getResult();
+  }
+
   NodeValue createRelu(NodeValue input) {
     return F_->createRELU("relu", input)->getResult();
   }
@@ -344,6 +380,10 @@ public:
       next = makeAvgPool(next);
     }
     next = makeAvgPool(next);
+    if (numClasses) {
+      next = F_->createFlatten("flatten", next, 1)->getResult();
+      next = createFC(next, numClasses);
+    }
     if (!fpEverywhere) {
       next =
           F_->createDequantize("dequant", next, ElemKind::FloatTy)->getResult();
@@ -351,7 +391,9 @@ public:
     if (avgPoolFP) {
       next = makeAvgPool(next);
     }
-    next = F_->createTranspose("NHWC2NCHW", next, NHWC2NCHW);
+    if (!numClasses) {
+      next = F_->createTranspose("NHWC2NCHW", next, NHWC2NCHW);
+    }
     Placeholder *output = F_->createSave("save", next)->getPlaceholder();
     F_ = nullptr;
     return output;
@@ -375,7 +417,12 @@ ResNetBuilder resnext101_32x4d() {
 // }
 
 /*
- * This class implements a performance proxy for ResNet-like models
+ * This class implements a performance proxy for ResNet-like models.
+ *
+ * On the CPU backend the activations following convolutions and the bias and
+ * activation of FullyConnected layers are fused into the kernels that compute
+ * them. Pass -cpu-fuse-conv-activations=0 and -cpu-fuse-fc=0 to measure the
+ * unfused graph; -numClasses adds the FullyConnected classifier.
  */
 class ResNetBench : public Benchmark {
 private:
@@ -530,6 +577,8 @@ int main(int argc, char *argv[]) {
 
   CHECK(!avgPool || !avgPoolFP) << "avgPool and avgPoolFP can't be true or "
                                    "pooling will occur two times";
+  CHECK(!numClasses || !avgPoolFP)
+      << "avgPoolFP can't follow the classifier";
 
   std::vector<ShapeNCHW> shapes =
       generateShapes(batchSize, baseSize, numBins, stepSize);
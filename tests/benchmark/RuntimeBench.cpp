@@ -537,6 +537,105 @@ protected:
       deviceManagerFunctions_;
 };
 
+/// Benchmark of a chain of layers split by the Partitioner into one partition
+/// per device, run on a batch of numMicroBatches_ micro-batches with
+/// HostManager::runNetworkMicroBatched. The argument of the benchmark is the
+/// maximum number of micro-batches in flight: 1 runs them one after the other
+/// while 0 streams them through the partitions, which then work concurrently.
+template <typename BackendTy>
+class PipelineBenchmark : public benchmark::Fixture {
+public:
+  void SetUp(benchmark::State &state) override {
+    BackendTy backend;
+    std::vector<std::unique_ptr<DeviceConfig>> configs;
+    for (unsigned i = 0; i < numDevices_; ++i) {
+      auto config = glow::make_unique<DeviceConfig>(backend.getBackendName());
+      config->deviceID = i;
+      configs.push_back(std::move(config));
+    }
+    hostManager_ = glow::make_unique<HostManager>(std::move(configs));
+
+    // Each partition runs layersPerDevice_ FC + ReLU layers.
+    auto mod = glow::make_unique<Module>();
+    Function *F = mod->createFunction("pipeline");
+    auto *input = mod->createPlaceholder(
+        ElemKind::FloatTy, {microBatchSize_, width_}, "input", false);
+    PartitionConfig partitionConfig;
+    partitionConfig.funcName = "pipeline";
+    partitionConfig.numOfPartitions = numDevices_;
+    for (unsigned i = 0; i < numDevices_; ++i) {
+      partitionConfig.backendNames.push_back(backend.getBackendName());
+      partitionConfig.partitionNames.push_back("stage" + std::to_string(i));
+      partitionConfig.logicalIDs.push_back({i});
+    }
+    NodeValue layer = input;
+    for (unsigned i = 0; i < numDevices_ * layersPerDevice_; ++i) {
+      auto *weights =
+          mod->createConstant(ElemKind::FloatTy, {width_, width_}, "weights");
+      auto *bias = mod->createConstant(ElemKind::FloatTy, {width_}, "bias");
+      weights->getPayloadMutable().getHandle<>().randomize(-0.1, 0.1,
+                                                             mod->getPRNG());
+      bias->getPayloadMutable().getHandle<>().clear(0);
+      std::string fcName = "fc" + std::to_string(i);
+      std::string reluName = "relu" + std::to_string(i);
+      auto *fc = F->createFullyConnected(fcName, layer, weights, bias);
+      layer = F->createRELU(reluName, fc);
+      partitionConfig.nodeToPartition[fcName] = i / layersPerDevice_;
+      partitionConfig.nodeToPartition[reluName] = i / layersPerDevice_;
+    }
+    auto *save = F->createSave("save", layer);
+    partitionConfig.nodeToPartition["save"] = numDevices_ - 1;
+
+    // The whole batch is bound, the network is compiled for a micro-batch.
+    dim_t batchSize = numMicroBatches_ * microBatchSize_;
+    bindings_.insert(input, Tensor(ElemKind::FloatTy, {batchSize, width_}));
+    bindings_.get(input)->getHandle<>().randomize(-1.0, 1.0, mod->getPRNG());
+    bindings_.insert(save->getPlaceholder(),
+                     Tensor(ElemKind::FloatTy, {batchSize, width_}));
+
+    CompilationContext cctx;
+    cctx.partitionConfig = &partitionConfig;
+    if (ERR_TO_BOOL(hostManager_->addNetwork(std::move(mod), cctx))) {
+      state.SkipWithError("Unable to set up host manager - failed to add "
+                          "module!");
+    }
+  }
+
+  void TearDown(benchmark::State &state) override {
+    bindings_.clear();
+    if (ERR_TO_BOOL(hostManager_->clearHost())) {
+      state.SkipWithError(
+          "Unable to tear down host manager - failed to clear host!");
+    }
+    hostManager_.reset();
+  }
+
+  void runBenchmark(benchmark::State &state) {
+    for (auto _ : state) {
+      ERR_TO_BOOL(hostManager_->runNetworkMicroBatched(
+          "pipeline", bindings_, /* maxInFlight */ state.range(0)));
+    }
+    state.SetItemsProcessed(state.iterations() * numMicroBatches_ *
+                            microBatchSize_);
+  }
+
+protected:
+  /// The HostManager running the pipeline.
+  std::unique_ptr<HostManager> hostManager_;
+  /// The whole batch of inputs and outputs.
+  PlaceholderBindings bindings_;
+  /// The number of devices, and so of partitions.
+  static constexpr unsigned numDevices_{4};
+  /// The number of layers run by each partition.
+  static constexpr unsigned layersPerDevice_{4};
+  /// The number of micro-batches in a batch.
+  static constexpr dim_t numMicroBatches_{16};
+  /// The size of a micro-batch, i.e. the batch the network is compiled for.
+  static constexpr dim_t microBatchSize_{8};
+  /// The width of the layers.
+  static constexpr dim_t width_{256};
+};
+
 //===--------------------------------------------------------------------===//
 //              Benchmark Module and DAG Creator Functions                  //
 //===--------------------------------------------------------------------===//
@@ -614,6 +713,17 @@ DECLARE_RUNTIME_BENCHMARK(SingleNode, createSingleNodeModule,
 // backend.
 INSTANTIATE_RUNTIME_BENCHMARK(SingleNode, CPUBackend);
 
+// Compare running the micro-batches of a batch one after the other against
+// streaming them through a network partitioned across four CPU devices.
+BENCHMARK_TEMPLATE_DEFINE_F(PipelineBenchmark, PipelineCPUBackend, CPUBackend)
+(benchmark::State &state) { runBenchmark(state); }
+BENCHMARK_REGISTER_F(PipelineBenchmark, PipelineCPUBackend)
+    ->ArgName("maxInFlight")
+    ->Arg(1)
+    ->Arg(0)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
 //===--------------------------------------------------------------------===//
 //                           Benchmark Main                                 //
 //===--------------------------------------------------------------------===//
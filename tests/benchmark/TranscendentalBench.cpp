@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) Glow Contributors. See CONTRIBUTORS file.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <random>
+
+#include "Bench.h"
+
+#include "glow/ExecutionEngine/ExecutionEngine.h"
+#include "glow/Optimizer/GraphOptimizer/GraphOptimizer.h"
+
+using namespace glow;
+
+/*
+ * This class implements a microbenchmark of an element-wise transcendental
+ * function (Exp, Log, Tanh, Sigmoid, Gelu or Swish) applied to a float tensor
+ * of n elements. The function is compiled either with the exact kernels or,
+ * when fast is set, with the "fast-transcendentals" backend specific option,
+ * which selects the polynomial approximations on the LLVM based backends.
+ */
+class TranscendentalBench : public Benchmark {
+  dim_t n_;
+  std::string op_;
+  bool fast_;
+  std::unique_ptr<runtime::HostManager> hostManager_;
+  std::vector<std::unique_ptr<ExecutionContext>> contexts_;
+  dim_t asyncLaunchSize_;
+  const char *backendStr_;
+
+public:
+  TranscendentalBench(dim_t n_, const char *op_, bool fast_,
+                      dim_t asyncLaunchSize_, const char *backendStr_)
+      : n_(n_), op_(op_), fast_(fast_), asyncLaunchSize_(asyncLaunchSize_),
+        backendStr_(backendStr_) {}
+
+  /// \returns the node computing the benchmarked function of \p input in
+  /// \p fn.
+  Node *createOp(Function *fn, Placeholder *input) {
+    if (op_ == "exp") {
+      return fn->createExp("exp", input);
+    } else if (op_ == "log") {
+      return fn->createLog("log", input);
+    } else if (op_ == "tanh") {
+      return fn->createTanh("tanh", input);
+    } else if (op_ == "sigmoid") {
+      return fn->createSigmoid("sigmoid", input);
+    } else if (op_ == "gelu") {
+      return fn->createGELU("gelu", input);
+    } else if (op_ == "swish") {
+      return fn->createSwish("swish", input);
+    }
+    llvm_unreachable("Unknown op");
+  }
+
+  void setup() override {
+    for (dim_t i = 0; i < asyncLaunchSize_; i++) {
+      std::unique_ptr<ExecutionContext> context(new ExecutionContext);
+      contexts_.push_back(std::move(context));
+    }
+
+    std::vector<std::unique_ptr<runtime::DeviceConfig>> configs;
+    auto config = glow::make_unique<runtime::DeviceConfig>(backendStr_);
+    configs.push_back(std::move(config));
+    hostManager_ = glow::make_unique<runtime::HostManager>(std::move(configs));
+
+    std::unique_ptr<Module> mod(new Module);
+    auto *fn = mod->createFunction("singleNode");
+
+    auto *input =
+        mod->createPlaceholder(ElemKind::FloatTy, {n_}, "input", false);
+    auto *S = fn->createSave("save", createOp(fn, input));
+
+    // Log is only benchmarked on positive inputs.
+    float low = op_ == "log" ? 0.01f : -8.0f;
+    for (dim_t i = 0; i < asyncLaunchSize_; i++) {
+      auto *bindings = contexts_[i]->getPlaceholderBindings();
+      bindings->allocate(input)->getHandle<float>().randomize(low, 8.0f,
+                                                              mod->getPRNG());
+      bindings->allocate(S->getPlaceholder());
+    }
+
+    CompilationContext ctx;
+    ctx.backendOpts.backendSpecificOpts["fast-transcendentals"] =
+        fast_ ? "true" : "false";
+    EXIT_ON_ERR(hostManager_->addNetwork(std::move(mod), ctx));
+  }
+
+  void run() override {
+    std::vector<std::unique_ptr<ExecutionContext>> localContexts(
+        asyncLaunchSize_);
+    std::vector<std::promise<void>> promises(asyncLaunchSize_);
+    std::vector<std::future<void>> futures;
+
+    // Launch a number of independent requests.
+    int i = 0;
+    for (auto &promise : promises) {
+      futures.push_back(promise.get_future());
+      hostManager_->runNetwork(
+          "singleNode", std::move(contexts_[i]),
+          [&localContexts, &promise,
+           i](runtime::RunIdentifierTy, Error err,
+              std::unique_ptr<ExecutionContext> contextPtr) {
+            EXIT_ON_ERR(std::move(err));
+            localContexts[i] = std::move(contextPtr);
+            promise.set_value();
+          });
+      i++;
+    }
+    for (auto &fut : futures) {
+      fut.wait();
+    }
+    for (dim_t j = 0; j < asyncLaunchSize_; j++) {
+      contexts_[j] = std::move(localContexts[j]);
+    }
+  }
+
+  void teardown() override {}
+
+  double gelems() const { return n_ / 1e9; }
+};
+
+int main(int argc, char *argv[]) {
+  printf("Transcendental Microbenchmark\n");
+  printf("Usage: TranscendentalBench n(Int) "
+         "op(\"exp\"|\"log\"|\"tanh\"|\"sigmoid\"|\"gelu\"|\"swish\") "
+         "fast(0|1) numReps(Int) numAsyncLaunches(Int) backendStr(String)\n");
+  printf("Standard Glow command-line options may be passed via the GLOW_OPTS "
+         "environment variable\n");
+  llvm::cl::ParseEnvironmentOptions(argv[0], "GLOW_OPTS", "");
+
+  assert(argc == 7);
+  size_t n = atoi(argv[1]);
+  const char *op = argv[2];
+  bool fast = atoi(argv[3]) != 0;
+  size_t numReps = atoi(argv[4]);
+  size_t numAsyncLaunches = atoi(argv[5]);
+  const char *backendStr = argv[6];
+  assert(numReps > 0);
+
+  TranscendentalBench b(n, op, fast, numAsyncLaunches, backendStr);
+
+  auto times = bench(&b, numReps);
+  printf("_,benchName,_,n,op,fast,numReps,numAsyncLaunches,backendStr,"
+         "runtime,gelemsPerSec\n");
+  for (auto t : times) {
+    printf("BenchResult,TranscendentalBench,SW,%zu,%s,%d,%zu,%zu,%s,%f,%f\n",
+           n, op, fast, numReps, numAsyncLaunches, backendStr,
+           t / numAsyncLaunches, b.gelems() * numAsyncLaunches / t);
+  }
+  double min = *(std::min_element(times.begin(), times.end()));
+  size_t midElt = times.size() / 2;
+  std::nth_element(times.begin(), times.begin() + midElt, times.end());
+  double median = times[midElt];
+  double median_runtime = median / ((double)numAsyncLaunches);
+  double min_runtime = min / ((double)numAsyncLaunches);
+  printf("_,benchName,_,n,op,fast,numReps,numAsyncLaunches,backendStr,"
+         "medianRuntime,minRuntime,medianGelemsPerSec,maxGelemsPerSec\n");
+  printf("BenchSummary,TranscendentalBench,SW,%zu,%s,%d,%zu,%zu,%s,%f,%f,%f,"
+         "%f\n",
+         n, op, fast, numReps, numAsyncLaunches, backendStr, median_runtime,
+         min_runtime, b.gelems() / median_runtime, b.gelems() / min_runtime);
+}
@@ -29,7 +29,9 @@ using namespace glow;
 /*
  * This class implements a transpose microbenchmark. There are multiple
  * layers of transpose, followed by an Add with the tensor from the previous
- * layer.
+ * layer. The tensors have the shape [batchSize, n, ..., n] and are transposed
+ * by the given permutation, e.g. "021" for batched matrices, "0231" and "0312"
+ * for NCHW <-> NHWC or "0213" for attention heads.
  *
  * Microbenchmarks are generally useful for understanding performance
  * through targeted experiementation and are not representative of
@@ -46,17 +48,27 @@ class TransposeBench : public Benchmark {
   const char *backendStr_;
   ElemKind dtype_;
   dim_t elementSize_;
+  std::vector<unsigned_t> shuffle_;
   const char *devId_;
 
 public:
   TransposeBench(dim_t batchSize_, dim_t n_, dim_t numLayers_,
                  dim_t asyncLaunchSize_, dim_t numCores_,
                  const char *backendStr_, const char *dtypeStr_,
+                 const char *shuffleStr_ = "021",
                  const char *devId_ = nullptr)
       : batchSize_(batchSize_), n_(n_), numLayers_(numLayers_),
         asyncLaunchSize_(asyncLaunchSize_), numCores_(numCores_),
         backendStr_(backendStr_), devId_(devId_) {
 
+    // The batch dimension has to stay in place so that every layer has the
+    // same shape.
+    for (const char *c = shuffleStr_; *c; c++) {
+      shuffle_.push_back(*c - '0');
+    }
+    assert(shuffle_.size() >= 2 && shuffle_[0] == 0 &&
+           "Invalid transpose permutation");
+
     dtype_ = ElemKind::Float16Ty;
     elementSize_ = 2;
     if (std::string(dtypeStr_) == "Float16") {
@@ -95,9 +107,10 @@ public:
     for (dim_t core = 0; core < numCores_; core++) {
       if (batchSizePerCore[core] == 0)
         continue;
-      input[core] =
-          mod->createPlaceholder(dtype_, {batchSizePerCore[core], n_, n_},
-                                 "A" + std::to_string(core), false);
+      std::vector<dim_t> dims(shuffle_.size(), n_);
+      dims[0] = batchSizePerCore[core];
+      input[core] = mod->createPlaceholder(dtype_, dims,
+                                           "A" + std::to_string(core), false);
     }
 
     // Create multiple chains of Transpose and Add nodes
@@ -125,7 +138,7 @@ public:
       for (dim_t layer = 0; layer < numLayers_; layer++) {
         auto *xp = fn->createTranspose("transpose_" + std::to_string(layer) +
                                            "_" + std::to_string(core),
-                                       cur, {0, 2, 1});
+                                       cur, shuffle_);
         auto *ad = fn->createAdd("add_" + std::to_string(layer) + "_" +
                                      std::to_string(core),
                                  cur, xp);
@@ -178,7 +191,11 @@ public:
 
   // Each layer reads the tensor thrice, and writes the tensor twice
   double gbytes() const {
-    return (5.0 * numLayers_ * batchSize_ * n_ * n_ * elementSize_) / 1e9;
+    double size = batchSize_ * elementSize_;
+    for (size_t i = 1; i < shuffle_.size(); i++) {
+      size *= n_;
+    }
+    return (5.0 * numLayers_ * size) / 1e9;
   }
 };
 
@@ -186,11 +203,13 @@ int main(int argc, char *argv[]) {
   printf("Transpose Microbenchmark\n");
   printf("Usage: TransposeBench batchSize(Int) n(Int) numLayers(Int) "
          "numReps(Int) numAsyncLaunches(Int) numTransposeChains(Int) "
-         "backendStr(String) dtypeStr(\"Float16\"|\"Float32\") dev_id(Int)\n");
+         "backendStr(String) dtypeStr(\"Float16\"|\"Float32\") "
+         "shuffle(String, e.g. \"021\"|\"0231\"|\"0312\"|\"0213\") "
+         "dev_id(Int)\n");
   printf("Standard Glow command-line options may be passed via the GLOW_OPTS "
          "environment variable\n");
   llvm::cl::ParseEnvironmentOptions(argv[0], "GLOW_OPTS", "");
-  assert(argc == 9 || argc == 10);
+  assert(argc >= 9 && argc <= 11);
   size_t batchSize = atoi(argv[1]);
   size_t n = atoi(argv[2]);
   size_t numLayers = atoi(argv[3]);
@@ -199,27 +218,29 @@ int main(int argc, char *argv[]) {
   size_t numCores = atoi(argv[6]);
   const char *backendStr = argv[7];
   const char *dtypeStr = argv[8];
+  const char *shuffleStr = argc > 9 ? argv[9] : "021";
   char *dev_id = nullptr;
 
-  if (argc > 9) {
-    dev_id = argv[9];
+  if (argc > 10) {
+    dev_id = argv[10];
     printf("Setting backend device: \"%s\"\n", dev_id);
   }
 
   assert(numReps > 0);
 
   TransposeBench b(batchSize, n, numLayers, numAsyncLaunches, numCores,
-                   backendStr, dtypeStr, dev_id);
+                   backendStr, dtypeStr, shuffleStr, dev_id);
 
   auto times = bench(&b, numReps);
   printf("_,benchName,_,batchSize,n,numLayers,numReps,numAsyncLaunches,"
-         "numTransposeChains,backendStr,dtypeStr,runtime,gbytesPerSec\n");
+         "numTransposeChains,backendStr,dtypeStr,shuffle,runtime,"
+         "gbytesPerSec\n");
   for (auto t : times) {
-    printf(
-        "BenchResult,TransposeBench,SW,%zu,%zu,%zu,%zu,%zu,%zu,%s,%s,%f,%f\n",
-        batchSize, n, numLayers, numReps, numAsyncLaunches, numCores,
-        backendStr, dtypeStr, t / numAsyncLaunches,
-        b.gbytes() * numAsyncLaunches / t);
+    printf("BenchResult,TransposeBench,SW,%zu,%zu,%zu,%zu,%zu,%zu,%s,%s,%s,%f,"
+           "%f\n",
+           batchSize, n, numLayers, numReps, numAsyncLaunches, numCores,
+           backendStr, dtypeStr, shuffleStr, t / numAsyncLaunches,
+           b.gbytes() * numAsyncLaunches / t);
   }
   double min = *(std::min_element(times.begin(), times.end()));
   size_t midElt = times.size() / 2;
@@ -228,12 +249,11 @@ int main(int argc, char *argv[]) {
   double median_runtime = median / ((double)numAsyncLaunches);
   double min_runtime = min / ((double)numAsyncLaunches);
   printf("_,benchName,_,batchSize,n,numLayers,numReps,numAsyncLaunches,"
-         "numTransposeChains,backendStr,dtypeStr,medianRuntime,minRuntime,"
-         "medianGbytesPerSec,maxGbytesPerSec\n");
-  printf(
-      "BenchSummary,TransposeBench,SW,%zu,%zu,%zu,%zu,%zu,%zu,%s,%s,%f,%f,%f,%"
-      "f\n",
-      batchSize, n, numLayers, numReps, numAsyncLaunches, numCores, backendStr,
-      dtypeStr, median_runtime, min_runtime, b.gbytes() / median_runtime,
-      b.gbytes() / min_runtime);
+         "numTransposeChains,backendStr,dtypeStr,shuffle,medianRuntime,"
+         "minRuntime,medianGbytesPerSec,maxGbytesPerSec\n");
+  printf("BenchSummary,TransposeBench,SW,%zu,%zu,%zu,%zu,%zu,%zu,%s,%s,%s,%f,"
+         "%f,%f,%f\n",
+         batchSize, n, numLayers, numReps, numAsyncLaunches, numCores,
+         backendStr, dtypeStr, shuffleStr, median_runtime, min_runtime,
+         b.gbytes() / median_runtime, b.gbytes() / min_runtime);
 }
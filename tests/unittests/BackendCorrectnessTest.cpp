@@ -535,6 +535,357 @@ TEST_P(BackendCorrectnessTest, maxSplatTest) {
   EXPECT_TRUE(out1.isEqual(out2));
 }
 
+/// Compares a float convolution followed by \p activation on \p backendName
+/// against the Interpreter, which never fuses activations. On the CPU an output
+/// depth of \p depth = 64 exercises the Winograd kernel; smaller depths use
+/// im2col + GEMM.
+static void convActivationTest(Kinded::Kind activation, dim_t depth,
+                               llvm::StringRef backendName) {
+  PseudoRNG PRNG;
+  Tensor inputs(ElemKind::FloatTy, {2, 8, 8, 16});
+  Tensor kernel(ElemKind::FloatTy, {depth, 3, 3, 16});
+  Tensor bias(ElemKind::FloatTy, {depth});
+  inputs.getHandle().randomize(-1.0, 1.0, PRNG);
+  kernel.getHandle().randomize(-0.5, 0.5, PRNG);
+  bias.getHandle().randomize(-0.5, 0.5, PRNG);
+  Tensor out1(ElemKind::FloatTy, {2, 8, 8, depth});
+  Tensor out2(ElemKind::FloatTy, {2, 8, 8, depth});
+
+  inferConvActivationNet(&inputs, &kernel, &bias, &out1, activation,
+                         backendName);
+  bool fused = inferConvActivationNet(&inputs, &kernel, &bias, &out2,
+                                      activation, "Interpreter");
+  EXPECT_FALSE(fused);
+
+  EXPECT_TRUE(out1.isEqual(out2, 0.0005));
+}
+
+/// Compares a float convolution of \p inputDims with a \p depth x \p kernel x
+/// \p kernel filter, followed by a Relu, on \p backendName against the
+/// Interpreter.
+static void convAlgorithmTest(llvm::ArrayRef<dim_t> inputDims, dim_t depth,
+                              unsigned_t kernel, unsigned_t stride,
+                              unsigned_t pad, llvm::StringRef backendName) {
+  PseudoRNG PRNG;
+  dim_t channels = inputDims[3];
+  Tensor inputs(ElemKind::FloatTy, inputDims);
+  Tensor filter(ElemKind::FloatTy, {depth, kernel, kernel, channels});
+  Tensor bias(ElemKind::FloatTy, {depth});
+  inputs.getHandle().randomize(-1.0, 1.0, PRNG);
+  filter.getHandle().randomize(-0.5, 0.5, PRNG);
+  bias.getHandle().randomize(-0.5, 0.5, PRNG);
+  auto outSz = calculateConvPoolOutputDims(
+      inputDims[1], inputDims[2], {kernel, kernel}, {stride, stride},
+      {pad, pad, pad, pad});
+  Tensor out1(ElemKind::FloatTy,
+              {inputDims[0], outSz.first, outSz.second, depth});
+  Tensor out2(ElemKind::FloatTy,
+              {inputDims[0], outSz.first, outSz.second, depth});
+
+  inferConvActivationNet(&inputs, &filter, &bias, &out1,
+                         Kinded::Kind::ReluNodeKind, backendName, stride, pad);
+  inferConvActivationNet(&inputs, &filter, &bias, &out2,
+                         Kinded::Kind::ReluNodeKind, "Interpreter", stride,
+                         pad);
+
+  EXPECT_TRUE(out1.isEqual(out2, 0.0005));
+}
+
+/// Covers the shapes for which the CPU backend picks each of its convolution
+/// algorithms: Winograd (including odd output sizes), the DKKC8 direct
+/// convolution, and im2col + GEMM for pointwise and strided convolutions.
+TEST_P(BackendCorrectnessTest, convAlgorithmsTest) {
+  CHECK_IF_ENABLED();
+  convAlgorithmTest({2, 9, 7, 16}, 24, 3, 1, 1, backendName_);
+  convAlgorithmTest({1, 6, 6, 8}, 64, 3, 1, 0, backendName_);
+  convAlgorithmTest({2, 5, 6, 24}, 40, 1, 1, 0, backendName_);
+  convAlgorithmTest({1, 11, 9, 3}, 10, 3, 2, 1, backendName_);
+}
+
+TEST_P(BackendCorrectnessTest, convReluTest) {
+  CHECK_IF_ENABLED();
+  convActivationTest(Kinded::Kind::ReluNodeKind, 10, backendName_);
+  convActivationTest(Kinded::Kind::ReluNodeKind, 64, backendName_);
+}
+
+TEST_P(BackendCorrectnessTest, convTanhTest) {
+  CHECK_IF_ENABLED();
+  convActivationTest(Kinded::Kind::TanhNodeKind, 10, backendName_);
+  convActivationTest(Kinded::Kind::TanhNodeKind, 64, backendName_);
+}
+
+TEST_P(BackendCorrectnessTest, convSigmoidTest) {
+  CHECK_IF_ENABLED();
+  convActivationTest(Kinded::Kind::SigmoidNodeKind, 10, backendName_);
+  convActivationTest(Kinded::Kind::SigmoidNodeKind, 64, backendName_);
+}
+
+/// Compares a float FullyConnected of \p rows x \p depth inputs with
+/// \p depth x \p cols weights, followed by an activation of kind
+/// \p activation, on \p backendName against the Interpreter.
+static void fcActivationTest(Kinded::Kind activation, dim_t rows, dim_t depth,
+                             dim_t cols, llvm::StringRef backendName) {
+  PseudoRNG PRNG;
+  Tensor inputs(ElemKind::FloatTy, {rows, depth});
+  Tensor weights(ElemKind::FloatTy, {depth, cols});
+  Tensor bias(ElemKind::FloatTy, {cols});
+  inputs.getHandle().randomize(-1.0, 1.0, PRNG);
+  weights.getHandle().randomize(-0.5, 0.5, PRNG);
+  bias.getHandle().randomize(-0.5, 0.5, PRNG);
+  Tensor out1(ElemKind::FloatTy, {rows, cols});
+  Tensor out2(ElemKind::FloatTy, {rows, cols});
+
+  inferFCActivationNet(&inputs, &weights, &bias, &out1, activation,
+                       backendName);
+  inferFCActivationNet(&inputs, &weights, &bias, &out2, activation,
+                       "Interpreter");
+
+  EXPECT_TRUE(out1.isEqual(out2, 0.0005));
+}
+
+/// Covers the GEMM epilogue that the CPU backend fuses into FullyConnected
+/// layers, on shapes with ragged edges and with more than one K panel.
+TEST_P(BackendCorrectnessTest, fcActivationTest) {
+  CHECK_IF_ENABLED();
+  for (auto activation :
+       {Kinded::Kind::ReluNodeKind, Kinded::Kind::TanhNodeKind,
+        Kinded::Kind::SigmoidNodeKind}) {
+    fcActivationTest(activation, 5, 7, 3, backendName_);
+    fcActivationTest(activation, 37, 300, 70, backendName_);
+  }
+}
+
+/// Runs an int8 FullyConnected of \p input with the constant \p weights and
+/// \p bias on \p backendName, optionally followed by a Relu and by a
+/// RescaleQuantized to \p outTy. The FullyConnected and the Relu have the
+/// type \p fcTy. \returns the result.
+static Tensor inferQuantizedFCNet(Tensor *input, Tensor *weights,
+                                  Tensor *bias, TypeRef fcTy, TypeRef outTy,
+                                  bool relu, bool rescale,
+                                  llvm::StringRef backendName) {
+  PlaceholderBindings bindings;
+  ExecutionEngine EE(backendName);
+  auto &mod = EE.getModule();
+  Function *F = mod.createFunction("main");
+  auto *inputP = mod.createPlaceholder(mod.uniqueType(input->getType()),
+                                       "input", /* isTrainable */ false);
+  auto *weightsC = mod.createConstant("weights", *weights);
+  auto *biasC = mod.createConstant("bias", *bias);
+  NodeValue result =
+      F->createFullyConnected("fc", inputP, weightsC, biasC,
+                              mod.uniqueType(*fcTy))
+          ->getResult();
+  if (relu) {
+    result = F->createRELU("relu", result, mod.uniqueType(*fcTy));
+  }
+  if (rescale) {
+    result = F->createRescaleQuantized("rescale", result,
+                                       mod.uniqueType(*outTy));
+  }
+  auto *save = F->createSave("save", result);
+  bindings.allocate(mod.getPlaceholders());
+
+  EE.compile(CompilationMode::Infer);
+
+  updateInputPlaceholders(bindings, {inputP}, {input});
+  EE.run(bindings);
+  return bindings.get(save->getPlaceholder())->clone();
+}
+
+/// Covers the int8 GEMM epilogue that the CPU backend fuses into quantized
+/// FullyConnected layers, which adds the int8 or int32 bias, requantizes once
+/// to the type of a following RescaleQuantized and clips at the quantized zero
+/// of a following Relu.
+TEST_P(BackendCorrectnessTest, quantizedFCActivationTest) {
+  CHECK_IF_ENABLED();
+  PseudoRNG PRNG;
+  for (dim_t depth : {7, 300}) {
+    dim_t rows = 37;
+    dim_t cols = 70;
+    Tensor input(ElemKind::Int8QTy, {rows, depth}, 0.05, 3);
+    Tensor weights(ElemKind::Int8QTy, {depth, cols}, 0.02, -2);
+    input.getHandle<int8_t>().randomize(-10, 10, PRNG);
+    weights.getHandle<int8_t>().randomize(-10, 10, PRNG);
+    Tensor bias32(ElemKind::Int32QTy, {cols}, 0.05 * 0.02, 0);
+    Tensor bias8(ElemKind::Int8QTy, {cols}, 0.005, 1);
+    bias32.getHandle<int32_t>().randomize(-500, 500, PRNG);
+    bias8.getHandle<int8_t>().randomize(-100, 100, PRNG);
+    Type fcTy(ElemKind::Int8QTy, {rows, cols}, 0.04, -5);
+    Type outTy(ElemKind::Int8QTy, {rows, cols}, 0.05, 7);
+
+    for (Tensor *bias : {&bias32, &bias8}) {
+      for (bool relu : {false, true}) {
+        for (bool rescale : {false, true}) {
+          Tensor out1 = inferQuantizedFCNet(&input, &weights, bias, &fcTy,
+                                            &outTy, relu, rescale,
+                                            backendName_);
+          Tensor out2 = inferQuantizedFCNet(&input, &weights, bias, &fcTy,
+                                            &outTy, relu, rescale,
+                                            "Interpreter");
+          // The fused epilogue rounds once, rather than after each node.
+          EXPECT_TRUE(out1.isEqual(out2, 2.0));
+        }
+      }
+    }
+  }
+}
+
+/// Runs a float FullyConnected of \p input with the constant \p weights and
+/// \p bias on \p backendName, followed by an activation of kind
+/// \p activation and a Quantize to \p outTy. \returns the result.
+static Tensor inferFCQuantizeNet(Tensor *input, Tensor *weights, Tensor *bias,
+                                 Kinded::Kind activation, TypeRef outTy,
+                                 llvm::StringRef backendName) {
+  PlaceholderBindings bindings;
+  ExecutionEngine EE(backendName);
+  auto &mod = EE.getModule();
+  Function *F = mod.createFunction("main");
+  auto *inputP = mod.createPlaceholder(mod.uniqueType(input->getType()),
+                                       "input", /* isTrainable */ false);
+  auto *weightsC = mod.createConstant("weights", *weights);
+  auto *biasC = mod.createConstant("bias", *bias);
+  NodeValue result = F->createFullyConnected("fc", inputP, weightsC, biasC);
+  switch (activation) {
+  case Kinded::Kind::ReluNodeKind:
+    result = F->createRELU("relu", result);
+    break;
+  case Kinded::Kind::TanhNodeKind:
+    result = F->createTanh("tanh", result);
+    break;
+  default:
+    result = F->createSigmoid("sigmoid", result);
+    break;
+  }
+  auto *QN = F->createQuantize("quantize", result, mod.uniqueType(*outTy));
+  auto *save = F->createSave("save", QN);
+  bindings.allocate(mod.getPlaceholders());
+
+  EE.compile(CompilationMode::Infer);
+
+  updateInputPlaceholders(bindings, {inputP}, {input});
+  EE.run(bindings);
+  return bindings.get(save->getPlaceholder())->clone();
+}
+
+/// Covers the quantization of the result of a float FullyConnected that the
+/// CPU backend fuses into its GEMM epilogue.
+TEST_P(BackendCorrectnessTest, fcQuantizeTest) {
+  CHECK_IF_ENABLED();
+  PseudoRNG PRNG;
+  Tensor input(ElemKind::FloatTy, {37, 300});
+  Tensor weights(ElemKind::FloatTy, {300, 70});
+  Tensor bias(ElemKind::FloatTy, {70});
+  input.getHandle().randomize(-1.0, 1.0, PRNG);
+  weights.getHandle().randomize(-0.1, 0.1, PRNG);
+  bias.getHandle().randomize(-0.5, 0.5, PRNG);
+  Type outTy(ElemKind::Int8QTy, {37, 70}, 0.02, -20);
+
+  for (auto activation :
+       {Kinded::Kind::ReluNodeKind, Kinded::Kind::TanhNodeKind,
+        Kinded::Kind::SigmoidNodeKind}) {
+    Tensor out1 = inferFCQuantizeNet(&input, &weights, &bias, activation,
+                                     &outTy, backendName_);
+    Tensor out2 = inferFCQuantizeNet(&input, &weights, &bias, activation,
+                                     &outTy, "Interpreter");
+    EXPECT_TRUE(out1.isEqual(out2, 1.0));
+  }
+}
+
+/// Computes Exp, Tanh, Sigmoid, Gelu and Swish of \p input and Log of
+/// \p positive on \p backendName, with the backend specific options \p opts.
+/// \returns the results in that order.
+static std::vector<Tensor>
+inferTranscendentalNet(Tensor *input, Tensor *positive,
+                       llvm::StringRef backendName,
+                       const BackendSpecificOptions &opts) {
+  PlaceholderBindings bindings;
+  ExecutionEngine EE(backendName);
+  auto &mod = EE.getModule();
+  Function *F = mod.createFunction("main");
+  auto *inputP = mod.createPlaceholder(mod.uniqueType(input->getType()),
+                                       "input", /* isTrainable */ false);
+  auto *positiveP = mod.createPlaceholder(mod.uniqueType(positive->getType()),
+                                          "positive", /* isTrainable */ false);
+  NodeValue results[] = {
+      F->createExp("exp", inputP),         F->createTanh("tanh", inputP),
+      F->createSigmoid("sigmoid", inputP), F->createGELU("gelu", inputP),
+      F->createSwish("swish", inputP),     F->createLog("log", positiveP)};
+  std::vector<Placeholder *> outputs;
+  for (auto &result : results) {
+    outputs.push_back(F->createSave("save", result)->getPlaceholder());
+  }
+  bindings.allocate(mod.getPlaceholders());
+
+  CompilationContext cctx;
+  cctx.backendOpts.backendSpecificOpts = opts;
+  EE.compile(cctx);
+
+  updateInputPlaceholders(bindings, {inputP, positiveP}, {input, positive});
+  EE.run(bindings);
+  std::vector<Tensor> tensors;
+  for (auto *PH : outputs) {
+    tensors.push_back(bindings.get(PH)->clone());
+  }
+  return tensors;
+}
+
+/// \returns the error of \p result in units in the last place of \p ref,
+/// rounded to float. The ULP of denormals is the smallest denormal.
+static double ulpError(float result, double ref) {
+  float refF = std::fabs(static_cast<float>(ref));
+  float ulp = std::max(
+      std::nextafter(refF, std::numeric_limits<float>::infinity()) - refF,
+      std::numeric_limits<float>::denorm_min());
+  return std::fabs(result - ref) / ulp;
+}
+
+/// Checks the transcendental functions computed with the fast approximations
+/// against a double precision reference, within the error bounds documented
+/// in libjit_defs.h, and checks that disabling them keeps the default kernels.
+TEST_P(BackendCorrectnessTest, fastTranscendentalsTest) {
+  CHECK_IF_ENABLED();
+  PseudoRNG PRNG;
+  Tensor input(ElemKind::FloatTy, {1000});
+  Tensor positive(ElemKind::FloatTy, {1000});
+  input.getHandle().randomize(-12.0, 12.0, PRNG);
+  positive.getHandle().randomize(1e-4, 100.0, PRNG);
+
+  auto defaults = inferTranscendentalNet(&input, &positive, backendName_, {});
+  auto exact = inferTranscendentalNet(&input, &positive, backendName_,
+                                      {{"fast-transcendentals", "false"}});
+  for (size_t i = 0; i < exact.size(); i++) {
+    EXPECT_TRUE(exact[i].isBitwiseEqual(defaults[i]));
+  }
+
+  auto fast = inferTranscendentalNet(&input, &positive, backendName_,
+                                     {{"fast-transcendentals", "true"}});
+  auto IH = input.getHandle();
+  auto PH = positive.getHandle();
+  for (dim_t j = 0; j < IH.size(); j++) {
+    double x = IH.raw(j);
+    double sigmoid = 1 / (1 + std::exp(-x));
+    double z = 0.7978845608028654 * (x + 0.044715 * x * x * x);
+    double gelu = x / (1 + std::exp(-2 * z));
+    EXPECT_LE(ulpError(fast[0].getHandle().raw(j), std::exp(x)), 2) << x;
+    EXPECT_LE(ulpError(fast[1].getHandle().raw(j), std::tanh(x)), 2) << x;
+    EXPECT_LE(ulpError(fast[2].getHandle().raw(j), sigmoid), 3) << x;
+    // Swish is x * sigmoid(x), which adds the rounding of the product.
+    EXPECT_LE(ulpError(fast[4].getHandle().raw(j), x * sigmoid), 4) << x;
+    // Gelu is accurate to 16 ULP for x >= -3, and to 2^8 ULP down to -9.6,
+    // below which it is flushed towards 0 like the default kernel.
+    float geluResult = fast[3].getHandle().raw(j);
+    if (x >= -3) {
+      EXPECT_LE(ulpError(geluResult, gelu), 16) << x;
+    } else if (x >= -9.6) {
+      EXPECT_LE(ulpError(geluResult, gelu), 256) << x;
+    } else {
+      EXPECT_LE(std::fabs(geluResult - gelu), 1e-33) << x;
+    }
+    double p = PH.raw(j);
+    EXPECT_LE(ulpError(fast[5].getHandle().raw(j), std::log(p)), 1) << p;
+  }
+}
+
 void QuantizedConvReluFusionTest(quantization::Schema schema,
                                  std::string backendName_, int expectedFusion) {
   PseudoRNG PRNG;
@@ -571,6 +571,78 @@ int inferConvReluNet(Tensor *inputs, Tensor *filter, Tensor *bias, Tensor *out,
   return conv->getFusedActivation();
 }
 
+/// \returns the activation of kind \p activation (Relu, Tanh or Sigmoid) of
+/// \p input, created in \p F.
+static NodeValue createActivation(Function *F, Kinded::Kind activation,
+                                  NodeValue input) {
+  switch (activation) {
+  case Kinded::Kind::ReluNodeKind:
+    return F->createRELU("relu", input);
+  case Kinded::Kind::TanhNodeKind:
+    return F->createTanh("tanh", input);
+  case Kinded::Kind::SigmoidNodeKind:
+    return F->createSigmoid("sigmoid", input);
+  default:
+    llvm_unreachable("Unsupported activation");
+  }
+}
+
+bool inferConvActivationNet(Tensor *inputs, Tensor *filter, Tensor *bias,
+                            Tensor *out, Kinded::Kind activation,
+                            llvm::StringRef kind, unsigned_t stride,
+                            unsigned_t pad) {
+  PlaceholderBindings bindings;
+  ExecutionEngine EE(kind);
+  auto &mod = EE.getModule();
+  Function *F = mod.createFunction("main");
+  auto *inputP = createPlaceholder(mod, bindings, inputs, "inputP");
+  auto *outP = createPlaceholder(mod, bindings, out, "outP");
+  // The filter is a Constant so that backends may re-layout it.
+  auto *filterC = mod.createConstant("filter", *filter);
+  auto *biasC = mod.createConstant("bias", *bias);
+  auto OT = mod.uniqueType(out->getElementType(), out->dims());
+  unsigned_t kernel = filter->dims()[1];
+  auto *conv = F->createConv("conv", inputP, filterC, biasC, OT, kernel, stride,
+                             pad, /* group */ 1);
+  NodeValue act = createActivation(F, activation, conv);
+  auto *result = F->createSave("ret", act, outP);
+  auto *resultTensor = bindings.get(result->getPlaceholder());
+
+  // Ask the backend before compiling: the optimizer fuses the activation by
+  // this decision and the backend may then replace or erase the convolution.
+  bool fused = EE.getBackend().supportsFusedActivation(conv, act.getNode());
+
+  EE.compile(CompilationMode::Infer);
+
+  updateInputPlaceholders(bindings, {inputP}, {inputs});
+  EE.run(bindings);
+  out->assign(resultTensor);
+  return fused;
+}
+
+void inferFCActivationNet(Tensor *inputs, Tensor *weights, Tensor *bias,
+                          Tensor *out, Kinded::Kind activation,
+                          llvm::StringRef kind) {
+  PlaceholderBindings bindings;
+  ExecutionEngine EE(kind);
+  auto &mod = EE.getModule();
+  Function *F = mod.createFunction("main");
+  auto *inputP = createPlaceholder(mod, bindings, inputs, "inputP");
+  auto *outP = createPlaceholder(mod, bindings, out, "outP");
+  auto *weightsC = mod.createConstant("weights", *weights);
+  auto *biasC = mod.createConstant("bias", *bias);
+  auto *FC = F->createFullyConnected("fc", inputP, weightsC, biasC);
+  auto *result =
+      F->createSave("ret", createActivation(F, activation, FC), outP);
+  auto *resultTensor = bindings.get(result->getPlaceholder());
+
+  EE.compile(CompilationMode::Infer);
+
+  updateInputPlaceholders(bindings, {inputP}, {inputs});
+  EE.run(bindings);
+  out->assign(resultTensor);
+}
+
 void trainConvNet(Tensor *inputs, Tensor *kernel1, Tensor *bias1,
                   Tensor *kernel2, Tensor *bias2, Tensor *selected,
                   llvm::ArrayRef<dim_t> shape1, llvm::ArrayRef<dim_t> shape2,
@@ -358,6 +358,24 @@ int inferConvReluNet(Tensor *inputs, Tensor *filter, Tensor *bias, Tensor *out,
                      unsigned_t kernel, unsigned_t stride, unsigned_t pad,
                      llvm::StringRef kind);
 
+/// Runs a float convolution of \p inputs with the constant \p filter and
+/// \p bias, followed by an activation of kind \p activation (Relu, Tanh or
+/// Sigmoid), on backend \p kind and stores the result in \p out. The kernel
+/// size is taken from \p filter; \p stride and \p pad apply to both spatial
+/// dimensions. \returns whether the backend fuses the activation into the
+/// convolution.
+bool inferConvActivationNet(Tensor *inputs, Tensor *filter, Tensor *bias,
+                            Tensor *out, Kinded::Kind activation,
+                            llvm::StringRef kind, unsigned_t stride = 1,
+                            unsigned_t pad = 1);
+
+/// Runs a float FullyConnected of \p inputs with the constant \p weights and
+/// \p bias, followed by an activation of kind \p activation (Relu, Tanh or
+/// Sigmoid), on backend \p kind and stores the result in \p out.
+void inferFCActivationNet(Tensor *inputs, Tensor *weights, Tensor *bias,
+                          Tensor *out, Kinded::Kind activation,
+                          llvm::StringRef kind);
+
 void trainConvNet(Tensor *inputs, Tensor *kernel1, Tensor *bias1,
                   Tensor *kernel2, Tensor *bias2, Tensor *selected,
                   llvm::ArrayRef<dim_t> shape1, llvm::ArrayRef<dim_t> shape2,
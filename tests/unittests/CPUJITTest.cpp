@@ -22,12 +22,17 @@
 #include "glow/Graph/Nodes.h"
 #include "glow/Graph/Utils.h"
 
+#include "../../lib/Backends/CPU/CPUAutotuner.h"
 #include "../../lib/Backends/CPU/CPUBackend.h"
 #include "../../lib/Backends/CPU/CPULLVMIRGen.h"
 #include "glow/IR/Instrs.h"
 
 #include "gtest/gtest.h"
 
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+
 using namespace glow;
 
 //==============================================================
@@ -143,3 +148,177 @@ TEST(CPUJITTest, testCppConstructors) {
   EXPECT_TRUE(outputT->isEqual(expectedT));
 }
 #endif // ! WIN32
+
+// Test that compiled functions report the libjit flavor picked for the host.
+TEST(CPUJITTest, libjitISAMetadata) {
+  Module M;
+  Function *F = M.createFunction("F");
+  auto *inputPH = M.createPlaceholder(ElemKind::FloatTy, {16}, "input", false);
+  F->createSave("output", F->createAdd("add", inputPH, inputPH));
+
+  CPUBackend backend;
+  EXPECT_EQ(backend.getLibjitISA(), CPUBackend::getHostLibjitISA());
+  auto compiled = EXIT_ON_ERR(backend.compile(F, BackendOptions()));
+  std::string isa = CPUBackend::getLibjitISAName(backend.getLibjitISA());
+  EXPECT_EQ(compiled->toJSON(), "{\"libjit_isa\": \"" + isa + "\"}");
+}
+
+// Test that a libjit flavor the host cannot run is clamped to the best one it
+// can.
+TEST(CPUJITTest, libjitISAClampedToHost) {
+  auto *isaOpt = static_cast<llvm::cl::opt<CPULibjitISA> *>(
+      llvm::cl::getRegisteredOptions().lookup("cpu-libjit-isa"));
+  ASSERT_TRUE(isaOpt);
+  isaOpt->setValue(CPULibjitISA::AVX512VNNI);
+  CPUBackend backend;
+  isaOpt->setValue(CPULibjitISA::Auto);
+  EXPECT_EQ(backend.getLibjitISA(), std::min(CPULibjitISA::AVX512VNNI,
+                                             CPUBackend::getHostLibjitISA()));
+}
+
+// Test that convolution configs round trip through their tuning database
+// strings, and that invalid strings parse to Auto.
+TEST(CPUJITTest, convConfigStrings) {
+  for (const char *str :
+       {"direct", "im2col:64", "winograd:8", "im2col:64:128x256x4096",
+        "winograd:8:64x64x1024", "direct:pixels:8x1", "direct:filter:2x5"}) {
+    EXPECT_EQ(CPUConvConfig::fromString(str).toString(), str);
+  }
+  auto config = CPUConvConfig::fromString("im2col:16:64x128x256");
+  EXPECT_EQ(config.algorithm, CPUConvAlgorithm::Im2Col);
+  EXPECT_EQ(config.tileSize, 16);
+  EXPECT_EQ(config.gemmMC, 64);
+  EXPECT_EQ(config.gemmKC, 128);
+  EXPECT_EQ(config.gemmNC, 256);
+  config = CPUConvConfig::fromString("direct:filter:4x2");
+  EXPECT_EQ(config.algorithm, CPUConvAlgorithm::Direct);
+  EXPECT_FALSE(config.pixelScanFirst);
+  EXPECT_EQ(config.numDepthRegs, 4);
+  EXPECT_EQ(config.sizeGroupY, 2);
+  for (const char *str :
+       {"", "auto", "gemm:16", "im2col:x", "im2col:16:64x128",
+        "im2col:16:0x128x256", "direct:rows:4x2", "direct:filter:4"}) {
+    EXPECT_EQ(CPUConvConfig::fromString(str).algorithm,
+              CPUConvAlgorithm::Auto);
+  }
+}
+
+/// \returns a float 3x3 convolution of a 1x8x8x16 input to \p depth output
+/// channels in a new Function of \p M, with Constant filter and bias.
+static ConvolutionNode *createTunedConv(Module &M, dim_t depth = 16) {
+  Function *F = M.createFunction("F");
+  auto *input =
+      M.createPlaceholder(ElemKind::FloatTy, {1, 8, 8, 16}, "input", false);
+  auto *filter =
+      M.createConstant(ElemKind::FloatTy, {depth, 3, 3, 16}, "filter");
+  auto *bias = M.createConstant(ElemKind::FloatTy, {depth}, "bias");
+  filter->getPayloadMutable().getHandle().randomize(-1.0, 1.0, M.getPRNG());
+  bias->getPayloadMutable().getHandle().randomize(-1.0, 1.0, M.getPRNG());
+  auto *outTy = M.uniqueType(ElemKind::FloatTy, {1, 8, 8, depth});
+  auto *conv = F->createConv("conv", input, filter, bias, outTy, 3, 1, 1, 1);
+  F->createSave("save", conv);
+  return conv;
+}
+
+// Test that autotuning a convolution stores its config in the tuning database
+// file, and that later compiles apply the stored config without autotuning.
+TEST(CPUJITTest, convAutotuning) {
+  llvm::SmallString<64> dbFile;
+  ASSERT_FALSE(
+      llvm::sys::fs::createTemporaryFile("cpu-tuning", "yaml", dbFile));
+  llvm::sys::fs::remove(dbFile);
+  auto &database = CPUTuningDatabase::get();
+  database.setFile(dbFile);
+
+  auto &opts = llvm::cl::getRegisteredOptions();
+  auto *autotuneOpt =
+      static_cast<llvm::cl::opt<bool> *>(opts.lookup("cpu-autotune"));
+  auto *repsOpt =
+      static_cast<llvm::cl::opt<unsigned> *>(opts.lookup("cpu-autotune-reps"));
+  ASSERT_TRUE(autotuneOpt && repsOpt);
+  unsigned reps = *repsOpt;
+  autotuneOpt->setValue(true);
+  repsOpt->setValue(1);
+
+  CPUBackend backend;
+  CompilationContext cctx;
+  Module M1;
+  auto *conv = createTunedConv(M1);
+  std::string key = getConvTuningKey(conv);
+  bool changed;
+  ASSIGN_VALUE_OR_FAIL_TEST(
+      changed, backend.transformPostLowering(conv->getParent(), cctx));
+  EXPECT_TRUE(changed);
+  autotuneOpt->setValue(false);
+  repsOpt->setValue(reps);
+
+  // The measured config is persisted.
+  auto tuned = database.lookup(key);
+  EXPECT_NE(tuned.algorithm, CPUConvAlgorithm::Auto);
+  EXPECT_TRUE(llvm::sys::fs::exists(dbFile));
+  database.setFile(dbFile);
+  EXPECT_EQ(database.lookup(key).toString(), tuned.toString());
+
+  // A stored config is applied as is, including the blocking of its GEMM.
+  database.insert(key, CPUConvConfig::fromString("im2col:16:64x256x1024"));
+  Module M2;
+  Function *F = createTunedConv(M2)->getParent();
+  ASSIGN_VALUE_OR_FAIL_TEST(changed, backend.transformPostLowering(F, cctx));
+  EXPECT_TRUE(changed);
+  unsigned numIm2Col = 0;
+  for (auto &N : F->getNodes()) {
+    if (auto *CN = llvm::dyn_cast<CPUConvIm2ColNode>(&N)) {
+      EXPECT_EQ(CN->getTileSize(), 16);
+      EXPECT_EQ(CN->getGemmMC(), 64);
+      EXPECT_EQ(CN->getGemmKC(), 256);
+      EXPECT_EQ(CN->getGemmNC(), 1024);
+      numIm2Col++;
+    }
+  }
+  EXPECT_EQ(numIm2Col, 1);
+
+  // So is the blocking of the DKKC8 direct convolution.
+  Module M3;
+  auto *directConv = createTunedConv(M3, 64);
+  database.insert(getConvTuningKey(directConv),
+                  CPUConvConfig::fromString("direct:filter:4x2"));
+  F = directConv->getParent();
+  ASSIGN_VALUE_OR_FAIL_TEST(changed, backend.transformPostLowering(F, cctx));
+  EXPECT_TRUE(changed);
+  unsigned numDKKC8 = 0;
+  for (auto &N : F->getNodes()) {
+    if (auto *CN = llvm::dyn_cast<CPUConvDKKC8Node>(&N)) {
+      EXPECT_FALSE(CN->getPixelScanFirst());
+      EXPECT_EQ(CN->getNumDepthRegs(), 4);
+      EXPECT_EQ(CN->getSizeGroupY(), 2);
+      numDKKC8++;
+    }
+  }
+  EXPECT_EQ(numDKKC8, 1);
+
+  // Blockings that do not fit the shapes evenly still compute the same result
+  // as the interpreter.
+  for (const char *str : {"im2col:16:24x20x12", "winograd:4:24x20x12",
+                          "direct:pixels:2x1", "direct:filter:8x2"}) {
+    dim_t depth = llvm::StringRef(str).startswith("direct") ? 64 : 16;
+    Tensor results[2];
+    for (unsigned i = 0; i < 2; i++) {
+      ExecutionEngine EE(i ? "CPU" : "Interpreter");
+      auto *conv = createTunedConv(EE.getModule(), depth);
+      database.insert(getConvTuningKey(conv), CPUConvConfig::fromString(str));
+      auto *save = llvm::cast<SaveNode>(conv->getUsers().begin()->getUser());
+      PlaceholderBindings bindings;
+      bindings.allocate(EE.getModule().getPlaceholders());
+      bindings.get(EE.getModule().getPlaceholderByNameSlow("input"))
+          ->getHandle()
+          .randomize(-1.0, 1.0, EE.getModule().getPRNG());
+      EE.compile(CompilationMode::Infer);
+      EE.run(bindings);
+      results[i] = bindings.get(save->getPlaceholder())->clone();
+    }
+    EXPECT_TRUE(results[0].isEqual(results[1], 1e-4)) << str;
+  }
+
+  database.setFile("");
+  llvm::sys::fs::remove(dbFile);
+}
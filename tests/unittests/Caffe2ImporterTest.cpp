@@ -1995,6 +1995,60 @@ TEST_F(Caffe2ImporterTest, tensorFillsTest) {
   }
 }
 
+/// Verify that given tensor fills are loaded from an external weight file at
+/// the offsets named in the init net.
+TEST_F(Caffe2ImporterTest, tensorFillsExternalWeightsTest) {
+  ExecutionEngine EE{};
+  auto &mod = EE.getModule();
+  Function *F = mod.createFunction("main");
+
+  std::string NetDescFilename(
+      GLOW_DATA_PATH "tests/models/caffe2Models/fill_test_predict_net.pbtxt");
+  std::string NetWeightFilename(
+      GLOW_DATA_PATH
+      "tests/models/caffe2Models/fill_test_external_init_net.pbtxt");
+
+  Constant *tensorFillFloat, *tensorIntFill, *tensorInt64Fill;
+
+  // Destroy the loader after the graph is loaded since the following execution
+  // will not depend on anything from the loader.
+  {
+    Type unusedTy = Type(ElemKind::FloatTy, {4});
+    Caffe2ModelLoader caffe2LD(
+        NetDescFilename, NetWeightFilename,
+        {"tensor_fill_float_eq", "tensor_int_fill_eq", "tensor_int64_fill_eq",
+         "tensor_string_to_uint8_fill_eq"},
+        {&unusedTy, &unusedTy, &unusedTy, &unusedTy}, *F);
+    tensorFillFloat = llvm::dyn_cast<Constant>(
+        EXIT_ON_ERR(caffe2LD.getNodeValueByName("tensor_fill_float")));
+    tensorIntFill = llvm::dyn_cast<Constant>(
+        EXIT_ON_ERR(caffe2LD.getNodeValueByName("tensor_int_fill")));
+    tensorInt64Fill = llvm::dyn_cast<Constant>(
+        EXIT_ON_ERR(caffe2LD.getNodeValueByName("tensor_int64_fill")));
+  }
+
+  ASSERT_TRUE(tensorFillFloat);
+  ASSERT_TRUE(tensorIntFill);
+  ASSERT_TRUE(tensorInt64Fill);
+
+  const std::vector<dim_t> expectedDims = {2, 2};
+  ASSERT_TRUE(tensorFillFloat->dims().equals(expectedDims));
+  ASSERT_TRUE(tensorIntFill->dims().equals(expectedDims));
+  ASSERT_TRUE(tensorInt64Fill->dims().equals(expectedDims));
+
+  auto tensorFillFloatH = tensorFillFloat->getPayload().getHandle<float>();
+  auto tensorIntFillH = tensorIntFill->getPayload().getHandle<int32_t>();
+  auto tensorInt64FillH = tensorInt64Fill->getPayload().getHandle<int64_t>();
+
+  // fill_test_external_weights.bin holds 8 bytes of padding followed by 0
+  // through 3 as floats, int32s and int64s.
+  for (size_t i = 0; i < 4; i++) {
+    EXPECT_FLOAT_EQ(tensorFillFloatH.raw(i), (float)i);
+    EXPECT_EQ(tensorIntFillH.raw(i), (int32_t)i);
+    EXPECT_EQ(tensorInt64FillH.raw(i), (int64_t)i);
+  }
+}
+
 TEST_F(Caffe2ImporterTest, HalfToFloat) {
   ExecutionEngine EE{};
   auto &mod = EE.getModule();
@@ -21,6 +21,8 @@
 
 #include "gtest/gtest.h"
 
+#include <atomic>
+
 using namespace glow;
 using namespace glow::runtime;
 
@@ -167,4 +169,123 @@ TEST_P(DeferredWeightLoaderTest, FP16StaticPlaceholderInference) {
   EXPECT_NEAR(resHandle.at({0}), 12.0, 1E-5);
 }
 
+/// Test that deferred weights are prefetched and converted to FP16 on worker
+/// threads when prefetching is enabled.
+TEST_P(DeferredWeightLoaderTest, FP16StaticPlaceholderInferencePrefetch) {
+  CHECK_IF_ENABLED();
+  auto hostmanager = createHostManager(GetParam());
+  ExecutionEngine EE{GetParam()};
+  auto &module = EE.getModule();
+  auto F = module.createFunction("main");
+  auto *X = module.createPlaceholder(ElemKind::FloatTy, {1}, "X", false);
+  auto *Y = module.createPlaceholder(ElemKind::FloatTy, {1}, "Y", false);
+  auto *Z = module.createPlaceholder(ElemKind::FloatTy, {1}, "Z", false);
+  auto *output =
+      module.createPlaceholder(ElemKind::FloatTy, {1}, "output", false);
+  // Set X and Y as static.
+  X->setStatic(true);
+  Y->setStatic(true);
+  auto mul1 = F->createMul("mul", X, Y);
+  auto mul2 = F->createMul("mul2", Z, mul1);
+  F->createSave("save", mul2, output);
+  auto xTensor = Tensor(X->getType());
+  auto yTensor = Tensor(Y->getType());
+  auto zTensor = Tensor(Z->getType());
+  xTensor.getHandle().clear(2.0);
+  yTensor.getHandle().clear(3.0);
+  zTensor.getHandle().clear(2.0);
+
+  TestDeferredWeightLoader loader;
+  loader.addWeight(&xTensor);
+  loader.addWeight(&yTensor);
+  loader.addName("X");
+  loader.addName("Y");
+  DeferredLoader()->registerLoader(&loader);
+
+  PlaceholderBindings pBindings;
+
+  CompilationContext cctx;
+  cctx.deferredWeightLoader = &loader;
+  cctx.deferredWeightPrefetchCount = 2;
+  cctx.numDeferredWeightConversionThreads = 2;
+  cctx.optimizationOpts.foldStaticPlaceholderConversions = true;
+  cctx.precisionConfig.convertToFP16 = true;
+
+  EE.compile(cctx);
+
+  pBindings.allocate(Z);
+  pBindings.allocate(output);
+  updateInputPlaceholders(pBindings, {Z}, {&zTensor});
+  EE.run(pBindings);
+  auto resHandle = pBindings.get(output)->getHandle();
+  EXPECT_NEAR(resHandle.at({0}), 12.0, 1E-5);
+}
+
 INSTANTIATE_BACKEND_TEST(DeferredWeightLoaderTest);
+
+/// Test that the async loader hands out converted weights in order, bounds
+/// the number of weights in flight and reports progress.
+TEST(AsyncDeferredWeightLoader, prefetchInOrder) {
+  constexpr unsigned numWeights = 8;
+  std::vector<Tensor> tensors;
+  tensors.reserve(numWeights);
+  TestDeferredWeightLoader loader;
+  for (unsigned i = 0; i < numWeights; i++) {
+    tensors.emplace_back(ElemKind::FloatTy, llvm::ArrayRef<dim_t>{4});
+    tensors.back().getHandle().clear(i);
+    loader.addWeight(&tensors.back());
+    loader.addName("W" + std::to_string(i));
+  }
+
+  std::atomic<unsigned> numConverted{0};
+  AsyncDeferredWeightLoader asyncLoader(
+      &loader, /* prefetchCount */ 2, /* numConversionThreads */ 2,
+      [&](const std::string &name, Tensor &weight) -> Error {
+        weight.getHandle().clear(weight.getHandle().raw(0) * 2);
+        numConverted++;
+        return Error::success();
+      });
+
+  for (unsigned i = 0; i < numWeights; i++) {
+    ASSERT_FALSE(ERR_TO_BOOL(asyncLoader.loadNextWeight()));
+    EXPECT_EQ(asyncLoader.getName(), "W" + std::to_string(i));
+    Tensor *weight = asyncLoader.getTensor();
+    ASSERT_TRUE(weight);
+    EXPECT_EQ(weight->getHandle().raw(3), 2.0f * i);
+    // At most the current weight and the two prefetched ones were converted.
+    EXPECT_LE(numConverted, i + 3);
+  }
+  ASSERT_FALSE(ERR_TO_BOOL(asyncLoader.loadNextWeight()));
+  EXPECT_EQ(asyncLoader.getName(), "");
+  EXPECT_EQ(asyncLoader.getTensor(), nullptr);
+
+  auto stats = asyncLoader.getStats();
+  EXPECT_EQ(stats.numWeightsLoaded, numWeights);
+  EXPECT_EQ(stats.numBytesLoaded, numWeights * 4 * sizeof(float));
+  EXPECT_GT(stats.getThroughput(), 0);
+}
+
+/// Test that an error raised while converting a prefetched weight is returned
+/// when that weight is loaded.
+TEST(AsyncDeferredWeightLoader, conversionError) {
+  Tensor A(ElemKind::FloatTy, {1});
+  Tensor B(ElemKind::FloatTy, {1});
+  TestDeferredWeightLoader loader;
+  loader.addWeight(&A);
+  loader.addWeight(&B);
+  loader.addName("A");
+  loader.addName("B");
+
+  AsyncDeferredWeightLoader asyncLoader(
+      &loader, /* prefetchCount */ 4, /* numConversionThreads */ 1,
+      [](const std::string &name, Tensor &weight) -> Error {
+        if (name == "B") {
+          return MAKE_ERR("Cannot convert B");
+        }
+        return Error::success();
+      });
+
+  ASSERT_FALSE(ERR_TO_BOOL(asyncLoader.loadNextWeight()));
+  EXPECT_EQ(asyncLoader.getName(), "A");
+  EXPECT_TRUE(ERR_TO_BOOL(asyncLoader.loadNextWeight()));
+}
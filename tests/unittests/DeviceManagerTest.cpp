@@ -26,6 +26,13 @@
 #include <chrono>
 #include <future>
 
+#ifdef __linux__
+#include <cerrno>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 using namespace glow;
 using namespace glow::runtime;
 
@@ -694,10 +701,15 @@ TEST(DeviceManagerTest, AvailableMemory) {
   auto module = makeBasicModule();
   auto compiledFunctions = compileFunctions("CPU", module.get(), backing);
 
+  // Functions on a CPU device share one activation arena.
   uint64_t expectedBytes{0};
+  uint64_t activationsBytes{0};
   for (const auto &f : backing) {
     expectedBytes += f->getRuntimeBundle().getConstantWeightSize();
+    activationsBytes = std::max<uint64_t>(
+        activationsBytes, f->getRuntimeBundle().getActivationsSize());
   }
+  expectedBytes += activationsBytes;
 
   auto config = DeviceConfig("CPU");
   config.setDeviceMemory(expectedBytes);
@@ -783,6 +795,255 @@ TEST(DeviceManagerTest, AvailableMemory) {
   EXPECT_EQ(cpuDeviceDefault->getMaximumMemory(), 2000000000);
 }
 
+/// Check that CPU functions with identical constants share them on a device.
+TEST(DeviceManagerTest, CPUSharedConstants) {
+  std::vector<std::unique_ptr<CompiledFunction>> backing;
+  auto moduleA = makeBasicModule("a");
+  auto moduleB = makeBasicModule("b");
+  auto functionsA = compileFunctions("CPU", moduleA.get(), backing);
+  auto functionsB = compileFunctions("CPU", moduleB.get(), backing);
+  auto constantBytes = backing[0]->getRuntimeBundle().getConstantWeightSize();
+  ASSERT_GT(constantBytes, 0);
+  // Both functions also share the device's activation arena.
+  auto usedBytes =
+      constantBytes + backing[0]->getRuntimeBundle().getActivationsSize();
+
+  auto device = std::unique_ptr<DeviceManager>(
+      DeviceManager::createDeviceManager(DeviceConfig("CPU")));
+  ASSERT_FALSE(ERR_TO_BOOL(device->init()));
+  auto maxMemory = device->getMaximumMemory();
+
+  auto add = [&](Module *module, FunctionMapTy functions) {
+    std::promise<const Module *> promise;
+    std::future<const Module *> future;
+    std::tie(promise, future) = getFutureHelper<const Module *>();
+    device->addNetwork(module, std::move(functions),
+                       [&promise](const Module *module, Error err) {
+                         callbackHelper(promise, module, std::move(err));
+                       });
+    future.wait_for(std::chrono::seconds(2));
+    EXPECT_EQ(future.get(), module);
+  };
+  auto evict = [&](std::string name) {
+    std::promise<std::string> promise;
+    std::future<std::string> future;
+    std::tie(promise, future) = getFutureHelper<std::string>();
+    device->evictNetwork(name, [&promise](std::string name, Error err) {
+      callbackHelper(promise, name, std::move(err));
+    });
+    future.wait_for(std::chrono::seconds(2));
+    EXPECT_EQ(future.get(), name);
+  };
+
+  // The second network reuses the constants of the first one.
+  add(moduleA.get(), functionsA);
+  EXPECT_EQ(device->getAvailableMemory(), maxMemory - usedBytes);
+  add(moduleB.get(), functionsB);
+  EXPECT_EQ(device->getAvailableMemory(), maxMemory - usedBytes);
+  EXPECT_EQ(backing[0]->getRuntimeBundle().getConstants(),
+            backing[1]->getRuntimeBundle().getConstants());
+
+  // The shared constants outlive the eviction of the first network.
+  evict("a");
+  EXPECT_EQ(device->getAvailableMemory(), maxMemory - usedBytes);
+
+  auto context = glow::make_unique<ExecutionContext>();
+  auto *input = moduleB->getPlaceholderByNameSlow("b_input");
+  auto *output = moduleB->getPlaceholderByNameSlow("b_output");
+  context->getPlaceholderBindings()->allocate(input)->getHandle().clear(-1.0f);
+  context->getPlaceholderBindings()->allocate(output);
+
+  std::promise<std::unique_ptr<ExecutionContext>> runPromise;
+  std::future<std::unique_ptr<ExecutionContext>> runFuture;
+  std::tie(runPromise, runFuture) =
+      getFutureHelper<std::unique_ptr<ExecutionContext>>();
+  device->runFunction("b", std::move(context),
+                      [&runPromise](RunIdentifierTy, Error err,
+                                    std::unique_ptr<ExecutionContext> context) {
+                        callbackHelper(runPromise, std::move(context),
+                                       std::move(err));
+                      });
+  runFuture.wait_for(std::chrono::seconds(2));
+  context = runFuture.get();
+  ASSERT_TRUE(context);
+  Tensor *result = context->getPlaceholderBindings()->get(output);
+  ASSERT_TRUE(result);
+  EXPECT_FLOAT_EQ(result->getHandle().at({0}), 0.25f);
+
+  evict("b");
+  EXPECT_EQ(device->getAvailableMemory(), maxMemory);
+  EXPECT_FALSE(ERR_TO_BOOL(device->stop()));
+}
+
+/// Check that functions on a CPU device share a single activation arena, sized
+/// for the function that needs the most activation memory and counted once in
+/// the device memory.
+TEST(DeviceManagerTest, CPUSharedActivations) {
+  std::unique_ptr<Module> module = glow::make_unique<Module>();
+  for (dim_t size : {4, 256}) {
+    Function *F = module->createFunction("f" + std::to_string(size));
+    auto *input = module->createPlaceholder(
+        ElemKind::FloatTy, {size}, "input" + std::to_string(size), false);
+    auto *output = module->createPlaceholder(
+        ElemKind::FloatTy, {size}, "output" + std::to_string(size), false);
+    auto *tanh = F->createTanh("tanh", input);
+    auto *sigmoid = F->createSigmoid("sigmoid", tanh);
+    F->createSave("ret", F->createAdd("add", tanh, sigmoid), output);
+  }
+  std::vector<std::unique_ptr<CompiledFunction>> backing;
+  auto functions = compileFunctions("CPU", module.get(), backing);
+
+  uint64_t constantBytes{0};
+  uint64_t activationsBytes{0};
+  uint64_t totalActivationsBytes{0};
+  for (const auto &f : backing) {
+    auto &bundle = f->getRuntimeBundle();
+    constantBytes += bundle.getConstantWeightSize();
+    activationsBytes =
+        std::max<uint64_t>(activationsBytes, bundle.getActivationsSize());
+    totalActivationsBytes += bundle.getActivationsSize();
+  }
+  ASSERT_GT(totalActivationsBytes, activationsBytes);
+
+  // Creates \p device with \p deviceMemory bytes and adds the network to it.
+  // \returns whether the device accepted the network.
+  auto addToDevice = [&](std::unique_ptr<DeviceManager> &device,
+                         uint64_t deviceMemory) {
+    auto config = DeviceConfig("CPU");
+    config.setDeviceMemory(deviceMemory);
+    device.reset(DeviceManager::createDeviceManager(config));
+    EXPECT_FALSE(ERR_TO_BOOL(device->init()));
+
+    std::promise<const Module *> promise;
+    std::future<const Module *> future;
+    std::tie(promise, future) = getFutureHelper<const Module *>();
+    device->addNetwork(module.get(), functions,
+                       [&promise](const Module *module, Error err) {
+                         callbackHelper(promise, module, std::move(err));
+                       });
+    future.wait_for(std::chrono::seconds(2));
+    return future.get() == module.get();
+  };
+
+  // A device without room for the largest activations rejects the network
+  // and stays empty.
+  std::unique_ptr<DeviceManager> smallDevice;
+  EXPECT_FALSE(addToDevice(smallDevice, constantBytes + activationsBytes - 1));
+  EXPECT_EQ(smallDevice->getAvailableMemory(),
+            constantBytes + activationsBytes - 1);
+  EXPECT_FALSE(ERR_TO_BOOL(smallDevice->stop()));
+
+  // The network fits in memory that could not hold separate activations.
+  std::unique_ptr<DeviceManager> device;
+  ASSERT_TRUE(addToDevice(device, constantBytes + activationsBytes));
+  EXPECT_EQ(device->getAvailableMemory(), 0);
+
+  // Runs the function of \p size elements and checks its result.
+  auto runAndCheck = [&](dim_t size) {
+    auto context = glow::make_unique<ExecutionContext>();
+    auto *input =
+        module->getPlaceholderByNameSlow("input" + std::to_string(size));
+    auto *output =
+        module->getPlaceholderByNameSlow("output" + std::to_string(size));
+    context->getPlaceholderBindings()->allocate(input)->getHandle().clear(0);
+    context->getPlaceholderBindings()->allocate(output);
+
+    std::promise<std::unique_ptr<ExecutionContext>> runPromise;
+    std::future<std::unique_ptr<ExecutionContext>> runFuture;
+    std::tie(runPromise, runFuture) =
+        getFutureHelper<std::unique_ptr<ExecutionContext>>();
+    device->runFunction(
+        "f" + std::to_string(size), std::move(context),
+        [&runPromise](RunIdentifierTy, Error err,
+                      std::unique_ptr<ExecutionContext> context) {
+          callbackHelper(runPromise, std::move(context), std::move(err));
+        });
+    runFuture.wait_for(std::chrono::seconds(2));
+    context = runFuture.get();
+    ASSERT_TRUE(context);
+    Tensor *result = context->getPlaceholderBindings()->get(output);
+    ASSERT_TRUE(result);
+    EXPECT_FLOAT_EQ(result->getHandle().at({size - 1}), 0.5f);
+  };
+
+  // Both functions run in the shared arena.
+  runAndCheck(4);
+  runAndCheck(256);
+
+  // Evicting the larger function shrinks the arena; the smaller one still runs
+  // in it.
+  std::promise<std::string> evictPromise;
+  std::future<std::string> evictFuture;
+  std::tie(evictPromise, evictFuture) = getFutureHelper<std::string>();
+  device->evictNetwork("f256",
+                       [&evictPromise](std::string functionName, Error err) {
+                         callbackHelper(evictPromise, functionName,
+                                        std::move(err));
+                       });
+  evictFuture.wait_for(std::chrono::seconds(2));
+  EXPECT_EQ(evictFuture.get(), "f256");
+  auto &bundle = functions["f4"]->getRuntimeBundle();
+  EXPECT_EQ(device->getAvailableMemory(),
+            activationsBytes + constantBytes - bundle.getConstantWeightSize() -
+                bundle.getActivationsSize());
+  runAndCheck(4);
+  EXPECT_FALSE(ERR_TO_BOOL(device->stop()));
+}
+
+/// Check that CPU devices validate and apply their CPU set and NUMA node.
+TEST(DeviceManagerTest, CPUDeviceBinding) {
+  auto badConfig = DeviceConfig("CPU");
+  badConfig.parameters["cpuSet"] = "3-1";
+  auto badDevice = std::unique_ptr<DeviceManager>(
+      DeviceManager::createDeviceManager(badConfig));
+  EXPECT_TRUE(ERR_TO_BOOL(badDevice->init()));
+
+  auto unboundDevice = std::unique_ptr<DeviceManager>(
+      DeviceManager::createDeviceManager(DeviceConfig("CPU")));
+  EXPECT_EQ(unboundDevice->getDeviceInfo().numaNode, -1);
+
+#ifdef __linux__
+  // Kernels without NUMA support, and sandboxes, reject memory policies.
+  if (syscall(SYS_set_mempolicy, /* MPOL_DEFAULT */ 0, nullptr, 0) != 0 &&
+      (errno == ENOSYS || errno == EPERM)) {
+    GTEST_SKIP();
+  }
+
+  // Bind the device to a CPU the test is allowed to run on.
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  int cpu = 0;
+  while (cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed)) {
+    cpu++;
+  }
+  ASSERT_LT(cpu, CPU_SETSIZE);
+
+  auto config = DeviceConfig("CPU");
+  config.parameters["cpuSet"] = std::to_string(cpu);
+  config.parameters["numaNode"] = "0";
+  auto device = std::unique_ptr<DeviceManager>(
+      DeviceManager::createDeviceManager(config));
+  ASSERT_FALSE(ERR_TO_BOOL(device->init()));
+  EXPECT_EQ(device->getDeviceInfo().numaNode, 0);
+
+  // The bound device still runs networks.
+  std::vector<std::unique_ptr<CompiledFunction>> backing;
+  auto module = makeBasicModule();
+  auto functions = compileFunctions("CPU", module.get(), backing);
+  std::promise<const Module *> promise;
+  std::future<const Module *> future;
+  std::tie(promise, future) = getFutureHelper<const Module *>();
+  device->addNetwork(module.get(), std::move(functions),
+                     [&promise](const Module *module, Error err) {
+                       callbackHelper(promise, module, std::move(err));
+                     });
+  future.wait_for(std::chrono::seconds(2));
+  EXPECT_EQ(future.get(), module.get());
+  EXPECT_FALSE(ERR_TO_BOOL(device->stop()));
+#endif
+}
+
 TEST(DeviceManagerTest, DummyDeviceManager) {
   DummyDeviceManager deviceManager{DeviceConfig("Interpreter")};
   ASSERT_FALSE(ERR_TO_BOOL(deviceManager.init()));
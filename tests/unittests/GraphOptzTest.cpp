@@ -4030,6 +4030,24 @@ TEST_F(GraphOptz, convertBroadcastedBatchMatMulToMatMul) {
   EXPECT_EQ(countNodeKind(F_, Kinded::Kind::BatchMatMulNodeKind), 0);
 }
 
+/// Test that a BatchMatMul whose RHS has a batch size of 1, without a Tile, is
+/// also converted to a single MatMul.
+TEST_F(GraphOptz, convertBatchOneRHSBatchMatMulToMatMul) {
+  auto *lhs =
+      mod_.createPlaceholder(ElemKind::FloatTy, {2, 3, 2}, "lhs", false);
+  auto *rhs =
+      mod_.createPlaceholder(ElemKind::FloatTy, {1, 2, 4}, "rhs", false);
+  auto OT = mod_.uniqueType(ElemKind::FloatTy, {2, 3, 4});
+  auto *BMMN = F_->addNode(new BatchMatMulNode("BMM", OT, lhs, rhs));
+  F_->createSave("save", BMMN);
+  EXPECT_TRUE(F_->verify());
+
+  ::glow::optimize(F_, CompilationMode::Infer);
+
+  EXPECT_EQ(countNodeKind(F_, Kinded::Kind::MatMulNodeKind), 1);
+  EXPECT_EQ(countNodeKind(F_, Kinded::Kind::BatchMatMulNodeKind), 0);
+}
+
 TEST_F(GraphOptz, dceQuantization) {
   auto *lhs =
       mod_.createPlaceholder(ElemKind::Int8QTy, {3, 5}, 0.3, 15, "lhs", false);
@@ -4507,6 +4525,77 @@ TEST_F(GraphOptz, constantFoldWholeFunction) {
   EXPECT_EQ(CH.at({1, 1}), 76.0f);
 }
 
+/// Create a Function in \p mod with two independent constant operations on
+/// Constants filled with \p val, each used by a non-constant operation.
+/// \returns the SaveNodes of the non-constant operations.
+static std::pair<SaveNode *, SaveNode *>
+createTwoConstantOperations(Module &mod, float val) {
+  Function *F = mod.createFunction("constFold");
+  auto *const1 = mod.createConstant(ElemKind::FloatTy, {2, 2}, "const1");
+  auto *const2 = mod.createConstant(ElemKind::FloatTy, {2, 2}, "const2");
+  const1->getPayloadMutable().getHandle().clear(val);
+  const2->getPayloadMutable().getHandle().clear(2.0f);
+  auto *ph = mod.createPlaceholder(ElemKind::FloatTy, {2, 2}, "input",
+                                   /* isTrainable */ false);
+  auto *add = F->createAdd("add", const1, const2);
+  auto *mul = F->createMul("mul", const1, const2);
+  auto *SN1 = F->createSave("save1", F->createAdd("add1", add, ph));
+  auto *SN2 = F->createSave("save2", F->createAdd("add2", mul, ph));
+  return {SN1, SN2};
+}
+
+/// Test batched, parallel constant folding and the reuse of its results when
+/// folding the same constant operations in another Module.
+TEST_F(GraphOptz, constantFoldBatchedWithCache) {
+  clearConstantFoldingCache();
+  CompilationContext cctx;
+  cctx.optimizationOpts.enableBatchedConstantFolding = true;
+  cctx.optimizationOpts.numConstantFoldingThreads = 2;
+  cctx.optimizationOpts.enableConstantFoldingCache = true;
+
+  // Checks that the operations feeding the SaveNodes \p SNs were folded to
+  // Constants holding \p expectedAdd and \p expectedMul.
+  auto checkFolded = [](std::pair<SaveNode *, SaveNode *> SNs,
+                        float expectedAdd, float expectedMul) {
+    for (auto SNAndExpected : {std::make_pair(SNs.first, expectedAdd),
+                               std::make_pair(SNs.second, expectedMul)}) {
+      auto *add = llvm::dyn_cast<AddNode>(SNAndExpected.first->getInput());
+      ASSERT_TRUE(add);
+      auto *C = llvm::dyn_cast<Constant>(add->getLHS());
+      if (!C) {
+        C = llvm::dyn_cast<Constant>(add->getRHS());
+      }
+      ASSERT_TRUE(C);
+      for (dim_t i = 0; i < 4; i++) {
+        EXPECT_EQ(C->getHandle().raw(i), SNAndExpected.second);
+      }
+    }
+  };
+
+  Module mod1;
+  auto SNs1 = createTwoConstantOperations(mod1, 3.0f);
+  ::glow::optimize(SNs1.first->getParent(), cctx);
+  checkFolded(SNs1, 5.0f, 6.0f);
+  EXPECT_EQ(getConstantFoldingCacheSize(), 2);
+  // All temporary Functions were removed.
+  EXPECT_EQ(mod1.getFunctions().size(), 1);
+
+  // The same operations in another Module reuse the cached results.
+  Module mod2;
+  auto SNs2 = createTwoConstantOperations(mod2, 3.0f);
+  ::glow::optimize(SNs2.first->getParent(), cctx);
+  checkFolded(SNs2, 5.0f, 6.0f);
+  EXPECT_EQ(getConstantFoldingCacheSize(), 2);
+
+  // Operations on Constants with different contents are folded again.
+  Module mod3;
+  auto SNs3 = createTwoConstantOperations(mod3, 4.0f);
+  ::glow::optimize(SNs3.first->getParent(), cctx);
+  checkFolded(SNs3, 6.0f, 8.0f);
+  EXPECT_EQ(getConstantFoldingCacheSize(), 4);
+  clearConstantFoldingCache();
+}
+
 /// Test constant folding for operators which are lowered in Interpreter
 /// backend.
 TEST_F(GraphOptz, constantFoldWithLowering) {
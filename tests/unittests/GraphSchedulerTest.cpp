@@ -23,6 +23,8 @@
 
 #include "gtest/gtest.h"
 
+#include <unordered_set>
+
 using namespace glow;
 
 /// Tests a case in which the memory required to store a node's
@@ -161,3 +163,83 @@ TEST(GraphScheduler, ScheduleQuantizationProfileRightAfterNodeBeingProfiled) {
   // Expect the save node to be the last in the schedule.
   EXPECT_EQ(save, schedule.back());
 }
+
+/// Tests that the MemoryAware scheduler produces a valid schedule whose packed
+/// peak memory is not worse than the one of the ChildMemSizeBased scheduler.
+TEST(GraphScheduler, MemoryAwareSchedulerNotWorseThanChildMemSize) {
+  Module MD;
+  auto *input =
+      MD.createPlaceholder(ElemKind::FloatTy, {4, 64}, "input", false);
+  Function *F = MD.createFunction("F");
+
+  // Several branches which first grow and then shrink their activations are
+  // joined together, so the order in which they are run matters.
+  std::vector<NodeValue> branches;
+  for (unsigned i = 0; i < 4; ++i) {
+    auto *tile = F->createTile("tile", input, 4 + 4 * i, 0);
+    auto *relu = F->createRELU("relu", tile);
+    auto *slice = F->createSlice("slice", relu, {0, 0}, {4, 64});
+    branches.push_back(F->createTanh("tanh", slice));
+  }
+  auto *concat = F->createConcat("concat", branches, 0);
+  F->createSave("save", concat);
+
+  NodesPtrList childMemSchedule;
+  ChildMemSizeBasedScheduler(*F, childMemSchedule).schedule();
+
+  SchedulerOptions opts;
+  opts.kind = SchedulerKind::MemoryAware;
+  opts.beamWidth = 8;
+  NodesPtrList schedule;
+  std::unique_ptr<Scheduler> scheduler(
+      createScheduler(opts.kind, *F, schedule, opts));
+  scheduler->schedule();
+
+  // Every node is scheduled once and after its inputs.
+  ASSERT_EQ(schedule.size(), F->getNodes().size());
+  std::unordered_map<const Node *, size_t> position;
+  size_t pos = 0;
+  for (auto *N : schedule) {
+    position[N] = pos++;
+  }
+  ASSERT_EQ(position.size(), schedule.size());
+  for (auto *N : schedule) {
+    for (unsigned idx = 0, e = N->getNumInputs(); idx < e; ++idx) {
+      const Node *input = N->getNthInput(idx).getNode();
+      if (llvm::isa<Storage>(input)) {
+        continue;
+      }
+      EXPECT_LT(position[input], position[N]);
+    }
+  }
+
+  EXPECT_LE(MemoryAwareScheduler::getPackedPeakMemory(*F, schedule),
+            MemoryAwareScheduler::getPackedPeakMemory(*F, childMemSchedule));
+}
+
+/// Tests that the MemoryAware scheduler still schedules every node once its
+/// search budget is exhausted.
+TEST(GraphScheduler, MemoryAwareSchedulerTinyBudget) {
+  Module MD;
+  auto *input =
+      MD.createPlaceholder(ElemKind::FloatTy, {4, 64}, "input", false);
+  Function *F = MD.createFunction("F");
+  std::vector<NodeValue> branches;
+  for (unsigned i = 0; i < 4; ++i) {
+    auto *tile = F->createTile("tile", input, 4 + 4 * i, 0);
+    branches.push_back(F->createTanh("tanh", tile));
+  }
+  F->createSave("save", F->createConcat("concat", branches, 0));
+
+  SchedulerOptions opts;
+  opts.kind = SchedulerKind::MemoryAware;
+  opts.searchBudget = 1;
+  NodesPtrList schedule;
+  std::unique_ptr<Scheduler> scheduler(
+      createScheduler(opts.kind, *F, schedule, opts));
+  scheduler->schedule();
+
+  EXPECT_EQ(schedule.size(), F->getNodes().size());
+  std::unordered_set<const Node *> scheduled(schedule.begin(), schedule.end());
+  EXPECT_EQ(scheduled.size(), schedule.size());
+}
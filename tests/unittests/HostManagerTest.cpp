@@ -506,6 +506,276 @@ TEST_P(HostManagerTest, testPartitionConfigReplication) {
   }
 }
 
+/// Test that a batch larger than the one of a network partitioned across two
+/// devices is split into micro-batches whose outputs are reassembled.
+TEST_P(HostManagerTest, runNetworkMicroBatched) {
+  CHECK_IF_ENABLED();
+  std::unique_ptr<Module> module = glow::make_unique<Module>();
+  Function *F = module->createFunction("main");
+  auto *X = module->createPlaceholder(ElemKind::FloatTy, {2, 3}, "X", false);
+  auto *pow = F->createPow("Pow", X, 2.0);
+  auto *add = F->createAdd("Add", pow, pow);
+  auto *save = F->createSave("save", add);
+  auto *savePH = save->getPlaceholder();
+
+  std::vector<std::unique_ptr<DeviceConfig>> configs =
+      generateConfigs(backendName_, 2);
+  std::unique_ptr<HostManager> hostManager =
+      glow::make_unique<HostManager>(std::move(configs), HostConfig());
+  CompilationContext cctx;
+  PartitionConfig partitionConfig;
+  partitionConfig.funcName = "main";
+  partitionConfig.numOfPartitions = 2;
+  partitionConfig.backendNames = {backendName_, backendName_};
+  partitionConfig.partitionNames = {"p0", "p1"};
+  partitionConfig.nodeToPartition = {{"Pow", 0}, {"Add", 1}, {"save", 1}};
+  partitionConfig.logicalIDs = {{0}, {1}};
+  cctx.partitionConfig = &partitionConfig;
+  ASSERT_FALSE(ERR_TO_BOOL(hostManager->addNetwork(std::move(module), cctx)));
+
+  // Four micro-batches of two rows.
+  PlaceholderBindings bindings;
+  bindings.insert(X, Tensor(ElemKind::FloatTy, {8, 3}));
+  auto HX = bindings.get(X)->getHandle<>();
+  for (dim_t i = 0; i < HX.size(); i++) {
+    HX.raw(i) = i;
+  }
+  bindings.insert(savePH, Tensor(ElemKind::FloatTy, {8, 3}));
+  EXPECT_FALSE(
+      ERR_TO_BOOL(hostManager->runNetworkMicroBatched("main", bindings)));
+
+  auto HS = bindings.get(savePH)->getHandle<>();
+  for (dim_t i = 0; i < HS.size(); i++) {
+    EXPECT_NEAR(HS.raw(i), 2.0f * i * i, 1E-5);
+  }
+
+  // Outputs which are not batched are rejected.
+  PlaceholderBindings badBindings;
+  badBindings.insert(X, Tensor(ElemKind::FloatTy, {8, 3}));
+  badBindings.allocate(savePH);
+  EXPECT_TRUE(
+      ERR_TO_BOOL(hostManager->runNetworkMicroBatched("main", badBindings)));
+}
+
+/// Test that replacing a network while requests are in flight drops none of
+/// them, and that bindings of the previous version keep working.
+TEST_P(HostManagerTest, replaceNetwork) {
+  CHECK_IF_ENABLED();
+  auto createModule = [](float exponent) {
+    auto module = glow::make_unique<Module>();
+    Function *F = module->createFunction("main");
+    auto *X = module->createPlaceholder(ElemKind::FloatTy, {3}, "X", false);
+    auto *pow = F->createPow("Pow", X, exponent);
+    F->createSave("save", pow);
+    return module;
+  };
+
+  auto module = createModule(2.0);
+  auto *X = module->getPlaceholderByNameSlow("X");
+  auto *save = llvm::cast<SaveNode>(
+      module->getFunction("main")->getNodeByName("save"));
+  auto *savePH = save->getPlaceholder();
+  ASSERT_TRUE(X);
+
+  auto hostManager = createHostManager(backendName_);
+  CompilationContext cctx;
+  ASSERT_FALSE(ERR_TO_BOOL(hostManager->addNetwork(std::move(module), cctx)));
+
+  // Each request checks that it ran on either the old or the new version.
+  constexpr unsigned numRequests = 32;
+  std::atomic<unsigned> numFailed{0};
+  std::vector<std::promise<void>> promises(numRequests);
+  auto runRequest = [&](unsigned i) {
+    auto context = glow::make_unique<ExecutionContext>();
+    context->getPlaceholderBindings()->allocate(X)->getHandle() = {1., 2., 3.};
+    context->getPlaceholderBindings()->allocate(savePH);
+    hostManager->runNetwork(
+        "main", std::move(context),
+        [&, i](RunIdentifierTy, Error err,
+               std::unique_ptr<ExecutionContext> context) {
+          if (ERR_TO_BOOL(std::move(err))) {
+            numFailed++;
+          } else {
+            auto *bindings = context->getPlaceholderBindings();
+            float out = bindings->get(savePH)->getHandle().at({2});
+            if (std::abs(out - 9) > 1E-5 && std::abs(out - 27) > 1E-5) {
+              numFailed++;
+            }
+          }
+          promises[i].set_value();
+        });
+  };
+
+  for (unsigned i = 0; i < numRequests / 2; i++) {
+    runRequest(i);
+  }
+  CompilationContext newCctx;
+  ASSERT_FALSE(
+      ERR_TO_BOOL(hostManager->replaceNetwork(createModule(3.0), newCctx)));
+  for (unsigned i = numRequests / 2; i < numRequests; i++) {
+    runRequest(i);
+  }
+  for (auto &promise : promises) {
+    promise.get_future().wait();
+  }
+  EXPECT_EQ(numFailed, 0);
+
+  // Requests bound to the Placeholders of the first version run on the new
+  // one.
+  PlaceholderBindings bindings;
+  bindings.allocate(X)->getHandle() = {1., 2., 3.};
+  auto *saveTensor = bindings.allocate(savePH);
+  ASSERT_FALSE(ERR_TO_BOOL(hostManager->runNetworkBlocking("main", bindings)));
+  EXPECT_NEAR(saveTensor->getHandle().at({2}), 27, 1E-5);
+
+  // Only one version of the network is left.
+  EXPECT_EQ(hostManager->getDevicePartitionMapping("main").size(), 1);
+  EXPECT_FALSE(ERR_TO_BOOL(hostManager->removeNetwork("main")));
+  EXPECT_FALSE(hostManager->networkAdded("main"));
+}
+
+/// Test that only the configured number of replaced versions is kept, and
+/// that bindings of the versions kept still run on the current one.
+TEST_P(HostManagerTest, replaceNetworkKeepsLastVersions) {
+  CHECK_IF_ENABLED();
+  auto createModule = [](float exponent) {
+    auto module = glow::make_unique<Module>();
+    Function *F = module->createFunction("main");
+    auto *X = module->createPlaceholder(ElemKind::FloatTy, {3}, "X", false);
+    auto *pow = F->createPow("Pow", X, exponent);
+    F->createSave("save", pow);
+    return module;
+  };
+
+  HostConfig hostConfig;
+  hostConfig.maxPreviousNetworkVersions = 1;
+  auto hostManager = createHostManager(backendName_, hostConfig);
+  CompilationContext cctx;
+  ASSERT_FALSE(ERR_TO_BOOL(hostManager->addNetwork(createModule(2.0), cctx)));
+
+  // Bind the Placeholders of the second version, which is the only previous
+  // version kept after the third one replaces it.
+  auto module = createModule(3.0);
+  auto *X = module->getPlaceholderByNameSlow("X");
+  auto *save = llvm::cast<SaveNode>(
+      module->getFunction("main")->getNodeByName("save"));
+  auto *savePH = save->getPlaceholder();
+  ASSERT_TRUE(X);
+  ASSERT_FALSE(
+      ERR_TO_BOOL(hostManager->replaceNetwork(std::move(module), cctx)));
+  ASSERT_FALSE(
+      ERR_TO_BOOL(hostManager->replaceNetwork(createModule(4.0), cctx)));
+
+  PlaceholderBindings bindings;
+  bindings.allocate(X)->getHandle() = {1., 2., 3.};
+  auto *saveTensor = bindings.allocate(savePH);
+  ASSERT_FALSE(ERR_TO_BOOL(hostManager->runNetworkBlocking("main", bindings)));
+  EXPECT_NEAR(saveTensor->getHandle().at({2}), 81, 1E-5);
+}
+
+/// Test that requests to a network with several compiled variants are routed
+/// to the smallest variant that fits them.
+TEST_P(HostManagerTest, networkVariants) {
+  CHECK_IF_ENABLED();
+  std::vector<std::unique_ptr<Module>> modules;
+  for (dim_t length : {8, 2, 4}) {
+    auto module = glow::make_unique<Module>();
+    Function *F = module->createFunction("main");
+    auto *X = module->createPlaceholder(ElemKind::FloatTy, {length, 2}, "X",
+                                        false);
+    auto *pow = F->createPow("Pow", X, 2.0);
+    F->createSave("save", pow, module->createPlaceholder(
+                                   ElemKind::FloatTy, {length, 2}, "Y", false));
+    modules.push_back(std::move(module));
+  }
+  auto *X = modules[0]->getPlaceholderByNameSlow("X");
+  auto *Y = modules[0]->getPlaceholderByNameSlow("Y");
+
+  auto hostManager = createHostManager(backendName_);
+  CompilationContext cctx;
+  ASSERT_FALSE(
+      ERR_TO_BOOL(hostManager->addNetworkVariants(std::move(modules), cctx)));
+  EXPECT_TRUE(hostManager->networkAdded("main"));
+
+  // Requests are bound to tensors of their actual shapes.
+  auto run = [&](dim_t length) -> Error {
+    PlaceholderBindings bindings;
+    auto *input =
+        &bindings.insert(X, Tensor(ElemKind::FloatTy, {length, 2}))->second;
+    auto *output =
+        &bindings.insert(Y, Tensor(ElemKind::FloatTy, {length, 2}))->second;
+    for (dim_t i = 0; i < input->size(); i++) {
+      input->getHandle().raw(i) = i;
+    }
+    RETURN_IF_ERR(hostManager->runNetworkBlocking("main", bindings));
+    for (dim_t i = 0; i < output->size(); i++) {
+      EXPECT_NEAR(output->getHandle().raw(i), i * i, 1E-5);
+    }
+    return Error::success();
+  };
+  EXPECT_FALSE(ERR_TO_BOOL(run(3)));
+  EXPECT_FALSE(ERR_TO_BOOL(run(4)));
+  EXPECT_FALSE(ERR_TO_BOOL(run(1)));
+  EXPECT_FALSE(ERR_TO_BOOL(run(8)));
+  EXPECT_TRUE(ERR_TO_BOOL(run(9)));
+  EXPECT_EQ(hostManager->getNetworkVariantHits("main"),
+            std::vector<uint64_t>({1, 2, 1}));
+
+  EXPECT_FALSE(ERR_TO_BOOL(hostManager->removeNetwork("main")));
+  EXPECT_FALSE(hostManager->networkAdded("main"));
+  EXPECT_TRUE(hostManager->getDevicePartitionMapping("main_variant0").empty());
+}
+
+/// Test that rows of an embedding table can be updated in a deployed network
+/// without reloading it.
+TEST_P(HostManagerTest, updateConstantRows) {
+  CHECK_IF_ENABLED();
+  if (backendName_ != "CPU" && backendName_ != "Interpreter") {
+    GTEST_SKIP();
+  }
+
+  auto module = glow::make_unique<Module>();
+  Function *F = module->createFunction("main");
+  auto *table = module->createConstant(ElemKind::FloatTy, {4, 2}, "table");
+  table->getPayloadMutable().getHandle() = {0., 1., 2., 3., 4., 5., 6., 7.};
+  auto *indices =
+      module->createPlaceholder(ElemKind::Int64ITy, {2}, "indices", false);
+  auto *gather = F->createGather("gather", table, indices);
+  auto *save = F->createSave("save", gather);
+  auto *savePH = save->getPlaceholder();
+
+  auto hostManager = createHostManager(backendName_);
+  CompilationContext cctx;
+  ASSERT_FALSE(ERR_TO_BOOL(hostManager->addNetwork(std::move(module), cctx)));
+
+  PlaceholderBindings bindings;
+  bindings.allocate(indices)->getHandle<int64_t>() = {1, 3};
+  auto *saveTensor = bindings.allocate(savePH);
+  ASSERT_FALSE(ERR_TO_BOOL(hostManager->runNetworkBlocking("main", bindings)));
+  EXPECT_NEAR(saveTensor->getHandle().at({0, 0}), 2, 1E-5);
+  EXPECT_NEAR(saveTensor->getHandle().at({1, 1}), 7, 1E-5);
+
+  // Overwrite rows 2 and 3; row 1 keeps its values.
+  Tensor rows(ElemKind::FloatTy, {2, 2});
+  rows.getHandle() = {20., 21., 30., 31.};
+  ASSERT_FALSE(
+      ERR_TO_BOOL(hostManager->updateConstantRows("main", "table", 2, rows)));
+  ASSERT_FALSE(ERR_TO_BOOL(hostManager->runNetworkBlocking("main", bindings)));
+  EXPECT_NEAR(saveTensor->getHandle().at({0, 0}), 2, 1E-5);
+  EXPECT_NEAR(saveTensor->getHandle().at({1, 0}), 30, 1E-5);
+  EXPECT_NEAR(saveTensor->getHandle().at({1, 1}), 31, 1E-5);
+
+  // Rows past the end of the table, rows of the wrong shape and unknown names
+  // are rejected.
+  EXPECT_TRUE(
+      ERR_TO_BOOL(hostManager->updateConstantRows("main", "table", 3, rows)));
+  Tensor wideRows(ElemKind::FloatTy, {1, 3});
+  EXPECT_TRUE(ERR_TO_BOOL(
+      hostManager->updateConstantRows("main", "table", 0, wideRows)));
+  EXPECT_TRUE(
+      ERR_TO_BOOL(hostManager->updateConstantRows("main", "other", 0, rows)));
+}
+
 /// Test replication for a single partition network.
 TEST_P(HostManagerTest, testSinglePartitionReplication) {
   CHECK_IF_ENABLED();
@@ -18,6 +18,8 @@
 
 #include "gtest/gtest.h"
 
+#include <random>
+
 using namespace glow;
 
 TEST(MemAlloc, simple) {
@@ -342,3 +344,99 @@ TEST(MemAlloc, testAlignment) {
   EXPECT_EQ(p2, 128);
   EXPECT_EQ(p3, 256);
 }
+
+/// Check that packing all buffers at once beats the online first-fit
+/// allocation when a hole left by an early buffer is too small for a later one.
+TEST(MemAlloc, allocateAllBeatsFirstFit) {
+  void *handle0 = reinterpret_cast<void *>(0);
+  void *handle1 = reinterpret_cast<void *>(1);
+  void *handle2 = reinterpret_cast<void *>(2);
+  std::vector<Allocation> allocList = {
+      {handle0, true, 64}, {handle1, true, 64}, {handle0, false},
+      {handle2, true, 128}, {handle1, false}, {handle2, false}};
+
+  // First-fit leaves a 64 byte hole which the 128 byte buffer does not fit.
+  MemoryAllocator firstFit("firstFit", 0);
+  for (const auto &A : allocList) {
+    if (A.alloc) {
+      firstFit.allocate(A.size, A.handle);
+    } else {
+      firstFit.deallocate(A.handle);
+    }
+  }
+  EXPECT_EQ(firstFit.getMaxMemoryUsage(), 256);
+
+  MemoryAllocator MA("test", 0);
+  EXPECT_EQ(MA.allocateAll(allocList), 192);
+  EXPECT_EQ(MA.getMaxMemoryUsage(), 192);
+  EXPECT_EQ(MA.getMemoryLowerBound(), 192);
+  EXPECT_NE(MA.getAllocationStrategy(), AllocationStrategy::LiveIntervalOrder);
+  EXPECT_EQ(MA.getSize(handle2), 128);
+  // Buffers 1 and 2 are live at the same time.
+  EXPECT_TRUE(MA.getAddress(handle1) >= MA.getAddress(handle2) + 128 ||
+              MA.getAddress(handle2) >= MA.getAddress(handle1) + 64);
+
+  // The peak does not fit into a smaller pool.
+  MemoryAllocator small("small", 128);
+  EXPECT_EQ(small.allocateAll(allocList), MemoryAllocator::npos);
+}
+
+/// Check that buffers packed at once never overlap while they are live at the
+/// same time, avoid segments which are already allocated, and never need more
+/// memory than the online first-fit allocation.
+TEST(MemAlloc, allocateAllRandom) {
+  std::mt19937 gen(42);
+  for (unsigned iter = 0; iter < 20; iter++) {
+    // Generate a random schedule of 50 buffers.
+    std::vector<Allocation> allocList;
+    std::vector<uintptr_t> live;
+    uintptr_t nextHandle = 1;
+    while (nextHandle <= 50 || !live.empty()) {
+      if (nextHandle <= 50 && (live.empty() || gen() % 2)) {
+        allocList.emplace_back(reinterpret_cast<void *>(nextHandle), true,
+                               1 + gen() % 1000);
+        live.push_back(nextHandle++);
+      } else {
+        size_t idx = gen() % live.size();
+        allocList.emplace_back(reinterpret_cast<void *>(live[idx]), false);
+        live.erase(live.begin() + idx);
+      }
+    }
+
+    MemoryAllocator firstFit("firstFit", 0);
+    void *fixedHandle = reinterpret_cast<void *>(1000);
+    firstFit.allocate(100, fixedHandle);
+    for (const auto &A : allocList) {
+      if (A.alloc) {
+        firstFit.allocate(A.size, A.handle);
+      } else {
+        firstFit.deallocate(A.handle);
+      }
+    }
+
+    MemoryAllocator MA("test", 0);
+    MA.allocate(100, fixedHandle);
+    uint64_t peak = MA.allocateAll(allocList);
+    EXPECT_LE(peak, firstFit.getMaxMemoryUsage());
+    EXPECT_GE(peak, MA.getMemoryLowerBound());
+
+    // Replay the schedule and check the addresses of the live buffers.
+    std::set<const void *> liveHandles;
+    for (const auto &A : allocList) {
+      if (!A.alloc) {
+        liveHandles.erase(A.handle);
+        continue;
+      }
+      uint64_t begin = MA.getAddress(A.handle);
+      uint64_t end = begin + MA.getSize(A.handle);
+      EXPECT_GE(begin, 100);
+      EXPECT_LE(end, peak);
+      for (const void *other : liveHandles) {
+        uint64_t otherBegin = MA.getAddress(other);
+        uint64_t otherEnd = otherBegin + MA.getSize(other);
+        EXPECT_TRUE(end <= otherBegin || otherEnd <= begin);
+      }
+      liveHandles.insert(A.handle);
+    }
+  }
+}
@@ -4878,3 +4878,42 @@ TEST(onnx, importClipV11) {
     EXPECT_FLOAT_EQ(result.raw(i), expectedValues[i]);
   }
 }
+
+/// Test loading initializers stored in an external data file along with
+/// initializers stored in the model.
+TEST_F(OnnxImporterTest, importExternalData) {
+  ExecutionEngine EE;
+  auto &mod = EE.getModule();
+  std::string netFilename(GLOW_DATA_PATH
+                          "tests/models/onnxModels/ExternalData.onnxtxt");
+  auto *F = mod.createFunction("main");
+  PlaceholderBindings bindings;
+  Placeholder *output;
+
+  Tensor X(ElemKind::FloatTy, {2, 2});
+  X.getHandle() = {100, 200, 300, 400};
+
+  {
+    ONNXModelLoader onnxLD(netFilename, {"X"}, {&X.getType()}, *F);
+    output = EXIT_ON_ERR(onnxLD.getOutputByName("Y"));
+    bindings.allocate(mod.getPlaceholders());
+    updateInputPlaceholdersByName(bindings, &mod, {"X"}, {&X});
+  }
+
+  // The external data starts at offset 8 of the file.
+  auto *W = mod.getConstantByName("W");
+  ASSERT_TRUE(W);
+  auto WH = W->getPayload().getHandle();
+  for (dim_t i = 0; i < 4; i++) {
+    EXPECT_EQ(WH.raw(i), float(i + 1));
+  }
+
+  EE.compile(CompilationMode::Infer);
+  EE.run(bindings);
+
+  std::vector<float> expectedValues = {111, 222, 333, 444};
+  auto result = bindings.get(output)->getHandle();
+  for (dim_t i = 0; i < 4; i++) {
+    EXPECT_FLOAT_EQ(result.raw(i), expectedValues[i]);
+  }
+}
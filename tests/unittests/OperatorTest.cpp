@@ -3024,6 +3024,36 @@ TEST_P(OperatorTest, BroadcastedBatchMatMul) {
   EXPECT_NEAR(H.at({1, 2, 0}), -95, 0.001);
 }
 
+/// Test that the batch mat mul operator works as expected when the LHS is
+/// broadcasted over the batch with a Tile.
+TEST_P(OperatorTest, TiledLHSBatchMatMul) {
+  CHECK_IF_ENABLED();
+
+  auto *lhs =
+      mod_.createPlaceholder(ElemKind::FloatTy, {1, 3, 2}, "lhs", false);
+  auto *rhs =
+      mod_.createPlaceholder(ElemKind::FloatTy, {2, 2, 1}, "rhs", false);
+  bindings_.allocate(lhs)->getHandle() = {1, 2, 3, 4, 5, 6};
+  bindings_.allocate(rhs)->getHandle() = {7, 10, -7, -10};
+
+  auto *tiledLHS = F_->createTile("tile", lhs, 2, /* axis */ 0);
+  auto *R = F_->createBatchMatMul("BMM", tiledLHS, rhs);
+
+  auto *save = F_->createSave("save", R);
+  auto *result = bindings_.allocate(save->getPlaceholder());
+
+  EE_.compile(CompilationMode::Infer);
+  EE_.run(bindings_);
+
+  auto H = result->getHandle();
+  EXPECT_NEAR(H.at({0, 0, 0}), 27, 0.001);
+  EXPECT_NEAR(H.at({0, 1, 0}), 61, 0.001);
+  EXPECT_NEAR(H.at({0, 2, 0}), 95, 0.001);
+  EXPECT_NEAR(H.at({1, 0, 0}), -27, 0.001);
+  EXPECT_NEAR(H.at({1, 1, 0}), -61, 0.001);
+  EXPECT_NEAR(H.at({1, 2, 0}), -95, 0.001);
+}
+
 /// Test that the broadcasted batch mat mul operator works as expected when the
 /// RHS does not have to be tiled.
 TEST_P(OperatorTest, NonBroadcastedBatchMatMul) {
@@ -3281,6 +3311,46 @@ TEST_P(OperatorTest, batchedReduceAdd_5Dinput) {
   EXPECT_TRUE(result->isEqual(expected));
 }
 
+/// Test BatchedReduceAdd over each axis of an input whose sizes are not
+/// multiples of the vector width, so that both the row and the strided
+/// reductions have remainders.
+TEST_P(OperatorTest, batchedReduceAdd_oddSizes) {
+  CHECK_IF_ENABLED();
+
+  const dim_t dims[] = {3, 37, 21};
+  auto *batch = mod_.createPlaceholder(ElemKind::FloatTy, dims, "batch", false);
+  auto BH = bindings_.allocate(batch)->getHandle<float>();
+  BH.randomize(-1.0, 1.0, mod_.getPRNG());
+
+  std::vector<SaveNode *> saves;
+  for (unsigned_t axis = 0; axis < 3; axis++) {
+    auto *R = F_->createBatchedReduceAdd("reduce.add", batch, axis);
+    saves.push_back(F_->createSave("save", R));
+    bindings_.allocate(saves.back()->getPlaceholder());
+  }
+
+  EE_.compile(CompilationMode::Infer);
+  EE_.run(bindings_);
+
+  for (unsigned_t axis = 0; axis < 3; axis++) {
+    auto RH = bindings_.get(saves[axis]->getPlaceholder())->getHandle<float>();
+    std::vector<float> expected(RH.size(), 0);
+    for (dim_t i = 0; i < dims[0]; i++) {
+      for (dim_t j = 0; j < dims[1]; j++) {
+        for (dim_t k = 0; k < dims[2]; k++) {
+          dim_t outer = axis == 0 ? j : i;
+          dim_t inner = axis == 2 ? j : k;
+          dim_t innerSize = axis == 2 ? dims[1] : dims[2];
+          expected[outer * innerSize + inner] += BH.at({i, j, k});
+        }
+      }
+    }
+    for (dim_t i = 0; i < RH.size(); i++) {
+      EXPECT_NEAR(RH.raw(i), expected[i], 1E-4);
+    }
+  }
+}
+
 /// Helper to test VectorNorm using \p DTy.
 template <typename DataType>
 static void testVectorNorm(glow::PlaceholderBindings &bindings,
@@ -5282,6 +5352,36 @@ TEST_P(OperatorTest, Transpose3Dims_Int8) {
   testTranspose3Dims<int8_t>(bindings_, mod_, F_, EE_, ElemKind::Int8QTy);
 }
 
+/// Check the layout conversions of 4-D tensors: NCHW -> NHWC, NHWC -> NCHW
+/// and the swap of the middle dims used to split attention heads. The odd
+/// dims leave ragged edges around the tiles of blocked kernels.
+/// Note: This assumes that Tensor::transpose is correct.
+TEST_P(OperatorTest, TransposeLayouts_Float) {
+  CHECK_IF_ENABLED();
+
+  auto *A = mod_.createPlaceholder(ElemKind::FloatTy, {2, 19, 13, 11}, "A",
+                                   false);
+  bindings_.allocate(A)->getHandle().randomize(-3.0, 3.0, mod_.getPRNG());
+
+  const std::vector<std::vector<unsigned_t>> shuffles = {
+      {0, 2, 3, 1}, {0, 3, 1, 2}, {0, 2, 1, 3}};
+  std::vector<SaveNode *> saves;
+  for (const auto &shuffle : shuffles) {
+    auto *tr = F_->createTranspose("tr", A, shuffle);
+    saves.push_back(F_->createSave("saveTranspose", tr));
+    bindings_.allocate(saves.back()->getPlaceholder());
+  }
+
+  EE_.compile(CompilationMode::Infer);
+  EE_.run(bindings_);
+
+  for (size_t i = 0; i < shuffles.size(); i++) {
+    Tensor dest;
+    bindings_.get(A)->transpose(&dest, shuffles[i]);
+    EXPECT_TRUE(bindings_.get(saves[i]->getPlaceholder())->isEqual(dest));
+  }
+}
+
 /// Test that Transpose optimization into Reshape yields expected results.
 TEST_P(OperatorTest, TransposeIntoReshapeOptim) {
   CHECK_IF_ENABLED();
@@ -17004,6 +17104,145 @@ TEST_P(OperatorStatelessTest, LayerNorm_Int8) {
                             parCloneCountOpt);
 }
 
+/// Test LayerNorm with FloatTy on rows with a large common offset and a small
+/// spread, against a reference computed in double precision. A variance
+/// computed as E[x^2] - E[x]^2 in float cancels to noise on these rows.
+TEST_P(OperatorTest, LayerNorm_Float_LargeOffset) {
+  CHECK_IF_ENABLED();
+
+  constexpr dim_t rows = 4, rowSize = 768;
+  auto *input =
+      mod_.createPlaceholder(ElemKind::FloatTy, {rows, rowSize}, "in", false);
+  // Uniform in 1000 +- 0.17, whose standard deviation is about 0.1.
+  auto IH = bindings_.allocate(input)->getHandle<float>();
+  IH.randomize(999.83f, 1000.17f, mod_.getPRNG());
+
+  Tensor scaleT(ElemKind::FloatTy, {rowSize});
+  scaleT.getHandle().randomize(0.5f, 1.5f, mod_.getPRNG());
+  Tensor biasT(ElemKind::FloatTy, {rowSize});
+  biasT.getHandle().randomize(-1.0f, 1.0f, mod_.getPRNG());
+  auto SH = scaleT.getHandle<float>();
+  auto BH = biasT.getHandle<float>();
+  std::vector<double> expected(IH.size());
+  for (dim_t r = 0; r < rows; r++) {
+    double mean = 0, var = 0;
+    for (dim_t i = 0; i < rowSize; i++) {
+      mean += IH.at({r, i});
+    }
+    mean /= rowSize;
+    for (dim_t i = 0; i < rowSize; i++) {
+      var += (IH.at({r, i}) - mean) * (IH.at({r, i}) - mean);
+    }
+    var /= rowSize;
+    for (dim_t i = 0; i < rowSize; i++) {
+      expected[r * rowSize + i] =
+          (IH.at({r, i}) - mean) / std::sqrt(var + 1e-5) * SH.at({i}) +
+          BH.at({i});
+    }
+  }
+
+  Constant *scaleC = mod_.createConstant("scale", std::move(scaleT));
+  Constant *biasC = mod_.createConstant("bias", std::move(biasT));
+  auto *LNN = F_->createLayerNormalization("LN", input, scaleC, biasC, 1e-5);
+  auto *save = F_->createSave("save", LNN);
+  bindings_.allocate(save->getPlaceholder());
+
+  EE_.compile(CompilationMode::Infer);
+  EE_.run(bindings_);
+
+  auto RH = bindings_.get(save->getPlaceholder())->getHandle<float>();
+  for (dim_t i = 0; i < RH.size(); i++) {
+    EXPECT_NEAR(RH.raw(i), expected[i], 1E-3);
+  }
+}
+
+/// Creates a transformer-style LayerNorm -> Gelu -> SoftMax chain on rows that
+/// are wider than, and not a multiple of, the vector width of row-wise
+/// kernels.
+static FunctionTensorPair
+createAndInitLayerNormGeluSoftMaxTest(glow::PlaceholderBindings &bindings,
+                                      glow::ExecutionEngine &EE) {
+  auto &mod = EE.getModule();
+  Function *F = mod.createFunction("main");
+
+  auto *input = mod.createPlaceholder(ElemKind::FloatTy, {4, 67}, "in", false);
+
+  Tensor scaleT(ElemKind::FloatTy, {67});
+  scaleT.getHandle().randomize(0.0f, 1.0f, mod.getPRNG());
+  Constant *scaleC = mod.createConstant("scale", std::move(scaleT));
+  Tensor biasT(ElemKind::FloatTy, {67});
+  biasT.getHandle().randomize(-1.0f, 1.0f, mod.getPRNG());
+  Constant *biasC = mod.createConstant("bias", std::move(biasT));
+
+  auto *LNN = F->createLayerNormalization("LN", input, scaleC, biasC, 1e-5);
+  auto *gelu = F->createGELU("gelu", LNN);
+  auto *selected =
+      mod.createPlaceholder(ElemKind::Int64ITy, {4, 1}, "selected", false);
+  auto *SM = F->createSoftMax("softmax", gelu, selected);
+
+  bindings.allocate(input)->getHandle().randomize(-5.0f, 5.0f, mod.getPRNG());
+  bindings.allocate(selected)->zero();
+
+  auto *res = F->createSave("save", SM);
+  auto *resultTensor = bindings.allocate(res->getPlaceholder());
+
+  return std::make_pair(F, resultTensor);
+}
+
+/// Test a LayerNorm, Gelu and SoftMax chain with FloatTy.
+TEST_P(OperatorStatelessTest, LayerNormGeluSoftMax_Float) {
+  CHECK_IF_ENABLED();
+  compareAgainstInterpreter(getBackendName(),
+                            createAndInitLayerNormGeluSoftMaxTest,
+                            ElemKind::FloatTy, ElemKind::FloatTy, 0.0001f);
+}
+
+/// Helper to create a scaled dot-product attention chain,
+/// softmax(Q x K^T * scale) x V, the way the BERT attention layer is built.
+static FunctionTensorPair
+createAndInitAttentionTest(glow::PlaceholderBindings &bindings,
+                           glow::ExecutionEngine &EE) {
+  auto &mod = EE.getModule();
+  Function *F = mod.createFunction("main");
+
+  // The number of keys is not a multiple of the tiles of the CPU kernel.
+  constexpr dim_t batches = 6, Sq = 13, Sk = 70, D = 16;
+  auto *Q = mod.createPlaceholder(ElemKind::FloatTy, {batches, Sq, D}, "Q",
+                                  false);
+  auto *K = mod.createPlaceholder(ElemKind::FloatTy, {batches, Sk, D}, "K",
+                                  false);
+  auto *V = mod.createPlaceholder(ElemKind::FloatTy, {batches, Sk, D}, "V",
+                                  false);
+  auto *selected = mod.createPlaceholder(ElemKind::Int64ITy, {batches * Sq, 1},
+                                         "selected", false);
+
+  auto *KT = F->createTranspose("key_transpose", K, {0, 2, 1});
+  auto *scores = F->createBatchMatMul("scores", Q, KT);
+  auto *scale = F->createSplat("scale", scores->getResult().getType(), 0.25f);
+  auto *scaled = F->createMul("scaled", scores, scale);
+  auto *flat = F->createReshape("flat", scaled, {batches * Sq, Sk});
+  auto *SM = F->createSoftMax("softmax", flat, selected);
+  auto *probs = F->createReshape("probs", SM, {batches, Sq, Sk});
+  auto *context = F->createBatchMatMul("context", probs, V);
+
+  for (auto *PH : {Q, K, V}) {
+    bindings.allocate(PH)->getHandle().randomize(-2.0f, 2.0f, mod.getPRNG());
+  }
+  bindings.allocate(selected)->zero();
+
+  auto *res = F->createSave("save", context);
+  auto *resultTensor = bindings.allocate(res->getPlaceholder());
+
+  return std::make_pair(F, resultTensor);
+}
+
+/// Test a scaled dot-product attention chain with FloatTy.
+TEST_P(OperatorStatelessTest, Attention_Float) {
+  CHECK_IF_ENABLED();
+  compareAgainstInterpreter(getBackendName(), createAndInitAttentionTest,
+                            ElemKind::FloatTy, ElemKind::FloatTy, 0.0001f);
+}
+
 static void testDequantizeFRWQ(glow::PlaceholderBindings &bindings,
                                glow::Module &mod, glow::Function *F,
                                glow::ExecutionEngine &EE, ElemKind destTy) {
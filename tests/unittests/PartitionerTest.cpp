@@ -19,7 +19,9 @@
 #include "glow/Graph/Graph.h"
 #include "glow/Importer/ONNXModelLoader.h"
 #include "glow/Optimizer/GraphOptimizer/GraphOptimizer.h"
+#include "glow/Partitioner/PartitionerOptimizer.h"
 #include "glow/Partitioner/PartitionerUtils.h"
+#include "glow/Partitioner/PartitionerValidation.h"
 
 #include "llvm/Support/FileSystem.h"
 
@@ -617,6 +619,86 @@ TEST_F(PartitionerTest, Basic1Roofline) {
   }
 }
 
+/// Test that measured node times gathered from OPERATOR level trace events
+/// take precedence over the roofline estimates, and that cost profiles round
+/// trip through files.
+TEST_F(PartitionerTest, NodeCostProfile) {
+  auto *input =
+      mod_.createPlaceholder(ElemKind::FloatTy, {1, 32}, "input", false);
+  auto *sigmoid = F_->createSigmoid("sigmoid", input);
+  auto *tanh = F_->createTanh("tanh", sigmoid);
+  F_->createSave("ret", tanh);
+
+  // Two runs of the sigmoid, durations are in microseconds. Events of other
+  // levels are ignored.
+  std::list<TraceEvent> events;
+  events.emplace_back("sigmoid", TraceLevel::OPERATOR, uint64_t(0),
+                      uint64_t(100), 0);
+  events.emplace_back("sigmoid", TraceLevel::OPERATOR, uint64_t(1000),
+                      uint64_t(300), 0);
+  events.emplace_back("tanh", TraceLevel::RUNTIME, uint64_t(0), uint64_t(5000),
+                      0);
+  NodeCostProfile profile = getNodeCostProfile(events);
+  ASSERT_EQ(profile.size(), 1);
+  EXPECT_FLOAT_EQ(profile.lookup("sigmoid"), 200e-6f);
+
+  BackendInfo backendInfo;
+  backendInfo.sramCapacity = 100;
+  backendInfo.peakCompute = 10;
+  backendInfo.peakDramBw = 0.1;
+  backendInfo.peakSramBw = 1;
+  backendInfo.peakPCIeBw = 0.05;
+  float rooflineTanh = getNodeComputeTime(tanh, backendInfo);
+  float rooflineSigmoid = getNodeComputeTime(sigmoid, backendInfo);
+  backendInfo.costProfile = &profile;
+  EXPECT_FLOAT_EQ(getNodeComputeTime(sigmoid, backendInfo), 200e-6f);
+  EXPECT_EQ(getNodeComputeTime(tanh, backendInfo), rooflineTanh);
+
+  auto comparison = comparePartitionCost({sigmoid, tanh}, backendInfo);
+  EXPECT_EQ(comparison.predicted, rooflineSigmoid + rooflineTanh);
+  EXPECT_FLOAT_EQ(comparison.observed, 200e-6f);
+  EXPECT_EQ(comparison.numProfiledNodes, 1);
+  EXPECT_EQ(comparison.numNodes, 2);
+
+  llvm::SmallString<64> path;
+  auto tempFileRes =
+      llvm::sys::fs::createTemporaryFile("cost_profile", "txt", path);
+  ASSERT_EQ(tempFileRes.value(), 0);
+  profile["node with spaces"] = 1.5f;
+  EXIT_ON_ERR(saveNodeCostProfile(profile, path));
+  NodeCostProfile loaded;
+  ASSIGN_VALUE_OR_FAIL_TEST(loaded, loadNodeCostProfile(path));
+  llvm::sys::fs::remove(path);
+  ASSERT_EQ(loaded.size(), 2);
+  EXPECT_FLOAT_EQ(loaded.lookup("sigmoid"), 200e-6f);
+  EXPECT_FLOAT_EQ(loaded.lookup("node with spaces"), 1.5f);
+
+  // Operators of lowered nodes are charged to the nodes they were lowered
+  // from, following chains of lowerings and splitting nodes lowered from
+  // several nodes evenly.
+  LoweredInfoMap loweredMap;
+  loweredMap["fc_dot:0"].insert(
+      NodeNameAndKind("fc", 0, Kinded::Kind::FullyConnectedNodeKind));
+  loweredMap["fc_add:0"].insert(
+      NodeNameAndKind("fc_dot", 0, Kinded::Kind::MatMulNodeKind));
+  loweredMap["shared:0"].insert(
+      NodeNameAndKind("sigmoid", 0, Kinded::Kind::SigmoidNodeKind));
+  loweredMap["shared:0"].insert(
+      NodeNameAndKind("tanh", 0, Kinded::Kind::TanhNodeKind));
+  events.clear();
+  events.emplace_back("fc_add", TraceLevel::OPERATOR, uint64_t(0),
+                      uint64_t(100), 0);
+  events.emplace_back("fc_dot", TraceLevel::OPERATOR, uint64_t(0),
+                      uint64_t(300), 0);
+  events.emplace_back("shared", TraceLevel::OPERATOR, uint64_t(0),
+                      uint64_t(200), 0);
+  profile = getNodeCostProfile(events, &loweredMap);
+  ASSERT_EQ(profile.size(), 3);
+  EXPECT_FLOAT_EQ(profile.lookup("fc"), 400e-6f);
+  EXPECT_FLOAT_EQ(profile.lookup("sigmoid"), 100e-6f);
+  EXPECT_FLOAT_EQ(profile.lookup("tanh"), 100e-6f);
+}
+
 TEST_F(PartitionerTest, SelectRepFunc) {
   auto *inA = mod_.createConstant(ElemKind::FloatTy, {2}, "A");
   auto *inB = mod_.createConstant(ElemKind::FloatTy, {2}, "B");
@@ -1418,6 +1500,63 @@ TEST_F(PartitionerTest, memoryUsageValidation1) {
   EXPECT_TRUE(ERR_TO_BOOL(dagList.takeError()));
 }
 
+/// Check that getGraphMemInfo and getFunctionMemory count the results
+/// consumed inside the subgraph as its activations.
+TEST_F(PartitionerTest, activationMemInfoCalculation) {
+  auto *input1 =
+      mod_.createPlaceholder(ElemKind::FloatTy, {16}, "input1", false);
+  auto *input2 =
+      mod_.createPlaceholder(ElemKind::FloatTy, {16}, "input2", false);
+  auto *sub = F_->createSub("sub", input1, input2);
+  auto *mul = F_->createMul("mul", input1, input2);
+  auto *sum = F_->createAdd("add", sub, mul);
+  auto *save = F_->createSave("ret", sum);
+
+  // sub and mul are consumed by sum, which is the output of the subgraph.
+  EXPECT_EQ(getGraphMemInfo({sub, mul, sum}, 1).activationMemSize, 128);
+  // With the save, sum is consumed inside the subgraph as well.
+  EXPECT_EQ(getGraphMemInfo({sub, mul, sum, save}, 1).activationMemSize, 192);
+  EXPECT_EQ(getFunctionMemory(F_).activationMemSize, 192);
+}
+
+/// Check that devices with shared activations are charged for the largest
+/// activations of their partitions, once per device.
+TEST_F(PartitionerTest, sharedActivationsMemoryUsage) {
+  auto *F1 = mod_.createFunction("p1");
+  auto *F2 = mod_.createFunction("p2");
+  NodeToFunctionMap mapping;
+  GraphMemInfo cost(100, 100, 100);
+  cost.activationMemSize = 350;
+  for (auto *F : {F1, F2}) {
+    mapping.createPartition(F, "CPU");
+    mapping.setGraphMemInfo(F, cost);
+  }
+
+  std::map<std::string, BackendInfo> backendMap;
+  backendMap["CPU"].num = 1;
+  backendMap["CPU"].memSize = 1000;
+  backendMap["CPU"].sharedActivations = true;
+
+  // Both partitions fit one device: 2 * 300 bytes plus one 350 bytes arena.
+  EXPECT_FALSE(ERR_TO_BOOL(memoryUsageValidation(mapping, backendMap)));
+  EXPECT_EQ(assignLogicalDeviceID(mapping, backendMap), 1);
+
+  // A larger arena for one of them no longer fits.
+  cost.activationMemSize = 450;
+  mapping.setGraphMemInfo(F2, cost);
+  mapping.clearLogicalDeviceID();
+  EXPECT_EQ(assignLogicalDeviceID(mapping, backendMap), 2);
+
+  // Devices without shared activations are not charged for them.
+  cost.activationMemSize = 800;
+  mapping.setGraphMemInfo(F2, cost);
+  EXPECT_TRUE(ERR_TO_BOOL(memoryUsageValidation(mapping, backendMap)));
+  backendMap["CPU"].sharedActivations = false;
+  EXPECT_FALSE(ERR_TO_BOOL(memoryUsageValidation(mapping, backendMap)));
+  mapping.clearLogicalDeviceID();
+  EXPECT_EQ(assignLogicalDeviceID(mapping, backendMap), 1);
+}
+
 /// This one test dagValidation in partitioner : p1->p2, p2->p1.
 TEST_F(PartitionerTest, dagValidationWithBackendHints) {
   auto *input1 =
@@ -133,3 +133,88 @@ TEST(Optimizer, FunctionPassPipelineFromFile) {
   /// Pipeline read from the file should be equivalent to the original pipeline.
   EXPECT_TRUE(origPipeline.equals(FPM.getPipeline()));
 }
+
+/// Test that passes run in incremental mode only revisit the nodes changed
+/// since their last run and still produce the same result as a full run.
+TEST(Optimizer, IncrementalFunctionPassPipeline) {
+  Module mod;
+  Function *F = mod.createFunction("IncrementalPassManagerTest");
+  auto *A = mod.createPlaceholder(ElemKind::FloatTy, {4}, "A", false);
+  auto *B = mod.createPlaceholder(ElemKind::FloatTy, {4}, "B", false);
+  auto *add1 = F->createAdd("add1", A, B);
+  auto *add2 = F->createAdd("add2", A, B);
+  auto *save1 = F->createSave("save1", add1);
+  auto *save2 = F->createSave("save2", add2);
+  F->createSave("save4", F->createTanh("tanh", A));
+
+  CompilationContext cctx;
+  cctx.optimizationOpts.enableIncrementalGraphOptimization = true;
+  FunctionPassManager FPM("opt", glow::make_unique<FunctionPassPipeline>(
+                                     std::initializer_list<FunctionPassConfig>(
+                                         {{FunctionPassID::CSE}})));
+
+  // The first run has nothing to start from and visits all 6 nodes. CSE only
+  // rewires save2 to add1; the dead add2 is left for the next DCE.
+  EXPECT_TRUE(FPM.run(F, cctx));
+  ASSERT_TRUE(F->verify());
+  EXPECT_EQ(F->getNodes().size(), 6);
+  EXPECT_EQ(save2->getInput().getNode(), add1);
+  auto statsIt = FPM.getPassStatistics().find("CSE");
+  ASSERT_NE(statsIt, FPM.getPassStatistics().end());
+  EXPECT_EQ(statsIt->second.numRuns, 1);
+  EXPECT_EQ(statsIt->second.numIncrementalRuns, 0);
+  EXPECT_EQ(statsIt->second.numNodesVisited, 6);
+
+  // Add a new redundant node. The DCE run before CSE erases add2, which leaves
+  // 7 nodes, and CSE again leaves the dead add3 behind.
+  auto *add3 = F->createAdd("add3", A, B);
+  auto *save3 = F->createSave("save3", add3);
+  EXPECT_TRUE(FPM.run(F, cctx));
+  ASSERT_TRUE(F->verify());
+  EXPECT_EQ(F->getNodes().size(), 7);
+  EXPECT_EQ(save1->getInput().getNode(), save3->getInput().getNode());
+  EXPECT_EQ(save2->getInput().getNode(), save3->getInput().getNode());
+  statsIt = FPM.getPassStatistics().find("CSE");
+  EXPECT_EQ(statsIt->second.numRuns, 2);
+  EXPECT_EQ(statsIt->second.numIncrementalRuns, 1);
+  // The second run only visits the 4 nodes changed since the first one began:
+  // save2 and add1, rewired by the first run, and the new add3 and save3. A
+  // full second run would have visited all 7 nodes.
+  EXPECT_EQ(statsIt->second.numNodesVisited, 6 + 4);
+}
+
+/// Test that changing the type of a node or the payload of a Constant marks
+/// the node and its users as changed for incremental passes.
+TEST(Optimizer, NodeChangeTrackerTypeAndPayload) {
+  Module mod;
+  Function *F = mod.createFunction("NodeChangeTrackerTest");
+  auto *A = mod.createPlaceholder(ElemKind::FloatTy, {4}, "A", false);
+  auto *C = mod.createConstant(ElemKind::FloatTy, {4}, "C");
+  C->getPayloadMutable().zero();
+  auto *add = F->createAdd("add", A, C);
+  auto *tanh = F->createTanh("tanh", add);
+  F->createSave("save", tanh);
+
+  F->enableChangeTracking();
+  NodeChangeTracker *tracker = F->getChangeTracker();
+  auto changedSince = [&](uint64_t epoch) {
+    std::vector<Node *> nodes;
+    tracker->getChangedSince(epoch, nodes);
+    return nodes;
+  };
+
+  uint64_t epoch = tracker->getEpoch();
+  C->getPayloadMutable().getHandle<float>().raw(0) = 1;
+  EXPECT_EQ(changedSince(epoch), std::vector<Node *>({add}));
+
+  epoch = tracker->getEpoch();
+  Tensor T(ElemKind::FloatTy, {4});
+  T.zero();
+  C->assign(&T);
+  EXPECT_EQ(changedSince(epoch), std::vector<Node *>({add}));
+
+  epoch = tracker->getEpoch();
+  add->setType(AddNode::ResultIdx,
+               mod.uniqueTypeWithNewShape(add->getResult().getType(), {4}));
+  EXPECT_EQ(changedSince(epoch), std::vector<Node *>({add, tanh}));
+}
@@ -217,3 +217,48 @@ TEST_F(ProvisionerTest, provisionReplicateWithBackendSpecificNodeInfo) {
   ASSERT_EQ(cloneNodeInfoFinal[cloneMM]["CPU_OptionB"].size(), 1);
   EXPECT_EQ(cloneNodeInfoFinal[cloneMM]["CPU_OptionB"][0], "val2");
 }
+
+/// Check that the partitions of a network are placed on devices bound to the
+/// same NUMA node.
+TEST_F(ProvisionerTest, provisionNUMAAware) {
+  auto mod = setupModule(2);
+
+  DAGListTy networks;
+  DAGNodePtrVec nodes;
+  auto rootNode = glow::make_unique<DAGNode>();
+  rootNode->name = "root";
+  DAGNode *parent = rootNode.get();
+  for (unsigned i = 0; i < 2; i++) {
+    auto node = glow::make_unique<DAGNode>();
+    node->name = "function" + std::to_string(i);
+    node->logicalDevices = {i};
+    node->backendName = "CPU";
+    node->parents.push_back(parent);
+    parent->children.push_back(node.get());
+    parent = node.get();
+    nodes.push_back(std::move(node));
+  }
+  networks.push_back({std::move(rootNode), std::move(nodes)});
+
+  // Devices alternate between NUMA nodes 0 and 1.
+  DeviceManagerMapTy devices;
+  for (unsigned i = 0; i < 4; i++) {
+    auto config = DeviceConfig("CPU");
+    config.parameters["numaNode"] = std::to_string(i % 2);
+    std::unique_ptr<DeviceManager> device(new CPUDeviceManager(config));
+    devices.emplace(i, std::move(device));
+  }
+
+  CompilationContext cctx;
+  Provisioner provisioner(devices);
+  auto err = provisioner.provision(networks, *mod.get(), cctx);
+  EXPECT_FALSE(ERR_TO_BOOL(std::move(err)));
+
+  auto &partitions = networks.front().nodes;
+  ASSERT_EQ(partitions[0]->deviceRuntimeInfos.size(), 1);
+  ASSERT_EQ(partitions[1]->deviceRuntimeInfos.size(), 1);
+  DeviceIDTy first = partitions[0]->deviceRuntimeInfos.begin()->first;
+  DeviceIDTy second = partitions[1]->deviceRuntimeInfos.begin()->first;
+  EXPECT_NE(first, second);
+  EXPECT_EQ(first % 2, second % 2);
+}
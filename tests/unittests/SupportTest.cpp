@@ -18,6 +18,9 @@
 #include "glow/Testing/StrCheck.h"
 #include "gtest/gtest.h"
 
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+
 #ifndef GLOW_DATA_PATH
 #define GLOW_DATA_PATH
 #endif
@@ -94,6 +97,18 @@ TEST(Support, loadStrStrMapYamlFile) {
   EXPECT_EQ(map["backendOption2"], "bar");
 }
 
+TEST(Support, saveStrStrMapYamlFile) {
+  llvm::SmallString<64> path;
+  auto tempFileRes = llvm::sys::fs::createTemporaryFile("map", ".yaml", path);
+  ASSERT_FALSE(tempFileRes.value());
+
+  std::map<std::string, std::string> map = {{"key1", "foo:1"},
+                                            {"key2", "bar"}};
+  serializeStrStrMapToYaml(path, map);
+  EXPECT_EQ(deserializeStrStrMapFromYaml(path), map);
+  llvm::sys::fs::remove(path);
+}
+
 TEST(Support, ScopeGuard) {
   int val = 1;
   {
@@ -619,6 +619,36 @@ TEST(Tensor, transpose2) {
   }
 }
 
+/// Check the permutations that are transposed with blocked kernels: 2-D and
+/// batched 2-D transposes, and swaps of two middle dims, including dims of
+/// size 1 and dims that collapse together.
+TEST(Tensor, transposeBlocked) {
+  PseudoRNG PRNG;
+  Tensor X(ElemKind::FloatTy, {3, 1, 37, 5, 9});
+  auto H = X.getHandle<>();
+  H.randomize(-2.0, 2.0, PRNG);
+
+  const std::vector<std::vector<unsigned_t>> shuffles = {
+      {2, 3, 4, 0, 1}, {0, 1, 3, 4, 2}, {0, 4, 1, 2, 3},
+      {0, 2, 1, 3, 4}, {0, 3, 2, 4, 1}, {3, 0, 2, 1, 4},
+      {4, 2, 3, 0, 1}};
+  for (const auto &shuffle : shuffles) {
+    Tensor Xhat;
+    X.transpose(&Xhat, shuffle);
+    auto XhatH = Xhat.getHandle<>();
+    dim_t src[5];
+    for (dim_t i = 0, e = X.size(); i < e; i++) {
+      // Unravel the output index and map it to the input coordinates.
+      dim_t rem = i;
+      for (int d = 4; d >= 0; d--) {
+        src[shuffle[d]] = rem % Xhat.dims()[d];
+        rem /= Xhat.dims()[d];
+      }
+      EXPECT_EQ(XhatH.raw(i), H.at(src));
+    }
+  }
+}
+
 TEST(Tensor, nonOwnedTensor) {
   Tensor T1 = {1.2f, 12.1f, 51.0f, 1515.2f};
 
@@ -232,6 +232,18 @@ int main(int argc, char **argv) {
       .autoVerify(VerifyKind::SameType, {"Dest", "Src", "Scale"})
       .addGradientInstr({"Dest", "Src", "Scale"}, {"Dest", "Src"});
 
+  /// Normalizes each layer of Src, whose size is given by the dimensions of
+  /// Scale and Bias, and then scales and shifts it by Scale and Bias.
+  BB.newInstr("LayerNormalization")
+      .addOperand("Dest", OperandKind::Out)
+      .addOperand("Src", OperandKind::In)
+      .addOperand("Scale", OperandKind::In)
+      .addOperand("Bias", OperandKind::In)
+      .addMember(MemberType::Float, "Epsilon")
+      .autoVerify(VerifyKind::SameType, {"Dest", "Src"})
+      .autoVerify(VerifyKind::SameType, {"Scale", "Bias"})
+      .autoIRGen();
+
   //===--------------------------------------------------------------------===//
   //                      Loss functions
   //===--------------------------------------------------------------------===//
@@ -278,7 +290,7 @@ int main(int argc, char **argv) {
 
   /// Performs batch matrix multiplication between the LHS and RHS. The operands
   /// are a stack of two dimensional matrices. Example: (N, A, Z) x (N, Z, B) =>
-  /// (N, A, B).
+  /// (N, A, B). An operand with a batch size of 1 is broadcasted.
   BB.newInstr("BatchMatMul")
       .addOperand("Dest", OperandKind::Out)
       .addOperand("LHS", OperandKind::In)
@@ -872,6 +884,17 @@ int main(int argc, char **argv) {
       .autoVerify(VerifyKind::SameType, {"Dest", "Src"})
       .autoIRGen();
 
+  BB.newInstr("Gelu")
+      .addOperand("Dest", OperandKind::Out)
+      .addOperand("Src", OperandKind::In)
+      .inplaceOperand({
+          "Dest",
+          "Src",
+      })
+      .dataParallel()
+      .autoVerify(VerifyKind::SameType, {"Dest", "Src"})
+      .autoIRGen();
+
   BB.newInstr("LeakyRelu")
       .addOperand("Dest", OperandKind::Out)
       .addOperand("Src", OperandKind::In)
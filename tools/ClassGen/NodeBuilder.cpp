@@ -63,8 +63,9 @@ NodeBuilder &NodeBuilder::addFusedActivation() {
                    /* addSetter */ true)
       .addExtraMethod(
           "bool hasFusedActivation() const;",
-          "bool ConvolutionNode::hasFusedActivation() const { return "
-          "getFusedActivation() != FusedActivation::NONE; }");
+          "bool " + name_ +
+              "Node::hasFusedActivation() const { return "
+              "getFusedActivation() != FusedActivation::NONE; }");
 }
 
 void NodeBuilder::emitMemberForwardDecls(std::ostream &os) const {
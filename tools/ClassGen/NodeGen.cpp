@@ -625,7 +625,8 @@ int main(int argc, char **argv) {
       .addResultFromCtorArg()
       .setDocstring("Performs batch matrix multiplication between the LHS and "
                     "RHS. The operands are a stack of two dimensional "
-                    "matrices. Example: (N, A, Z) x (N, Z, B) => (N, A, B)");
+                    "matrices. Example: (N, A, Z) x (N, Z, B) => (N, A, B). "
+                    "An input with a batch size of 1 is broadcasted.");
 
   BB.newNode("BatchedReduceAdd")
       .addInput("Batch")
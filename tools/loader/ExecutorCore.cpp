@@ -211,8 +211,8 @@ int Executor::executeNetwork() {
       << "Cannot emit a bundle and also stream inputs.";
 
   // If tracing is enabled, create a TraceContext to merge each runs events
-  // into.
-  if (!tracePath.empty()) {
+  // into. The node cost profile is computed from the operator events.
+  if (!tracePath.empty() || !nodeCostProfilePath.empty()) {
     traceContext = glow::make_unique<TraceContext>(TraceLevel::STANDARD);
   }
 
@@ -245,6 +245,9 @@ int Executor::executeNetwork() {
   llvm::outs() << "Model: " << Loader::getModelOptPath() << "\n";
   std::mutex ioMu;
   int numErrors = 0;
+  // Origins of the lowered nodes, to charge their operators to the nodes of
+  // the model in the node cost profile.
+  LoweredInfoMap loweredMap;
 
   if (runAllInputsOnAllDevices) {
     if (numDevices != miniBatchThreads) {
@@ -514,6 +517,10 @@ int Executor::executeNetwork() {
     if (profilingGraph()) {
       loader.generateAndSerializeProfilingInfos(bindings);
     }
+    if (!nodeCostProfilePath.empty()) {
+      std::lock_guard<std::mutex> lock(ioMu);
+      loweredMap = loader.getLoweredInfoMap();
+    }
     if (!tracePath.empty()) {
       Error err = loader.getHostManager()->stopDeviceTrace();
       if (err) {
@@ -577,6 +584,9 @@ int Executor::executeNetwork() {
   if (!tracePath.empty()) {
     traceContext->dump(tracePath, appName_);
   }
+  if (!nodeCostProfilePath.empty()) {
+    dumpNodeCostProfile(*traceContext, loweredMap, nodeCostProfilePath);
+  }
 
   return numErrors;
 }
@@ -19,6 +19,7 @@
 #include "glow/Graph/Nodes.h"
 #include "glow/Importer/Caffe2ModelLoader.h"
 #include "glow/Importer/ONNXModelLoader.h"
+#include "glow/Partitioner/PartitionerUtils.h"
 
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/CommandLine.h"
@@ -121,6 +122,13 @@ llvm::cl::opt<std::string> tracePath("trace-path",
                                      llvm::cl::init(""),
                                      llvm::cl::cat(executorCat));
 
+llvm::cl::opt<std::string> nodeCostProfilePath(
+    "dump-node-cost-profile",
+    llvm::cl::desc("Write the mean execution time of each node, measured with "
+                   "operator tracing, to the given file for use with "
+                   "-partitioner-cost-profile"),
+    llvm::cl::init(""), llvm::cl::cat(executorCat));
+
 llvm::cl::opt<bool>
     autoInstrument("auto-instrument",
                    llvm::cl::desc("Add instrumentation for operator tracing"),
@@ -275,7 +283,8 @@ buildAndCompileAndGetInAndOutPair(Loader &loader, PlaceholderBindings &bindings,
   // if requested from command line.
   CompilationContext cctx = loader.getCompilationContext();
   cctx.bindings = &bindings;
-  cctx.backendOpts.autoInstrument = autoInstrument;
+  cctx.backendOpts.autoInstrument =
+      autoInstrument || !nodeCostProfilePath.empty();
   loader.compile(cctx);
 
   // Get input/output placeholder maps.
@@ -424,3 +433,12 @@ void runBenchmark(std::string name, Loader &loader,
   // Wait for all to finish.
   fut.wait();
 }
+
+void dumpNodeCostProfile(TraceContext &traceContext,
+                         const LoweredInfoMap &loweredMap,
+                         llvm::StringRef path) {
+  auto profile = getNodeCostProfile(traceContext.getTraceEvents(), &loweredMap);
+  EXIT_ON_ERR(saveNodeCostProfile(profile, path));
+  llvm::outs() << "Node cost profile of " << profile.size()
+               << " nodes written to " << path << "\n";
+}
@@ -30,6 +30,7 @@ extern llvm::cl::opt<std::string> inputTensorListFile;
 extern llvm::cl::opt<unsigned> excludedFirstWarmupRuns;
 extern llvm::cl::opt<unsigned> warmup;
 extern llvm::cl::opt<std::string> tracePath;
+extern llvm::cl::opt<std::string> nodeCostProfilePath;
 extern llvm::cl::opt<bool> convertInAndOutToFp16;
 extern llvm::cl::opt<unsigned> miniBatch;
 extern llvm::cl::opt<unsigned> miniBatchThreads;
@@ -82,4 +83,11 @@ void runBenchmark(std::string name, glow::Loader &loader,
                   unsigned requestCount, unsigned warmUp,
                   llvm::Timer *restRunsTimer, llvm::Timer *firstRunsTimer,
                   double *bestRunTime);
+
+/// Write the mean time of each node of the model, measured by the OPERATOR
+/// events of \p traceContext, to \p path. Lowered nodes are charged to the
+/// nodes they were lowered from according to \p loweredMap.
+void dumpNodeCostProfile(glow::TraceContext &traceContext,
+                         const glow::LoweredInfoMap &loweredMap,
+                         llvm::StringRef path);
 #endif // GLOW_TOOLS_LOADER_EXECUTOR_CORE_HELPER_FUNCTIONS_H
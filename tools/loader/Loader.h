@@ -122,6 +122,9 @@ public:
   /// Getter for function name.
   std::string getFunctionName() { return functionName_; }
 
+  /// Getter for the origins of the nodes lowered by compile.
+  const LoweredInfoMap &getLoweredInfoMap() const { return loweredMap_; }
+
   /// Getter for the Module. This should not be called after compile since the
   /// compile process is destructive on the original function and module.
   Module *getModule() { return F_->getParent(); }